@@ -2,8 +2,18 @@
 """
 Comprehensive SGX vs TDX Baseline Comparison
 Using actual measurement data
+
+Reads the newest benchmark JSON for each layer (same schema on both sides):
+  tdx_baseline_*.json          attestation_benchmark_fixed.py / collect_all_data.sh
+  sgx_baseline_*.json          benchmark_enclave/benchmark_app
+  sgx_quote_benchmark_*.json   quote_benchmark/quote_benchmark
+Any file can be given explicitly with --tdx / --sgx / --sgx-quote. Values
+that have no measurement fall back to the recorded baseline below.
 """
 
+import argparse
+import glob
+import os
 import matplotlib.pyplot as plt
 import numpy as np
 import json
@@ -15,9 +25,38 @@ plt.rcParams['font.size'] = 11
 plt.rcParams['axes.labelsize'] = 12
 plt.rcParams['legend.fontsize'] = 10
 
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+
+
+def find_latest(prefix):
+    """Newest <prefix>_*.json in the working/script dirs or one level below"""
+    candidates = set()
+    for base in {os.getcwd(), SCRIPT_DIR}:
+        for pattern in (f"{prefix}_*.json", f"*/{prefix}_*.json"):
+            candidates.update(glob.glob(os.path.join(base, pattern)))
+    if not candidates:
+        return None
+    return max(candidates, key=os.path.getmtime)
+
+
+def load_benchmarks(path):
+    """Map operation name -> benchmark entry"""
+    with open(path) as f:
+        data = json.load(f)
+    return {b["operation"]: b for b in data.get("benchmarks", []) if "operation" in b}
+
+
+def measured(benchmarks, operation, key):
+    """Value from a successful benchmark entry, None if absent or errored"""
+    entry = benchmarks.get(operation)
+    if not entry or "error" in entry:
+        return None
+    return entry.get(key)
+
+
 class HierarchicalTEEAnalysis:
-    def __init__(self):
-        # SGX Baseline (from your benchmark)
+    def __init__(self, sgx_file=None, sgx_quote_file=None, tdx_file=None):
+        # SGX Baseline (recorded run, overridden by measurements below)
         self.sgx = {
             'ereport_ms': 0.014,
             'quote_prep_ms': 0.007,
@@ -36,6 +75,68 @@ class HierarchicalTEEAnalysis:
             'payload_bytes': 5172,
             'signature_bytes': 512
         }
+        
+        self.sources = {}
+        self._load_sgx(sgx_file or find_latest("sgx_baseline"))
+        self._load_sgx_quote(sgx_quote_file or find_latest("sgx_quote_benchmark"))
+        self._load_tdx(tdx_file or find_latest("tdx_baseline"))
+    
+    def _apply(self, target, key, value):
+        if value is not None:
+            target[key] = value
+    
+    def _load_sgx(self, path):
+        """benchmark_enclave: local EREPORT, quote preparation, enclave creation"""
+        self.sources['sgx'] = path
+        if not path:
+            print("⚠ No sgx_baseline_*.json found, using recorded SGX baseline")
+            return
+        b = load_benchmarks(path)
+        self._apply(self.sgx, 'ereport_ms', measured(b, "SGX EREPORT Generation", "mean_ms"))
+        self._apply(self.sgx, 'quote_prep_ms', measured(b, "SGX Quote Preparation", "mean_ms"))
+        self._apply(self.sgx, 'enclave_creation_ms', measured(b, "SGX Enclave Creation", "mean_ms"))
+        self._apply(self.sgx, 'throughput',
+                    measured(b, "SGX EREPORT Generation", "throughput_per_sec"))
+        self.sgx['combined_ms'] = self.sgx['ereport_ms'] + self.sgx['quote_prep_ms']
+        print(f"✓ SGX baseline: {path}")
+    
+    def _load_sgx_quote(self, path):
+        """quote_benchmark: DCAP quote generation, the SGX side of remote attestation"""
+        self.sources['sgx_quote'] = path
+        if not path:
+            print("⚠ No sgx_quote_benchmark_*.json found, SGX layer uses local attestation only")
+            return
+        b = load_benchmarks(path)
+        self._apply(self.sgx, 'quote_ms', measured(b, "SGX Quote Generation (QE)", "mean_ms"))
+        self._apply(self.sgx, 'quote_p99_ms', measured(b, "SGX Quote Generation (QE)", "p99_ms"))
+        self._apply(self.sgx, 'quote_end_to_end_ms',
+                    measured(b, "SGX End-to-End Quote", "mean_ms"))
+        self._apply(self.sgx, 'quote_size_bytes', measured(b, "SGX Quote Sizes", "quote_bytes"))
+        print(f"✓ SGX quote benchmark: {path}")
+    
+    def _load_tdx(self, path):
+        """attestation_benchmark_fixed.py output"""
+        self.sources['tdx'] = path
+        if not path:
+            print("⚠ No tdx_baseline_*.json found, using recorded TDX baseline")
+            return
+        b = load_benchmarks(path)
+        phases = "Attestation Phase Breakdown"
+        sizes = "TDX Evidence and Token Sizes"
+        self._apply(self.tdx, 'evidence_collection_ms',
+                    measured(b, phases, "evidence_collection_mean_ms"))
+        self._apply(self.tdx, 'full_attestation_ms', measured(b, phases, "full_attestation_mean_ms"))
+        self._apply(self.tdx, 'network_overhead_ms',
+                    measured(b, phases, "network_verification_overhead_ms"))
+        self._apply(self.tdx, 'token_size_bytes', measured(b, sizes, "token_jwt_bytes"))
+        self._apply(self.tdx, 'header_bytes', measured(b, sizes, "token_header_bytes"))
+        self._apply(self.tdx, 'payload_bytes', measured(b, sizes, "token_payload_bytes"))
+        self._apply(self.tdx, 'signature_bytes', measured(b, sizes, "token_signature_bytes"))
+        print(f"✓ TDX baseline: {path}")
+    
+    def sgx_layer_ms(self):
+        """SGX cost inside the hierarchical protocol: full quote when measured"""
+        return self.sgx.get('quote_end_to_end_ms', self.sgx['combined_ms'])
     
     def create_comprehensive_comparison(self):
         """Create all comparison visualizations"""
@@ -134,7 +235,7 @@ class HierarchicalTEEAnalysis:
         """Plot 3: Hierarchical Protocol Composition"""
         components = ['SGX\nLayer', 'TDX\nLayer', 'Network\n(SGX↔TDX)', 'Binding\nOverhead', 'Total']
         
-        sgx_time = self.sgx['combined_ms']
+        sgx_time = self.sgx_layer_ms()
         tdx_time = self.tdx['evidence_collection_ms']
         network_time = 2.0  # Estimated: SGX server to TDX VM
         binding_time = 1.0  # Estimated: cryptographic binding
@@ -187,8 +288,8 @@ class HierarchicalTEEAnalysis:
         
         ax.set_title(f'TDX Token Structure\nTotal: {sum(sizes)} bytes')
         
-        # Add hierarchical estimate
-        hierarchical_size = sum(sizes) + 1000  # Estimate: +1KB for SGX quote
+        # Add hierarchical estimate: measured SGX quote, else +1KB
+        hierarchical_size = sum(sizes) + int(self.sgx.get('quote_size_bytes', 1000))
         ax.text(0, -1.3, f'Hierarchical (est.): {hierarchical_size} bytes (+{(hierarchical_size-sum(sizes))/sum(sizes)*100:.0f}%)',
                ha='center', fontsize=9, 
                bbox=dict(boxstyle='round', facecolor='lightyellow', alpha=0.7))
@@ -205,7 +306,7 @@ class HierarchicalTEEAnalysis:
         ]
         
         tdx_only = self.tdx['evidence_collection_ms']
-        hierarchical_no_anon = self.sgx['combined_ms'] + tdx_only + 3.0  # 3ms for network+binding
+        hierarchical_no_anon = self.sgx_layer_ms() + tdx_only + 3.0  # 3ms for network+binding
         target_50 = tdx_only * 1.5
         target_100 = tdx_only * 2.0
         
@@ -264,6 +365,12 @@ class HierarchicalTEEAnalysis:
         print(f"  Combined (SGX Layer):        {self.sgx['combined_ms']:10.3f} ms")
         print(f"  Enclave Creation (1-time):   {self.sgx['enclave_creation_ms']:10.3f} ms")
         print(f"  Throughput:                  {self.sgx['throughput']:10,.0f} reports/sec")
+        if 'quote_end_to_end_ms' in self.sgx:
+            print(f"  DCAP Quote (QE):             {self.sgx['quote_ms']:10.3f} ms "
+                  f"(p99 {self.sgx.get('quote_p99_ms', 0):.3f} ms)")
+            print(f"  Quote End-to-End:            {self.sgx['quote_end_to_end_ms']:10.3f} ms")
+        if 'quote_size_bytes' in self.sgx:
+            print(f"  Quote Size:                  {int(self.sgx['quote_size_bytes']):10,d} bytes")
         
         print("\n[2] TDX BASELINE (Outer Layer - VM-Level Isolation)")
         print("-" * 85)
@@ -285,7 +392,7 @@ class HierarchicalTEEAnalysis:
         print("\n[4] HIERARCHICAL COMPOSITION (Estimated)")
         print("-" * 85)
         
-        sgx_layer = self.sgx['combined_ms']
+        sgx_layer = self.sgx_layer_ms()
         tdx_layer = self.tdx['evidence_collection_ms']
         network_sgx_tdx = 2.0  # SGX server <-> TDX VM
         binding = 1.0
@@ -396,6 +503,7 @@ class HierarchicalTEEAnalysis:
                 'projected_total_with_anon_ms': total_with_anon,
                 'projected_overhead_percent': overhead_with_anon
             },
+            'sources': self.sources,
             'timestamp': datetime.now().isoformat()
         }
         
@@ -405,7 +513,14 @@ class HierarchicalTEEAnalysis:
         print("✓ Detailed analysis saved to: hierarchical_tee_analysis.json\n")
 
 if __name__ == "__main__":
-    analyzer = HierarchicalTEEAnalysis()
+    parser = argparse.ArgumentParser(description="SGX vs TDX baseline comparison")
+    parser.add_argument("--sgx", help="benchmark_enclave JSON (default: newest sgx_baseline_*.json)")
+    parser.add_argument("--sgx-quote",
+                        help="quote_benchmark JSON (default: newest sgx_quote_benchmark_*.json)")
+    parser.add_argument("--tdx", help="TDX baseline JSON (default: newest tdx_baseline_*.json)")
+    args = parser.parse_args()
+    
+    analyzer = HierarchicalTEEAnalysis(args.sgx, args.sgx_quote, args.tdx)
     
     # Print detailed text analysis
     analyzer.print_detailed_analysis()
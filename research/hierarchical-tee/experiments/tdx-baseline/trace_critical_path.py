@@ -0,0 +1,334 @@
+#!/usr/bin/env python3
+"""
+Critical path of composite attestations from per-layer span files
+
+Every layer writes its own spans (common/trace_span.h):
+  quote_benchmark --trace FILE       sgx.evidence: sgx.ereport, sgx.qe_quote
+  tdx_bench --compose Q --trace F    tdx.evidence: tdx.td_quote, tdx.ita_token, tdx.submit
+  verifier_daemon --trace FILE       verifier.request: receive, decode, verify
+The files may be Chrome trace format or OTLP/JSON (*.otlp.json) and may
+come from different machines. Spans are joined by the trace ID the SGX
+binding nonce carries.
+
+For each trace this reports the end-to-end time (first span start to last
+span end), the time in each phase, and the critical path. The critical path
+is built backwards from the last span to end. Each step takes the span that
+ended last before the current one started. Gaps on the path are handoffs
+(network, queueing, a file between runs). Overlap is time on which more than
+one phase was running. The serial sum of the phases minus the end-to-end
+time is what running the layers concurrently saved.
+
+Timestamps are CLOCK_REALTIME on each host, so cross-machine gaps are only
+as good as the hosts' clock sync. A handoff that runs backwards against a
+data dependency (the verifier receiving a frame before its token existed)
+is reported as clock skew instead of being folded into the path.
+
+Usage:
+    python3 trace_critical_path.py [--json OUT] [--merged OUT] SPANS [SPANS ...]
+"""
+
+import argparse
+import decimal
+import json
+import statistics
+import sys
+from datetime import datetime
+
+# (producer, consumer): the consumer cannot start before the producer ends
+CAUSAL_ORDER = [
+    ("sgx.ereport", "tdx.td_quote"),        # TD report_data carries the SGX binding
+    ("tdx.ita_token", "verifier.receive"),  # the frame carries the token
+    ("sgx.qe_quote", "verifier.receive"),   # and the SGX quote
+]
+
+# Spans with children only group their phases
+GROUP_SPANS = ("sgx.evidence", "tdx.evidence", "verifier.request")
+
+# Client-side waits on another layer: when that layer's spans are present,
+# the wait is replaced by them and the time after them is the reply's handoff
+REMOTE_WAITS = {"tdx.submit": "verifier."}
+
+
+def load_chrome(doc):
+    """Chrome trace events -> span dicts; the service is the process_name."""
+    events = doc["traceEvents"] if isinstance(doc, dict) else doc
+    services = {}
+    for event in events:
+        if event.get("ph") == "M" and event.get("name") == "process_name":
+            services[event.get("pid")] = event.get("args", {}).get("name", "")
+    spans = []
+    for event in events:
+        args = event.get("args", {})
+        if event.get("ph") != "X" or "trace_id" not in args:
+            continue
+        start_ns = int(decimal.Decimal(event["ts"]) * 1000)
+        spans.append({
+            "trace_id": args["trace_id"],
+            "span_id": args.get("span_id", ""),
+            "parent_id": args.get("parent_id", ""),
+            "name": event["name"],
+            "service": services.get(event.get("pid"), event.get("cat", "")),
+            "start_ns": start_ns,
+            "end_ns": start_ns + int(decimal.Decimal(event.get("dur", 0)) * 1000),
+        })
+    return spans
+
+
+def load_otlp(doc):
+    """OTLP/JSON resourceSpans -> span dicts."""
+    spans = []
+    for resource in doc.get("resourceSpans", []):
+        service = ""
+        for attr in resource.get("resource", {}).get("attributes", []):
+            if attr.get("key") == "service.name":
+                service = attr.get("value", {}).get("stringValue", "")
+        for scope in resource.get("scopeSpans", []):
+            for span in scope.get("spans", []):
+                spans.append({
+                    "trace_id": span["traceId"].lower(),
+                    "span_id": span.get("spanId", ""),
+                    "parent_id": span.get("parentSpanId", ""),
+                    "name": span["name"],
+                    "service": service,
+                    "start_ns": int(span["startTimeUnixNano"]),
+                    "end_ns": int(span["endTimeUnixNano"]),
+                })
+    return spans
+
+
+def load_spans(path):
+    # Decimal: a double keeps only ~0.25 us of an epoch timestamp in us
+    with open(path, "r") as f:
+        doc = json.load(f, parse_float=decimal.Decimal)
+    if isinstance(doc, dict) and "resourceSpans" in doc:
+        return load_otlp(doc)
+    return load_chrome(doc)
+
+
+def union_ns(intervals):
+    """Length of the union of (start, end) intervals."""
+    total = 0
+    current_start = current_end = None
+    for start, end in sorted(intervals):
+        if current_end is None or start > current_end:
+            if current_end is not None:
+                total += current_end - current_start
+            current_start, current_end = start, end
+        else:
+            current_end = max(current_end, end)
+    if current_end is not None:
+        total += current_end - current_start
+    return total
+
+
+def critical_path(phases, waits):
+    """
+    [(name, ns)] from the first span to the last, handoffs included, for
+    the phase spans of one trace. `waits` are the replaced remote waits
+    whose ends follow the last phase.
+    """
+    remaining = sorted(phases, key=lambda s: s["end_ns"])
+    current = remaining.pop()
+    path = [(current["name"], current["end_ns"] - current["start_ns"])]
+    for wait in waits:
+        if wait["end_ns"] > current["end_ns"]:
+            path.insert(0, (f"handoff {current['name']} -> {wait['name']} (reply)",
+                            wait["end_ns"] - current["end_ns"]))
+    while remaining:
+        before = [s for s in remaining if s["end_ns"] <= current["start_ns"]]
+        if not before:
+            break
+        previous = max(before, key=lambda s: s["end_ns"])
+        gap = current["start_ns"] - previous["end_ns"]
+        if gap > 0:
+            path.append((f"handoff {previous['name']} -> {current['name']}", gap))
+        path.append((previous["name"], previous["end_ns"] - previous["start_ns"]))
+        remaining = [s for s in remaining if s["end_ns"] <= previous["start_ns"]]
+        current = previous
+    path.reverse()
+    return path
+
+
+def analyze_trace(spans):
+    phases = [s for s in spans if s["name"] not in GROUP_SPANS]
+    if not phases:
+        phases = spans
+    waits = [s for s in phases if s["name"] in REMOTE_WAITS and
+             any(p["name"].startswith(REMOTE_WAITS[s["name"]]) for p in phases)]
+    phases = [s for s in phases if s not in waits]
+    start = min(s["start_ns"] for s in spans)
+    end = max(s["end_ns"] for s in spans)
+    
+    durations = {}
+    offsets = {}
+    for span in phases:
+        name = span["name"]
+        durations[name] = durations.get(name, 0) + span["end_ns"] - span["start_ns"]
+        offsets[name] = min(offsets.get(name, span["start_ns"]), span["start_ns"])
+    serial = sum(durations.values())
+    covered = union_ns([(s["start_ns"], s["end_ns"]) for s in phases])
+    
+    by_name = {}
+    for span in phases:
+        by_name.setdefault(span["name"], []).append(span)
+    skew_ns = 0
+    for producer, consumer in CAUSAL_ORDER:
+        if producer in by_name and consumer in by_name:
+            produced = max(s["end_ns"] for s in by_name[producer])
+            consumed = min(s["start_ns"] for s in by_name[consumer])
+            skew_ns = max(skew_ns, produced - consumed)
+    
+    return {
+        "end_to_end_ns": end - start,
+        "durations_ns": durations,
+        "offsets_ns": {name: ns - start for name, ns in offsets.items()},
+        "serial_ns": serial,
+        "overlap_ns": serial - covered,
+        "idle_ns": (end - start) - covered,
+        "path": critical_path(phases, waits),
+        "services": sorted({s["service"] for s in spans}),
+        "skew_ns": skew_ns,
+    }
+
+
+def summarize(samples):
+    samples = sorted(samples)
+    n = len(samples)
+    summary = {"iterations": n, "successes": n, "failures": 0}
+    if n:
+        summary.update({
+            "mean_ms": statistics.mean(samples),
+            "median_ms": statistics.median(samples),
+            "stdev_ms": statistics.stdev(samples) if n > 1 else 0,
+            "min_ms": samples[0],
+            "max_ms": samples[-1],
+            "p90_ms": samples[min(int(n * 0.90), n - 1)],
+            "p95_ms": samples[min(int(n * 0.95), n - 1)],
+            "p99_ms": samples[min(int(n * 0.99), n - 1)],
+        })
+    return summary
+
+
+def write_merged(path, traces):
+    """One Chrome trace with a process per service, for chrome://tracing or Perfetto."""
+    pids = {}
+    events = []
+    for trace_id, spans in traces.items():
+        for span in spans:
+            pid = pids.setdefault(span["service"], len(pids) + 1)
+            events.append({
+                "name": span["name"], "cat": span["service"], "ph": "X",
+                "ts": span["start_ns"] / 1000, "dur": (span["end_ns"] - span["start_ns"]) / 1000,
+                "pid": pid, "tid": int(trace_id[:6], 16),
+                "args": {"trace_id": trace_id, "span_id": span["span_id"],
+                         "parent_id": span["parent_id"]},
+            })
+    for service, pid in pids.items():
+        events.append({"name": "process_name", "ph": "M", "pid": pid, "tid": 0,
+                       "args": {"name": service}})
+    with open(path, "w") as f:
+        json.dump({"displayTimeUnit": "ms", "traceEvents": events}, f)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Critical path of traced composite attestations")
+    parser.add_argument("spans", nargs="+", help="span files (Chrome trace or *.otlp.json)")
+    parser.add_argument("--json", help="BenchReport-style JSON for final_comparison.py")
+    parser.add_argument("--merged", help="all spans as one Chrome trace")
+    args = parser.parse_args()
+    
+    traces = {}
+    for path in args.spans:
+        try:
+            spans = load_spans(path)
+        except (OSError, ValueError, KeyError) as e:
+            print(f"❌ Error: {path}: {e}")
+            return 1
+        print(f"  ✓ {path}: {len(spans)} spans")
+        for span in spans:
+            traces.setdefault(span["trace_id"], []).append(span)
+    if not traces:
+        print("❌ Error: no traced spans")
+        return 1
+    
+    results = {trace_id: analyze_trace(spans) for trace_id, spans in traces.items()}
+    layers = max(len(r["services"]) for r in results.values())
+    complete = {t: r for t, r in results.items() if len(r["services"]) == layers}
+    skewed = [r for r in complete.values() if r["skew_ns"] > 0]
+    clean = [r for r in complete.values() if r["skew_ns"] <= 0]
+    
+    print(f"\nTraces: {len(traces)} ({len(complete)} seen by all {layers} layers, "
+          f"{len(skewed)} with clock skew)")
+    if skewed:
+        worst = max(r["skew_ns"] for r in skewed) / 1e6
+        print(f"⚠ {len(skewed)} traces run backwards across hosts (up to {worst:.3f} ms): "
+              f"sync the clocks (chrony, PTP); they are left out below")
+    if not clean:
+        print("❌ Error: no complete trace with consistent clocks")
+        return 1
+    
+    end_to_end = [r["end_to_end_ns"] / 1e6 for r in clean]
+    # Phases in the order they start within a trace
+    offsets = {}
+    for r in clean:
+        for name, ns in r["offsets_ns"].items():
+            offsets.setdefault(name, []).append(ns)
+    phase_names = sorted(offsets, key=lambda name: statistics.mean(offsets[name]))
+    phases = {name: [r["durations_ns"][name] / 1e6 for r in clean if name in r["durations_ns"]]
+              for name in phase_names}
+    
+    # Critical path shares: mean time per step over all clean traces
+    path_totals = {}
+    path_order = []
+    for r in clean:
+        for name, ns in r["path"]:
+            if name not in path_totals:
+                path_totals[name] = 0
+                path_order.append(name)
+            path_totals[name] += ns / 1e6
+    mean_e2e = statistics.mean(end_to_end)
+    
+    print(f"\n{'Phase':<44} {'p50 ms':>10} {'p99 ms':>10} {'mean ms':>10}")
+    print("-" * 77)
+    for name in phase_names:
+        s = summarize(phases[name])
+        print(f"{name:<44} {s['median_ms']:>10.3f} {s['p99_ms']:>10.3f} {s['mean_ms']:>10.3f}")
+    s = summarize(end_to_end)
+    print(f"{'end-to-end':<44} {s['median_ms']:>10.3f} {s['p99_ms']:>10.3f} {s['mean_ms']:>10.3f}")
+    
+    print(f"\nCritical path (mean per trace):")
+    for name in path_order:
+        share = path_totals[name] / len(clean)
+        print(f"  {name:<54} {share:>10.3f} ms  {100 * share / mean_e2e:5.1f}%")
+    overlap = statistics.mean(r["overlap_ns"] / 1e6 for r in clean)
+    serial = statistics.mean(r["serial_ns"] / 1e6 for r in clean)
+    idle = statistics.mean(r["idle_ns"] / 1e6 for r in clean)
+    print(f"\nSerial sum of phases: {serial:.3f} ms, end-to-end {mean_e2e:.3f} ms")
+    print(f"Overlap (phases running at once): {overlap:.3f} ms")
+    print(f"Idle (no phase running, handoffs): {idle:.3f} ms")
+    
+    if args.json:
+        benchmarks = [dict({"operation": "Traced Composite Attestation (end-to-end)"},
+                           **summarize(end_to_end), samples_ms=end_to_end)]
+        for name in phase_names:
+            benchmarks.append(dict({"operation": f"Traced Phase {name}"},
+                                   **summarize(phases[name]), samples_ms=phases[name]))
+        path = {"operation": "Traced Critical Path", "traces": len(clean),
+                "skewed_traces": len(skewed), "serial_ms": serial, "overlap_ms": overlap,
+                "idle_ms": idle}
+        for name in path_order:
+            path[name.replace(" ", "_").replace("->", "to") + "_ms"] = path_totals[name] / len(clean)
+        benchmarks.append(path)
+        report = {"timestamp": datetime.now().isoformat(),
+                  "platform": "Composite SGX+TDX (traced)", "benchmarks": benchmarks}
+        with open(args.json, "w") as f:
+            json.dump(report, f, indent=2)
+        print(f"\n✓ Results saved to: {args.json}")
+    if args.merged:
+        write_merged(args.merged, {t: traces[t] for t in complete})
+        print(f"✓ Merged trace: {args.merged}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,316 @@
+/*
+ * quote_shim.cpp - native /dev/attestation client for Gramine.
+ *
+ * attestation_demo.py pays for a Python interpreter and its imports before
+ * the first quote, then opens, writes and closes user_report_data and opens
+ * quote again for every request. This shim is a statically linked C++
+ * entrypoint (quote_shim.manifest.template) that sets up once and then
+ * serves any number of quotes per process:
+ *
+ *   - user_report_data stays open; each request rewrites it in place and
+ *     fsync()s, which makes Gramine commit the new report data. Gramines
+ *     that do not commit on fsync get the open/write/close path instead.
+ *   - quote has to be reopened per request, since Gramine generates the
+ *     quote when the file is opened, but it is read into one reused buffer.
+ *
+ * Modes:
+ *   quote_shim [--out FILE]                 one quote, saved to FILE
+ *   quote_shim --benchmark N [--json FILE]  N quotes, latency histogram
+ *   quote_shim --serve                      64-byte report data per request
+ *                                           on stdin, <u32 size><quote> on
+ *                                           stdout, until EOF
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+#include "bench_clock.h"
+#include "bench_report.h"
+#include "latency_histogram.h"
+
+#define ATTESTATION_DIR "/dev/attestation"
+#define USER_REPORT_DATA_SIZE 64
+#define SGX_QUOTE_MAX_SIZE 8192
+#define MAX_ITERATIONS 100000
+
+class GramineQuoter {
+public:
+    GramineQuoter() : report_data_fd_(-1), persistent_(true), quote_buf_(SGX_QUOTE_MAX_SIZE) {
+    }
+
+    ~GramineQuoter() {
+        if (report_data_fd_ >= 0) {
+            close(report_data_fd_);
+        }
+    }
+
+    /* Checks the attestation type and opens user_report_data; errors go to stderr. */
+    bool open_device() {
+        FILE* f = fopen(ATTESTATION_DIR "/attestation_type", "r");
+        if (!f) {
+            fprintf(stderr, "❌ Error: %s not found, run inside Gramine SGX\n", ATTESTATION_DIR);
+            return false;
+        }
+        char type[32] = {0};
+        if (!fgets(type, sizeof(type), f)) {
+            type[0] = '\0';
+        }
+        fclose(f);
+        type[strcspn(type, "\n")] = '\0';
+        type_ = type;
+        if (type_ != "dcap") {
+            fprintf(stderr, "⚠ Attestation type '%s', expected 'dcap'\n", type);
+            if (type_ == "none") {
+                return false;
+            }
+        }
+
+        report_data_fd_ = open(ATTESTATION_DIR "/user_report_data", O_WRONLY);
+        if (report_data_fd_ < 0) {
+            fprintf(stderr, "❌ Error opening user_report_data: %s\n", strerror(errno));
+            return false;
+        }
+        return true;
+    }
+
+    /* Quote over `report_data`; `*out` stays valid until the next call. -1 on error. */
+    ssize_t quote(const uint8_t* report_data, const uint8_t** out) {
+        if (!write_report_data(report_data)) {
+            return -1;
+        }
+
+        int fd = open(ATTESTATION_DIR "/quote", O_RDONLY);
+        if (fd < 0) {
+            return -1;
+        }
+        size_t size = 0;
+        while (size < quote_buf_.size()) {
+            ssize_t n = read(fd, &quote_buf_[size], quote_buf_.size() - size);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                break;
+            }
+            size += (size_t)n;
+        }
+        close(fd);
+        if (size == 0) {
+            return -1;
+        }
+        *out = &quote_buf_[0];
+        return (ssize_t)size;
+    }
+
+    const std::string& attestation_type() const { return type_; }
+    bool persistent() const { return persistent_; }
+
+private:
+    GramineQuoter(const GramineQuoter&);
+    GramineQuoter& operator=(const GramineQuoter&);
+
+    static bool write_all(int fd, const uint8_t* data) {
+        return pwrite(fd, data, USER_REPORT_DATA_SIZE, 0) == USER_REPORT_DATA_SIZE;
+    }
+
+    bool write_report_data(const uint8_t* data) {
+        if (persistent_) {
+            if (write_all(report_data_fd_, data) && fsync(report_data_fd_) == 0) {
+                return true;
+            }
+            // No commit on fsync here: fall back to the demo's open/write/close
+            persistent_ = false;
+            close(report_data_fd_);
+            report_data_fd_ = -1;
+        }
+
+        int fd = open(ATTESTATION_DIR "/user_report_data", O_WRONLY);
+        if (fd < 0) {
+            return false;
+        }
+        bool ok = write_all(fd, data);
+        return close(fd) == 0 && ok;
+    }
+
+    int report_data_fd_;
+    bool persistent_;
+    std::vector<uint8_t> quote_buf_;
+    std::string type_;
+};
+
+/* Same padding as generate_user_report_data() in attestation_demo.py. */
+static void fill_report_data(uint8_t* report_data, const char* message) {
+    memset(report_data, 0, USER_REPORT_DATA_SIZE);
+    strncpy((char*)report_data, message, USER_REPORT_DATA_SIZE);
+}
+
+static bool read_exact(int fd, uint8_t* buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = read(fd, buf, len);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        buf += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+static bool write_exact(int fd, const uint8_t* buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, buf, len);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        buf += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+/* --serve: a failed request is answered with size 0 and the loop goes on. */
+static int serve(GramineQuoter* quoter) {
+    uint8_t report_data[USER_REPORT_DATA_SIZE];
+    while (read_exact(STDIN_FILENO, report_data, sizeof(report_data))) {
+        const uint8_t* quote = NULL;
+        ssize_t size = quoter->quote(report_data, &quote);
+        uint32_t len = size > 0 ? (uint32_t)size : 0;
+        uint8_t header[4] = {(uint8_t)len, (uint8_t)(len >> 8), (uint8_t)(len >> 16),
+                             (uint8_t)(len >> 24)};
+        if (!write_exact(STDOUT_FILENO, header, sizeof(header)) ||
+            (len > 0 && !write_exact(STDOUT_FILENO, quote, len))) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int benchmark(GramineQuoter* quoter, int iterations, double setup_ms,
+                     const std::string& json_path) {
+    printf("\nBenchmarking Quote Generation (%d iterations)\n", iterations);
+    printf("--------------------------------------------------\n");
+
+    LatencyHistogram hist;
+    std::vector<double> samples;
+    samples.reserve(iterations);
+    ssize_t quote_size = 0;
+    uint8_t report_data[USER_REPORT_DATA_SIZE];
+    char message[USER_REPORT_DATA_SIZE];
+    double start = bench_now_ms();
+    for (int i = 0; i < iterations; i++) {
+        snprintf(message, sizeof(message), "benchmark-%d-%.3f", i, bench_now_ms());
+        fill_report_data(report_data, message);
+
+        // The whole request: report data write plus quote read
+        const uint8_t* quote = NULL;
+        double call_start = bench_now_ms();
+        ssize_t size = quoter->quote(report_data, &quote);
+        double latency = bench_now_ms() - call_start;
+        if (size > 0) {
+            quote_size = size;
+            hist.record_ms(latency);
+            samples.push_back(latency);
+        }
+    }
+    double elapsed = bench_now_ms() - start;
+
+    printf("  Setup (device open):  %.3f ms\n", setup_ms);
+    printf("  Successful: %d/%d\n", (int)samples.size(), iterations);
+    printf("  Throughput: %.2f quotes/sec\n", samples.size() * 1000.0 / elapsed);
+    printf("  Quote size: %zd bytes\n", quote_size);
+    printf("  user_report_data: %s\n",
+           quoter->persistent() ? "persistent fd (fsync)" : "reopened per request");
+    print_latency_header();
+    print_latency_row("Native shim", hist);
+
+    BenchReport report("Gramine SGX");
+    report.add_latency("Gramine Quote Generation (native shim)", samples, iterations);
+    report.add_field("setup_ms", setup_ms);
+    report.add_field("quote_size", (double)quote_size);
+    report.add_field("persistent_report_data_fd", quoter->persistent() ? 1 : 0);
+    report.add_field("throughput_per_sec", samples.size() * 1000.0 / elapsed);
+    if (report.write_json(json_path.c_str())) {
+        printf("\n✓ Results saved to: %s\n", json_path.c_str());
+    } else {
+        printf("\n✗ Failed to write results to %s\n", json_path.c_str());
+    }
+    return samples.empty() ? 1 : 0;
+}
+
+int main(int argc, char* argv[]) {
+    int iterations = 0;
+    bool serving = false;
+    std::string out_path = "quote.bin";
+    // results/ is the only allowed directory in quote_shim.manifest.template
+    std::string json_path = bench_report_path("results/gramine_shim", "json");
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--benchmark") == 0 && i + 1 < argc) {
+            iterations = atoi(argv[++i]);
+            if (iterations <= 0 || iterations > MAX_ITERATIONS) {
+                printf("Invalid iterations. Using default: 10\n");
+                iterations = 10;
+            }
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            out_path = argv[++i];
+        } else if (strcmp(argv[i], "--serve") == 0) {
+            serving = true;
+        } else {
+            fprintf(stderr, "Usage: %s [--out FILE] [--benchmark N [--json FILE]] [--serve]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+
+    // Calibrate outside the timed setup
+    bench_clock();
+    double setup_start = bench_now_ms();
+    GramineQuoter quoter;
+    if (!quoter.open_device()) {
+        return 1;
+    }
+    double setup_ms = bench_now_ms() - setup_start;
+
+    // stdout carries quotes in --serve, so nothing else may be printed there
+    if (serving) {
+        return serve(&quoter);
+    }
+
+    printf("✓ Attestation type: %s\n", quoter.attestation_type().c_str());
+    if (iterations > 0) {
+        return benchmark(&quoter, iterations, setup_ms, json_path);
+    }
+
+    uint8_t report_data[USER_REPORT_DATA_SIZE];
+    fill_report_data(report_data, "Hierarchical-TEE-SGX-Gramine-Demo");
+    const uint8_t* quote = NULL;
+    ssize_t size = quoter.quote(report_data, &quote);
+    if (size <= 0) {
+        printf("❌ Error reading quote\n");
+        return 1;
+    }
+    FILE* f = fopen(out_path.c_str(), "wb");
+    if (!f || fwrite(quote, 1, (size_t)size, f) != (size_t)size) {
+        printf("❌ Error saving quote to %s\n", out_path.c_str());
+        if (f) {
+            fclose(f);
+        }
+        return 1;
+    }
+    fclose(f);
+    printf("✓ Quote generated (%zd bytes), saved to: %s\n", size, out_path.c_str());
+    return 0;
+}
@@ -0,0 +1,244 @@
+#!/usr/bin/env python3
+"""
+Trimmed Gramine manifest generator
+
+attestation.manifest.template trusts whole directories (the Python stdlib,
+dist-packages, the system library dirs). gramine-manifest hashes every file in
+them, which gives the 188k-line manifest, and the enclave parses all of it at
+startup. This script runs the attestation workload natively under strace,
+collects the files it actually opens, and writes a copy of the template whose
+sgx.trusted_files lists only those files.
+
+With --zipapp, the traced stdlib modules are packed as .pyc into the zip that
+the interpreter already has on sys.path (e.g. /usr/lib/python312.zip). The
+zip is mounted there, so the stdlib becomes one trusted file. os.py
+is always trusted as a regular file, because Python's getpath uses it as
+the prefix landmark. Extension modules (lib-dynload) stay regular files
+as well.
+
+A native run cannot reach /dev/attestation, so the demo exits after its
+imports. A workload that imports lazily inside Gramine needs the trace taken
+with that code path, e.g. by passing a different command after "--".
+
+Usage:
+    python3 trim_manifest.py [--zipapp] [--python PATH] [--trace LOG]
+                             attestation.manifest.template out.manifest.template
+                             [-- command ...]
+"""
+
+import os
+import re
+import subprocess
+import sys
+import tempfile
+import zipfile
+import py_compile
+
+# Opened by the native run but not needed (or not allowed) in the enclave
+SKIP_PREFIXES = ("/dev/", "/proc/", "/sys/", "/tmp/", "/etc/", "/run/")
+
+# Kept as the first entry: Gramine's own glibc and loader
+RUNTIME_ENTRY = '"file:{{ gramine.runtimedir() }}/"'
+
+STRACE_OPEN = re.compile(
+    r'^(?:\d+\s+)?(?:open|openat|execve)\((?:AT_FDCWD, |\d+, )?"((?:[^"\\]|\\.)*)".*\)\s+=\s+(\d+)')
+
+
+def run_trace(python, command, log_path):
+    """Run `command` under strace -f, logging every successful open and exec."""
+    env = dict(os.environ, RUN_BENCHMARK="0")
+    argv = ["strace", "-f", "-qq", "-e", "trace=open,openat,execve", "-o", log_path]
+    argv += command if command else [python, "attestation_demo.py"]
+    print(f"[1/3] Tracing: {' '.join(argv[7:])}")
+    try:
+        subprocess.run(argv, env=env, stdout=subprocess.DEVNULL, check=False)
+    except FileNotFoundError:
+        print("❌ Error: strace not found (or pass an existing log with --trace)")
+        sys.exit(1)
+
+
+def traced_files(log_path):
+    """Regular files the traced run opened, as absolute paths (or cwd-relative)."""
+    cwd = os.getcwd()
+    files = []
+    seen = set()
+    with open(log_path, "r") as f:
+        for line in f:
+            match = STRACE_OPEN.match(line)
+            if not match:
+                continue
+            path = match.group(1).encode().decode("unicode_escape")
+            path = os.path.normpath(os.path.join(cwd, path))
+            if not os.path.isfile(path):
+                continue
+            if path.startswith(cwd + os.sep):
+                path = os.path.relpath(path, cwd)
+            elif path.startswith(SKIP_PREFIXES):
+                continue
+            if path not in seen:
+                seen.add(path)
+                files.append(path)
+    return files
+
+
+def with_sources(files):
+    """
+    Add the .py next to every traced __pycache__ .pyc, and the other way
+    round: Python stats the source to validate the cache.
+    """
+    result = list(files)
+    seen = set(files)
+    for path in files:
+        head, name = os.path.split(path)
+        if os.path.basename(head) == "__pycache__" and name.endswith(".pyc"):
+            partner = os.path.join(os.path.dirname(head), name.split(".")[0] + ".py")
+        elif path.endswith(".py"):
+            tag = sys.implementation.cache_tag
+            partner = os.path.join(head, "__pycache__", f"{name[:-3]}.{tag}.pyc")
+        else:
+            continue
+        if partner not in seen and os.path.isfile(partner):
+            seen.add(partner)
+            result.append(partner)
+    return result
+
+
+def python_paths(python):
+    """(stdlib dir, stdlib zip on sys.path) of the traced interpreter."""
+    out = subprocess.run(
+        [python, "-c", "import sys, sysconfig; print(sysconfig.get_paths()['stdlib']); "
+         "print(next((p for p in sys.path if p.endswith('.zip')), ''))"],
+        capture_output=True, text=True, check=True).stdout.split("\n")
+    return out[0], out[1]
+
+
+def build_zipapp(files, stdlib, zip_path, out_zip):
+    """
+    Move the traced pure-Python stdlib modules into `out_zip`. Returns the
+    files that stay regular trusted files.
+    """
+    keep = []
+    modules = {}
+    for path in files:
+        rel = os.path.relpath(path, stdlib) if os.path.isabs(path) else ""
+        if not rel or rel.startswith("..") or rel.startswith(("lib-dynload", "site-packages")):
+            keep.append(path)
+            continue
+        if rel in ("os.py", os.path.join("__pycache__", f"os.{sys.implementation.cache_tag}.pyc")):
+            keep.append(path)
+            continue
+        
+        # pkg/__pycache__/mod.cpython-XY.pyc and pkg/mod.py both become pkg/mod.pyc
+        head, name = os.path.split(rel)
+        if os.path.basename(head) == "__pycache__" and name.endswith(".pyc"):
+            modules[os.path.join(os.path.dirname(head), name.split(".")[0] + ".pyc")] = path
+        elif rel.endswith(".py"):
+            modules.setdefault(rel[:-3] + ".pyc", path)
+        else:
+            keep.append(path)
+    
+    with zipfile.ZipFile(out_zip, "w", zipfile.ZIP_STORED) as zf, \
+            tempfile.TemporaryDirectory() as tmp:
+        for arcname, path in sorted(modules.items()):
+            if path.endswith(".py"):
+                compiled = os.path.join(tmp, "module.pyc")
+                py_compile.compile(path, cfile=compiled, dfile=os.path.join(zip_path, arcname),
+                                   doraise=True)
+                path = compiled
+            zf.write(path, arcname)
+    print(f"  ✓ {len(modules)} stdlib modules packed into {out_zip} (mounted at {zip_path})")
+    return keep
+
+
+def rewrite_template(template, entries, zip_mount):
+    """Replace the template's sgx.trusted_files block; add the zip mount if any."""
+    lines = ",\n".join(f"    {entry}" for entry in entries)
+    block = f"sgx.trusted_files = [\n{lines},\n]"
+    text, count = re.subn(r"^sgx\.trusted_files = \[.*?^\]", lambda m: block, template,
+                          count=1, flags=re.S | re.M)
+    if count != 1:
+        raise ValueError("sgx.trusted_files block not found in template")
+    
+    if zip_mount:
+        # Last, so the /usr/lib parent mount earlier in the list does not shadow it
+        mount = (f'    \n    # Traced stdlib (trim_manifest.py --zipapp)\n'
+                 f'    {{ path = "{zip_mount[0]}", uri = "file:{zip_mount[1]}" }},\n')
+        text, count = re.subn(r"(^fs\.mounts = \[.*?)(^\])", lambda m: m.group(1) + mount + m.group(2),
+                              text, count=1, flags=re.S | re.M)
+        if count != 1:
+            raise ValueError("fs.mounts block not found in template")
+    
+    header = ("# Generated by trim_manifest.py from attestation.manifest.template:\n"
+              "# sgx.trusted_files holds only the files a traced run opened.\n#\n")
+    return header + text
+
+
+def main():
+    args = sys.argv[1:]
+    command = []
+    if "--" in args:
+        command = args[args.index("--") + 1:]
+        args = args[:args.index("--")]
+    
+    zipapp = False
+    python = sys.executable
+    trace_log = None
+    positional = []
+    i = 0
+    while i < len(args):
+        if args[i] == "--zipapp":
+            zipapp = True
+        elif args[i] == "--python" and i + 1 < len(args):
+            i += 1
+            python = args[i]
+        elif args[i] == "--trace" and i + 1 < len(args):
+            i += 1
+            trace_log = args[i]
+        else:
+            positional.append(args[i])
+        i += 1
+    
+    if len(positional) != 2:
+        print(__doc__.split("Usage:")[1].rstrip())
+        sys.exit(1)
+    template_path, out_path = positional
+    
+    if trace_log is None:
+        trace_log = "trusted_files.strace"
+        run_trace(python, command, trace_log)
+    files = with_sources(traced_files(trace_log))
+    print(f"[2/3] {len(files)} files opened by the workload")
+    
+    # os is frozen in 3.11+, so os.py is never opened, but getpath stats it
+    stdlib, zip_path = python_paths(python)
+    landmark = os.path.join(stdlib, "os.py")
+    if landmark not in files and os.path.isfile(landmark):
+        files.append(landmark)
+    
+    zip_mount = None
+    if zipapp:
+        if not zip_path:
+            print("❌ Error: the interpreter has no stdlib zip on sys.path")
+            sys.exit(1)
+        files = build_zipapp(files, stdlib, zip_path, "python-stdlib.zip")
+        zip_mount = (zip_path, "python-stdlib.zip")
+    
+    python_real = os.path.realpath(python)
+    entries = [RUNTIME_ENTRY, '"file:{{ python_path }}"']
+    for path in files:
+        if path in (python, python_real):
+            continue
+        entries.append(f'"file:{path}"')
+    if zip_mount:
+        entries.append(f'"file:{zip_mount[1]}"')
+    
+    with open(template_path, "r") as f:
+        template = f.read()
+    with open(out_path, "w") as f:
+        f.write(rewrite_template(template, entries, zip_mount))
+    print(f"[3/3] ✓ {out_path}: {len(entries)} trusted files")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
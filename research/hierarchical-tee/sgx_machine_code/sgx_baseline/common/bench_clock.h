@@ -0,0 +1,113 @@
+#ifndef BENCH_CLOCK_H
+#define BENCH_CLOCK_H
+
+/*
+ * Monotonic, high-resolution clock for the SGX benchmarks.
+ *
+ * Uses rdtscp when the CPU advertises an invariant TSC, calibrated once
+ * against CLOCK_MONOTONIC_RAW, and CLOCK_MONOTONIC_RAW itself otherwise.
+ * Both are immune to NTP slews and wall-clock steps, unlike gettimeofday.
+ * rdtscp waits for earlier instructions to retire, so the timestamp does
+ * not drift ahead of the ecall or QE call being measured.
+ *
+ * Header-only so quote_benchmark and benchmark_enclave can share it
+ * without a common library; the clock state lives in an inline function's
+ * static and is shared across translation units.
+ */
+
+#include <stdint.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#define BENCH_CLOCK_HAVE_TSC 1
+#endif
+
+#define BENCH_CLOCK_CALIBRATION_NS 20000000ULL  /* 20 ms */
+
+typedef struct {
+    bool use_tsc;
+    double ns_per_tick;
+    uint64_t origin;
+} bench_clock_t;
+
+static inline uint64_t bench_raw_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+#ifdef BENCH_CLOCK_HAVE_TSC
+static inline uint64_t bench_rdtscp() {
+    unsigned int aux;
+    return __rdtscp(&aux);
+}
+
+static inline bool bench_tsc_usable() {
+    unsigned int eax, ebx, ecx, edx;
+    // RDTSCP: CPUID.80000001H:EDX[27], invariant TSC: CPUID.80000007H:EDX[8]
+    if (!__get_cpuid(0x80000001, &eax, &ebx, &ecx, &edx) || !(edx & (1u << 27))) {
+        return false;
+    }
+    if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) || !(edx & (1u << 8))) {
+        return false;
+    }
+    return true;
+}
+#endif
+
+static inline bench_clock_t bench_clock_calibrate() {
+    bench_clock_t clock;
+    clock.use_tsc = false;
+    clock.ns_per_tick = 1.0;
+    clock.origin = bench_raw_ns();
+#ifdef BENCH_CLOCK_HAVE_TSC
+    if (bench_tsc_usable()) {
+        uint64_t ns_start = bench_raw_ns();
+        uint64_t tsc_start = bench_rdtscp();
+        uint64_t ns_end;
+        do {
+            ns_end = bench_raw_ns();
+        } while (ns_end - ns_start < BENCH_CLOCK_CALIBRATION_NS);
+        uint64_t tsc_end = bench_rdtscp();
+        if (tsc_end > tsc_start) {
+            clock.use_tsc = true;
+            clock.ns_per_tick = (double)(ns_end - ns_start) / (double)(tsc_end - tsc_start);
+            clock.origin = tsc_end;
+        }
+    }
+#endif
+    return clock;
+}
+
+/* Calibrated on first use; call early to keep the 20 ms out of a timed region. */
+inline const bench_clock_t& bench_clock() {
+    static const bench_clock_t clock = bench_clock_calibrate();
+    return clock;
+}
+
+/* Raw ticks: TSC cycles or nanoseconds, see bench_ticks_to_ns(). */
+static inline uint64_t bench_now_ticks() {
+#ifdef BENCH_CLOCK_HAVE_TSC
+    if (bench_clock().use_tsc) {
+        return bench_rdtscp();
+    }
+#endif
+    return bench_raw_ns();
+}
+
+static inline double bench_ticks_to_ns(uint64_t ticks) {
+    return (double)ticks * bench_clock().ns_per_tick;
+}
+
+/* Milliseconds since calibration, drop-in for the old gettimeofday() helpers. */
+static inline double bench_now_ms() {
+    uint64_t now = bench_now_ticks();
+    return bench_ticks_to_ns(now - bench_clock().origin) / 1e6;
+}
+
+static inline const char* bench_clock_source() {
+    return bench_clock().use_tsc ? "rdtscp (invariant TSC)" : "CLOCK_MONOTONIC_RAW";
+}
+
+#endif /* BENCH_CLOCK_H */
@@ -0,0 +1,204 @@
+#ifndef BENCH_REPORT_H
+#define BENCH_REPORT_H
+
+/*
+ * Machine-readable benchmark output for the SGX harnesses.
+ *
+ * Writes the same JSON layout as the TDX side (attestation_benchmark_fixed.py):
+ *
+ *   { "timestamp": ..., "platform": ..., "benchmarks": [
+ *       { "operation": ..., "iterations": ..., "successes": ..., "failures": ...,
+ *         "mean_ms": ..., "median_ms": ..., "stdev_ms": ..., "min_ms": ...,
+ *         "max_ms": ..., "p95_ms": ..., "p99_ms": ..., <extra fields>,
+ *         "samples_ms": [ ... ] }, ... ] }
+ *
+ * Summary statistics follow the Python script's definitions (sample stdev,
+ * p95 = sorted[int(n * 0.95)]) so SGX and TDX numbers are directly
+ * comparable. The raw per-iteration samples are kept so the plotting
+ * scripts can recompute anything else. write_csv() emits the samples as
+ * operation,iteration,latency_ms rows for spreadsheet/CI tooling.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+class BenchReport {
+public:
+    explicit BenchReport(const char* platform) : platform_(platform) {
+        struct timeval tv;
+        gettimeofday(&tv, NULL);
+        struct tm local;
+        localtime_r(&tv.tv_sec, &local);
+        char stamp[32];
+        strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%S", &local);
+        char micros[16];
+        snprintf(micros, sizeof(micros), ".%06ld", (long)tv.tv_usec);
+        timestamp_ = std::string(stamp) + micros;
+    }
+
+    /* Latency operation built from successful per-iteration samples. */
+    void add_latency(const char* operation, const std::vector<double>& samples_ms,
+                     int attempts) {
+        operation_t op;
+        op.name = operation;
+        op.samples_ms = samples_ms;
+        op.has_samples = true;
+        
+        std::vector<double> sorted(samples_ms);
+        std::sort(sorted.begin(), sorted.end());
+        size_t n = sorted.size();
+        op.fields.push_back(field_t("iterations", (double)n));
+        op.fields.push_back(field_t("successes", (double)n));
+        op.fields.push_back(field_t("failures", (double)(attempts - (int)n)));
+        if (n > 0) {
+            double sum = 0;
+            for (size_t i = 0; i < n; i++) {
+                sum += sorted[i];
+            }
+            double mean = sum / (double)n;
+            double var = 0;
+            for (size_t i = 0; i < n; i++) {
+                var += (sorted[i] - mean) * (sorted[i] - mean);
+            }
+            double median = n % 2 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+            op.fields.push_back(field_t("mean_ms", mean));
+            op.fields.push_back(field_t("median_ms", median));
+            op.fields.push_back(field_t("stdev_ms", n > 1 ? sqrt(var / (double)(n - 1)) : 0));
+            op.fields.push_back(field_t("min_ms", sorted[0]));
+            op.fields.push_back(field_t("max_ms", sorted[n - 1]));
+            op.fields.push_back(field_t("p90_ms", rank(sorted, 0.90)));
+            op.fields.push_back(field_t("p95_ms", rank(sorted, 0.95)));
+            op.fields.push_back(field_t("p99_ms", rank(sorted, 0.99)));
+            op.fields.push_back(field_t("p999_ms", rank(sorted, 0.999)));
+        }
+        ops_.push_back(op);
+    }
+
+    /* Operation with only scalar fields (sizes, derived numbers). */
+    void add_operation(const char* operation) {
+        operation_t op;
+        op.name = operation;
+        op.has_samples = false;
+        ops_.push_back(op);
+    }
+
+    /* Extra numeric field on the most recently added operation. */
+    void add_field(const char* key, double value) {
+        if (!ops_.empty()) {
+            ops_.back().fields.push_back(field_t(key, value));
+        }
+    }
+
+    bool write_json(const char* path) const {
+        FILE* f = fopen(path, "w");
+        if (!f) {
+            return false;
+        }
+        fprintf(f, "{\n  \"timestamp\": \"%s\",\n  \"platform\": ", timestamp_.c_str());
+        write_string(f, platform_.c_str());
+        fprintf(f, ",\n  \"benchmarks\": [");
+        for (size_t i = 0; i < ops_.size(); i++) {
+            const operation_t& op = ops_[i];
+            fprintf(f, "%s\n    {\n      \"operation\": ", i ? "," : "");
+            write_string(f, op.name.c_str());
+            for (size_t j = 0; j < op.fields.size(); j++) {
+                fprintf(f, ",\n      \"%s\": ", op.fields[j].first.c_str());
+                write_number(f, op.fields[j].second);
+            }
+            if (op.has_samples) {
+                fprintf(f, ",\n      \"samples_ms\": [");
+                for (size_t j = 0; j < op.samples_ms.size(); j++) {
+                    fprintf(f, "%s", j ? ", " : "");
+                    write_number(f, op.samples_ms[j]);
+                }
+                fprintf(f, "]");
+            }
+            fprintf(f, "\n    }");
+        }
+        fprintf(f, "\n  ]\n}\n");
+        return fclose(f) == 0;
+    }
+
+    bool write_csv(const char* path) const {
+        FILE* f = fopen(path, "w");
+        if (!f) {
+            return false;
+        }
+        fprintf(f, "operation,iteration,latency_ms\n");
+        for (size_t i = 0; i < ops_.size(); i++) {
+            for (size_t j = 0; j < ops_[i].samples_ms.size(); j++) {
+                fprintf(f, "\"%s\",%zu,%.6f\n", ops_[i].name.c_str(), j,
+                        ops_[i].samples_ms[j]);
+            }
+        }
+        return fclose(f) == 0;
+    }
+
+private:
+    typedef std::pair<std::string, double> field_t;
+
+    typedef struct {
+        std::string name;
+        std::vector<field_t> fields;
+        std::vector<double> samples_ms;
+        bool has_samples;
+    } operation_t;
+
+    static double rank(const std::vector<double>& sorted, double fraction) {
+        size_t index = (size_t)((double)sorted.size() * fraction);
+        return sorted[index < sorted.size() ? index : sorted.size() - 1];
+    }
+
+    static void write_string(FILE* f, const char* s) {
+        fputc('"', f);
+        for (; *s; s++) {
+            if (*s == '"' || *s == '\\') {
+                fputc('\\', f);
+            }
+            fputc(*s, f);
+        }
+        fputc('"', f);
+    }
+
+    static void write_number(FILE* f, double value) {
+        // JSON has no NaN/Inf
+        if (isfinite(value)) {
+            fprintf(f, "%.17g", value);
+        } else {
+            fprintf(f, "null");
+        }
+    }
+
+    std::string platform_;
+    std::string timestamp_;
+    std::vector<operation_t> ops_;
+};
+
+/* "<prefix>_YYYYmmdd_HHMMSS.<ext>", the TDX scripts' file naming. */
+static inline std::string bench_report_path(const char* prefix, const char* ext) {
+    time_t now = time(NULL);
+    struct tm local;
+    localtime_r(&now, &local);
+    char stamp[32];
+    strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", &local);
+    return std::string(prefix) + "_" + stamp + "." + ext;
+}
+
+/* foo.json -> foo.csv */
+static inline std::string bench_report_csv_path(const std::string& json_path) {
+    size_t dot = json_path.rfind('.');
+    size_t slash = json_path.rfind('/');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return json_path + ".csv";
+    }
+    return json_path.substr(0, dot) + ".csv";
+}
+
+#endif /* BENCH_REPORT_H */
@@ -0,0 +1,274 @@
+#ifndef COMPOSITE_EVIDENCE_H
+#define COMPOSITE_EVIDENCE_H
+
+/*
+ * Binary container for composite SGX+TDX evidence.
+ *
+ * Replaces the JSON object of 05-sgx-integration.md ({"sgx_quote": hex,
+ * "tdx_token": jwt, "binding_hash": hex}): the quote and binding hash travel
+ * as raw bytes instead of hex, and the parser returns views into the receive
+ * buffer instead of decoded copies.
+ *
+ * Layout, all integers little-endian:
+ *
+ *   header   magic "HTEE" | u8 major | u8 minor | u16 section_count |
+ *            u32 frame_length (header included) | u32 reserved (0)
+ *   section  u16 type | u16 flags (0) | u32 length | payload |
+ *            zero padding to the next 8-byte boundary
+ *
+ * Sections: SGX quote (raw sgx_quote3_t), TDX token (the JWT exactly as
+ * Trust Authority returned it) and the 32-byte SHA-256 binding hash. Each
+ * is required exactly once. A reader rejects another major version, accepts
+ * a newer minor one and skips section types it does not know, so optional
+ * sections can be added without breaking deployed verifiers.
+ *
+ * Minor 1 adds an optional binding proof (binding_merkle.h): when the TDX
+ * token covers a whole batch of enclaves, the token's report_data carries
+ * the Merkle root over their binding hashes and the proof places this
+ * frame's binding under that root.
+ *
+ * The quote section comes first at a fixed offset, so a producer can have
+ * the QE write the quote straight into the frame (composite_evidence_write
+ * leaves it in place) and only append the token and hash behind it.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define COMPOSITE_MAGIC "HTEE"
+#define COMPOSITE_VERSION_MAJOR 1
+#define COMPOSITE_VERSION_MINOR 1
+#define COMPOSITE_HEADER_SIZE 16
+#define COMPOSITE_SECTION_HEADER_SIZE 8
+#define COMPOSITE_QUOTE_OFFSET (COMPOSITE_HEADER_SIZE + COMPOSITE_SECTION_HEADER_SIZE)
+#define COMPOSITE_BINDING_HASH_SIZE 32
+#define COMPOSITE_FRAME_MAX (1u << 20)  /* refuse to buffer more from a peer */
+
+enum composite_section_type_t {
+    COMPOSITE_SECTION_SGX_QUOTE = 1,
+    COMPOSITE_SECTION_TDX_TOKEN = 2,
+    COMPOSITE_SECTION_BINDING_HASH = 3,
+    COMPOSITE_SECTION_BINDING_PROOF = 4   /* optional, minor 1 */
+};
+
+enum composite_status_t {
+    COMPOSITE_OK = 0,
+    COMPOSITE_TRUNCATED,         /* fewer bytes than the header/frame says */
+    COMPOSITE_BAD_MAGIC,
+    COMPOSITE_BAD_VERSION,
+    COMPOSITE_BAD_LENGTH,        /* frame or section length out of bounds */
+    COMPOSITE_DUPLICATE_SECTION,
+    COMPOSITE_MISSING_SECTION,
+    COMPOSITE_BUFFER_TOO_SMALL   /* writer: frame does not fit */
+};
+
+/* Read-only view into a frame; valid as long as the frame buffer is. */
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+} byte_span_t;
+
+typedef struct {
+    uint8_t version_major;
+    uint8_t version_minor;
+    byte_span_t sgx_quote;
+    byte_span_t tdx_token;
+    byte_span_t binding_hash;
+    byte_span_t binding_proof;   /* data NULL when absent */
+} composite_evidence_t;
+
+static inline const char* composite_status_str(composite_status_t status) {
+    switch (status) {
+    case COMPOSITE_OK:                return "ok";
+    case COMPOSITE_TRUNCATED:         return "truncated frame";
+    case COMPOSITE_BAD_MAGIC:         return "bad magic";
+    case COMPOSITE_BAD_VERSION:       return "unsupported version";
+    case COMPOSITE_BAD_LENGTH:        return "bad length";
+    case COMPOSITE_DUPLICATE_SECTION: return "duplicate section";
+    case COMPOSITE_MISSING_SECTION:   return "missing section";
+    case COMPOSITE_BUFFER_TOO_SMALL:  return "buffer too small";
+    }
+    return "unknown";
+}
+
+static inline uint16_t composite_get_u16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t composite_get_u32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void composite_put_u16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void composite_put_u32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static inline size_t composite_section_size(size_t payload) {
+    return COMPOSITE_SECTION_HEADER_SIZE + ((payload + 7) & ~(size_t)7);
+}
+
+/* Frame size for a quote and token of the given lengths. */
+static inline size_t composite_evidence_size(size_t quote_len, size_t token_len) {
+    return COMPOSITE_HEADER_SIZE + composite_section_size(quote_len) +
+           composite_section_size(token_len) +
+           composite_section_size(COMPOSITE_BINDING_HASH_SIZE);
+}
+
+/* The same with a binding proof of `proof_len` bytes. */
+static inline size_t composite_evidence_size_with_proof(size_t quote_len, size_t token_len,
+                                                        size_t proof_len) {
+    return composite_evidence_size(quote_len, token_len) + composite_section_size(proof_len);
+}
+
+static inline uint8_t* composite_put_section(uint8_t* p, uint16_t type,
+                                             const uint8_t* payload, size_t len) {
+    composite_put_u16(p, type);
+    composite_put_u16(p + 2, 0);
+    composite_put_u32(p + 4, (uint32_t)len);
+    p += COMPOSITE_SECTION_HEADER_SIZE;
+    if (payload != p) {
+        memmove(p, payload, len);
+    }
+    size_t padded = composite_section_size(len) - COMPOSITE_SECTION_HEADER_SIZE;
+    memset(p + len, 0, padded - len);
+    return p + padded;
+}
+
+/*
+ * Serialize into `buf`, with a binding proof section unless `proof` is
+ * NULL. Pass quote == buf + COMPOSITE_QUOTE_OFFSET when the quote was
+ * generated in place; it is then not copied. Returns
+ * COMPOSITE_BUFFER_TOO_SMALL without touching `buf` if the frame won't fit.
+ */
+static inline composite_status_t composite_evidence_write_with_proof(
+        uint8_t* buf, size_t capacity, const uint8_t* quote, size_t quote_len,
+        const uint8_t* token, size_t token_len, const uint8_t* binding_hash,
+        const uint8_t* proof, size_t proof_len, size_t* frame_len) {
+    size_t total = proof ? composite_evidence_size_with_proof(quote_len, token_len, proof_len)
+                         : composite_evidence_size(quote_len, token_len);
+    if (total > capacity || total > COMPOSITE_FRAME_MAX) {
+        return COMPOSITE_BUFFER_TOO_SMALL;
+    }
+
+    memcpy(buf, COMPOSITE_MAGIC, 4);
+    buf[4] = COMPOSITE_VERSION_MAJOR;
+    buf[5] = COMPOSITE_VERSION_MINOR;
+    composite_put_u16(buf + 6, proof ? 4 : 3);
+    composite_put_u32(buf + 8, (uint32_t)total);
+    composite_put_u32(buf + 12, 0);
+
+    uint8_t* p = buf + COMPOSITE_HEADER_SIZE;
+    p = composite_put_section(p, COMPOSITE_SECTION_SGX_QUOTE, quote, quote_len);
+    p = composite_put_section(p, COMPOSITE_SECTION_TDX_TOKEN, token, token_len);
+    p = composite_put_section(p, COMPOSITE_SECTION_BINDING_HASH, binding_hash,
+                              COMPOSITE_BINDING_HASH_SIZE);
+    if (proof) {
+        composite_put_section(p, COMPOSITE_SECTION_BINDING_PROOF, proof, proof_len);
+    }
+    *frame_len = total;
+    return COMPOSITE_OK;
+}
+
+static inline composite_status_t composite_evidence_write(uint8_t* buf, size_t capacity,
+                                                          const uint8_t* quote, size_t quote_len,
+                                                          const uint8_t* token, size_t token_len,
+                                                          const uint8_t* binding_hash,
+                                                          size_t* frame_len) {
+    return composite_evidence_write_with_proof(buf, capacity, quote, quote_len, token, token_len,
+                                               binding_hash, NULL, 0, frame_len);
+}
+
+/*
+ * Validate a frame header and return its total length, so a stream reader
+ * can receive the first COMPOSITE_HEADER_SIZE bytes, then the rest of the
+ * frame into the same buffer.
+ */
+static inline composite_status_t composite_evidence_frame_length(const uint8_t* buf, size_t len,
+                                                                 size_t* frame_len) {
+    if (len < COMPOSITE_HEADER_SIZE) {
+        return COMPOSITE_TRUNCATED;
+    }
+    if (memcmp(buf, COMPOSITE_MAGIC, 4) != 0) {
+        return COMPOSITE_BAD_MAGIC;
+    }
+    if (buf[4] != COMPOSITE_VERSION_MAJOR) {
+        return COMPOSITE_BAD_VERSION;
+    }
+    uint32_t total = composite_get_u32(buf + 8);
+    if (total < COMPOSITE_HEADER_SIZE || total > COMPOSITE_FRAME_MAX) {
+        return COMPOSITE_BAD_LENGTH;
+    }
+    *frame_len = total;
+    return COMPOSITE_OK;
+}
+
+/* Parse a complete frame. On success every span points into `buf`. */
+static inline composite_status_t composite_evidence_parse(const uint8_t* buf, size_t len,
+                                                          composite_evidence_t* out) {
+    size_t total = 0;
+    composite_status_t status = composite_evidence_frame_length(buf, len, &total);
+    if (status != COMPOSITE_OK) {
+        return status;
+    }
+    if (len < total) {
+        return COMPOSITE_TRUNCATED;
+    }
+
+    memset(out, 0, sizeof(*out));
+    out->version_major = buf[4];
+    out->version_minor = buf[5];
+
+    uint16_t sections = composite_get_u16(buf + 6);
+    size_t offset = COMPOSITE_HEADER_SIZE;
+    for (uint16_t i = 0; i < sections; i++) {
+        if (total - offset < COMPOSITE_SECTION_HEADER_SIZE) {
+            return COMPOSITE_BAD_LENGTH;
+        }
+        uint16_t type = composite_get_u16(buf + offset);
+        size_t length = composite_get_u32(buf + offset + 4);
+        offset += COMPOSITE_SECTION_HEADER_SIZE;
+        // total <= COMPOSITE_FRAME_MAX, so the padded length cannot overflow
+        if (length > total - offset) {
+            return COMPOSITE_BAD_LENGTH;
+        }
+
+        byte_span_t* slot = NULL;
+        switch (type) {
+        case COMPOSITE_SECTION_SGX_QUOTE:    slot = &out->sgx_quote; break;
+        case COMPOSITE_SECTION_TDX_TOKEN:    slot = &out->tdx_token; break;
+        case COMPOSITE_SECTION_BINDING_HASH: slot = &out->binding_hash; break;
+        case COMPOSITE_SECTION_BINDING_PROOF: slot = &out->binding_proof; break;
+        default: break;  // newer optional section
+        }
+        if (slot) {
+            if (slot->data) {
+                return COMPOSITE_DUPLICATE_SECTION;
+            }
+            slot->data = buf + offset;
+            slot->size = length;
+        }
+
+        size_t padded = (length + 7) & ~(size_t)7;
+        offset += padded < total - offset ? padded : total - offset;
+    }
+
+    if (!out->sgx_quote.data || !out->tdx_token.data || !out->binding_hash.data) {
+        return COMPOSITE_MISSING_SECTION;
+    }
+    if (out->sgx_quote.size == 0 || out->tdx_token.size == 0 ||
+        out->binding_hash.size != COMPOSITE_BINDING_HASH_SIZE) {
+        return COMPOSITE_BAD_LENGTH;
+    }
+    return COMPOSITE_OK;
+}
+
+#endif /* COMPOSITE_EVIDENCE_H */
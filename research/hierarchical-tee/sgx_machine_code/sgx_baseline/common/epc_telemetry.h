@@ -0,0 +1,121 @@
+#ifndef EPC_TELEMETRY_H
+#define EPC_TELEMETRY_H
+
+/*
+ * Host-side EPC paging counters for the SGX benchmarks.
+ *
+ * When the EPC is oversubscribed the kernel evicts enclave pages with EWB
+ * and reloads them with ELDU on the next touch, and an enclave that was
+ * fast in isolation slows down with nothing in its own code to show why.
+ * epc_sample() reads what the host exposes, so a benchmark can take one
+ * sample per window and line the deltas up with that window's latencies:
+ *
+ *   - free EPC pages, from the out-of-tree isgx driver
+ *     (/sys/module/isgx/parameters/sgx_nr_free_pages); the in-kernel
+ *     driver has no such counter
+ *   - total EPC, from the in-kernel driver's per-node sgx_total_bytes
+ *   - EWB and ELDU counts, from kprobe hit counters in tracefs. Neither
+ *     driver counts them, so the probes have to be set up once as root:
+ *
+ *       cd /sys/kernel/tracing
+ *       echo 'p:sgx_ewb __sgx_encl_ewb' >> kprobe_events
+ *       echo 'p:sgx_eldu __sgx_encl_eldu' >> kprobe_events
+ *       echo 1 > events/kprobes/enable
+ *
+ *     The symbols are static in arch/x86/kernel/cpu/sgx and can be renamed
+ *     or inlined; check /proc/kallsyms and probe whatever the running
+ *     kernel calls them. kprobe_profile is readable by root only unless the
+ *     tracefs permissions are relaxed.
+ *
+ * A counter the host does not expose reads as -1, so a run on a plain
+ * host still shows the latency side.
+ */
+
+#include <glob.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define EPC_ISGX_FREE_PAGES "/sys/module/isgx/parameters/sgx_nr_free_pages"
+#define EPC_NODE_TOTAL_GLOB "/sys/devices/system/node/node*/x86/sgx_total_bytes"
+#define EPC_KPROBE_EWB "sgx_ewb"
+#define EPC_KPROBE_ELDU "sgx_eldu"
+
+typedef struct {
+    int64_t free_pages;     /* -1: not exposed */
+    int64_t total_bytes;    /* -1: not exposed */
+    int64_t ewb;            /* cumulative since the probe was added, -1: no probe */
+    int64_t eldu;
+} epc_sample_t;
+
+static inline int64_t epc_read_counter(const char* path) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        return -1;
+    }
+    long long value = -1;
+    if (fscanf(f, "%lld", &value) != 1) {
+        value = -1;
+    }
+    fclose(f);
+    return value;
+}
+
+static inline int64_t epc_total_bytes() {
+    glob_t nodes;
+    if (glob(EPC_NODE_TOTAL_GLOB, 0, NULL, &nodes) != 0) {
+        return -1;
+    }
+    int64_t total = 0;
+    for (size_t i = 0; i < nodes.gl_pathc; i++) {
+        int64_t bytes = epc_read_counter(nodes.gl_pathv[i]);
+        if (bytes > 0) {
+            total += bytes;
+        }
+    }
+    globfree(&nodes);
+    return total;
+}
+
+/* kprobe_profile rows are "<event> <hits> <misses>". */
+static inline void epc_read_kprobes(int64_t* ewb, int64_t* eldu) {
+    *ewb = -1;
+    *eldu = -1;
+    FILE* f = fopen("/sys/kernel/tracing/kprobe_profile", "r");
+    if (!f) {
+        f = fopen("/sys/kernel/debug/tracing/kprobe_profile", "r");
+    }
+    if (!f) {
+        return;
+    }
+    char event[128];
+    unsigned long long hits;
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        if (sscanf(line, "%127s %llu", event, &hits) != 2) {
+            continue;
+        }
+        if (strcmp(event, EPC_KPROBE_EWB) == 0) {
+            *ewb = (int64_t)hits;
+        } else if (strcmp(event, EPC_KPROBE_ELDU) == 0) {
+            *eldu = (int64_t)hits;
+        }
+    }
+    fclose(f);
+}
+
+/* A few small file reads; cheap enough to take between requests. */
+static inline epc_sample_t epc_sample() {
+    epc_sample_t sample;
+    sample.free_pages = epc_read_counter(EPC_ISGX_FREE_PAGES);
+    sample.total_bytes = epc_total_bytes();
+    epc_read_kprobes(&sample.ewb, &sample.eldu);
+    return sample;
+}
+
+/* Counter delta between two samples, -1 if either side is missing. */
+static inline int64_t epc_delta(int64_t before, int64_t after) {
+    return before < 0 || after < 0 ? -1 : after - before;
+}
+
+#endif /* EPC_TELEMETRY_H */
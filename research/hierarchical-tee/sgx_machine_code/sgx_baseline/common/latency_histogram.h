@@ -0,0 +1,149 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+/*
+ * HDR-style latency histogram for the SGX benchmarks.
+ *
+ * Values are recorded in nanoseconds into log-linear buckets: each power
+ * of two is split into 2^(LATENCY_HIST_SUB_BITS - 1) linear sub-buckets,
+ * so any recorded value is reported within 1/128 (< 0.8%) of its true
+ * value from 1 ns up to hours. Recording is a shift and an increment; the
+ * counts array is allocated once by the constructor.
+ *
+ * Histograms are not thread-safe: give each worker its own and merge()
+ * them after join, the same way the worker stats are aggregated.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+#define LATENCY_HIST_SUB_BITS 8
+#define LATENCY_HIST_SUB_COUNT (1u << LATENCY_HIST_SUB_BITS)         /* 256 */
+#define LATENCY_HIST_HALF_COUNT (LATENCY_HIST_SUB_COUNT / 2)          /* 128 */
+#define LATENCY_HIST_BUCKETS \
+    ((64 - LATENCY_HIST_SUB_BITS + 2) * LATENCY_HIST_HALF_COUNT)
+
+class LatencyHistogram {
+public:
+    LatencyHistogram()
+        : counts_(LATENCY_HIST_BUCKETS, 0), total_(0), min_(UINT64_MAX), max_(0), sum_ns_(0) {
+    }
+
+    void record_ns(uint64_t value) {
+        counts_[index_of(value)]++;
+        total_++;
+        sum_ns_ += (double)value;
+        if (value < min_) {
+            min_ = value;
+        }
+        if (value > max_) {
+            max_ = value;
+        }
+    }
+
+    void record_ms(double ms) {
+        record_ns(ms > 0 ? (uint64_t)(ms * 1e6 + 0.5) : 0);
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (size_t i = 0; i < counts_.size(); i++) {
+            counts_[i] += other.counts_[i];
+        }
+        total_ += other.total_;
+        sum_ns_ += other.sum_ns_;
+        if (other.min_ < min_) {
+            min_ = other.min_;
+        }
+        if (other.max_ > max_) {
+            max_ = other.max_;
+        }
+    }
+
+    void reset() {
+        counts_.assign(counts_.size(), 0);
+        total_ = 0;
+        min_ = UINT64_MAX;
+        max_ = 0;
+        sum_ns_ = 0;
+    }
+
+    uint64_t count() const { return total_; }
+    uint64_t min_ns() const { return total_ ? min_ : 0; }
+    uint64_t max_ns() const { return max_; }
+    double mean_ns() const { return total_ ? sum_ns_ / (double)total_ : 0; }
+
+    /* Smallest recorded value v such that `percentile`% of samples are <= v. */
+    uint64_t percentile_ns(double percentile) const {
+        if (total_ == 0) {
+            return 0;
+        }
+        uint64_t rank = (uint64_t)(percentile / 100.0 * (double)total_ + 0.5);
+        if (rank < 1) {
+            rank = 1;
+        }
+        if (rank >= total_) {
+            return max_;
+        }
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts_.size(); i++) {
+            seen += counts_[i];
+            if (seen >= rank) {
+                uint64_t value = highest_equivalent(i);
+                return value < max_ ? value : max_;
+            }
+        }
+        return max_;
+    }
+
+    double percentile_ms(double percentile) const {
+        return (double)percentile_ns(percentile) / 1e6;
+    }
+
+private:
+    static unsigned msb(uint64_t value) {
+        return 63 - __builtin_clzll(value);
+    }
+
+    static size_t index_of(uint64_t value) {
+        if (value < LATENCY_HIST_SUB_COUNT) {
+            return (size_t)value;
+        }
+        unsigned bucket = msb(value) - (LATENCY_HIST_SUB_BITS - 1);
+        return (size_t)bucket * LATENCY_HIST_HALF_COUNT + (size_t)(value >> bucket);
+    }
+
+    static uint64_t highest_equivalent(size_t index) {
+        if (index < LATENCY_HIST_SUB_COUNT) {
+            return index;
+        }
+        unsigned bucket = (unsigned)(index / LATENCY_HIST_HALF_COUNT) - 1;
+        uint64_t sub = index - (size_t)bucket * LATENCY_HIST_HALF_COUNT;
+        return ((sub + 1) << bucket) - 1;
+    }
+
+    std::vector<uint64_t> counts_;
+    uint64_t total_;
+    uint64_t min_;
+    uint64_t max_;
+    double sum_ns_;
+};
+
+/* One row of the tail-latency table, in milliseconds. */
+static inline void print_latency_header() {
+    printf("  %-18s | %9s | %9s | %9s | %9s | %9s | %9s\n",
+           "Phase", "p50 ms", "p90 ms", "p99 ms", "p99.9 ms", "max ms", "mean ms");
+}
+
+static inline void print_latency_row(const char* label, const LatencyHistogram& hist) {
+    if (hist.count() == 0) {
+        printf("  %-18s | (no samples)\n", label);
+        return;
+    }
+    printf("  %-18s | %9.3f | %9.3f | %9.3f | %9.3f | %9.3f | %9.3f\n",
+           label, hist.percentile_ms(50.0), hist.percentile_ms(90.0),
+           hist.percentile_ms(99.0), hist.percentile_ms(99.9),
+           (double)hist.max_ns() / 1e6, hist.mean_ns() / 1e6);
+}
+
+#endif /* LATENCY_HISTOGRAM_H */
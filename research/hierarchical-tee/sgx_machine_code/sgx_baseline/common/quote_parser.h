@@ -0,0 +1,313 @@
+#ifndef QUOTE_PARSER_H
+#define QUOTE_PARSER_H
+
+/*
+ * Zero-copy parsers for DCAP quotes: SGX quote v3 (sgx_quote3_t) and TDX
+ * quote v4.
+ *
+ * The layouts are types: every field is a quote_field<Offset, Size>. The
+ * static_asserts below check that the fields tile each structure exactly
+ * and that the totals match sgx_quote3_t and the TDX v4 quote. Accessors
+ * return pointers into the caller's buffer, so nothing is copied and the
+ * SGX SDK headers are not needed (the offline tools build without them).
+ *
+ *   header       48 bytes  version, attestation key type, TEE type, QE vendor, ...
+ *   report body  SGX: 384 bytes (sgx_report_body_t), TDX: 584 bytes (TD report)
+ *   u32          signature_data_len
+ *   signature    ECDSA signature, attestation key, QE report, certification data
+ *
+ * QuoteView<Layout>::parse() validates one quote. QuoteStream walks a log
+ * of quotes stored back to back. Each quote's length follows from its
+ * header and signature_data_len, so next() reads a few bytes per quote and
+ * skips the rest. That keeps a scan over an archive bound by memory
+ * bandwidth.
+ *
+ * All integers are little-endian.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define QUOTE_TEE_TYPE_SGX 0x00000000u
+#define QUOTE_TEE_TYPE_TDX 0x00000081u
+
+/* A field of Size bytes at Offset within its structure. */
+template <size_t Offset, size_t Size>
+struct quote_field {
+    static constexpr size_t offset = Offset;
+    static constexpr size_t size = Size;
+    static constexpr size_t end = Offset + Size;
+};
+
+/* Header shared by v3 and v4; tee_type is reserved (0) in v3. */
+struct quote_header_layout {
+    typedef quote_field<0, 2> version;
+    typedef quote_field<2, 2> att_key_type;
+    typedef quote_field<4, 4> tee_type;
+    typedef quote_field<8, 2> qe_svn;
+    typedef quote_field<10, 2> pce_svn;
+    typedef quote_field<12, 16> qe_vendor_id;
+    typedef quote_field<28, 20> user_data;
+    static constexpr size_t size = user_data::end;
+};
+
+/* sgx_report_body_t */
+struct sgx_report_body_layout {
+    typedef quote_field<0, 16> cpu_svn;
+    typedef quote_field<16, 4> misc_select;
+    typedef quote_field<20, 12> reserved1;
+    typedef quote_field<32, 16> isv_ext_prod_id;
+    typedef quote_field<48, 16> attributes;
+    typedef quote_field<64, 32> mr_enclave;
+    typedef quote_field<96, 32> reserved2;
+    typedef quote_field<128, 32> mr_signer;
+    typedef quote_field<160, 32> reserved3;
+    typedef quote_field<192, 64> config_id;
+    typedef quote_field<256, 2> isv_prod_id;
+    typedef quote_field<258, 2> isv_svn;
+    typedef quote_field<260, 2> config_svn;
+    typedef quote_field<262, 42> reserved4;
+    typedef quote_field<304, 16> isv_family_id;
+    typedef quote_field<320, 64> report_data;
+    static constexpr size_t size = report_data::end;
+};
+
+/* TD report body of a v4 quote (TDX 1.0) */
+struct td_report_body_layout {
+    typedef quote_field<0, 16> tee_tcb_svn;
+    typedef quote_field<16, 48> mr_seam;
+    typedef quote_field<64, 48> mr_signer_seam;
+    typedef quote_field<112, 8> seam_attributes;
+    typedef quote_field<120, 8> td_attributes;
+    typedef quote_field<128, 8> xfam;
+    typedef quote_field<136, 48> mr_td;
+    typedef quote_field<184, 48> mr_config_id;
+    typedef quote_field<232, 48> mr_owner;
+    typedef quote_field<280, 48> mr_owner_config;
+    typedef quote_field<328, 48> rtmr0;
+    typedef quote_field<376, 48> rtmr1;
+    typedef quote_field<424, 48> rtmr2;
+    typedef quote_field<472, 48> rtmr3;
+    typedef quote_field<520, 64> report_data;
+    static constexpr size_t size = report_data::end;
+};
+
+/* Start of sgx_ql_ecdsa_sig_data_t: signature, then the attestation public key */
+struct quote_ecdsa_sig_layout {
+    typedef quote_field<0, 64> signature;
+    typedef quote_field<64, 64> attest_pub_key;
+    static constexpr size_t size = attest_pub_key::end;
+};
+
+template <typename Body, uint16_t Version, uint32_t TeeType>
+struct quote_layout {
+    typedef Body body_layout;
+    static constexpr uint16_t version = Version;
+    static constexpr uint32_t tee_type = TeeType;
+    static constexpr size_t body_offset = quote_header_layout::size;
+    static constexpr size_t sig_len_offset = body_offset + Body::size;
+    static constexpr size_t fixed_size = sig_len_offset + 4;   /* sig data follows */
+};
+
+typedef quote_layout<sgx_report_body_layout, 3, QUOTE_TEE_TYPE_SGX> sgx_quote3_layout;
+typedef quote_layout<sgx_report_body_layout, 4, QUOTE_TEE_TYPE_SGX> sgx_quote4_layout;
+typedef quote_layout<td_report_body_layout, 4, QUOTE_TEE_TYPE_TDX> tdx_quote4_layout;
+
+static_assert(quote_header_layout::size == 48, "quote header is 48 bytes");
+static_assert(quote_header_layout::qe_svn::offset == quote_header_layout::tee_type::end &&
+              quote_header_layout::qe_vendor_id::offset == quote_header_layout::pce_svn::end,
+              "quote header fields must be contiguous");
+static_assert(sgx_report_body_layout::size == 384, "sgx_report_body_t is 384 bytes");
+static_assert(sgx_report_body_layout::reserved4::end == sgx_report_body_layout::isv_family_id::offset &&
+              sgx_report_body_layout::isv_family_id::end == sgx_report_body_layout::report_data::offset,
+              "SGX report body fields must be contiguous");
+static_assert(td_report_body_layout::size == 584, "TD report body is 584 bytes");
+static_assert(td_report_body_layout::rtmr3::end == td_report_body_layout::report_data::offset,
+              "TD report body fields must be contiguous");
+static_assert(sgx_quote3_layout::fixed_size == 436, "sizeof(sgx_quote3_t) is 436 bytes");
+static_assert(tdx_quote4_layout::fixed_size == 636, "TDX v4 quote fixed part is 636 bytes");
+
+enum quote_parse_status_t {
+    QUOTE_OK = 0,
+    QUOTE_TRUNCATED,        /* shorter than the fixed part or its signature data */
+    QUOTE_BAD_VERSION,
+    QUOTE_BAD_TEE_TYPE,
+    QUOTE_BAD_SIGNATURE     /* signature data too short for the ECDSA fields */
+};
+
+static inline const char* quote_status_str(quote_parse_status_t status) {
+    switch (status) {
+    case QUOTE_OK:            return "ok";
+    case QUOTE_TRUNCATED:     return "truncated quote";
+    case QUOTE_BAD_VERSION:   return "unsupported version";
+    case QUOTE_BAD_TEE_TYPE:  return "unsupported TEE type";
+    case QUOTE_BAD_SIGNATURE: return "bad signature data";
+    }
+    return "unknown";
+}
+
+static inline uint16_t quote_get_u16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t quote_get_u32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/* One quote in a caller-owned buffer; valid as long as the buffer is. */
+template <typename Layout>
+class QuoteView {
+public:
+    typedef typename Layout::body_layout body_layout;
+
+    QuoteView() : data_(NULL), size_(0) {
+    }
+
+    /*
+     * Checks version, TEE type and that the signature data fits in `len`.
+     * Bytes after the quote are ignored; size() is the quote's own length.
+     */
+    quote_parse_status_t parse(const uint8_t* data, size_t len) {
+        data_ = NULL;
+        size_ = 0;
+        if (len < Layout::fixed_size) {
+            return QUOTE_TRUNCATED;
+        }
+        if (quote_get_u16(data + quote_header_layout::version::offset) != Layout::version) {
+            return QUOTE_BAD_VERSION;
+        }
+        if (Layout::version >= 4 &&
+            quote_get_u32(data + quote_header_layout::tee_type::offset) != Layout::tee_type) {
+            return QUOTE_BAD_TEE_TYPE;
+        }
+        uint32_t sig_len = quote_get_u32(data + Layout::sig_len_offset);
+        if (sig_len > len - Layout::fixed_size) {
+            return QUOTE_TRUNCATED;
+        }
+        if (sig_len < quote_ecdsa_sig_layout::size) {
+            return QUOTE_BAD_SIGNATURE;
+        }
+        data_ = data;
+        size_ = Layout::fixed_size + sig_len;
+        return QUOTE_OK;
+    }
+
+    /* e.g. view.header<quote_header_layout::qe_vendor_id>() */
+    template <typename Field>
+    const uint8_t* header() const {
+        static_assert(Field::end <= quote_header_layout::size, "not a header field");
+        return data_ + Field::offset;
+    }
+
+    /* e.g. view.body<td_report_body_layout::mr_td>() */
+    template <typename Field>
+    const uint8_t* body() const {
+        static_assert(Field::end <= body_layout::size, "not a report body field");
+        return data_ + Layout::body_offset + Field::offset;
+    }
+
+    template <typename Field>
+    const uint8_t* signature() const {
+        static_assert(Field::end <= quote_ecdsa_sig_layout::size, "not an ECDSA field");
+        return signature_data() + Field::offset;
+    }
+
+    uint16_t version() const { return quote_get_u16(header<quote_header_layout::version>()); }
+    uint16_t att_key_type() const { return quote_get_u16(header<quote_header_layout::att_key_type>()); }
+    const uint8_t* report_data() const { return body<typename body_layout::report_data>(); }
+    uint32_t signature_data_len() const { return (uint32_t)(size_ - Layout::fixed_size); }
+    const uint8_t* signature_data() const { return data_ + Layout::fixed_size; }
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+};
+
+typedef QuoteView<sgx_quote3_layout> SgxQuote3View;
+typedef QuoteView<sgx_quote4_layout> SgxQuote4View;
+typedef QuoteView<tdx_quote4_layout> TdxQuote4View;
+
+enum quote_kind_t {
+    QUOTE_KIND_SGX_V3,
+    QUOTE_KIND_SGX_V4,
+    QUOTE_KIND_TDX_V4
+};
+
+/* One quote of a stream, already validated with the matching QuoteView. */
+typedef struct {
+    quote_kind_t kind;
+    size_t offset;          /* from the start of the stream */
+    const uint8_t* data;
+    size_t size;
+} quote_record_t;
+
+/*
+ * Iterates quotes stored back to back, e.g. quote files concatenated with
+ * cat, or an mmap()ed archive. next() stops at the first malformed quote and
+ * leaves status() and offset() pointing at it, since a log has no framing
+ * to resynchronise on.
+ */
+class QuoteStream {
+public:
+    QuoteStream(const uint8_t* data, size_t len)
+        : data_(data), len_(len), offset_(0), status_(QUOTE_OK) {
+    }
+
+    /* false at the end of the stream (status() QUOTE_OK) or on an error. */
+    bool next(quote_record_t* record) {
+        if (status_ != QUOTE_OK || offset_ == len_) {
+            return false;
+        }
+        const uint8_t* p = data_ + offset_;
+        size_t left = len_ - offset_;
+        if (left < quote_header_layout::size) {
+            status_ = QUOTE_TRUNCATED;
+            return false;
+        }
+
+        uint16_t version = quote_get_u16(p + quote_header_layout::version::offset);
+        uint32_t tee_type = quote_get_u32(p + quote_header_layout::tee_type::offset);
+        size_t size = 0;
+        if (version == 3) {
+            record->kind = QUOTE_KIND_SGX_V3;
+            status_ = parse_as<sgx_quote3_layout>(p, left, &size);
+        } else if (version == 4 && tee_type == QUOTE_TEE_TYPE_TDX) {
+            record->kind = QUOTE_KIND_TDX_V4;
+            status_ = parse_as<tdx_quote4_layout>(p, left, &size);
+        } else if (version == 4 && tee_type == QUOTE_TEE_TYPE_SGX) {
+            record->kind = QUOTE_KIND_SGX_V4;
+            status_ = parse_as<sgx_quote4_layout>(p, left, &size);
+        } else {
+            status_ = version == 4 ? QUOTE_BAD_TEE_TYPE : QUOTE_BAD_VERSION;
+        }
+        if (status_ != QUOTE_OK) {
+            return false;
+        }
+        record->offset = offset_;
+        record->data = p;
+        record->size = size;
+        offset_ += size;
+        return true;
+    }
+
+    quote_parse_status_t status() const { return status_; }
+    size_t offset() const { return offset_; }
+
+private:
+    template <typename Layout>
+    static quote_parse_status_t parse_as(const uint8_t* p, size_t left, size_t* size) {
+        QuoteView<Layout> view;
+        quote_parse_status_t status = view.parse(p, left);
+        *size = view.size();
+        return status;
+    }
+
+    const uint8_t* data_;
+    size_t len_;
+    size_t offset_;
+    quote_parse_status_t status_;
+};
+
+#endif /* QUOTE_PARSER_H */
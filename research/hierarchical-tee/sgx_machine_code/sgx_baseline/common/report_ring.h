@@ -0,0 +1,38 @@
+#ifndef REPORT_RING_H
+#define REPORT_RING_H
+
+#include <stdint.h>
+#include <sgx_report.h>
+
+/*
+ * Shared ring of EREPORT slots in untrusted memory, for
+ * ecall_generate_report_ring().
+ *
+ * The host registers the ring once with ecall_register_report_ring(),
+ * together with the QE target info, and passes only slot positions on
+ * each call. Both buffers are [user_check], so the bridge in Enclave_t.c
+ * neither allocates on the trusted heap nor copies the batch in and out.
+ * Instead the enclave checks each slot with sgx_is_outside_enclave(),
+ * copies its report_data in once and writes the report and status back
+ * once. It never reads a slot field twice, so a host that rewrites a slot
+ * mid-call can only change its own input.
+ *
+ * Slots are REPORT_RING_SLOT_SIZE bytes, so a page holds eight of them,
+ * and the ring must be REPORT_RING_ALIGN-aligned. Register again when the
+ * QE target info changes (AttestationContext generation). There is one
+ * ring per enclave; do not register while a ring call is running.
+ */
+
+#define REPORT_RING_SLOT_SIZE 512
+#define REPORT_RING_ALIGN 64
+#define REPORT_RING_SLOTS_MAX 4096
+
+typedef struct {
+    sgx_report_data_t report_data;   /* in: written by the host */
+    sgx_report_t report;             /* out */
+    int32_t status;                  /* out: 0, or the ecall error code for this slot */
+    uint8_t reserved[REPORT_RING_SLOT_SIZE - sizeof(sgx_report_data_t) - sizeof(sgx_report_t) -
+                     sizeof(int32_t)];
+} report_ring_slot_t;
+
+#endif /* REPORT_RING_H */
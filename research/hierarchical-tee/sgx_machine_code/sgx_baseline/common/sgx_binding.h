@@ -0,0 +1,28 @@
+#ifndef SGX_BINDING_H
+#define SGX_BINDING_H
+
+/*
+ * SGX -> TDX binding, computed inside the enclave (05-sgx-integration.md):
+ *
+ *   binding     = SHA256(MRENCLAVE || SGX_BINDING_PURPOSE || nonce)
+ *   report_data = binding (32) | nonce (32)
+ *
+ * MRENCLAVE is the enclave's own, from sgx_self_report(), so the untrusted
+ * side cannot bind a TDX token to a measurement it made up. The nonce is
+ * the caller's freshness value (timestamp, verifier challenge); carrying it
+ * in the second half of report_data lets a verifier recompute the binding
+ * from the quote alone. The TDX side puts `binding` into its report_data.
+ *
+ * Only macros, so the enclave (no libc++ headers) can include it too.
+ */
+
+#define SGX_BINDING_PURPOSE "hierarchical-tee-composition"
+#define SGX_BINDING_PURPOSE_LEN (sizeof(SGX_BINDING_PURPOSE) - 1)
+#define SGX_BINDING_MRENCLAVE_SIZE 32
+#define SGX_BINDING_NONCE_SIZE 32
+#define SGX_BINDING_SIZE 32
+#define SGX_BINDING_MESSAGE_SIZE \
+    (SGX_BINDING_MRENCLAVE_SIZE + SGX_BINDING_PURPOSE_LEN + SGX_BINDING_NONCE_SIZE)
+#define SGX_BINDING_NONCE_OFFSET 32  /* of the nonce within report_data */
+
+#endif /* SGX_BINDING_H */
@@ -0,0 +1,50 @@
+#ifndef SGX_SESSION_H
+#define SGX_SESSION_H
+
+/*
+ * Attested session set up by ecall_generate_composite_report().
+ *
+ * The enclave creates an ephemeral P-256 key pair and binds its public key
+ * into the binding report of sgx_binding.h through the nonce:
+ *
+ *   key_nonce   = SHA256(public_key || nonce)
+ *   report_data = SHA256(MRENCLAVE || purpose || key_nonce) | key_nonce
+ *
+ * so one quote vouches for the enclave, the TDX binding and the key. The
+ * private key leaves the enclave only sealed to MRENCLAVE, with a type tag,
+ * the public key and key_nonce as additional MAC text; the tag keeps the
+ * enclave from taking a sealed session key for a private key and back. The
+ * verifier answers with its own ephemeral public key and both ends derive
+ *
+ *   session_key = SHA256(ECDH x || SGX_SESSION_LABEL || key_nonce)
+ *
+ * after which requests are authenticated with HMAC-SHA256 under the session
+ * key instead of a new quote. Public keys use the SDK's sgx_ec256_public_t
+ * layout: x then y, each 32 bytes little-endian. The ECDH x coordinate is
+ * hashed big-endian, as OpenSSL returns it.
+ */
+
+#define SGX_SESSION_LABEL "hierarchical-tee-session"
+#define SGX_SESSION_LABEL_LEN (sizeof(SGX_SESSION_LABEL) - 1)
+#define SGX_SESSION_PUBLIC_KEY_SIZE 64
+#define SGX_SESSION_COORD_SIZE 32
+#define SGX_SESSION_KEY_SIZE 32
+#define SGX_SESSION_MAC_SIZE 32
+#define SGX_SESSION_SEALED_SIZE 1024  /* sealed private or session key plus its MAC text */
+
+/*
+ * Resumption: after a full attestation the verifier issues an opaque ticket
+ * (resumption_ticket.h) holding the session key. The enclave seals it with
+ * the session key; a reconnecting prover answers a fresh verifier challenge
+ * with
+ *
+ *   proof = HMAC-SHA256(session_key, SGX_RESUME_LABEL || challenge || ticket)
+ *
+ * and the verifier accepts it without a new quote or TDX token.
+ */
+#define SGX_RESUME_LABEL "hierarchical-tee-resume"
+#define SGX_RESUME_LABEL_LEN (sizeof(SGX_RESUME_LABEL) - 1)
+#define SGX_RESUME_CHALLENGE_SIZE 32
+#define SGX_RESUMPTION_TICKET_MAX 256
+
+#endif /* SGX_SESSION_H */
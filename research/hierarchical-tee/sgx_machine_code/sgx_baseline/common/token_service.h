@@ -0,0 +1,86 @@
+#ifndef TOKEN_SERVICE_H
+#define TOKEN_SERVICE_H
+
+/*
+ * Wire protocol of the TD token service (tdx_bench --serve): the SGX host
+ * sends a binding and the TD answers with a Trust Authority token over a
+ * TD quote whose report_data is binding | 32 zero bytes. That is the layout
+ * the verifier compares against the SGX quote's report_data.
+ *
+ *   request   magic "HTTQ" | u8 version | u8 reserved[3] | binding (32)
+ *   response  magic "HTTS" | u8 version | u8 status | u16 reserved |
+ *             u32 token length | token (JWT as returned by Trust Authority)
+ *
+ * all little-endian. Requests on one connection are answered in order. The
+ * service does not care where the binding came from, so the SGX host can
+ * send it before its enclave has produced a report. See the overlapped mode
+ * of quote_benchmark (--overlap).
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "composite_evidence.h"
+#include "sgx_binding.h"
+
+#define TOKEN_REQUEST_MAGIC "HTTQ"
+#define TOKEN_RESPONSE_MAGIC "HTTS"
+#define TOKEN_SERVICE_VERSION 1
+#define TOKEN_REQUEST_SIZE (8 + SGX_BINDING_SIZE)
+#define TOKEN_RESPONSE_HEADER_SIZE 12
+#define TOKEN_RESPONSE_MAX (64 * 1024)  /* ITA tokens are ~6 KB */
+
+enum token_status_t {
+    TOKEN_STATUS_OK = 0,
+    TOKEN_STATUS_BAD_REQUEST,
+    TOKEN_STATUS_QUOTE_FAILED,   /* TD quote from configfs-tsm */
+    TOKEN_STATUS_ITA_FAILED      /* Trust Authority attest */
+};
+
+static inline const char* token_status_str(uint32_t status) {
+    switch (status) {
+    case TOKEN_STATUS_OK:           return "ok";
+    case TOKEN_STATUS_BAD_REQUEST:  return "bad request";
+    case TOKEN_STATUS_QUOTE_FAILED: return "TD quote failed";
+    case TOKEN_STATUS_ITA_FAILED:   return "Trust Authority attest failed";
+    }
+    return "unknown";
+}
+
+static inline void token_request_encode(const uint8_t binding[SGX_BINDING_SIZE],
+                                        uint8_t out[TOKEN_REQUEST_SIZE]) {
+    memset(out, 0, TOKEN_REQUEST_SIZE);
+    memcpy(out, TOKEN_REQUEST_MAGIC, 4);
+    out[4] = TOKEN_SERVICE_VERSION;
+    memcpy(out + 8, binding, SGX_BINDING_SIZE);
+}
+
+static inline bool token_request_decode(const uint8_t in[TOKEN_REQUEST_SIZE],
+                                        uint8_t binding[SGX_BINDING_SIZE]) {
+    if (memcmp(in, TOKEN_REQUEST_MAGIC, 4) != 0 || in[4] != TOKEN_SERVICE_VERSION) {
+        return false;
+    }
+    memcpy(binding, in + 8, SGX_BINDING_SIZE);
+    return true;
+}
+
+static inline void token_response_encode(uint8_t status, uint32_t token_len,
+                                         uint8_t out[TOKEN_RESPONSE_HEADER_SIZE]) {
+    memcpy(out, TOKEN_RESPONSE_MAGIC, 4);
+    out[4] = TOKEN_SERVICE_VERSION;
+    out[5] = status;
+    composite_put_u16(out + 6, 0);
+    composite_put_u32(out + 8, token_len);
+}
+
+/* false on a bad header or a token longer than TOKEN_RESPONSE_MAX. */
+static inline bool token_response_decode(const uint8_t in[TOKEN_RESPONSE_HEADER_SIZE],
+                                         uint8_t* status, uint32_t* token_len) {
+    if (memcmp(in, TOKEN_RESPONSE_MAGIC, 4) != 0 || in[4] != TOKEN_SERVICE_VERSION) {
+        return false;
+    }
+    *status = in[5];
+    *token_len = composite_get_u32(in + 8);
+    return *token_len <= TOKEN_RESPONSE_MAX;
+}
+
+#endif /* TOKEN_SERVICE_H */
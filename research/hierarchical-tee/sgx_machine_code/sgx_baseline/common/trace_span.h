@@ -0,0 +1,246 @@
+#ifndef TRACE_SPAN_H
+#define TRACE_SPAN_H
+
+/*
+ * Cross-layer spans for composite attestations, joined by a trace ID that
+ * travels in the SGX binding nonce (sgx_binding.h):
+ *
+ *   nonce = trace ID (16) | "HTTR" (4) | random (12)
+ *
+ * The nonce is copied into the quote's report_data, so the TDX prover and
+ * the verifier read the trace ID from the quote itself. Nothing has to
+ * travel alongside the evidence. The marker stops an untraced nonce (a
+ * timestamp, a verifier challenge) from being read as a trace ID. The
+ * trace ID is random, so the nonce is still fresh.
+ *
+ * Each process records its own spans with CLOCK_REALTIME timestamps and
+ * writes them to one file. trace_critical_path.py merges the files from
+ * every machine by trace ID. Gaps between machines are only as accurate as
+ * the hosts' clock sync (chrony, PTP). A process's top-level spans take
+ * trace_root_span_id() as their parent. That is the span ID of the whole
+ * attestation, which no single process records.
+ *
+ * write() picks the format from the file name:
+ *
+ *   *.otlp.json  OTLP/JSON, one resourceSpans entry per file, IDs in hex
+ *   otherwise    Chrome trace event format (chrome://tracing, Perfetto)
+ *
+ * TraceRecorder is thread-safe. record() takes a mutex: cheap enough for a
+ * handful of spans per request, too slow for per-packet tracing.
+ */
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "sgx_binding.h"
+
+#define TRACE_ID_SIZE 16
+#define TRACE_NONCE_MARKER "HTTR"
+#define TRACE_NONCE_MARKER_SIZE 4
+#define TRACE_MAX_SPANS (1u << 20)   /* per recorder; further spans are counted, not kept */
+#define TRACE_OTLP_SUFFIX ".otlp.json"
+
+typedef struct {
+    uint8_t bytes[TRACE_ID_SIZE];
+} trace_id_t;
+
+typedef struct {
+    trace_id_t trace_id;
+    uint64_t span_id;
+    uint64_t parent_id;
+    const char* name;   /* string literal */
+    int64_t start_ns;   /* CLOCK_REALTIME */
+    int64_t end_ns;
+    uint32_t thread;
+} trace_span_t;
+
+static inline int64_t trace_now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static inline bool trace_random(uint8_t* out, size_t len) {
+    int fd = open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    size_t got = 0;
+    while (got < len) {
+        ssize_t n = read(fd, out + got, len - got);
+        if (n <= 0) {
+            break;
+        }
+        got += (size_t)n;
+    }
+    close(fd);
+    return got == len;
+}
+
+/* A fresh trace ID and the binding nonce that carries it. */
+static inline bool trace_new_nonce(trace_id_t* id, uint8_t nonce[SGX_BINDING_NONCE_SIZE]) {
+    if (!trace_random(nonce, SGX_BINDING_NONCE_SIZE)) {
+        return false;
+    }
+    memcpy(nonce + TRACE_ID_SIZE, TRACE_NONCE_MARKER, TRACE_NONCE_MARKER_SIZE);
+    memcpy(id->bytes, nonce, TRACE_ID_SIZE);
+    return true;
+}
+
+/* false if the nonce was not made by trace_new_nonce(). */
+static inline bool trace_id_from_nonce(const uint8_t* nonce, trace_id_t* id) {
+    if (memcmp(nonce + TRACE_ID_SIZE, TRACE_NONCE_MARKER, TRACE_NONCE_MARKER_SIZE) != 0) {
+        return false;
+    }
+    memcpy(id->bytes, nonce, TRACE_ID_SIZE);
+    return true;
+}
+
+/* report_data = binding | nonce, as every layer sees it in the SGX quote. */
+static inline bool trace_id_from_report_data(const uint8_t* report_data, trace_id_t* id) {
+    return trace_id_from_nonce(report_data + SGX_BINDING_NONCE_OFFSET, id);
+}
+
+/* Same value in every process, so their top-level spans share a parent. */
+static inline uint64_t trace_root_span_id(const trace_id_t& id) {
+    uint64_t root = 0;
+    for (int i = 0; i < 8; i++) {
+        root = root << 8 | id.bytes[i];
+    }
+    return root | 1;
+}
+
+static inline void trace_id_hex(const trace_id_t& id, char out[2 * TRACE_ID_SIZE + 1]) {
+    for (int i = 0; i < TRACE_ID_SIZE; i++) {
+        snprintf(out + 2 * i, 3, "%02x", id.bytes[i]);
+    }
+}
+
+class TraceRecorder {
+public:
+    /* `service` names this process in the exported trace (e.g. "sgx-prover"). */
+    explicit TraceRecorder(const char* service)
+        : service_(service), next_id_(0), dropped_(0) {
+        // Random base: span IDs from different processes must not collide
+        if (!trace_random((uint8_t*)&next_id_, sizeof(next_id_))) {
+            next_id_ = (uint64_t)trace_now_ns() ^ ((uint64_t)getpid() << 32);
+        }
+    }
+
+    /* Returns the span's ID, to parent child spans on; 0 if the recorder is full. */
+    uint64_t record(const trace_id_t& trace, uint64_t parent, const char* name,
+                    int64_t start_ns, int64_t end_ns) {
+        trace_span_t span;
+        span.trace_id = trace;
+        span.parent_id = parent;
+        span.name = name;
+        span.start_ns = start_ns;
+        span.end_ns = end_ns;
+        span.thread = (uint32_t)syscall(SYS_gettid);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (spans_.size() >= TRACE_MAX_SPANS) {
+            dropped_++;
+            return 0;
+        }
+        span.span_id = ++next_id_ ? next_id_ : ++next_id_;
+        spans_.push_back(span);
+        return span.span_id;
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return spans_.size();
+    }
+
+    uint64_t dropped() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return dropped_;
+    }
+
+    bool write(const char* path) const {
+        FILE* f = fopen(path, "w");
+        if (!f) {
+            return false;
+        }
+        size_t len = strlen(path);
+        size_t suffix = strlen(TRACE_OTLP_SUFFIX);
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (len >= suffix && strcmp(path + len - suffix, TRACE_OTLP_SUFFIX) == 0) {
+            write_otlp(f);
+        } else {
+            write_chrome(f);
+        }
+        return fclose(f) == 0;
+    }
+
+private:
+    TraceRecorder(const TraceRecorder&);
+    TraceRecorder& operator=(const TraceRecorder&);
+
+    /* Microseconds with the nanoseconds kept: a double loses them at epoch scale. */
+    static void write_micros(FILE* f, int64_t ns) {
+        // A wall-clock step can end a span before it starts
+        uint64_t magnitude = ns < 0 ? (uint64_t)-ns : (uint64_t)ns;
+        fprintf(f, "%s%llu.%03llu", ns < 0 ? "-" : "", (unsigned long long)(magnitude / 1000),
+                (unsigned long long)(magnitude % 1000));
+    }
+
+    void write_chrome(FILE* f) const {
+        int pid = (int)getpid();
+        fprintf(f, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+        fprintf(f, "  {\"name\": \"process_name\", \"ph\": \"M\", \"pid\": %d, \"tid\": 0, "
+                   "\"args\": {\"name\": \"%s\"}}", pid, service_.c_str());
+        for (size_t i = 0; i < spans_.size(); i++) {
+            const trace_span_t& s = spans_[i];
+            char trace[2 * TRACE_ID_SIZE + 1];
+            trace_id_hex(s.trace_id, trace);
+            fprintf(f, ",\n  {\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"X\", \"ts\": ",
+                    s.name, service_.c_str());
+            write_micros(f, s.start_ns);
+            fprintf(f, ", \"dur\": ");
+            write_micros(f, s.end_ns - s.start_ns);
+            fprintf(f, ", \"pid\": %d, \"tid\": %u, \"args\": {\"trace_id\": \"%s\", "
+                       "\"span_id\": \"%016llx\", \"parent_id\": \"%016llx\"}}",
+                    pid, s.thread, trace, (unsigned long long)s.span_id,
+                    (unsigned long long)s.parent_id);
+        }
+        fprintf(f, "\n]}\n");
+    }
+
+    void write_otlp(FILE* f) const {
+        fprintf(f, "{\"resourceSpans\": [{\n"
+                   "  \"resource\": {\"attributes\": [{\"key\": \"service.name\", "
+                   "\"value\": {\"stringValue\": \"%s\"}}]},\n"
+                   "  \"scopeSpans\": [{\"scope\": {\"name\": \"hierarchical-tee\"}, \"spans\": [",
+                service_.c_str());
+        for (size_t i = 0; i < spans_.size(); i++) {
+            const trace_span_t& s = spans_[i];
+            char trace[2 * TRACE_ID_SIZE + 1];
+            trace_id_hex(s.trace_id, trace);
+            fprintf(f, "%s\n    {\"traceId\": \"%s\", \"spanId\": \"%016llx\", "
+                       "\"parentSpanId\": \"%016llx\", \"name\": \"%s\", \"kind\": 1, "
+                       "\"startTimeUnixNano\": \"%lld\", \"endTimeUnixNano\": \"%lld\", "
+                       "\"attributes\": [{\"key\": \"thread.id\", \"value\": {\"intValue\": \"%u\"}}]}",
+                    i ? "," : "", trace, (unsigned long long)s.span_id,
+                    (unsigned long long)s.parent_id, s.name, (long long)s.start_ns,
+                    (long long)s.end_ns, s.thread);
+        }
+        fprintf(f, "\n  ]}]\n}]}\n");
+    }
+
+    std::string service_;
+    mutable std::mutex mutex_;
+    std::vector<trace_span_t> spans_;
+    uint64_t next_id_;
+    uint64_t dropped_;
+};
+
+#endif /* TRACE_SPAN_H */
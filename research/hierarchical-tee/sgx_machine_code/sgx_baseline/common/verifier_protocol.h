@@ -0,0 +1,108 @@
+#ifndef VERIFIER_PROTOCOL_H
+#define VERIFIER_PROTOCOL_H
+
+/*
+ * Wire protocol of the native verifier daemon (sgx-layer/verifier_daemon).
+ *
+ * A prover keeps one TCP connection open and writes composite evidence
+ * frames (composite_evidence.h) back to back without waiting for replies.
+ * The verifier answers every frame, in order, with one fixed-size verdict:
+ *
+ *   magic "HTER" | u8 version | u8 verdict | u16 checks passed |
+ *   u32 sequence (0-based frame index on this connection) | u32 error
+ *
+ * all little-endian. A frame whose header cannot be parsed gets a verdict
+ * with VERIFY_ERROR_FRAME and the connection is closed, since the byte
+ * stream can no longer be re-synchronised.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "composite_evidence.h"
+
+#define VERDICT_MAGIC "HTER"
+#define VERDICT_VERSION 1
+#define VERDICT_SIZE 16
+
+#define VERIFY_CHECK_FRAME     0x0001  /* frame parsed, all sections present */
+#define VERIFY_CHECK_SGX_QUOTE 0x0002  /* DCAP quote verification accepted */
+#define VERIFY_CHECK_TDX_TOKEN 0x0004  /* issuer, expiry and TDX claims */
+#define VERIFY_CHECK_BINDING   0x0008  /* both report_data carry the binding hash */
+#define VERIFY_CHECK_POLICY    0x0010  /* measurement, debug and TCB status policy */
+#define VERIFY_CHECK_ALL       0x001f
+
+enum verdict_t {
+    VERDICT_UNTRUSTED = 0,
+    VERDICT_TRUSTED = 1
+};
+
+/* First check that failed; VERIFY_ERROR_NONE iff the verdict is TRUSTED. */
+enum verify_error_t {
+    VERIFY_ERROR_NONE = 0,
+    VERIFY_ERROR_FRAME,
+    VERIFY_ERROR_SGX_QUOTE_FORMAT,
+    VERIFY_ERROR_SGX_QUOTE_VERIFY,   /* sgx_qv_verify_quote() call failed */
+    VERIFY_ERROR_SGX_QUOTE_RESULT,   /* verified, but the TCB result is not accepted */
+    VERIFY_ERROR_TOKEN_FORMAT,
+    VERIFY_ERROR_TOKEN_ISSUER,
+    VERIFY_ERROR_TOKEN_EXPIRED,
+    VERIFY_ERROR_TOKEN_NO_TDX,
+    VERIFY_ERROR_BINDING,
+    VERIFY_ERROR_POLICY_MRTD,
+    VERIFY_ERROR_POLICY_DEBUG,
+    VERIFY_ERROR_POLICY_TCB,
+    VERIFY_ERROR_TOKEN_SIGNATURE,    /* not signed by a configured ITA key */
+    VERIFY_ERROR_POLICY_SGX,         /* MRENCLAVE, MRSIGNER or ISVSVN */
+    VERIFY_ERROR_POLICY_RTMR
+};
+
+typedef struct {
+    uint8_t verdict;
+    uint16_t checks;
+    uint32_t sequence;
+    uint32_t error;
+} verdict_record_t;
+
+static inline const char* verify_error_str(uint32_t error) {
+    switch (error) {
+    case VERIFY_ERROR_NONE:              return "none";
+    case VERIFY_ERROR_FRAME:             return "malformed frame";
+    case VERIFY_ERROR_SGX_QUOTE_FORMAT:  return "malformed SGX quote";
+    case VERIFY_ERROR_SGX_QUOTE_VERIFY:  return "SGX quote verification failed";
+    case VERIFY_ERROR_SGX_QUOTE_RESULT:  return "SGX TCB status not accepted";
+    case VERIFY_ERROR_TOKEN_FORMAT:      return "malformed TDX token";
+    case VERIFY_ERROR_TOKEN_ISSUER:      return "invalid token issuer";
+    case VERIFY_ERROR_TOKEN_EXPIRED:     return "token expired";
+    case VERIFY_ERROR_TOKEN_NO_TDX:      return "no TDX claims in token";
+    case VERIFY_ERROR_BINDING:           return "binding mismatch";
+    case VERIFY_ERROR_POLICY_MRTD:       return "MRTD not in trusted list";
+    case VERIFY_ERROR_POLICY_DEBUG:      return "TD is debuggable";
+    case VERIFY_ERROR_POLICY_TCB:        return "TDX TCB status not accepted";
+    case VERIFY_ERROR_TOKEN_SIGNATURE:   return "invalid token signature";
+    case VERIFY_ERROR_POLICY_SGX:        return "enclave identity not allowed by policy";
+    case VERIFY_ERROR_POLICY_RTMR:       return "RTMR not allowed by policy";
+    }
+    return "unknown";
+}
+
+static inline void verdict_encode(const verdict_record_t* record, uint8_t out[VERDICT_SIZE]) {
+    memcpy(out, VERDICT_MAGIC, 4);
+    out[4] = VERDICT_VERSION;
+    out[5] = record->verdict;
+    composite_put_u16(out + 6, record->checks);
+    composite_put_u32(out + 8, record->sequence);
+    composite_put_u32(out + 12, record->error);
+}
+
+static inline bool verdict_decode(const uint8_t in[VERDICT_SIZE], verdict_record_t* record) {
+    if (memcmp(in, VERDICT_MAGIC, 4) != 0 || in[4] != VERDICT_VERSION) {
+        return false;
+    }
+    record->verdict = in[5];
+    record->checks = composite_get_u16(in + 6);
+    record->sequence = composite_get_u32(in + 8);
+    record->error = composite_get_u32(in + 12);
+    return true;
+}
+
+#endif /* VERIFIER_PROTOCOL_H */
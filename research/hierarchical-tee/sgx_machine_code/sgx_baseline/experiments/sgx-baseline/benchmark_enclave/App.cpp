@@ -1,34 +1,54 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
 #include <sgx_urts.h>
 #include <sgx_uae_service.h>
-#include <sys/time.h>
 #include "Enclave_u.h"
+#include "bench_clock.h"
+#include "bench_report.h"
+#include "enclave_pool.h"
+#include "epc_telemetry.h"
+#include "latency_histogram.h"
 
 #define ENCLAVE_FILE "enclave.signed.so"
+#define EDMM_ENCLAVE_FILE "enclave.edmm.signed.so"  /* make EDMM=1 */
 #define MAX_ITERATIONS 1000
+#define MAX_POOL_SIZE 16
+#define COLD_REQUESTS_MAX 20  /* every cold request loads a whole enclave */
+#define MAX_TELEMETRY_SECONDS 3600
+#define TELEMETRY_WINDOW_MS 1000.0
+#define LAYOUT_COLD_STARTS 10
+#define LAYOUT_BURSTS 20
+#define LAYOUT_BURST_BYTES (512 * 1024)  /* fits the 1 MB heap of the static image */
+#define LAYOUT_TCS_PROBE 10              /* TCSNum of the static image, TCSMaxNum of EDMM */
+#define LAYOUT_TCS_PROBE_MS 500          /* time for EDMM to add TCSs under the probe */
 
-// Get current time in milliseconds
+// Get current time in milliseconds (monotonic, see bench_clock.h)
 double get_time_ms() {
-    struct timeval tv;
-    gettimeofday(&tv, NULL);
-    return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+    return bench_now_ms();
 }
 
 // Benchmark EREPORT generation
-void benchmark_ereport_generation(sgx_enclave_id_t eid, int iterations) {
+void benchmark_ereport_generation(sgx_enclave_id_t eid, BenchReport* report_out, int iterations) {
     printf("\n[1/3] Benchmarking EREPORT Generation (%d iterations)...\n", iterations);
     
     uint8_t report[sizeof(sgx_report_t)];
     uint8_t custom_data[64] = {0};
     snprintf((char*)custom_data, 64, "Benchmark-Data-%d", iterations);
     
+    LatencyHistogram ereport_hist;
+    std::vector<double> samples;
+    samples.reserve(iterations);
     double start = get_time_ms();
     
     int successful = 0;
     for (int i = 0; i < iterations; i++) {
         int enclave_ret;
+        double call_start = get_time_ms();
         sgx_status_t ret = ecall_generate_report(
             eid, 
             &enclave_ret,
@@ -36,9 +56,12 @@ void benchmark_ereport_generation(sgx_enclave_id_t eid, int iterations) {
             sizeof(report),
             custom_data
         );
+        double call_end = get_time_ms();
         
         if (ret == SGX_SUCCESS && enclave_ret == 0) {
             successful++;
+            ereport_hist.record_ms(call_end - call_start);
+            samples.push_back(call_end - call_start);
         }
     }
     
@@ -50,23 +73,35 @@ void benchmark_ereport_generation(sgx_enclave_id_t eid, int iterations) {
     printf("  Average per EREPORT: %.3f ms\n", avg);
     printf("  Successful: %d/%d\n", successful, iterations);
     printf("  Throughput: %.2f reports/sec\n", 1000.0 / avg);
+    print_latency_header();
+    print_latency_row("EREPORT", ereport_hist);
+    
+    report_out->add_latency("SGX EREPORT Generation", samples, iterations);
+    report_out->add_field("throughput_per_sec", 1000.0 / avg);
 }
 
 // Benchmark quote preparation
-void benchmark_quote_preparation(sgx_enclave_id_t eid, int iterations) {
+void benchmark_quote_preparation(sgx_enclave_id_t eid, BenchReport* report_out, int iterations) {
     printf("\n[2/3] Benchmarking Quote Preparation (%d iterations)...\n", iterations);
     
     uint8_t report_data[64];
     
+    LatencyHistogram prepare_hist;
+    std::vector<double> samples;
+    samples.reserve(iterations);
     double start = get_time_ms();
     
     int successful = 0;
     for (int i = 0; i < iterations; i++) {
         int enclave_ret;
+        double call_start = get_time_ms();
         sgx_status_t ret = ecall_prepare_quote_data(eid, &enclave_ret, report_data);
+        double call_end = get_time_ms();
         
         if (ret == SGX_SUCCESS && enclave_ret == 0) {
             successful++;
+            prepare_hist.record_ms(call_end - call_start);
+            samples.push_back(call_end - call_start);
         }
     }
     
@@ -77,10 +112,14 @@ void benchmark_quote_preparation(sgx_enclave_id_t eid, int iterations) {
     printf("  Total time: %.2f ms\n", elapsed);
     printf("  Average per preparation: %.3f ms\n", avg);
     printf("  Successful: %d/%d\n", successful, iterations);
+    print_latency_header();
+    print_latency_row("Quote preparation", prepare_hist);
+    
+    report_out->add_latency("SGX Quote Preparation", samples, iterations);
 }
 
 // Measure enclave creation overhead
-void measure_enclave_creation(int iterations) {
+void measure_enclave_creation(BenchReport* report_out, int iterations) {
     printf("\n[3/3] Measuring Enclave Creation Overhead (%d iterations)...\n", iterations);
     
     sgx_launch_token_t token = {0};
@@ -88,6 +127,10 @@ void measure_enclave_creation(int iterations) {
     
     double total_create = 0.0;
     double total_destroy = 0.0;
+    LatencyHistogram create_hist;
+    LatencyHistogram destroy_hist;
+    std::vector<double> create_samples;
+    std::vector<double> destroy_samples;
     
     for (int i = 0; i < iterations; i++) {
         sgx_enclave_id_t eid = 0;
@@ -110,6 +153,8 @@ void measure_enclave_creation(int iterations) {
         }
         
         total_create += (end_create - start_create);
+        create_hist.record_ms(end_create - start_create);
+        create_samples.push_back(end_create - start_create);
         
         // Measure destruction
         double start_destroy = get_time_ms();
@@ -117,6 +162,8 @@ void measure_enclave_creation(int iterations) {
         double end_destroy = get_time_ms();
         
         total_destroy += (end_destroy - start_destroy);
+        destroy_hist.record_ms(end_destroy - start_destroy);
+        destroy_samples.push_back(end_destroy - start_destroy);
     }
     
     double avg_create = total_create / iterations;
@@ -125,6 +172,433 @@ void measure_enclave_creation(int iterations) {
     printf("  Average creation time: %.3f ms\n", avg_create);
     printf("  Average destruction time: %.3f ms\n", avg_destroy);
     printf("  Total enclave overhead: %.3f ms\n", avg_create + avg_destroy);
+    print_latency_header();
+    print_latency_row("Enclave creation", create_hist);
+    print_latency_row("Enclave destruction", destroy_hist);
+    
+    report_out->add_latency("SGX Enclave Creation", create_samples, iterations);
+    report_out->add_latency("SGX Enclave Destruction", destroy_samples, iterations);
+}
+
+// One attestation request: a single EREPORT on a loaded enclave
+static sgx_status_t request_ereport(sgx_enclave_id_t eid, int request_id) {
+    uint8_t report[sizeof(sgx_report_t)];
+    uint8_t custom_data[64] = {0};
+    snprintf((char*)custom_data, 64, "Request-%d", request_id);
+    
+    int enclave_ret = 0;
+    sgx_status_t ret = ecall_generate_report(eid, &enclave_ret, report, sizeof(report),
+                                             custom_data);
+    if (ret == SGX_SUCCESS && enclave_ret != 0) {
+        return SGX_ERROR_UNEXPECTED;
+    }
+    return ret;
+}
+
+typedef struct {
+    int successful;
+    LatencyHistogram latency_hist;
+    std::vector<double> samples;
+} pool_worker_stats_t;
+
+static void pool_worker(EnclavePool* pool, int worker_id, int requests,
+                        pool_worker_stats_t* stats) {
+    stats->samples.reserve(requests);
+    for (int i = 0; i < requests; i++) {
+        int request_id = worker_id * requests + i;
+        double start = get_time_ms();
+        sgx_status_t ret = pool->call([request_id](sgx_enclave_id_t eid) {
+            return request_ereport(eid, request_id);
+        });
+        double latency = get_time_ms() - start;
+        if (ret == SGX_SUCCESS) {
+            stats->successful++;
+            stats->latency_hist.record_ms(latency);
+            stats->samples.push_back(latency);
+        }
+    }
+}
+
+// Request latency with enclave creation on the request path vs. a warm pool
+void benchmark_enclave_pool(BenchReport* report_out, int pool_size, int requests) {
+    printf("\n[+] Benchmarking Enclave Pool (%d instances, %d requests)...\n",
+           pool_size, requests);
+    
+    // Without the pool every request loads, uses and tears down an enclave
+    int cold_requests = requests < COLD_REQUESTS_MAX ? requests : COLD_REQUESTS_MAX;
+    LatencyHistogram cold_hist;
+    std::vector<double> cold_samples;
+    for (int i = 0; i < cold_requests; i++) {
+        sgx_launch_token_t token = {0};
+        int updated = 0;
+        sgx_enclave_id_t eid = 0;
+        
+        double start = get_time_ms();
+        sgx_status_t ret = sgx_create_enclave(ENCLAVE_FILE, SGX_DEBUG_FLAG,
+                                              &token, &updated, &eid, NULL);
+        if (ret == SGX_SUCCESS) {
+            ret = request_ereport(eid, i);
+            sgx_destroy_enclave(eid);
+        }
+        double latency = get_time_ms() - start;
+        if (ret == SGX_SUCCESS) {
+            cold_hist.record_ms(latency);
+            cold_samples.push_back(latency);
+        }
+    }
+    
+    EnclavePool pool;
+    sgx_status_t ret = pool.init(ENCLAVE_FILE, pool_size);
+    if (ret != SGX_SUCCESS) {
+        printf("  ✗ Failed to preload enclave pool: 0x%x\n", ret);
+        return;
+    }
+    printf("  ✓ Preloaded %zu enclaves in %.3f ms\n", pool.size(), pool.init_ms());
+    
+    // With the pool: one worker per instance, each request leases an enclave
+    std::vector<std::thread> workers;
+    std::vector<pool_worker_stats_t> stats(pool_size);
+    int per_worker = (requests + pool_size - 1) / pool_size;
+    double start = get_time_ms();
+    for (int t = 0; t < pool_size; t++) {
+        workers.push_back(std::thread(pool_worker, &pool, t, per_worker, &stats[t]));
+    }
+    for (size_t t = 0; t < workers.size(); t++) {
+        workers[t].join();
+    }
+    double wall_time = get_time_ms() - start;
+    
+    int pooled_successful = 0;
+    LatencyHistogram pooled_hist;
+    std::vector<double> pooled_samples;
+    for (int t = 0; t < pool_size; t++) {
+        pooled_successful += stats[t].successful;
+        pooled_hist.merge(stats[t].latency_hist);
+        pooled_samples.insert(pooled_samples.end(),
+                              stats[t].samples.begin(), stats[t].samples.end());
+    }
+    
+    printf("  Cold requests:   %d/%d successful\n", (int)cold_samples.size(), cold_requests);
+    printf("  Pooled requests: %d/%d successful (%.1f requests/sec)\n",
+           pooled_successful, per_worker * pool_size,
+           pooled_successful * 1000.0 / wall_time);
+    printf("  Enclaves recreated after SGX_ERROR_ENCLAVE_LOST: %lu\n",
+           (unsigned long)pool.recreate_count());
+    print_latency_header();
+    print_latency_row("No pool (create)", cold_hist);
+    print_latency_row("Warm pool", pooled_hist);
+    if (pooled_hist.count() > 0 && cold_hist.count() > 0) {
+        printf("  Pool speedup (p50): %.1fx\n",
+               cold_hist.percentile_ms(50.0) / pooled_hist.percentile_ms(50.0));
+    }
+    
+    report_out->add_latency("SGX Request without Enclave Pool", cold_samples, cold_requests);
+    report_out->add_latency("SGX Request with Enclave Pool", pooled_samples,
+                            per_worker * pool_size);
+    report_out->add_field("pool_size", pool_size);
+    report_out->add_field("pool_init_ms", pool.init_ms());
+    report_out->add_field("requests_per_sec", pooled_successful * 1000.0 / wall_time);
+    report_out->add_field("enclaves_recreated", (double)pool.recreate_count());
+}
+
+typedef struct {
+    LatencyHistogram cold_hist;     // create + first EREPORT
+    LatencyHistogram burst_hist;
+    std::vector<double> cold_samples;
+    double steady_per_sec;          // EREPORTs/sec after the bursts
+    int trimmed_bursts;
+    int bursts;
+    int tcs_available;              // concurrent ECALLs the loaded image served
+} layout_stats_t;
+
+static void hold_tcs_worker(sgx_enclave_id_t eid, int* entered, int* release) {
+    // Out of TCS: retry while the probe lasts, EDMM may add one meanwhile
+    while (__atomic_load_n(release, __ATOMIC_ACQUIRE) == 0) {
+        int enclave_ret = 0;
+        if (ecall_hold_tcs(eid, &enclave_ret, entered, release) != SGX_ERROR_OUT_OF_TCS) {
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+// How many TCSs the image gives LAYOUT_TCS_PROBE concurrent ECALLs: TCSNum on
+// a static layout or an SGX1 host, up to TCSMaxNum where EDMM adds them
+static int probe_tcs(sgx_enclave_id_t eid) {
+    int entered = 0;
+    int release = 0;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < LAYOUT_TCS_PROBE; t++) {
+        threads.push_back(std::thread(hold_tcs_worker, eid, &entered, &release));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(LAYOUT_TCS_PROBE_MS));
+    int available = __atomic_load_n(&entered, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&release, 1, __ATOMIC_RELEASE);
+    for (size_t t = 0; t < threads.size(); t++) {
+        threads[t].join();
+    }
+    return available;
+}
+
+// Cold start, request bursts and steady-state EREPORT throughput of one image
+static bool measure_layout(const char* enclave_file, int iterations, layout_stats_t* stats) {
+    for (int i = 0; i < LAYOUT_COLD_STARTS; i++) {
+        sgx_launch_token_t token = {0};
+        int updated = 0;
+        sgx_enclave_id_t eid = 0;
+        
+        double start = get_time_ms();
+        sgx_status_t ret = sgx_create_enclave(enclave_file, SGX_DEBUG_FLAG,
+                                              &token, &updated, &eid, NULL);
+        if (ret != SGX_SUCCESS) {
+            printf("  ✗ Failed to create %s: 0x%x\n", enclave_file, ret);
+            return false;
+        }
+        ret = request_ereport(eid, i);
+        double latency = get_time_ms() - start;
+        sgx_destroy_enclave(eid);
+        if (ret == SGX_SUCCESS) {
+            stats->cold_hist.record_ms(latency);
+            stats->cold_samples.push_back(latency);
+        }
+    }
+    
+    sgx_launch_token_t token = {0};
+    int updated = 0;
+    sgx_enclave_id_t eid = 0;
+    if (sgx_create_enclave(enclave_file, SGX_DEBUG_FLAG, &token, &updated, &eid, NULL) != SGX_SUCCESS) {
+        return false;
+    }
+    
+    // Each burst grows the heap (or commits user-region pages) and releases them
+    stats->bursts = 0;
+    stats->trimmed_bursts = 0;
+    for (int i = 0; i < LAYOUT_BURSTS; i++) {
+        int enclave_ret = 0;
+        int trimmed = 0;
+        double start = get_time_ms();
+        sgx_status_t ret = ecall_burst(eid, &enclave_ret, LAYOUT_BURST_BYTES, &trimmed);
+        double latency = get_time_ms() - start;
+        if (ret == SGX_SUCCESS && enclave_ret == 0) {
+            stats->bursts++;
+            stats->trimmed_bursts += trimmed;
+            stats->burst_hist.record_ms(latency);
+        }
+    }
+    
+    int successful = 0;
+    double start = get_time_ms();
+    for (int i = 0; i < iterations; i++) {
+        if (request_ereport(eid, i) == SGX_SUCCESS) {
+            successful++;
+        }
+    }
+    double elapsed = get_time_ms() - start;
+    stats->steady_per_sec = elapsed > 0 ? successful * 1000.0 / elapsed : 0;
+    stats->tcs_available = probe_tcs(eid);
+    sgx_destroy_enclave(eid);
+    return true;
+}
+
+static void report_layout(BenchReport* report_out, const char* operation,
+                          const layout_stats_t& stats) {
+    report_out->add_latency(operation, stats.cold_samples, LAYOUT_COLD_STARTS);
+    report_out->add_field("steady_reports_per_sec", stats.steady_per_sec);
+    report_out->add_field("burst_p50_ms", stats.burst_hist.percentile_ms(50.0));
+    report_out->add_field("burst_bytes", LAYOUT_BURST_BYTES);
+    report_out->add_field("trimmed_bursts", stats.trimmed_bursts);
+    report_out->add_field("tcs_available", stats.tcs_available);
+}
+
+// Static layout (everything EADDed at load) vs. the EDMM image that commits a
+// minimal heap/stack/TCS pool and grows on demand
+void benchmark_edmm_layout(BenchReport* report_out, int iterations) {
+    printf("\n[+] Benchmarking EDMM Lazy Commit vs. Static Layout (%d cold starts, %d bursts)...\n",
+           LAYOUT_COLD_STARTS, LAYOUT_BURSTS);
+    
+    layout_stats_t static_stats;
+    layout_stats_t edmm_stats;
+    if (!measure_layout(ENCLAVE_FILE, iterations, &static_stats)) {
+        return;
+    }
+    if (!measure_layout(EDMM_ENCLAVE_FILE, iterations, &edmm_stats)) {
+        printf("  Build the EDMM image with: make EDMM=1\n");
+        return;
+    }
+    
+    printf("  Steady state: static %.1f reports/sec, EDMM %.1f reports/sec\n",
+           static_stats.steady_per_sec, edmm_stats.steady_per_sec);
+    printf("  Bursts trimmed via sgx_mm_dealloc: %d/%d\n",
+           edmm_stats.trimmed_bursts, edmm_stats.bursts);
+    printf("  TCSs serving %d concurrent ECALLs: static %d, EDMM %d\n",
+           LAYOUT_TCS_PROBE, static_stats.tcs_available, edmm_stats.tcs_available);
+    if (edmm_stats.trimmed_bursts == 0) {
+        printf("  ⚠ No EDMM trimming: SGX1 host, or SDK/driver without EDMM; the EDMM image\n"
+               "    then commits HeapInitSize at load but keeps only its %d loaded TCSs\n",
+               edmm_stats.tcs_available);
+    }
+    print_latency_header();
+    print_latency_row("Static cold start", static_stats.cold_hist);
+    print_latency_row("EDMM cold start", edmm_stats.cold_hist);
+    print_latency_row("Static burst", static_stats.burst_hist);
+    print_latency_row("EDMM burst", edmm_stats.burst_hist);
+    if (static_stats.cold_hist.count() > 0 && edmm_stats.cold_hist.count() > 0) {
+        printf("  EDMM cold-start speedup (p50): %.2fx\n",
+               static_stats.cold_hist.percentile_ms(50.0) / edmm_stats.cold_hist.percentile_ms(50.0));
+    }
+    
+    report_layout(report_out, "SGX Cold Start (Static Layout)", static_stats);
+    report_layout(report_out, "SGX Cold Start (EDMM Lazy Commit)", edmm_stats);
+}
+
+static void print_counter(const char* label, int64_t value) {
+    if (value < 0) {
+        printf("  %-24s n/a\n", label);
+    } else {
+        printf("  %-24s %lld\n", label, (long long)value);
+    }
+}
+
+// Sustained EREPORT load, with the AEXs each request took and the host's EPC
+// paging counters sampled per window, to show when co-tenants page us out
+void benchmark_epc_telemetry(sgx_enclave_id_t eid, BenchReport* report_out, int seconds) {
+    printf("\n[+] EPC/AEX Telemetry (%d s of EREPORTs, %.0f ms windows)...\n",
+           seconds, TELEMETRY_WINDOW_MS);
+    
+    uint8_t report[sizeof(sgx_report_t)];
+    uint8_t custom_data[64] = {0};
+    snprintf((char*)custom_data, 64, "Telemetry-%d", seconds);
+    
+    // -3: built without AEX_NOTIFY=1, or the CPU lacks AEX-Notify
+    int enclave_ret = 0;
+    uint32_t aex = 0;
+    sgx_status_t ret = ecall_generate_report_aex(eid, &enclave_ret, report, sizeof(report),
+                                                 custom_data, &aex);
+    bool have_aex = ret == SGX_SUCCESS && enclave_ret != -3;
+    epc_sample_t first = epc_sample();
+    printf("  AEX counting: %s\n", have_aex ? "AEX-Notify" : "n/a (needs AEX_NOTIFY=1 and an AEX-Notify CPU)");
+    print_counter("Total EPC bytes:", first.total_bytes);
+    print_counter("Free EPC pages:", first.free_pages);
+    if (first.ewb < 0) {
+        printf("  EWB/ELDU: n/a (no sgx_ewb/sgx_eldu kprobes, see epc_telemetry.h)\n");
+    }
+    
+    printf("  %6s | %8s | %9s | %9s | %8s | %8s | %8s | %10s\n",
+           "t s", "requests", "p50 ms", "p99 ms", "AEX", "EWB", "ELDU", "free pages");
+    
+    LatencyHistogram quiet_hist;     // requests without an AEX
+    LatencyHistogram aex_hist;       // requests interrupted at least once
+    LatencyHistogram steady_hist;    // windows without EWB/ELDU
+    LatencyHistogram paging_hist;    // windows in which the host paged EPC
+    std::vector<double> samples;
+    uint64_t aex_total = 0;
+    uint64_t requests_with_aex = 0;
+    int paging_windows = 0;
+    int attempts = 0;
+    
+    epc_sample_t window_start = first;
+    double run_end = get_time_ms() + seconds * 1000.0;
+    for (int window = 0; get_time_ms() < run_end && ret != SGX_ERROR_ENCLAVE_LOST; window++) {
+        LatencyHistogram window_hist;
+        uint64_t window_aex = 0;
+        double window_end = get_time_ms() + TELEMETRY_WINDOW_MS;
+        while (get_time_ms() < window_end) {
+            attempts++;
+            aex = 0;
+            double call_start = get_time_ms();
+            if (have_aex) {
+                ret = ecall_generate_report_aex(eid, &enclave_ret, report, sizeof(report),
+                                                custom_data, &aex);
+            } else {
+                ret = ecall_generate_report(eid, &enclave_ret, report, sizeof(report),
+                                            custom_data);
+            }
+            double latency = get_time_ms() - call_start;
+            if (ret != SGX_SUCCESS || enclave_ret != 0) {
+                if (ret == SGX_ERROR_ENCLAVE_LOST) {
+                    break;
+                }
+                continue;
+            }
+            
+            window_hist.record_ms(latency);
+            samples.push_back(latency);
+            window_aex += aex;
+            if (aex > 0) {
+                requests_with_aex++;
+                aex_hist.record_ms(latency);
+            } else {
+                quiet_hist.record_ms(latency);
+            }
+        }
+        
+        epc_sample_t window_now = epc_sample();
+        int64_t ewb = epc_delta(window_start.ewb, window_now.ewb);
+        int64_t eldu = epc_delta(window_start.eldu, window_now.eldu);
+        bool paging = ewb > 0 || eldu > 0;
+        window_start = window_now;
+        aex_total += window_aex;
+        if (paging) {
+            paging_windows++;
+            paging_hist.merge(window_hist);
+        } else {
+            steady_hist.merge(window_hist);
+        }
+        
+        printf("  %6.1f | %8llu | %9.3f | %9.3f | %8lld | %8lld | %8lld | %10lld\n",
+               (window + 1) * TELEMETRY_WINDOW_MS / 1000.0, (unsigned long long)window_hist.count(),
+               window_hist.percentile_ms(50.0), window_hist.percentile_ms(99.0),
+               have_aex ? (long long)window_aex : -1LL, (long long)ewb, (long long)eldu,
+               (long long)window_now.free_pages);
+        
+        char name[64];
+        snprintf(name, sizeof(name), "SGX EPC Telemetry Window %d", window);
+        report_out->add_operation(name);
+        report_out->add_field("t_s", (window + 1) * TELEMETRY_WINDOW_MS / 1000.0);
+        report_out->add_field("requests", (double)window_hist.count());
+        report_out->add_field("p50_ms", window_hist.percentile_ms(50.0));
+        report_out->add_field("p99_ms", window_hist.percentile_ms(99.0));
+        report_out->add_field("aex", have_aex ? (double)window_aex : -1);
+        report_out->add_field("ewb", (double)ewb);
+        report_out->add_field("eldu", (double)eldu);
+        report_out->add_field("free_epc_pages", (double)window_now.free_pages);
+    }
+    
+    if (ret == SGX_ERROR_ENCLAVE_LOST) {
+        printf("  ✗ Enclave lost, telemetry run cut short\n");
+    }
+    epc_sample_t last = epc_sample();
+    printf("  Successful: %d/%d\n", (int)samples.size(), attempts);
+    if (have_aex) {
+        printf("  AEXs: %llu over %llu interrupted requests\n",
+               (unsigned long long)aex_total, (unsigned long long)requests_with_aex);
+    }
+    printf("  Windows with EPC paging: %d\n", paging_windows);
+    print_latency_header();
+    print_latency_row("No AEX", quiet_hist);
+    print_latency_row("With AEX", aex_hist);
+    print_latency_row("Steady windows", steady_hist);
+    print_latency_row("Paging windows", paging_hist);
+    
+    report_out->add_latency("SGX EREPORT under EPC Telemetry", samples, attempts);
+    report_out->add_field("aex_total", have_aex ? (double)aex_total : -1);
+    report_out->add_field("requests_with_aex", have_aex ? (double)requests_with_aex : -1);
+    report_out->add_field("ewb_total", (double)epc_delta(first.ewb, last.ewb));
+    report_out->add_field("eldu_total", (double)epc_delta(first.eldu, last.eldu));
+    report_out->add_field("paging_windows", paging_windows);
+    report_out->add_field("epc_total_bytes", (double)first.total_bytes);
+    if (quiet_hist.count() > 0) {
+        report_out->add_field("no_aex_p99_ms", quiet_hist.percentile_ms(99.0));
+    }
+    if (aex_hist.count() > 0) {
+        report_out->add_field("aex_p99_ms", aex_hist.percentile_ms(99.0));
+    }
+    if (steady_hist.count() > 0) {
+        report_out->add_field("steady_p99_ms", steady_hist.percentile_ms(99.0));
+    }
+    if (paging_hist.count() > 0) {
+        report_out->add_field("paging_p99_ms", paging_hist.percentile_ms(99.0));
+    }
 }
 
 int main(int argc, char *argv[]) {
@@ -134,17 +608,44 @@ int main(int argc, char *argv[]) {
     int updated = 0;
     
     int iterations = 100;
-    if (argc > 1) {
-        iterations = atoi(argv[1]);
-        if (iterations <= 0 || iterations > MAX_ITERATIONS) {
-            printf("Invalid iterations. Using default: 100\n");
-            iterations = 100;
+    int pool_size = 0;
+    int telemetry_seconds = 0;
+    bool edmm = false;
+    std::string json_path = bench_report_path("sgx_baseline", "json");
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else if (strcmp(argv[i], "--pool") == 0 && i + 1 < argc) {
+            pool_size = atoi(argv[++i]);
+            if (pool_size <= 0 || pool_size > MAX_POOL_SIZE) {
+                printf("Invalid pool size. Using default: 4\n");
+                pool_size = 4;
+            }
+        } else if (strcmp(argv[i], "--telemetry") == 0 && i + 1 < argc) {
+            telemetry_seconds = atoi(argv[++i]);
+            if (telemetry_seconds <= 0 || telemetry_seconds > MAX_TELEMETRY_SECONDS) {
+                printf("Invalid telemetry duration. Using default: 30\n");
+                telemetry_seconds = 30;
+            }
+        } else if (strcmp(argv[i], "--edmm") == 0) {
+            edmm = true;
+        } else if (argv[i][0] == '-') {
+            printf("Usage: %s [iterations] [--json FILE] [--pool K] [--telemetry SECONDS] [--edmm]\n",
+                   argv[0]);
+            return -1;
+        } else {
+            iterations = atoi(argv[i]);
+            if (iterations <= 0 || iterations > MAX_ITERATIONS) {
+                printf("Invalid iterations. Using default: 100\n");
+                iterations = 100;
+            }
         }
     }
     
     printf("======================================================\n");
     printf("SGX Attestation Baseline Benchmark\n");
     printf("======================================================\n");
+    printf("Clock: %s\n", bench_clock_source());
     
     // Create enclave
     printf("\nInitializing enclave...\n");
@@ -156,14 +657,34 @@ int main(int argc, char *argv[]) {
     printf("✓ Enclave created (EID: %lu)\n", eid);
     
     // Run benchmarks
-    benchmark_ereport_generation(eid, iterations);
-    benchmark_quote_preparation(eid, iterations);
+    BenchReport report("Intel SGX");
+    benchmark_ereport_generation(eid, &report, iterations);
+    benchmark_quote_preparation(eid, &report, iterations);
+    if (telemetry_seconds > 0) {
+        benchmark_epc_telemetry(eid, &report, telemetry_seconds);
+    }
     
     // Destroy enclave
     sgx_destroy_enclave(eid);
     
     // Measure creation overhead
-    measure_enclave_creation(10);
+    measure_enclave_creation(&report, 10);
+    
+    if (pool_size > 0) {
+        benchmark_enclave_pool(&report, pool_size, iterations);
+    }
+    
+    if (edmm) {
+        benchmark_edmm_layout(&report, iterations);
+    }
+    
+    // Same schema as the TDX baseline JSON, consumed by final_comparison.py
+    std::string csv_path = bench_report_csv_path(json_path);
+    if (report.write_json(json_path.c_str()) && report.write_csv(csv_path.c_str())) {
+        printf("\n✓ Results saved to: %s (samples: %s)\n", json_path.c_str(), csv_path.c_str());
+    } else {
+        printf("\n✗ Failed to write results to %s\n", json_path.c_str());
+    }
     
     printf("\n======================================================\n");
     printf("Benchmark Complete!\n");
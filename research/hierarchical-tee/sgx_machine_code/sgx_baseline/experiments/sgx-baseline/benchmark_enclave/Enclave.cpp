@@ -2,7 +2,14 @@
 #include <sgx_report.h>
 #include <sgx_utils.h>
 #include <sgx_trts.h>
+#include <stdlib.h>
 #include <string.h>
+#ifdef BENCH_EDMM
+#include <sgx_mm.h>
+#endif
+#ifdef BENCH_AEX_NOTIFY
+#include <sgx_trts_aex.h>
+#endif
 
 // Generate EREPORT for benchmarking
 int ecall_generate_report(uint8_t *report_data, size_t report_size, uint8_t *custom_data) {
@@ -34,6 +41,85 @@ int ecall_generate_report(uint8_t *report_data, size_t report_size, uint8_t *cus
     return 0;
 }
 
+#ifdef BENCH_AEX_NOTIFY
+// Runs on this thread when it re-enters after an AEX; args is the ecall's counter
+static void count_aex(const sgx_exception_info_t *info, const void *args) {
+    (void)info;
+    (*(uint32_t *)(uintptr_t)args)++;
+}
+#endif
+
+// ecall_generate_report, counting the asynchronous exits it suffered.
+// Returns -3 when AEX-Notify is not built in or not enabled for this enclave.
+int ecall_generate_report_aex(uint8_t *report_data, size_t report_size, uint8_t *custom_data,
+                              uint32_t *aex_count) {
+    *aex_count = 0;
+#ifdef BENCH_AEX_NOTIFY
+    uint32_t count = 0;
+    sgx_aex_mitigation_node_t node;
+    if (sgx_register_aex_handler(&node, count_aex, &count) != SGX_SUCCESS) {
+        return -3;
+    }
+    
+    int ret = ecall_generate_report(report_data, report_size, custom_data);
+    sgx_unregister_aex_handler(count_aex);
+    *aex_count = count;
+    return ret;
+#else
+    (void)report_data;
+    (void)report_size;
+    (void)custom_data;
+    return -3;
+#endif
+}
+
+// One write per 4 KB page, so every page is actually committed
+static void touch_pages(uint8_t *buf, size_t bytes) {
+    for (size_t off = 0; off < bytes; off += 4096) {
+        buf[off] = (uint8_t)off;
+    }
+}
+
+// Request burst needing `bytes` of scratch. With EDMM the scratch comes from
+// the user region, committed on demand and trimmed again by sgx_mm_dealloc so
+// the burst does not leave its EPC behind; without it (SGX1, or an image
+// signed without UserRegionSize) it is a heap allocation.
+int ecall_burst(size_t bytes, int *trimmed) {
+    *trimmed = 0;
+#ifdef BENCH_EDMM
+    void *region = NULL;
+    if (sgx_mm_alloc(NULL, bytes, SGX_EMA_COMMIT_ON_DEMAND, NULL, NULL, &region) == 0) {
+        touch_pages((uint8_t *)region, bytes);
+        if (sgx_mm_dealloc(region, bytes) != 0) {
+            return -2;
+        }
+        *trimmed = 1;
+        return 0;
+    }
+#endif
+    
+    uint8_t *buf = (uint8_t *)malloc(bytes);
+    if (buf == NULL) {
+        return -1;
+    }
+    touch_pages(buf, bytes);
+    free(buf);
+    return 0;
+}
+
+// Both flags live in untrusted memory: the host counts how many threads got a
+// TCS at once, then lets them all go
+int ecall_hold_tcs(int *entered, int *release) {
+    if (!sgx_is_outside_enclave(entered, sizeof(int)) ||
+        !sgx_is_outside_enclave(release, sizeof(int))) {
+        return -1;
+    }
+    __atomic_add_fetch(entered, 1, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(release, __ATOMIC_ACQUIRE) == 0) {
+    }
+    return 0;
+}
+
 // Prepare data for remote attestation quote
 int ecall_prepare_quote_data(uint8_t *report_data) {
     if (report_data == NULL) {
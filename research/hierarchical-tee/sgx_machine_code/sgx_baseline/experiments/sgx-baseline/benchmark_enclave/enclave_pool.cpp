@@ -0,0 +1,94 @@
+#include "enclave_pool.h"
+
+#include "bench_clock.h"
+
+EnclavePool::EnclavePool() : recreate_count_(0), init_ms_(0) {
+}
+
+EnclavePool::~EnclavePool() {
+    for (size_t i = 0; i < slots_.size(); i++) {
+        if (slots_[i] != 0) {
+            sgx_destroy_enclave(slots_[i]);
+        }
+    }
+}
+
+sgx_status_t EnclavePool::create_instance(sgx_enclave_id_t* eid) const {
+    sgx_launch_token_t token = {0};
+    int updated = 0;
+    return sgx_create_enclave(enclave_file_.c_str(), SGX_DEBUG_FLAG,
+                              &token, &updated, eid, NULL);
+}
+
+sgx_status_t EnclavePool::init(const char* enclave_file, size_t count) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!slots_.empty() || count == 0) {
+        return SGX_ERROR_INVALID_PARAMETER;
+    }
+    
+    enclave_file_ = enclave_file;
+    slots_.assign(count, 0);
+    idle_.reserve(count);
+    
+    double start = bench_now_ms();
+    for (size_t i = 0; i < count; i++) {
+        sgx_status_t ret = create_instance(&slots_[i]);
+        if (ret != SGX_SUCCESS) {
+            slots_[i] = 0;
+            return ret;
+        }
+        idle_.push_back(i);
+    }
+    init_ms_ = bench_now_ms() - start;
+    return SGX_SUCCESS;
+}
+
+size_t EnclavePool::acquire() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (idle_.empty()) {
+        idle_cv_.wait(lock);
+    }
+    // LIFO: the most recently used instance is the one least likely paged out
+    size_t slot = idle_.back();
+    idle_.pop_back();
+    return slot;
+}
+
+sgx_enclave_id_t EnclavePool::eid(size_t slot) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return slots_[slot];
+}
+
+void EnclavePool::release(size_t slot) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        idle_.push_back(slot);
+    }
+    idle_cv_.notify_one();
+}
+
+sgx_status_t EnclavePool::recreate(size_t slot) {
+    // The slot is leased, so nobody else touches its eid; the mutex only
+    // guards the vectors and counters. enclave_file_ is fixed after init()
+    sgx_enclave_id_t old_eid;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        old_eid = slots_[slot];
+    }
+    if (old_eid != 0) {
+        sgx_destroy_enclave(old_eid);
+    }
+    
+    sgx_enclave_id_t new_eid = 0;
+    sgx_status_t ret = create_instance(&new_eid);
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    slots_[slot] = ret == SGX_SUCCESS ? new_eid : 0;
+    recreate_count_++;
+    return ret;
+}
+
+uint64_t EnclavePool::recreate_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return recreate_count_;
+}
@@ -0,0 +1,82 @@
+#ifndef ENCLAVE_POOL_H
+#define ENCLAVE_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <sgx_urts.h>
+
+/*
+ * Warm pool of loaded enclaves.
+ *
+ * sgx_create_enclave() costs milliseconds (EADD/EEXTEND of every page plus
+ * EINIT), so init() pays it K times up front and requests only lease an
+ * already-initialized sgx_enclave_id_t. acquire() blocks while every
+ * instance is out.
+ *
+ * An enclave is lost when the EPC is reset under it (S3/S4 resume, VM
+ * migration); every ecall then returns SGX_ERROR_ENCLAVE_LOST and the
+ * only fix is destroy + create. call() does that transparently and retries
+ * the ecall once on the fresh instance; the loss only costs the request
+ * that hit it.
+ */
+class EnclavePool {
+public:
+    EnclavePool();
+    ~EnclavePool();
+
+    /* Load `count` instances of `enclave_file`, returns the first failure. */
+    sgx_status_t init(const char* enclave_file, size_t count);
+
+    /* Lease the slot of an idle instance, blocking until one is free. */
+    size_t acquire();
+
+    sgx_enclave_id_t eid(size_t slot) const;
+
+    void release(size_t slot);
+
+    /* Destroy and re-create the instance in a leased slot. */
+    sgx_status_t recreate(size_t slot);
+
+    /*
+     * Run `ecall(eid)` on a leased instance. On SGX_ERROR_ENCLAVE_LOST the
+     * instance is re-created and the ecall retried once; a slot left empty
+     * by a failed re-create is retried by the next lease.
+     */
+    template <typename Ecall>
+    sgx_status_t call(Ecall ecall) {
+        size_t slot = acquire();
+        sgx_status_t ret = SGX_ERROR_ENCLAVE_LOST;
+        if (eid(slot) != 0) {
+            ret = ecall(eid(slot));
+        }
+        if (ret == SGX_ERROR_ENCLAVE_LOST && recreate(slot) == SGX_SUCCESS) {
+            ret = ecall(eid(slot));
+        }
+        release(slot);
+        return ret;
+    }
+
+    size_t size() const { return slots_.size(); }
+    uint64_t recreate_count() const;
+    double init_ms() const { return init_ms_; }
+
+private:
+    EnclavePool(const EnclavePool&);
+    EnclavePool& operator=(const EnclavePool&);
+
+    sgx_status_t create_instance(sgx_enclave_id_t* eid) const;
+
+    mutable std::mutex mutex_;
+    std::condition_variable idle_cv_;
+    std::string enclave_file_;
+    std::vector<sgx_enclave_id_t> slots_;
+    std::vector<size_t> idle_;
+    uint64_t recreate_count_;
+    double init_ms_;
+};
+
+#endif /* ENCLAVE_POOL_H */
@@ -36,5 +36,14 @@ else
     echo "No quote test utility available"
 fi
 
+echo ""
+echo "[7] Checking quote provider cache..."
+if grep -Eq 'cache_expire_hours|local_cache' /etc/sgx_default_qcnl.conf 2>/dev/null; then
+    grep -E 'cache_expire_hours|local_cache' /etc/sgx_default_qcnl.conf | grep -v "^ *#"
+else
+    echo "No cache settings: PCK certs and collateral come from PCCS on first use"
+fi
+echo "  quote_benchmark prefetches collateral in the background (--refresh-interval S)"
+
 echo ""
 echo "=== Configuration Check Complete ==="
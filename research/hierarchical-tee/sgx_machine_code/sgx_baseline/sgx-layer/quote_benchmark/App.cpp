@@ -1,293 +1,24 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <string>
 #include <sgx_urts.h>
-#include <sgx_quote_3.h>
-#include <sgx_dcap_ql_wrapper.h>
-#include <sgx_ql_quote.h>
-#include <sys/time.h>
-#include "Enclave_u.h"
+#include <sgx_uswitchless.h>
+#include "attestation_context.h"
+#include "bench_clock.h"
+#include "bench_report.h"
+#include "composite_evidence.h"
+#include "quote_benchmark.h"
+#include "quote_buffer_pool.h"
+#include "quote_verifier.h"
 
 #define ENCLAVE_FILE "enclave.signed.so"
-
-double get_time_ms() {
-    struct timeval tv;
-    gettimeofday(&tv, NULL);
-    return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
-}
-
-void print_hex(const char* label, uint8_t* data, size_t len) {
-    printf("%s (%zu bytes): ", label, len);
-    for (size_t i = 0; i < (len < 32 ? len : 32); i++) {
-        printf("%02x", data[i]);
-    }
-    if (len > 32) printf("...");
-    printf("\n");
-}
-
-int benchmark_quote_generation(sgx_enclave_id_t eid, int iterations) {
-    printf("\n[1/3] Benchmarking SGX Quote Generation (%d iterations)...\n", iterations);
-    printf("---------------------------------------------------------------\n");
-    
-    double total_ereport_time = 0;
-    double total_quote_time = 0;
-    double total_end_to_end = 0;
-    int successful = 0;
-    
-    // Get target info for Quoting Enclave
-    sgx_target_info_t qe_target_info;
-    uint32_t quote_size = 0;
-    
-    // Initialize quote library
-    quote3_error_t qe3_ret = sgx_qe_get_target_info(&qe_target_info);
-    if (qe3_ret != SGX_QL_SUCCESS) {
-        printf("  ✗ Failed to get QE target info: 0x%x\n", qe3_ret);
-        printf("  Note: DCAP may not be fully configured\n");
-        printf("  Possible issues:\n");
-        printf("    - PCCS not accessible\n");
-        printf("    - AESM service not running\n");
-        printf("    - Quote provider library not properly installed\n");
-        return -1;
-    }
-    
-    printf("  ✓ Quote Provider initialized\n");
-    
-    // Get quote size
-    qe3_ret = sgx_qe_get_quote_size(&quote_size);
-    if (qe3_ret != SGX_QL_SUCCESS) {
-        printf("  ✗ Failed to get quote size: 0x%x\n", qe3_ret);
-        return -1;
-    }
-    
-    printf("  ✓ Quote size: %u bytes\n\n", quote_size);
-    
-    uint8_t* quote_buffer = (uint8_t*)malloc(quote_size);
-    if (!quote_buffer) {
-        printf("  ✗ Failed to allocate quote buffer\n");
-        return -1;
-    }
-    
-    // Benchmark loop
-    for (int i = 0; i < iterations; i++) {
-        double iter_start = get_time_ms();
-        
-        // Step 1: Generate EREPORT inside enclave
-        uint8_t report[sizeof(sgx_report_t)];
-        uint8_t custom_data[64] = {0};
-        snprintf((char*)custom_data, 64, "Iteration-%d", i);
-        
-        double ereport_start = get_time_ms();
-        
-        int enclave_ret;
-        sgx_status_t ret = ecall_generate_report_for_quote(
-            eid,
-            &enclave_ret,
-            report,
-            sizeof(report),
-            (uint8_t*)&qe_target_info,
-            sizeof(qe_target_info),
-            custom_data,
-            64
-        );
-        
-        double ereport_end = get_time_ms();
-        
-        if (ret != SGX_SUCCESS || enclave_ret != 0) {
-            if (i == 0) {
-                printf("  [%d] ✗ Failed to generate EREPORT: SGX=0x%x, Enclave=%d\n", 
-                       i+1, ret, enclave_ret);
-            }
-            continue;
-        }
-        
-        // Step 2: Convert EREPORT to Quote using Quoting Enclave
-        double quote_start = get_time_ms();
-        
-        qe3_ret = sgx_qe_get_quote(
-            (sgx_report_t*)report,
-            quote_size,
-            quote_buffer
-        );
-        
-        double quote_end = get_time_ms();
-        double iter_end = get_time_ms();
-        
-        if (qe3_ret != SGX_QL_SUCCESS) {
-            if (i == 0) {
-                printf("  [%d] ✗ Failed to generate quote: 0x%x\n", i+1, qe3_ret);
-            }
-            continue;
-        }
-        
-        successful++;
-        
-        double ereport_time = ereport_end - ereport_start;
-        double quote_time = quote_end - quote_start;
-        double end_to_end_time = iter_end - iter_start;
-        
-        total_ereport_time += ereport_time;
-        total_quote_time += quote_time;
-        total_end_to_end += end_to_end_time;
-        
-        if ((i + 1) % 20 == 0) {
-            printf("  Progress: %d/%d (successes: %d)\n", i+1, iterations, successful);
-        }
-    }
-    
-    printf("\n  Results Summary:\n");
-    printf("  ---------------\n");
-    printf("  Successful: %d/%d\n", successful, iterations);
-    
-    if (successful > 0) {
-        printf("  Average EREPORT time:    %.3f ms\n", total_ereport_time / successful);
-        printf("  Average Quote time:      %.3f ms\n", total_quote_time / successful);
-        printf("  Average End-to-End:      %.3f ms\n", total_end_to_end / successful);
-        printf("  Quote size:              %u bytes\n", quote_size);
-        
-        // Parse and print quote header (first quote only)
-        printf("\n  Quote Structure (first quote):\n");
-        // Use generic byte parsing instead of sgx_quote3_t structure
-        printf("    Version: %u\n", *(uint16_t*)quote_buffer);
-        printf("    Quote size: %u bytes\n", quote_size);
-        print_hex("    Quote header", quote_buffer, 48);
-    }
-    
-    free(quote_buffer);
-    return successful;
-}
-
-int measure_quote_sizes(sgx_enclave_id_t eid) {
-    printf("\n[2/3] Measuring Quote Sizes...\n");
-    printf("---------------------------------------------------------------\n");
-    
-    sgx_target_info_t qe_target_info;
-    uint32_t quote_size = 0;
-    
-    quote3_error_t qe3_ret = sgx_qe_get_target_info(&qe_target_info);
-    if (qe3_ret != SGX_QL_SUCCESS) {
-        printf("  ✗ Failed to get QE target info\n");
-        return -1;
-    }
-    
-    qe3_ret = sgx_qe_get_quote_size(&quote_size);
-    if (qe3_ret != SGX_QL_SUCCESS) {
-        printf("  ✗ Failed to get quote size\n");
-        return -1;
-    }
-    
-    printf("  SGX Quote Size: %u bytes\n", quote_size);
-    
-    // Compare with TDX
-    printf("\n  Comparison with TDX:\n");
-    printf("    SGX Quote:     %u bytes\n", quote_size);
-    printf("    TDX Token:     5934 bytes (from your baseline)\n");
-    printf("    TDX Evidence:  11469 bytes (raw output)\n");
-    
-    if (quote_size < 5934) {
-        printf("    SGX quote is %.1fx smaller than TDX token\n", 5934.0 / quote_size);
-    } else {
-        printf("    SGX quote is %.1fx larger than TDX token\n", (float)quote_size / 5934.0);
-    }
-    
-    // Hierarchical estimate
-    uint32_t hierarchical_size = quote_size + 5934 + 200; // SGX + TDX + binding
-    printf("\n  Hierarchical Protocol Estimate:\n");
-    printf("    SGX quote:     %u bytes\n", quote_size);
-    printf("    TDX token:     5934 bytes\n");
-    printf("    Binding data:  ~200 bytes (estimate)\n");
-    printf("    Total:         ~%u bytes\n", hierarchical_size);
-    
-    return 0;
-}
-
-int test_single_quote_detailed(sgx_enclave_id_t eid) {
-    printf("\n[3/3] Detailed Single Quote Test...\n");
-    printf("---------------------------------------------------------------\n");
-    
-    sgx_target_info_t qe_target_info;
-    uint32_t quote_size = 0;
-    
-    quote3_error_t qe3_ret = sgx_qe_get_target_info(&qe_target_info);
-    if (qe3_ret != SGX_QL_SUCCESS) {
-        printf("  ✗ Failed to get QE target info: 0x%x\n", qe3_ret);
-        return -1;
-    }
-    
-    qe3_ret = sgx_qe_get_quote_size(&quote_size);
-    if (qe3_ret != SGX_QL_SUCCESS) {
-        printf("  ✗ Failed to get quote size: 0x%x\n", qe3_ret);
-        return -1;
-    }
-    
-    uint8_t* quote_buffer = (uint8_t*)malloc(quote_size);
-    if (!quote_buffer) {
-        printf("  ✗ Failed to allocate quote buffer\n");
-        return -1;
-    }
-    
-    uint8_t report[sizeof(sgx_report_t)];
-    uint8_t custom_data[64] = "Hierarchical-TEE-SGX-Quote-Test";
-    
-    // Generate EREPORT
-    printf("  Step 1: Generating EREPORT...\n");
-    double start = get_time_ms();
-    
-    int enclave_ret;
-    sgx_status_t ret = ecall_generate_report_for_quote(
-        eid, &enclave_ret,
-        report, sizeof(report),
-        (uint8_t*)&qe_target_info, sizeof(qe_target_info),
-        custom_data, 64
-    );
-    
-    double ereport_time = get_time_ms() - start;
-    
-    if (ret != SGX_SUCCESS || enclave_ret != 0) {
-        printf("  ✗ Failed to generate EREPORT: SGX=0x%x, Enclave=%d\n", ret, enclave_ret);
-        free(quote_buffer);
-        return -1;
-    }
-    printf("    ✓ EREPORT generated in %.3f ms\n", ereport_time);
-    
-    // Generate Quote
-    printf("  Step 2: Converting to Quote (via Quoting Enclave)...\n");
-    start = get_time_ms();
-    
-    qe3_ret = sgx_qe_get_quote((sgx_report_t*)report, quote_size, quote_buffer);
-    
-    double quote_time = get_time_ms() - start;
-    
-    if (qe3_ret != SGX_QL_SUCCESS) {
-        printf("  ✗ Failed to generate quote: 0x%x\n", qe3_ret);
-        free(quote_buffer);
-        return -1;
-    }
-    printf("    ✓ Quote generated in %.3f ms\n", quote_time);
-    
-    // Print quote information
-    printf("\n  Quote Details:\n");
-    printf("    Total Size: %u bytes\n", quote_size);
-    printf("    Version: %u\n", *(uint16_t*)quote_buffer);
-    
-    // Print some quote data
-    print_hex("    Quote header", quote_buffer, 48);
-    print_hex("    Report body (partial)", quote_buffer + 48, 64);
-    
-    printf("\n  Performance Summary:\n");
-    printf("    EREPORT generation:     %.3f ms\n", ereport_time);
-    printf("    Quote generation (QE):  %.3f ms\n", quote_time);
-    printf("    Total:                  %.3f ms\n", ereport_time + quote_time);
-    
-    printf("\n  For Hierarchical Protocol:\n");
-    printf("    SGX layer time:  %.3f ms (this measurement)\n", ereport_time + quote_time);
-    printf("    TDX layer time:  199.75 ms (from your baseline)\n");
-    printf("    Estimated total: %.2f ms\n", ereport_time + quote_time + 199.75);
-    printf("    Added overhead:  +%.1f%%\n", 
-           ((ereport_time + quote_time) / 199.75) * 100.0);
-    
-    free(quote_buffer);
-    return 0;
-}
+#define REPORT_BATCH_MAX 256
+#define VERIFY_QUOTES_MAX 256
+#define DEFAULT_REFRESH_INTERVAL_S 600
+#define QUOTE_POOL_BUFFERS (ENCLAVE_TCS_NUM + 2)  /* one lease per enclave thread */
+#define RESERVOIR_CAPACITY 16
+#define RESERVOIR_CAPACITY_MAX 256
 
 int main(int argc, char* argv[]) {
     sgx_enclave_id_t eid = 0;
@@ -295,10 +26,91 @@ int main(int argc, char* argv[]) {
     int updated = 0;
     
     int iterations = 100;
-    if (argc > 1) {
-        iterations = atoi(argv[1]);
-        if (iterations <= 0 || iterations > 1000) {
-            iterations = 100;
+    int batch_size = 0;
+    bool switchless = false;
+    int uworkers = 1;
+    int tworkers = 2;
+    int threads = 0;
+    int pipeline = 0;
+    int verify = 0;
+    int refresh_interval = DEFAULT_REFRESH_INTERVAL_S;
+    const char* trace_path = NULL;
+    const char* trace_quotes_path = "traced_quotes.bin";
+    const char* overlap_address = NULL;
+    const char* reservoir_address = NULL;
+    int reservoir_depth = RESERVOIR_CAPACITY;
+    std::string json_path = bench_report_path("sgx_quote_benchmark", "json");
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+            batch_size = atoi(argv[++i]);
+            if (batch_size <= 0 || batch_size > REPORT_BATCH_MAX) {
+                printf("Invalid batch size. Using default: 32\n");
+                batch_size = 32;
+            }
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+            if (threads <= 0 || threads > WORKER_TCS_NUM) {
+                printf("Invalid thread count. Using default: %d\n", WORKER_TCS_NUM);
+                threads = WORKER_TCS_NUM;
+            }
+        } else if (strcmp(argv[i], "--pipeline") == 0 && i + 1 < argc) {
+            pipeline = atoi(argv[++i]);
+            if (pipeline <= 0 || pipeline > WORKER_TCS_NUM) {
+                printf("Invalid stage count. Using default: 2\n");
+                pipeline = 2;
+            }
+        } else if (strcmp(argv[i], "--verify") == 0 && i + 1 < argc) {
+            verify = atoi(argv[++i]);
+            if (verify <= 0 || verify > VERIFY_QUOTES_MAX) {
+                printf("Invalid quote count. Using default: 64\n");
+                verify = 64;
+            }
+        } else if (strcmp(argv[i], "--refresh-interval") == 0 && i + 1 < argc) {
+            refresh_interval = atoi(argv[++i]);
+            if (refresh_interval <= 0) {
+                refresh_interval = DEFAULT_REFRESH_INTERVAL_S;
+            }
+        } else if (strcmp(argv[i], "--no-refresh") == 0) {
+            refresh_interval = 0;
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            trace_path = argv[++i];
+        } else if (strcmp(argv[i], "--trace-quotes") == 0 && i + 1 < argc) {
+            trace_quotes_path = argv[++i];
+        } else if (strcmp(argv[i], "--overlap") == 0 && i + 1 < argc) {
+            overlap_address = argv[++i];
+        } else if (strcmp(argv[i], "--reservoir") == 0 && i + 1 < argc) {
+            reservoir_address = argv[++i];
+        } else if (strcmp(argv[i], "--reservoir-depth") == 0 && i + 1 < argc) {
+            reservoir_depth = atoi(argv[++i]);
+            if (reservoir_depth <= 0 || reservoir_depth > RESERVOIR_CAPACITY_MAX) {
+                printf("Invalid reservoir depth. Using default: %d\n", RESERVOIR_CAPACITY);
+                reservoir_depth = RESERVOIR_CAPACITY;
+            }
+        } else if (strcmp(argv[i], "--switchless") == 0) {
+            switchless = true;
+        } else if (strcmp(argv[i], "--uworkers") == 0 && i + 1 < argc) {
+            uworkers = atoi(argv[++i]);
+            if (uworkers < 0 || uworkers > ENCLAVE_TCS_NUM) {
+                uworkers = 1;
+            }
+        } else if (strcmp(argv[i], "--tworkers") == 0 && i + 1 < argc) {
+            tworkers = atoi(argv[++i]);
+            if (tworkers <= 0 || tworkers >= WORKER_TCS_NUM) {
+                tworkers = 2;
+            }
+        } else if (argv[i][0] == '-') {
+            printf("Usage: %s [iterations] [--json FILE] [--batch N] [--threads N] [--pipeline N] "
+                   "[--trace FILE [--trace-quotes FILE]] [--overlap TD_HOST:PORT|model] "
+                   "[--reservoir TD_HOST:PORT|model [--reservoir-depth N]] "
+                   "[--switchless [--uworkers N] [--tworkers N]]\n", argv[0]);
+            return -1;
+        } else {
+            iterations = atoi(argv[i]);
+            if (iterations <= 0 || iterations > 1000) {
+                iterations = 100;
+            }
         }
     }
     
@@ -308,8 +120,21 @@ int main(int argc, char* argv[]) {
     
     // Create enclave
     printf("\nInitializing enclave...\n");
-    sgx_status_t ret = sgx_create_enclave(ENCLAVE_FILE, SGX_DEBUG_FLAG, 
-                                          &token, &updated, &eid, NULL);
+    sgx_status_t ret;
+    if (switchless) {
+        // Worker counts come from the command line; everything else uses SDK defaults
+        sgx_uswitchless_config_t us_config = SGX_USWITCHLESS_CONFIG_INITIALIZER;
+        us_config.num_uworkers = (uint32_t)uworkers;
+        us_config.num_tworkers = (uint32_t)tworkers;
+        const void* enclave_ex_p[32] = {0};
+        enclave_ex_p[SGX_CREATE_ENCLAVE_EX_SWITCHLESS_BIT_IDX] = (const void*)&us_config;
+        
+        ret = sgx_create_enclave_ex(ENCLAVE_FILE, SGX_DEBUG_FLAG, &token, &updated, &eid, NULL,
+                                    SGX_CREATE_ENCLAVE_EX_SWITCHLESS, enclave_ex_p);
+    } else {
+        ret = sgx_create_enclave(ENCLAVE_FILE, SGX_DEBUG_FLAG, 
+                                 &token, &updated, &eid, NULL);
+    }
     if (ret != SGX_SUCCESS) {
         printf("✗ Failed to create enclave: 0x%x\n", ret);
         printf("\nPossible reasons:\n");
@@ -320,13 +145,89 @@ int main(int argc, char* argv[]) {
         return -1;
     }
     printf("✓ Enclave created (EID: %lu)\n", eid);
+    if (switchless) {
+        printf("✓ Switchless calls enabled (uworkers: %d, tworkers: %d)\n", uworkers, tworkers);
+    }
     
-    // Run benchmarks
-    int success = benchmark_quote_generation(eid, iterations);
+    // Calibrate the TSC before anything is timed
+    printf("✓ Benchmark clock: %s\n", bench_clock_source());
+    
+    // Fetch QE target info and quote size once for every phase; the
+    // refresher's verifier must outlive the context that stops it
+    QuoteVerifier collateral_verifier;
+    AttestationContext ctx;
+    QuoteBufferPool pool;
+    BenchReport report("Intel SGX (DCAP)");
+    int success = -1;
+    quote3_error_t qe3_ret = ctx.init();
+    if (qe3_ret != SGX_QL_SUCCESS) {
+        printf("✗ Failed to get QE target info: 0x%x\n", qe3_ret);
+        printf("  Note: DCAP may not be fully configured\n");
+        printf("  Possible issues:\n");
+        printf("    - PCCS not accessible\n");
+        printf("    - AESM service not running\n");
+        printf("    - Quote provider library not properly installed\n");
+    } else {
+        report_attestation_context_cost(&ctx, &report);
+        if (refresh_interval > 0) {
+            bool verifier_ok = collateral_verifier.init() == SGX_QL_SUCCESS;
+            ctx.start_refresher(refresh_interval, verifier_ok ? &collateral_verifier : NULL);
+            printf("✓ Background refresher: every %d s, %s\n", refresh_interval,
+                   verifier_ok ? "collateral prefetch on first quote" : "no QVL for collateral prefetch");
+        }
+        
+        // Run benchmarks
+        // Each buffer can hold a whole composite frame as well as a bare quote
+        size_t buffer_size = composite_evidence_size(ctx.quote_size(), TDX_TOKEN_BUDGET);
+        if (pool.init(buffer_size, QUOTE_POOL_BUFFERS)) {
+            success = benchmark_quote_generation(eid, &ctx, &pool, &report, iterations);
+        } else {
+            printf("✗ Failed to allocate quote buffer pool\n");
+        }
+    }
     
     if (success > 0) {
-        measure_quote_sizes(eid);
-        test_single_quote_detailed(eid);
+        if (refresh_interval > 0) {
+            report_attestation_startup(&ctx, &report);
+        }
+        measure_quote_sizes(&ctx, &report);
+        test_single_quote_detailed(eid, &ctx, &pool);
+        benchmark_composite_evidence(eid, &ctx, &pool, &report, iterations);
+        benchmark_binding_reports(eid, &ctx, &pool, &report, iterations);
+        benchmark_attested_session(eid, &ctx, &pool, &report, iterations);
+        benchmark_session_resumption(eid, &ctx, &pool, &report, iterations);
+        if (batch_size > 0) {
+            benchmark_batched_reports(eid, &ctx, &pool, iterations, batch_size);
+        }
+        if (switchless) {
+            benchmark_switchless_reports(eid, &ctx, iterations, tworkers);
+        }
+        if (threads > 0) {
+            // Trusted switchless workers hold TCSs for the enclave lifetime
+            int max_threads = switchless ? WORKER_TCS_NUM - tworkers : WORKER_TCS_NUM;
+            benchmark_threaded_quotes(eid, &ctx, &pool, &report, iterations,
+                                      threads < max_threads ? threads : max_threads);
+        }
+        if (pipeline > 0) {
+            int max_stages = switchless ? WORKER_TCS_NUM - tworkers : WORKER_TCS_NUM;
+            benchmark_pipelined_quotes(eid, &ctx, &pool, &report, iterations,
+                                       pipeline < max_stages ? pipeline : max_stages);
+        }
+        if (verify > 0) {
+            benchmark_quote_verification(eid, &ctx, &report, verify);
+        }
+        if (trace_path) {
+            benchmark_traced_evidence(eid, &ctx, &pool, &report, iterations,
+                                      trace_path, trace_quotes_path);
+        }
+        if (overlap_address) {
+            benchmark_overlapped_attestation(eid, &ctx, &pool, &report, iterations,
+                                             overlap_address);
+        }
+        if (reservoir_address) {
+            benchmark_evidence_reservoir(eid, &ctx, &pool, &report, iterations,
+                                         reservoir_address, reservoir_depth);
+        }
     } else {
         printf("\n⚠ Quote generation failed.\n");
         printf("This may be due to PCCS configuration issues.\n");
@@ -334,11 +235,23 @@ int main(int argc, char* argv[]) {
     }
     
     // Cleanup
+    ctx.stop_refresher();
     sgx_destroy_enclave(eid);
     
+    // Same schema as the TDX baseline JSON, consumed by final_comparison.py
+    std::string csv_path = bench_report_csv_path(json_path);
+    if (report.write_json(json_path.c_str()) && report.write_csv(csv_path.c_str())) {
+        printf("\n✓ Results saved to: %s (samples: %s)\n", json_path.c_str(), csv_path.c_str());
+    } else {
+        printf("\n✗ Failed to write results to %s\n", json_path.c_str());
+    }
+    
     printf("\n===============================================================\n");
     if (success > 0) {
-        printf("✓ Benchmark Complete!\n");
+        printf("✓ Benchmark Complete! (QE context refreshes: %d, background checks: %d)\n",
+               ctx.refresh_count(), ctx.background_refreshes());
+        printf("  Quote buffer pool: %zu/%zu buffers at peak, %lu failed leases\n",
+               pool.high_water(), pool.capacity(), (unsigned long)pool.lease_failures());
     } else {
         printf("⚠ Benchmark completed with errors\n");
         printf("Check PCCS configuration: /etc/sgx_default_qcnl.conf\n");
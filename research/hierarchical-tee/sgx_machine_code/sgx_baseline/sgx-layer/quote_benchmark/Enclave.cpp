@@ -1,7 +1,29 @@
 #include "Enclave_t.h"
+#include <sgx_lfence.h>
 #include <sgx_report.h>
+#include <sgx_tcrypto.h>
+#include <sgx_trts.h>
+#include <sgx_tseal.h>
 #include <sgx_utils.h>
+#include <stdint.h>
 #include <string.h>
+#include "report_ring.h"
+#include "sgx_binding.h"
+#include "sgx_session.h"
+
+// Public key || key_nonce: the MAC text sealed with the private key
+#define SESSION_KEY_TEXT_SIZE (SGX_SESSION_PUBLIC_KEY_SIZE + SGX_BINDING_NONCE_SIZE)
+// Sealed session keys carry key_nonce as MAC text, sealed tickets
+// key_nonce || ticket
+#define SESSION_TEXT_MAX (SGX_BINDING_NONCE_SIZE + SGX_RESUMPTION_TICKET_MAX)
+
+// The private and session keys are both 32-byte secrets, so the MAC text
+// starts with a tag saying which one a blob holds; callers check it before
+// using the secret
+#define SEALED_TAG_SIZE 1
+#define SEALED_TAG_PRIVATE_KEY 0x01
+#define SEALED_TAG_SESSION_KEY 0x02
+#define SEALED_TAG_TICKET 0x03       /* session key with a resumption ticket */
 
 int ecall_generate_report_for_quote(
     uint8_t *report_data,
@@ -42,3 +64,582 @@ int ecall_generate_report_for_quote(
     memcpy(report_data, &report, sizeof(sgx_report_t));
     return 0;
 }
+
+int ecall_generate_report_switchless(
+    uint8_t *report_data,
+    size_t report_size,
+    uint8_t *target_info,
+    size_t target_info_size,
+    uint8_t *custom_report_data,
+    size_t report_data_size)
+{
+    // Identical work; only the transition mechanism differs
+    return ecall_generate_report_for_quote(
+        report_data, report_size,
+        target_info, target_info_size,
+        custom_report_data, report_data_size);
+}
+
+int ecall_generate_report_batch(
+    uint8_t *reports,
+    size_t reports_size,
+    uint8_t *target_info,
+    size_t target_info_size,
+    uint8_t *nonces,
+    size_t nonces_size,
+    size_t report_count)
+{
+    if (report_count == 0 || report_count > SIZE_MAX / sizeof(sgx_report_t)) {
+        return -1;
+    }
+    
+    if (reports_size < report_count * sizeof(sgx_report_t) ||
+        nonces_size < report_count * sizeof(sgx_report_data_t)) {
+        return -1;
+    }
+    
+    if (target_info_size != sizeof(sgx_target_info_t)) {
+        return -2;
+    }
+    
+    // Single EENTER/EEXIT for the whole batch: the target info is shared,
+    // only report_data changes per report
+    for (size_t i = 0; i < report_count; i++) {
+        sgx_report_t report;
+        sgx_report_data_t report_d;
+        memcpy(&report_d, nonces + i * sizeof(sgx_report_data_t), sizeof(report_d));
+        
+        sgx_status_t ret = sgx_create_report(
+            (const sgx_target_info_t*)target_info,
+            &report_d,
+            &report
+        );
+        
+        if (ret != SGX_SUCCESS) {
+            return -3;
+        }
+        
+        memcpy(reports + i * sizeof(sgx_report_t), &report, sizeof(sgx_report_t));
+    }
+    
+    return 0;
+}
+
+static_assert(sizeof(report_ring_slot_t) == REPORT_RING_SLOT_SIZE, "report ring slot layout");
+
+// Registered ring (report_ring.h); the pointer and target info live in
+// enclave memory, so the host can change slot contents but not which slots
+static report_ring_slot_t* g_ring_slots = NULL;
+static size_t g_ring_slot_count = 0;
+static sgx_target_info_t g_ring_target_info;
+
+int ecall_register_report_ring(
+    uint8_t *slots,
+    size_t slot_count,
+    uint8_t *target_info,
+    size_t target_info_size)
+{
+    if (slots == NULL) {
+        g_ring_slots = NULL;
+        g_ring_slot_count = 0;
+        return 0;
+    }
+    
+    if (slot_count == 0 || slot_count > REPORT_RING_SLOTS_MAX ||
+        (uintptr_t)slots % REPORT_RING_ALIGN != 0 ||
+        !sgx_is_outside_enclave(slots, slot_count * sizeof(report_ring_slot_t))) {
+        return -1;
+    }
+    
+    if (target_info_size != sizeof(sgx_target_info_t)) {
+        return -2;
+    }
+    
+    memcpy(&g_ring_target_info, target_info, sizeof(g_ring_target_info));
+    g_ring_slots = (report_ring_slot_t*)slots;
+    g_ring_slot_count = slot_count;
+    return 0;
+}
+
+int ecall_generate_report_ring(
+    size_t first,
+    size_t count)
+{
+    if (g_ring_slots == NULL) {
+        return -2;
+    }
+    
+    if (count == 0 || count > g_ring_slot_count || first >= g_ring_slot_count) {
+        return -1;
+    }
+    // No slot is touched on a speculated path past the range check
+    sgx_lfence();
+    
+    int result = 0;
+    for (size_t i = 0; i < count; i++) {
+        size_t index = first + i;
+        if (index >= g_ring_slot_count) {
+            index -= g_ring_slot_count;
+        }
+        report_ring_slot_t* slot = &g_ring_slots[index];
+        if (!sgx_is_outside_enclave(slot, sizeof(*slot))) {
+            return -1;
+        }
+        
+        // One read of the input and one write of each output, straight
+        // from and to the ring: no bridge copy, no trusted heap
+        sgx_report_data_t report_d;
+        memcpy(&report_d, &slot->report_data, sizeof(report_d));
+        
+        sgx_report_t report;
+        if (sgx_create_report(&g_ring_target_info, &report_d, &report) != SGX_SUCCESS) {
+            slot->status = -3;
+            result = -3;
+            continue;
+        }
+        
+        memcpy(&slot->report, &report, sizeof(report));
+        slot->status = 0;
+    }
+    
+    return result;
+}
+
+// MRENCLAVE || purpose; the nonce goes in the tail. sgx_self_report() is
+// generated once by the trusted runtime, so this costs no EREPORT.
+static void binding_message_init(uint8_t message[SGX_BINDING_MESSAGE_SIZE])
+{
+    const sgx_report_t* self = sgx_self_report();
+    memcpy(message, self->body.mr_enclave.m, SGX_BINDING_MRENCLAVE_SIZE);
+    memcpy(message + SGX_BINDING_MRENCLAVE_SIZE, SGX_BINDING_PURPOSE, SGX_BINDING_PURPOSE_LEN);
+}
+
+static int create_binding_report(
+    const sgx_target_info_t* target_info,
+    uint8_t message[SGX_BINDING_MESSAGE_SIZE],
+    const uint8_t* nonce,
+    uint8_t* report_out,
+    uint8_t* binding_out)
+{
+    memcpy(message + SGX_BINDING_MESSAGE_SIZE - SGX_BINDING_NONCE_SIZE, nonce,
+           SGX_BINDING_NONCE_SIZE);
+    
+    // report_data = binding | nonce
+    sgx_report_data_t report_d;
+    if (sgx_sha256_msg(message, SGX_BINDING_MESSAGE_SIZE,
+                       (sgx_sha256_hash_t*)report_d.d) != SGX_SUCCESS) {
+        return -4;
+    }
+    memcpy(report_d.d + SGX_BINDING_NONCE_OFFSET, nonce, SGX_BINDING_NONCE_SIZE);
+    
+    sgx_report_t report;
+    if (sgx_create_report(target_info, &report_d, &report) != SGX_SUCCESS) {
+        return -3;
+    }
+    
+    memcpy(report_out, &report, sizeof(sgx_report_t));
+    memcpy(binding_out, report_d.d, SGX_BINDING_SIZE);
+    return 0;
+}
+
+int ecall_generate_binding_report(
+    uint8_t *report,
+    size_t report_size,
+    uint8_t *target_info,
+    size_t target_info_size,
+    uint8_t *nonce,
+    size_t nonce_size,
+    uint8_t *binding,
+    size_t binding_size)
+{
+    if (report_size < sizeof(sgx_report_t) || nonce_size != SGX_BINDING_NONCE_SIZE ||
+        binding_size < SGX_BINDING_SIZE) {
+        return -1;
+    }
+    
+    if (target_info_size != sizeof(sgx_target_info_t)) {
+        return -2;
+    }
+    
+    uint8_t message[SGX_BINDING_MESSAGE_SIZE];
+    binding_message_init(message);
+    return create_binding_report((const sgx_target_info_t*)target_info, message,
+                                 nonce, report, binding);
+}
+
+int ecall_generate_binding_report_batch(
+    uint8_t *reports,
+    size_t reports_size,
+    uint8_t *target_info,
+    size_t target_info_size,
+    uint8_t *nonces,
+    size_t nonces_size,
+    uint8_t *bindings,
+    size_t bindings_size,
+    size_t report_count)
+{
+    if (report_count == 0 || report_count > SIZE_MAX / sizeof(sgx_report_t)) {
+        return -1;
+    }
+    
+    if (reports_size < report_count * sizeof(sgx_report_t) ||
+        nonces_size < report_count * SGX_BINDING_NONCE_SIZE ||
+        bindings_size < report_count * SGX_BINDING_SIZE) {
+        return -1;
+    }
+    
+    if (target_info_size != sizeof(sgx_target_info_t)) {
+        return -2;
+    }
+    
+    // The MRENCLAVE || purpose prefix is laid out once for the whole batch;
+    // each digest only rewrites the nonce tail. sgx_sha256_msg() is the
+    // SDK's IPP SHA-256, which dispatches to SHA-NI/AVX2 where available.
+    uint8_t message[SGX_BINDING_MESSAGE_SIZE];
+    binding_message_init(message);
+    for (size_t i = 0; i < report_count; i++) {
+        int ret = create_binding_report(
+            (const sgx_target_info_t*)target_info, message,
+            nonces + i * SGX_BINDING_NONCE_SIZE,
+            reports + i * sizeof(sgx_report_t),
+            bindings + i * SGX_BINDING_SIZE);
+        if (ret != 0) {
+            return ret;
+        }
+    }
+    
+    return 0;
+}
+
+// Sealed to this enclave's measurement only, so another enclave from the same
+// signer cannot open a session key. The MAC text is tag || mac_text.
+static int seal_secret(
+    uint8_t tag,
+    const uint8_t* secret,
+    uint32_t secret_size,
+    const uint8_t* mac_text,
+    uint32_t mac_text_size,
+    uint8_t* sealed,
+    size_t sealed_size)
+{
+    if (mac_text_size > SESSION_TEXT_MAX) {
+        return -1;
+    }
+    uint8_t text[SEALED_TAG_SIZE + SESSION_TEXT_MAX];
+    uint32_t text_size = SEALED_TAG_SIZE + mac_text_size;
+    text[0] = tag;
+    memcpy(text + SEALED_TAG_SIZE, mac_text, mac_text_size);
+    uint32_t needed = sgx_calc_sealed_data_size(text_size, secret_size);
+    if (needed == UINT32_MAX || needed > sealed_size) {
+        return -1;
+    }
+    
+    sgx_attributes_t attribute_mask;
+    attribute_mask.flags = TSEAL_DEFAULT_FLAGSMASK;
+    attribute_mask.xfrm = 0;
+    sgx_status_t ret = sgx_seal_data_ex(
+        SGX_KEYPOLICY_MRENCLAVE, attribute_mask, TSEAL_DEFAULT_MISCMASK,
+        text_size, text, secret_size, secret,
+        needed, (sgx_sealed_data_t*)sealed);
+    return ret == SGX_SUCCESS ? 0 : -5;
+}
+
+// mac_text_size: buffer size in, MAC text length (without the tag) out.
+// The caller must check `tag` before using the secret.
+static int unseal_secret(
+    const uint8_t* sealed,
+    size_t sealed_size,
+    uint8_t* tag,
+    uint8_t* secret,
+    uint32_t secret_size,
+    uint8_t* mac_text,
+    uint32_t* mac_text_size)
+{
+    if (sealed_size < sizeof(sgx_sealed_data_t)) {
+        return -1;
+    }
+    
+    // Both lengths come from the untrusted blob: check them before unsealing
+    const sgx_sealed_data_t* blob = (const sgx_sealed_data_t*)sealed;
+    uint32_t text_len = sgx_get_encrypt_txt_len(blob);
+    uint32_t mac_len = sgx_get_add_mac_txt_len(blob);
+    uint32_t needed = sgx_calc_sealed_data_size(mac_len, text_len);
+    if (text_len != secret_size || mac_len < SEALED_TAG_SIZE ||
+        mac_len - SEALED_TAG_SIZE > *mac_text_size ||
+        mac_len - SEALED_TAG_SIZE > SESSION_TEXT_MAX ||
+        needed == UINT32_MAX || needed > sealed_size) {
+        return -5;
+    }
+    
+    uint8_t text[SEALED_TAG_SIZE + SESSION_TEXT_MAX];
+    if (sgx_unseal_data(blob, text, &mac_len, secret, &text_len) != SGX_SUCCESS) {
+        return -5;
+    }
+    *tag = text[0];
+    memcpy(mac_text, text + SEALED_TAG_SIZE, mac_len - SEALED_TAG_SIZE);
+    *mac_text_size = mac_len - SEALED_TAG_SIZE;
+    return 0;
+}
+
+int ecall_generate_composite_report(
+    uint8_t *report,
+    size_t report_size,
+    uint8_t *target_info,
+    size_t target_info_size,
+    uint8_t *nonce,
+    size_t nonce_size,
+    uint8_t *binding,
+    size_t binding_size,
+    uint8_t *public_key,
+    size_t public_key_size,
+    uint8_t *sealed_key,
+    size_t sealed_size)
+{
+    if (report_size < sizeof(sgx_report_t) || nonce_size != SGX_BINDING_NONCE_SIZE ||
+        binding_size < SGX_BINDING_SIZE || public_key_size != SGX_SESSION_PUBLIC_KEY_SIZE) {
+        return -1;
+    }
+    
+    if (target_info_size != sizeof(sgx_target_info_t)) {
+        return -2;
+    }
+    
+    // Ephemeral key pair, one per attestation
+    sgx_ecc_state_handle_t ecc = NULL;
+    if (sgx_ecc256_open_context(&ecc) != SGX_SUCCESS) {
+        return -6;
+    }
+    sgx_ec256_private_t private_key;
+    sgx_ec256_public_t session_public;
+    sgx_status_t status = sgx_ecc256_create_key_pair(&private_key, &session_public, ecc);
+    sgx_ecc256_close_context(ecc);
+    if (status != SGX_SUCCESS) {
+        return -6;
+    }
+    
+    // key_nonce = SHA256(public_key || nonce) goes where the binding nonce goes
+    uint8_t key_input[SGX_SESSION_PUBLIC_KEY_SIZE + SGX_BINDING_NONCE_SIZE];
+    memcpy(key_input, &session_public, SGX_SESSION_PUBLIC_KEY_SIZE);
+    memcpy(key_input + SGX_SESSION_PUBLIC_KEY_SIZE, nonce, SGX_BINDING_NONCE_SIZE);
+    uint8_t key_text[SESSION_KEY_TEXT_SIZE];
+    memcpy(key_text, &session_public, SGX_SESSION_PUBLIC_KEY_SIZE);
+    if (sgx_sha256_msg(key_input, sizeof(key_input),
+                       (sgx_sha256_hash_t*)(key_text + SGX_SESSION_PUBLIC_KEY_SIZE)) != SGX_SUCCESS) {
+        memset_s(&private_key, sizeof(private_key), 0, sizeof(private_key));
+        return -4;
+    }
+    
+    uint8_t message[SGX_BINDING_MESSAGE_SIZE];
+    binding_message_init(message);
+    int ret = create_binding_report((const sgx_target_info_t*)target_info, message,
+                                    key_text + SGX_SESSION_PUBLIC_KEY_SIZE, report, binding);
+    if (ret == 0) {
+        ret = seal_secret(SEALED_TAG_PRIVATE_KEY, private_key.r, sizeof(private_key.r),
+                          key_text, sizeof(key_text), sealed_key, sealed_size);
+    }
+    memset_s(&private_key, sizeof(private_key), 0, sizeof(private_key));
+    if (ret != 0) {
+        return ret;
+    }
+    
+    memcpy(public_key, &session_public, SGX_SESSION_PUBLIC_KEY_SIZE);
+    return 0;
+}
+
+int ecall_open_session(
+    uint8_t *sealed_key,
+    size_t sealed_size,
+    uint8_t *peer_public_key,
+    size_t peer_key_size,
+    uint8_t *sealed_session,
+    size_t session_size)
+{
+    if (peer_key_size != SGX_SESSION_PUBLIC_KEY_SIZE) {
+        return -1;
+    }
+    
+    sgx_ec256_private_t private_key;
+    uint8_t key_text[SESSION_KEY_TEXT_SIZE];
+    uint32_t key_text_len = sizeof(key_text);
+    uint8_t tag = 0;
+    int ret = unseal_secret(sealed_key, sealed_size, &tag, private_key.r, sizeof(private_key.r),
+                            key_text, &key_text_len);
+    if (ret == 0 && (tag != SEALED_TAG_PRIVATE_KEY || key_text_len != sizeof(key_text))) {
+        ret = -5;
+    }
+    if (ret != 0) {
+        memset_s(&private_key, sizeof(private_key), 0, sizeof(private_key));
+        return ret;
+    }
+    
+    // Reject points off the curve before using them in ECDH
+    sgx_ecc_state_handle_t ecc = NULL;
+    sgx_ec256_dh_shared_t shared;
+    int valid = 0;
+    sgx_status_t status = sgx_ecc256_open_context(&ecc);
+    if (status == SGX_SUCCESS) {
+        status = sgx_ecc256_check_point((const sgx_ec256_public_t*)peer_public_key, ecc, &valid);
+        if (status == SGX_SUCCESS && valid) {
+            status = sgx_ecc256_compute_shared_dhkey(
+                &private_key, (const sgx_ec256_public_t*)peer_public_key, &shared, ecc);
+        }
+        sgx_ecc256_close_context(ecc);
+    }
+    memset_s(&private_key, sizeof(private_key), 0, sizeof(private_key));
+    if (status != SGX_SUCCESS || !valid) {
+        return -6;
+    }
+    
+    // session_key = SHA256(x || label || key_nonce), x big-endian
+    uint8_t kdf_input[SGX_SESSION_COORD_SIZE + SGX_SESSION_LABEL_LEN + SGX_BINDING_NONCE_SIZE];
+    for (size_t i = 0; i < SGX_SESSION_COORD_SIZE; i++) {
+        kdf_input[i] = shared.s[SGX_SESSION_COORD_SIZE - 1 - i];
+    }
+    memcpy(kdf_input + SGX_SESSION_COORD_SIZE, SGX_SESSION_LABEL, SGX_SESSION_LABEL_LEN);
+    memcpy(kdf_input + SGX_SESSION_COORD_SIZE + SGX_SESSION_LABEL_LEN,
+           key_text + SGX_SESSION_PUBLIC_KEY_SIZE, SGX_BINDING_NONCE_SIZE);
+    sgx_sha256_hash_t session_key;
+    ret = sgx_sha256_msg(kdf_input, sizeof(kdf_input), &session_key) == SGX_SUCCESS ? 0 : -4;
+    if (ret == 0) {
+        ret = seal_secret(SEALED_TAG_SESSION_KEY, session_key, sizeof(session_key),
+                          key_text + SGX_SESSION_PUBLIC_KEY_SIZE, SGX_BINDING_NONCE_SIZE,
+                          sealed_session, session_size);
+    }
+    
+    memset_s(&shared, sizeof(shared), 0, sizeof(shared));
+    memset_s(kdf_input, sizeof(kdf_input), 0, sizeof(kdf_input));
+    memset_s(session_key, sizeof(session_key), 0, sizeof(session_key));
+    return ret;
+}
+
+// A sealed session key (key_nonce only) or sealed ticket (key_nonce || ticket);
+// `tag` says which, and the caller checks it is one it takes
+static int unseal_session(
+    const uint8_t* sealed,
+    size_t sealed_size,
+    uint8_t* tag,
+    uint8_t session_key[SGX_SESSION_KEY_SIZE],
+    uint8_t text[SESSION_TEXT_MAX],
+    uint32_t* text_len)
+{
+    *text_len = SESSION_TEXT_MAX;
+    int ret = unseal_secret(sealed, sealed_size, tag, session_key, SGX_SESSION_KEY_SIZE,
+                            text, text_len);
+    bool session = *tag == SEALED_TAG_SESSION_KEY && *text_len == SGX_BINDING_NONCE_SIZE;
+    bool ticket = *tag == SEALED_TAG_TICKET && *text_len > SGX_BINDING_NONCE_SIZE;
+    if (ret == 0 && !session && !ticket) {
+        ret = -5;
+    }
+    if (ret != 0) {
+        memset_s(session_key, SGX_SESSION_KEY_SIZE, 0, SGX_SESSION_KEY_SIZE);
+    }
+    return ret;
+}
+
+int ecall_session_mac(
+    uint8_t *sealed_session,
+    size_t session_size,
+    uint8_t *message,
+    size_t message_size,
+    uint8_t *mac,
+    size_t mac_size)
+{
+    if (message_size == 0 || message_size > INT32_MAX || mac_size < SGX_SESSION_MAC_SIZE) {
+        return -1;
+    }
+    
+    // Either kind holds the session key; a private key is never accepted here
+    uint8_t session_key[SGX_SESSION_KEY_SIZE];
+    uint8_t text[SESSION_TEXT_MAX];
+    uint32_t text_len = 0;
+    uint8_t tag = 0;
+    int ret = unseal_session(sealed_session, session_size, &tag, session_key, text, &text_len);
+    if (ret != 0) {
+        return ret;
+    }
+    
+    sgx_status_t status = sgx_hmac_sha256_msg(message, (int)message_size,
+                                              session_key, sizeof(session_key),
+                                              mac, SGX_SESSION_MAC_SIZE);
+    memset_s(session_key, sizeof(session_key), 0, sizeof(session_key));
+    return status == SGX_SUCCESS ? 0 : -4;
+}
+
+int ecall_seal_ticket(
+    uint8_t *sealed_session,
+    size_t session_size,
+    uint8_t *ticket,
+    size_t ticket_size,
+    uint8_t *sealed_ticket,
+    size_t sealed_ticket_size)
+{
+    if (ticket_size == 0 || ticket_size > SGX_RESUMPTION_TICKET_MAX) {
+        return -1;
+    }
+    
+    uint8_t session_key[SGX_SESSION_KEY_SIZE];
+    uint8_t text[SESSION_TEXT_MAX];
+    uint32_t text_len = 0;
+    uint8_t tag = 0;
+    int ret = unseal_session(sealed_session, session_size, &tag, session_key, text, &text_len);
+    if (ret != 0) {
+        return ret;
+    }
+    
+    // The ticket replaces any previous one behind the key_nonce
+    memcpy(text + SGX_BINDING_NONCE_SIZE, ticket, ticket_size);
+    ret = seal_secret(SEALED_TAG_TICKET, session_key, sizeof(session_key),
+                      text, (uint32_t)(SGX_BINDING_NONCE_SIZE + ticket_size),
+                      sealed_ticket, sealed_ticket_size);
+    memset_s(session_key, sizeof(session_key), 0, sizeof(session_key));
+    return ret;
+}
+
+int ecall_resume_proof(
+    uint8_t *sealed_ticket,
+    size_t sealed_ticket_size,
+    uint8_t *challenge,
+    size_t challenge_size,
+    uint8_t *ticket,
+    size_t ticket_capacity,
+    size_t *ticket_size,
+    uint8_t *proof,
+    size_t proof_size)
+{
+    if (challenge_size != SGX_RESUME_CHALLENGE_SIZE || proof_size < SGX_SESSION_MAC_SIZE) {
+        return -1;
+    }
+    
+    uint8_t session_key[SGX_SESSION_KEY_SIZE];
+    uint8_t text[SESSION_TEXT_MAX];
+    uint32_t text_len = 0;
+    uint8_t tag = 0;
+    int ret = unseal_session(sealed_ticket, sealed_ticket_size, &tag, session_key, text,
+                             &text_len);
+    if (ret != 0) {
+        return ret;
+    }
+    size_t len = text_len - SGX_BINDING_NONCE_SIZE;
+    if (tag != SEALED_TAG_TICKET || len > ticket_capacity) {
+        memset_s(session_key, sizeof(session_key), 0, sizeof(session_key));
+        return tag != SEALED_TAG_TICKET ? -5 : -1;
+    }
+    
+    // proof = HMAC(session key, label || challenge || ticket)
+    uint8_t message[SGX_RESUME_LABEL_LEN + SGX_RESUME_CHALLENGE_SIZE + SGX_RESUMPTION_TICKET_MAX];
+    memcpy(message, SGX_RESUME_LABEL, SGX_RESUME_LABEL_LEN);
+    memcpy(message + SGX_RESUME_LABEL_LEN, challenge, SGX_RESUME_CHALLENGE_SIZE);
+    memcpy(message + SGX_RESUME_LABEL_LEN + SGX_RESUME_CHALLENGE_SIZE,
+           text + SGX_BINDING_NONCE_SIZE, len);
+    sgx_status_t status = sgx_hmac_sha256_msg(
+        message, (int)(SGX_RESUME_LABEL_LEN + SGX_RESUME_CHALLENGE_SIZE + len),
+        session_key, sizeof(session_key), proof, SGX_SESSION_MAC_SIZE);
+    memset_s(session_key, sizeof(session_key), 0, sizeof(session_key));
+    if (status != SGX_SUCCESS) {
+        return -4;
+    }
+    
+    memcpy(ticket, text + SGX_BINDING_NONCE_SIZE, len);
+    *ticket_size = len;
+    return 0;
+}
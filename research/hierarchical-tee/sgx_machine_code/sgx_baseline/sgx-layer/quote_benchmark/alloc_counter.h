@@ -0,0 +1,16 @@
+#ifndef ALLOC_COUNTER_H
+#define ALLOC_COUNTER_H
+
+#include <stdint.h>
+
+/*
+ * Process-wide count of heap allocations.
+ *
+ * alloc_counter.cpp interposes malloc/calloc/realloc/posix_memalign on
+ * glibc and forwards to the __libc_* entry points, so allocations made
+ * inside the quote library and AESM client are counted as well as our
+ * own. Diff two readings around a loop to get allocations per quote.
+ */
+uint64_t alloc_count();
+
+#endif /* ALLOC_COUNTER_H */
@@ -0,0 +1,266 @@
+#include "attestation_context.h"
+
+#include <string.h>
+#include <time.h>
+#include <chrono>
+#include <sgx_quote_3.h>
+#include "bench_clock.h"
+#include "quote_verifier.h"
+
+#define REFRESH_LEAD_S 3600    /* re-fetch collateral this long before nextUpdate */
+#define REFRESH_MIN_WAIT_S 300
+
+AttestationContext::AttestationContext()
+    : quote_size_(0), generation_(0), refresh_count_(0), cold_start_ms_(0), refreshing_(false),
+      last_refresh_status_(SGX_QL_ERROR_UNEXPECTED), stopping_(false), reference_generation_(0), collateral_warm_ms_(0),
+      background_refreshes_(0) {
+    memset(&target_info_, 0, sizeof(target_info_));
+}
+
+AttestationContext::~AttestationContext() {
+    stop_refresher();
+}
+
+quote3_error_t AttestationContext::init() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    double start = bench_now_ms();
+    quote3_error_t ret = refresh_locked(&lock, true);
+    cold_start_ms_ = bench_now_ms() - start;
+    return ret;
+}
+
+uint64_t AttestationContext::target_info(sgx_target_info_t* out) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    memcpy(out, &target_info_, sizeof(target_info_));
+    return generation_;
+}
+
+uint32_t AttestationContext::quote_size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return quote_size_;
+}
+
+int AttestationContext::refresh_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return refresh_count_;
+}
+
+int AttestationContext::background_refreshes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return background_refreshes_;
+}
+
+double AttestationContext::collateral_warm_ms() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return collateral_warm_ms_;
+}
+
+bool AttestationContext::is_refresh_error(quote3_error_t err) {
+    switch (err) {
+    case SGX_QL_INVALID_REPORT:             /* report targets an old QE identity */
+    case SGX_QL_ATT_KEY_NOT_INITIALIZED:    /* QE restarted and lost its key */
+    case SGX_QL_ATT_KEY_CERT_DATA_INVALID:  /* PCK cert data changed (TCB recovery) */
+    case SGX_QL_ERROR_PUB_KEY_ID_MISMATCH:
+    case SGX_QL_ERROR_ECDSA_ID_MISMATCH:
+    case SGX_QL_ENCLAVE_LOST:
+    case SGX_QL_ERROR_INVALID_PARAMETER:    /* quote size grew after a TCB change */
+        return true;
+    default:
+        return false;
+    }
+}
+
+quote3_error_t AttestationContext::get_quote(const sgx_report_t* report, uint64_t generation,
+                                             uint32_t quote_capacity, uint8_t* quote) {
+    quote3_error_t ret = sgx_qe_get_quote(report, quote_capacity, quote);
+    if (ret == SGX_QL_SUCCESS) {
+        // One copy per generation for the refresher; the fast path is an atomic load
+        if (reference_generation_.load(std::memory_order_relaxed) != generation) {
+            record_reference(quote, quote_capacity, generation);
+        }
+        return ret;
+    }
+    if (!is_refresh_error(ret)) {
+        return ret;
+    }
+    
+    std::unique_lock<std::mutex> lock(mutex_);
+    // Another thread may already have refreshed for this stale generation
+    if (generation == generation_) {
+        refresh_locked(&lock, true);
+    }
+    return ret;
+}
+
+quote3_error_t AttestationContext::refresh() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return refresh_locked(&lock, true);
+}
+
+quote3_error_t AttestationContext::fetch(sgx_target_info_t* target_info, uint32_t* quote_size) {
+    quote3_error_t ret = sgx_qe_get_target_info(target_info);
+    if (ret != SGX_QL_SUCCESS) {
+        return ret;
+    }
+    return sgx_qe_get_quote_size(quote_size);
+}
+
+quote3_error_t AttestationContext::refresh_locked(std::unique_lock<std::mutex>* lock, bool force) {
+    // Waiters get the outcome of the fetch they waited for, not a blanket success
+    if (refreshing_) {
+        refreshed_.wait(*lock, [this] { return !refreshing_; });
+        return last_refresh_status_;
+    }
+    refreshing_ = true;
+    lock->unlock();
+    
+    sgx_target_info_t target_info;
+    uint32_t quote_size = 0;
+    quote3_error_t ret = fetch(&target_info, &quote_size);
+    
+    lock->lock();
+    refreshing_ = false;
+    last_refresh_status_ = ret;
+    refreshed_.notify_all();
+    if (ret != SGX_QL_SUCCESS) {
+        return ret;
+    }
+    // A background check that found nothing new leaves outstanding reports valid
+    bool changed = quote_size != quote_size_ ||
+                   memcmp(&target_info, &target_info_, sizeof(target_info_)) != 0;
+    if (!force && !changed) {
+        return SGX_QL_SUCCESS;
+    }
+    memcpy(&target_info_, &target_info, sizeof(target_info_));
+    quote_size_ = quote_size;
+    if (generation_ != 0) {
+        refresh_count_++;
+    }
+    generation_++;
+    return SGX_QL_SUCCESS;
+}
+
+void AttestationContext::record_reference(const uint8_t* quote, uint32_t capacity,
+                                          uint64_t generation) {
+    // Header, report body and signature length, then the signature itself
+    if (capacity < sizeof(sgx_quote3_t)) {
+        return;
+    }
+    size_t len = sizeof(sgx_quote3_t) + ((const sgx_quote3_t*)quote)->signature_data_len;
+    if (len > capacity) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (generation != generation_ || reference_generation_.load() == generation) {
+        return;
+    }
+    reference_quote_.assign(quote, quote + len);
+    reference_generation_.store(generation);
+    wake_.notify_all();
+}
+
+void AttestationContext::start_refresher(int interval_s, const QuoteVerifier* verifier) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (refresher_.joinable() || interval_s <= 0) {
+        return;
+    }
+    stopping_ = false;
+    refresher_ = std::thread(&AttestationContext::refresher_loop, this, interval_s, verifier);
+}
+
+void AttestationContext::stop_refresher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        wake_.notify_all();
+    }
+    if (refresher_.joinable()) {
+        refresher_.join();
+    }
+}
+
+bool AttestationContext::wait_warm(int timeout_ms) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return warm_.wait_for(lock, std::chrono::milliseconds(timeout_ms),
+                          [this] { return collateral_warm_ms_ > 0; });
+}
+
+/* One platform's collateral as the refresher tracks it. */
+struct collateral_entry_t {
+    collateral_key_t key;
+    std::vector<uint8_t> quote;   /* latest quote from the platform, to fetch with */
+    int64_t refresh_at;           /* 0: due now */
+};
+
+void AttestationContext::refresher_loop(int interval_s, const QuoteVerifier* verifier) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    std::vector<collateral_entry_t> entries;
+    uint64_t adopted_generation = 0;
+    time_t check_at = time(NULL) + interval_s;
+    while (!stopping_) {
+        // A new platform key is due at once; a known one keeps its schedule
+        if (verifier && !reference_quote_.empty() &&
+            reference_generation_.load() != adopted_generation) {
+            adopted_generation = reference_generation_.load();
+            byte_span_t span = {reference_quote_.data(), reference_quote_.size()};
+            collateral_key_t key;
+            if (quote_collateral_key(span, &key)) {
+                size_t e = 0;
+                while (e < entries.size() &&
+                       memcmp(&entries[e].key, &key, sizeof(collateral_key_t)) != 0) {
+                    e++;
+                }
+                if (e == entries.size()) {
+                    entries.push_back(collateral_entry_t());
+                    entries[e].key = key;
+                    entries[e].refresh_at = 0;
+                }
+                entries[e].quote = reference_quote_;
+            }
+        }
+        
+        time_t now = time(NULL);
+        int64_t wake_at = check_at;
+        size_t due = entries.size();
+        for (size_t e = 0; e < entries.size(); e++) {
+            if (entries[e].refresh_at <= now) {
+                due = e;
+                break;
+            }
+            wake_at = entries[e].refresh_at < wake_at ? entries[e].refresh_at : wake_at;
+        }
+        if (due == entries.size() && now < check_at) {
+            wake_.wait_for(lock, std::chrono::seconds(wake_at - now), [&] {
+                return stopping_ || (verifier && reference_generation_.load() != adopted_generation);
+            });
+            continue;
+        }
+        
+        if (due == entries.size()) {
+            refresh_locked(&lock, false);
+            background_refreshes_++;
+            check_at = time(NULL) + interval_s;
+            continue;
+        }
+        
+        // Only this entry is re-fetched; the others wait for their own nextUpdate
+        std::vector<uint8_t> quote(entries[due].quote);
+        lock.unlock();
+        
+        double start = bench_now_ms();
+        byte_span_t span = {quote.data(), quote.size()};
+        int64_t fetched = verifier->prefetch_collateral(span, time(NULL));
+        double elapsed = bench_now_ms() - start;
+        
+        lock.lock();
+        now = time(NULL);
+        int64_t refresh_at = fetched - REFRESH_LEAD_S;
+        entries[due].refresh_at = refresh_at > now + REFRESH_MIN_WAIT_S ? refresh_at
+                                                                        : now + REFRESH_MIN_WAIT_S;
+        if (fetched > 0 && collateral_warm_ms_ == 0) {
+            collateral_warm_ms_ = elapsed > 0 ? elapsed : 1e-6;
+            warm_.notify_all();
+        }
+    }
+}
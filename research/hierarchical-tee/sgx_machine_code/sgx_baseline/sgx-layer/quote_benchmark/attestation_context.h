@@ -0,0 +1,111 @@
+#ifndef ATTESTATION_CONTEXT_H
+#define ATTESTATION_CONTEXT_H
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <sgx_report.h>
+#include <sgx_dcap_ql_wrapper.h>
+
+class QuoteVerifier;
+
+/*
+ * Process-wide cache of the Quoting Enclave target info and quote size.
+ *
+ * sgx_qe_get_target_info() and sgx_qe_get_quote_size() can go through
+ * AESM/PCE and sometimes PCCS, so they are fetched once by init() and
+ * shared by every benchmark phase and worker thread. The cache is only
+ * refreshed when sgx_qe_get_quote() reports that the QE identity, its
+ * attestation key or the platform TCB changed underneath us.
+ *
+ * Each snapshot carries a generation number. A report built from an old
+ * generation is stale after a refresh and must be regenerated; passing the
+ * generation back to get_quote() also makes sure concurrent failures from
+ * the same stale snapshot trigger a single refresh.
+ *
+ * Re-fetches run without the lock held, so target_info() never waits on a
+ * PCCS round trip. start_refresher() adds a background thread that keeps
+ * the quote provider's caches warm ahead of the foreground:
+ *
+ *   - every interval it re-fetches target info and quote size, which keeps
+ *     the PCK cert chain cached and picks up a TCB recovery before a
+ *     foreground get_quote() fails on it. The generation only moves if the
+ *     snapshot changed.
+ *   - given a verifier, it prefetches the verification collateral (TCB
+ *     info, QE identity, CRLs) for each platform key (FMSPC/CA) its quotes
+ *     carry, as soon as the first quote with that key exists. Each entry
+ *     is then re-fetched an hour before its own cached nextUpdate, not on
+ *     every interval.
+ */
+class AttestationContext {
+public:
+    AttestationContext();
+    ~AttestationContext();
+
+    /* Cold fetch of target info and quote size. */
+    quote3_error_t init();
+
+    /* Copy the cached QE target info, returns its generation. */
+    uint64_t target_info(sgx_target_info_t* out) const;
+
+    uint32_t quote_size() const;
+
+    /*
+     * sgx_qe_get_quote() on a report built from generation `generation`.
+     * On a target-info/TCB change error the cache is refreshed and the
+     * original error returned: the caller should rebuild its report.
+     */
+    quote3_error_t get_quote(const sgx_report_t* report, uint64_t generation,
+                             uint32_t quote_capacity, uint8_t* quote);
+
+    /* Unconditionally re-fetch from the quote library. */
+    quote3_error_t refresh();
+
+    static bool is_refresh_error(quote3_error_t err);
+
+    /* `verifier` may be NULL: only the generation side is kept warm. */
+    void start_refresher(int interval_s, const QuoteVerifier* verifier);
+    void stop_refresher();
+
+    /* Wait up to timeout_ms for the startup collateral prefetch; true once done. */
+    bool wait_warm(int timeout_ms);
+
+    double cold_start_ms() const { return cold_start_ms_; }
+    /* Duration of the startup collateral prefetch, 0 until it succeeded. */
+    double collateral_warm_ms() const;
+    int refresh_count() const;
+    int background_refreshes() const;
+
+private:
+    static quote3_error_t fetch(sgx_target_info_t* target_info, uint32_t* quote_size);
+    /* Re-fetch off the lock; callers arriving meanwhile wait for that one and
+     * get its result. */
+    quote3_error_t refresh_locked(std::unique_lock<std::mutex>* lock, bool force);
+    void record_reference(const uint8_t* quote, uint32_t capacity, uint64_t generation);
+    void refresher_loop(int interval_s, const QuoteVerifier* verifier);
+
+    mutable std::mutex mutex_;
+    sgx_target_info_t target_info_;
+    uint32_t quote_size_;
+    uint64_t generation_;
+    int refresh_count_;
+    double cold_start_ms_;
+    bool refreshing_;
+    quote3_error_t last_refresh_status_;   /* of the latest fetch, for its waiters */
+    std::condition_variable refreshed_;
+
+    /* Background refresher state, under mutex_ */
+    std::thread refresher_;
+    bool stopping_;
+    std::condition_variable wake_;
+    std::condition_variable warm_;
+    std::vector<uint8_t> reference_quote_;   /* latest quote, for collateral prefetch */
+    std::atomic<uint64_t> reference_generation_;
+    double collateral_warm_ms_;
+    int background_refreshes_;
+};
+
+#endif /* ATTESTATION_CONTEXT_H */
@@ -0,0 +1,213 @@
+#include "evidence_reservoir.h"
+
+#include <math.h>
+#include <string.h>
+#include <chrono>
+#include "bench_clock.h"
+
+#define RESERVOIR_EWMA_WEIGHT 0.2
+#define RESERVOIR_RETRY_MS 100      /* after a failed production or an empty nonce batch */
+#define RESERVOIR_SPARE_BUFFERS 4   /* one in production, the rest with callers */
+
+EvidenceReservoir::EvidenceReservoir()
+    : source_(NULL), capacity_(0), freshness_ms_(0), nonce_batch_(0), stopping_(false),
+      last_take_ms_(0), interval_ms_(0), production_ms_(0) {
+    memset(&stats_, 0, sizeof(stats_));
+}
+
+EvidenceReservoir::~EvidenceReservoir() {
+    stop();
+}
+
+bool EvidenceReservoir::start(ReservoirSource* source, size_t capacity, size_t frame_size,
+                              double freshness_ms, size_t nonce_batch) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (producer_.joinable() || !source || capacity == 0 || freshness_ms <= 0 ||
+        nonce_batch == 0 || !pool_.init(frame_size, capacity + RESERVOIR_SPARE_BUFFERS)) {
+        return false;
+    }
+    source_ = source;
+    capacity_ = capacity;
+    freshness_ms_ = freshness_ms;
+    nonce_batch_ = nonce_batch;
+    batch_.resize(nonce_batch);
+    stopping_ = false;
+    producer_ = std::thread(&EvidenceReservoir::producer_loop, this);
+    return true;
+}
+
+void EvidenceReservoir::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        wake_.notify_all();
+        filled_.notify_all();
+    }
+    if (producer_.joinable()) {
+        producer_.join();
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < ready_.size(); i++) {
+        pool_.release(ready_[i].frame);
+    }
+    ready_.clear();
+}
+
+bool EvidenceReservoir::take(evidence_bundle_t* out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    double now = bench_now_ms();
+    if (last_take_ms_ > 0) {
+        double interval = now - last_take_ms_;
+        interval_ms_ = interval_ms_ == 0
+            ? interval
+            : (1 - RESERVOIR_EWMA_WEIGHT) * interval_ms_ + RESERVOIR_EWMA_WEIGHT * interval;
+    }
+    last_take_ms_ = now;
+    drop_expired_locked(now);
+    wake_.notify_all();  // demand moved, and a slot may have opened
+    
+    if (ready_.empty() || stopping_) {
+        stats_.misses++;
+        return false;
+    }
+    *out = ready_.front();
+    ready_.pop_front();
+    stats_.hits++;
+    return true;
+}
+
+void EvidenceReservoir::release(const evidence_bundle_t& bundle) {
+    pool_.release(bundle.frame);
+    std::lock_guard<std::mutex> lock(mutex_);
+    wake_.notify_all();
+}
+
+bool EvidenceReservoir::wait_depth(size_t depth, int timeout_ms) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return filled_.wait_for(lock, std::chrono::milliseconds(timeout_ms),
+                            [this, depth] { return ready_.size() >= depth || stopping_; }) &&
+           ready_.size() >= depth;
+}
+
+reservoir_stats_t EvidenceReservoir::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    double now = bench_now_ms();
+    reservoir_stats_t stats = stats_;
+    stats.depth = ready_.size();
+    stats.target_depth = target_depth_locked(now);
+    double interval = interval_ms_ > now - last_take_ms_ ? interval_ms_ : now - last_take_ms_;
+    stats.demand_per_s = interval_ms_ > 0 ? 1000.0 / interval : 0;
+    stats.production_ms = production_ms_;
+    return stats;
+}
+
+size_t EvidenceReservoir::target_depth_locked(double now_ms) const {
+    // No demand seen yet: one frame for the first session
+    if (interval_ms_ == 0) {
+        return 1;
+    }
+    // An idle stretch counts as a long interval, so the target decays with it
+    double interval = interval_ms_ > now_ms - last_take_ms_ ? interval_ms_ : now_ms - last_take_ms_;
+    double lead = ceil(2 * production_ms_ / interval);
+    double usable = floor(freshness_ms_ / interval);
+    double target = lead < usable ? lead : usable;
+    if (target < 1) {
+        return 1;
+    }
+    return target > capacity_ ? capacity_ : (size_t)target;
+}
+
+void EvidenceReservoir::drop_expired_locked(double now_ms) {
+    for (std::deque<evidence_bundle_t>::iterator it = ready_.begin(); it != ready_.end();) {
+        if (it->expires_ms > now_ms) {
+            ++it;
+            continue;
+        }
+        pool_.release(it->frame);
+        it = ready_.erase(it);
+        stats_.expired++;
+    }
+}
+
+bool EvidenceReservoir::next_nonce(std::unique_lock<std::mutex>* lock, issued_nonce_t* out) {
+    double now = bench_now_ms();
+    while (!nonces_.empty() && nonces_.front().expires_ms <= now) {
+        nonces_.pop_front();
+        stats_.nonces_expired++;
+    }
+    if (nonces_.empty()) {
+        // One verifier round trip per batch, off the lock
+        lock->unlock();
+        size_t issued = source_->issue_nonces(&batch_[0], nonce_batch_);
+        lock->lock();
+        if (issued == 0) {
+            return false;
+        }
+        stats_.nonce_batches++;
+        nonces_.insert(nonces_.end(), batch_.begin(), batch_.begin() + issued);
+    }
+    *out = nonces_.front();
+    nonces_.pop_front();
+    return true;
+}
+
+void EvidenceReservoir::producer_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        double now = bench_now_ms();
+        drop_expired_locked(now);
+        if (ready_.size() >= target_depth_locked(now)) {
+            // Full: sleep until a take() or the earliest frame expires
+            double wake_at = now + freshness_ms_;
+            for (size_t i = 0; i < ready_.size(); i++) {
+                wake_at = ready_[i].expires_ms < wake_at ? ready_[i].expires_ms : wake_at;
+            }
+            wake_.wait_for(lock, std::chrono::microseconds((int64_t)((wake_at - now) * 1000) + 1));
+            continue;
+        }
+        
+        issued_nonce_t nonce;
+        uint8_t* buffer = pool_.lease(pool_.buffer_size());
+        if (!buffer || !next_nonce(&lock, &nonce)) {
+            pool_.release(buffer);
+            wake_.wait_for(lock, std::chrono::milliseconds(RESERVOIR_RETRY_MS));
+            continue;
+        }
+        if (stopping_) {
+            pool_.release(buffer);
+            break;
+        }
+        
+        lock.unlock();
+        size_t frame_len = 0;
+        double start = bench_now_ms();
+        bool produced = source_->produce(nonce.nonce, buffer, pool_.buffer_size(), &frame_len);
+        double end = bench_now_ms();
+        lock.lock();
+        
+        if (!produced) {
+            stats_.production_failures++;
+            pool_.release(buffer);
+            wake_.wait_for(lock, std::chrono::milliseconds(RESERVOIR_RETRY_MS));
+            continue;
+        }
+        production_ms_ = production_ms_ == 0
+            ? end - start
+            : (1 - RESERVOIR_EWMA_WEIGHT) * production_ms_ + RESERVOIR_EWMA_WEIGHT * (end - start);
+        
+        evidence_bundle_t bundle;
+        bundle.frame = buffer;
+        bundle.frame_len = frame_len;
+        memcpy(bundle.nonce, nonce.nonce, SGX_BINDING_NONCE_SIZE);
+        bundle.produced_ms = end;
+        bundle.expires_ms = end + freshness_ms_ < nonce.expires_ms ? end + freshness_ms_
+                                                                   : nonce.expires_ms;
+        ready_.push_back(bundle);
+        stats_.produced++;
+        if (ready_.size() > stats_.high_water) {
+            stats_.high_water = ready_.size();
+        }
+        filled_.notify_all();
+    }
+}
@@ -0,0 +1,130 @@
+#ifndef EVIDENCE_RESERVOIR_H
+#define EVIDENCE_RESERVOIR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "quote_buffer_pool.h"
+#include "sgx_binding.h"
+
+/*
+ * Bounded reservoir of ready composite evidence frames (SGX quote + TDX
+ * token + binding), each over a one-time nonce the verifier issued ahead
+ * of time, so session setup pops a frame instead of waiting for the QE and
+ * Trust Authority.
+ *
+ * A background producer thread takes nonces from the source in batches,
+ * spends each one on exactly one frame, and stops at a target depth:
+ *
+ *   target = demand rate x (production time + one production of margin)
+ *
+ * clamped to [1, capacity] and to what demand can use up within the
+ * freshness window. Demand is an exponentially weighted moving average of
+ * the interval between take() calls, hits and misses alike. It decays
+ * while no sessions arrive, so an idle reservoir drains to one frame
+ * instead of keeping frames nobody will ask for before they expire.
+ *
+ * A frame expires at the earlier of its nonce's expiry and its production
+ * time plus the freshness window. take() drops expired frames and returns
+ * the oldest live one, or false on a miss. The caller then attests inline
+ * and should not reuse a nonce from here. Frames live in buffers of an
+ * internal QuoteBufferPool: give them back with release().
+ */
+
+typedef struct {
+    uint8_t nonce[SGX_BINDING_NONCE_SIZE];
+    double expires_ms;   /* bench_now_ms() clock */
+} issued_nonce_t;
+
+typedef struct {
+    uint8_t* frame;      /* composite_evidence.h frame, owned by the reservoir */
+    size_t frame_len;
+    uint8_t nonce[SGX_BINDING_NONCE_SIZE];
+    double produced_ms;
+    double expires_ms;
+} evidence_bundle_t;
+
+typedef struct {
+    size_t depth;
+    size_t high_water;
+    size_t target_depth;
+    uint64_t produced;
+    uint64_t production_failures;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t expired;          /* frames dropped unused */
+    uint64_t nonces_expired;   /* issued nonces that timed out before production */
+    uint64_t nonce_batches;
+    double demand_per_s;
+    double production_ms;      /* moving average */
+} reservoir_stats_t;
+
+/* Where the nonces come from and how a frame is made; called on the producer thread. */
+class ReservoirSource {
+public:
+    virtual ~ReservoirSource() {}
+
+    /* Up to `max` fresh nonces from the verifier; 0 if it issued none. */
+    virtual size_t issue_nonces(issued_nonce_t* out, size_t max) = 0;
+
+    /* A composite frame over `nonce` into `buffer`; false on failure. */
+    virtual bool produce(const uint8_t nonce[SGX_BINDING_NONCE_SIZE], uint8_t* buffer,
+                         size_t capacity, size_t* frame_len) = 0;
+};
+
+class EvidenceReservoir {
+public:
+    EvidenceReservoir();
+    ~EvidenceReservoir();
+
+    /*
+     * Allocate `capacity` frames of `frame_size` bytes and start producing.
+     * `nonce_batch` nonces are requested at a time.
+     */
+    bool start(ReservoirSource* source, size_t capacity, size_t frame_size,
+               double freshness_ms, size_t nonce_batch);
+    void stop();
+
+    /* Oldest frame still fresh, without blocking; false on a miss. */
+    bool take(evidence_bundle_t* out);
+    void release(const evidence_bundle_t& bundle);
+
+    /* Wait up to timeout_ms for at least `depth` frames; true once there. */
+    bool wait_depth(size_t depth, int timeout_ms);
+
+    reservoir_stats_t stats() const;
+
+private:
+    EvidenceReservoir(const EvidenceReservoir&);
+    EvidenceReservoir& operator=(const EvidenceReservoir&);
+
+    void producer_loop();
+    size_t target_depth_locked(double now_ms) const;
+    void drop_expired_locked(double now_ms);
+    bool next_nonce(std::unique_lock<std::mutex>* lock, issued_nonce_t* out);
+
+    QuoteBufferPool pool_;
+    ReservoirSource* source_;
+    size_t capacity_;
+    double freshness_ms_;
+    size_t nonce_batch_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;    /* producer: demand or stop */
+    std::condition_variable filled_;  /* wait_depth() */
+    std::thread producer_;
+    bool stopping_;
+    std::deque<evidence_bundle_t> ready_;
+    std::deque<issued_nonce_t> nonces_;
+    std::vector<issued_nonce_t> batch_;   /* producer thread only */
+    double last_take_ms_;
+    double interval_ms_;      /* EWMA of the time between take() calls, 0 until two */
+    double production_ms_;    /* EWMA of one produce() */
+    reservoir_stats_t stats_;
+};
+
+#endif /* EVIDENCE_RESERVOIR_H */
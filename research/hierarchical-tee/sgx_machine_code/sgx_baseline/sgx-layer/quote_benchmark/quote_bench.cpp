@@ -0,0 +1,349 @@
+#include "quote_benchmark.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include <sgx_dcap_ql_wrapper.h>
+#include "Enclave_u.h"
+#include "alloc_counter.h"
+#include "latency_histogram.h"
+
+static void print_hex(const char* label, uint8_t* data, size_t len) {
+    printf("%s (%zu bytes): ", label, len);
+    for (size_t i = 0; i < (len < 32 ? len : 32); i++) {
+        printf("%02x", data[i]);
+    }
+    if (len > 32) printf("...");
+    printf("\n");
+}
+
+int benchmark_quote_generation(sgx_enclave_id_t eid, AttestationContext* ctx,
+                               QuoteBufferPool* pool, BenchReport* report_out,
+                               int iterations) {
+    printf("\n[1/3] Benchmarking SGX Quote Generation (%d iterations)...\n", iterations);
+    printf("---------------------------------------------------------------\n");
+    
+    double total_ereport_time = 0;
+    double total_quote_time = 0;
+    double total_end_to_end = 0;
+    int successful = 0;
+    uint8_t first_header[48];
+    LatencyHistogram ereport_hist;
+    LatencyHistogram quote_hist;
+    LatencyHistogram end_to_end_hist;
+    // Raw samples for the JSON report, reserved so the loop does not allocate
+    std::vector<double> ereport_samples;
+    std::vector<double> quote_samples;
+    std::vector<double> end_to_end_samples;
+    ereport_samples.reserve(iterations);
+    quote_samples.reserve(iterations);
+    end_to_end_samples.reserve(iterations);
+    
+    // Target info for Quoting Enclave comes from the shared context
+    sgx_target_info_t qe_target_info;
+    uint32_t quote_size = ctx->quote_size();
+    
+    printf("  ✓ Quote Provider initialized (cold start: %.3f ms)\n", ctx->cold_start_ms());
+    printf("  ✓ Quote size: %u bytes\n", quote_size);
+    printf("  ✓ Quote buffer pool: %zu x %zu bytes\n\n", pool->capacity(), pool->buffer_size());
+    
+    uint64_t allocs_start = alloc_count();
+    
+    // Benchmark loop
+    for (int i = 0; i < iterations; i++) {
+        double iter_start = get_time_ms();
+        
+        uint64_t generation = ctx->target_info(&qe_target_info);
+        // A TCB change can make quotes larger
+        quote_size = ctx->quote_size();
+        uint8_t* quote_buffer = pool->lease(quote_size);
+        if (!quote_buffer) {
+            if (i == 0) {
+                printf("  [%d] ✗ No pooled buffer for a %u byte quote\n", i+1, quote_size);
+            }
+            continue;
+        }
+        
+        // Step 1: Generate EREPORT inside enclave
+        uint8_t report[sizeof(sgx_report_t)];
+        uint8_t custom_data[64] = {0};
+        snprintf((char*)custom_data, 64, "Iteration-%d", i);
+        
+        double ereport_start = get_time_ms();
+        
+        int enclave_ret;
+        sgx_status_t ret = ecall_generate_report_for_quote(
+            eid,
+            &enclave_ret,
+            report,
+            sizeof(report),
+            (uint8_t*)&qe_target_info,
+            sizeof(qe_target_info),
+            custom_data,
+            64
+        );
+        
+        double ereport_end = get_time_ms();
+        
+        if (ret != SGX_SUCCESS || enclave_ret != 0) {
+            if (i == 0) {
+                printf("  [%d] ✗ Failed to generate EREPORT: SGX=0x%x, Enclave=%d\n", 
+                       i+1, ret, enclave_ret);
+            }
+            pool->release(quote_buffer);
+            continue;
+        }
+        
+        // Step 2: Convert EREPORT to Quote using Quoting Enclave
+        double quote_start = get_time_ms();
+        
+        quote3_error_t qe3_ret = ctx->get_quote(
+            (sgx_report_t*)report,
+            generation,
+            quote_size,
+            quote_buffer
+        );
+        
+        double quote_end = get_time_ms();
+        double iter_end = get_time_ms();
+        
+        if (qe3_ret != SGX_QL_SUCCESS) {
+            if (i == 0) {
+                printf("  [%d] ✗ Failed to generate quote: 0x%x\n", i+1, qe3_ret);
+            }
+            pool->release(quote_buffer);
+            continue;
+        }
+        
+        if (successful == 0) {
+            memcpy(first_header, quote_buffer, sizeof(first_header));
+        }
+        pool->release(quote_buffer);
+        successful++;
+        
+        double ereport_time = ereport_end - ereport_start;
+        double quote_time = quote_end - quote_start;
+        double end_to_end_time = iter_end - iter_start;
+        
+        total_ereport_time += ereport_time;
+        total_quote_time += quote_time;
+        total_end_to_end += end_to_end_time;
+        ereport_hist.record_ms(ereport_time);
+        quote_hist.record_ms(quote_time);
+        end_to_end_hist.record_ms(end_to_end_time);
+        ereport_samples.push_back(ereport_time);
+        quote_samples.push_back(quote_time);
+        end_to_end_samples.push_back(end_to_end_time);
+        
+        if ((i + 1) % 20 == 0) {
+            printf("  Progress: %d/%d (successes: %d)\n", i+1, iterations, successful);
+        }
+    }
+    
+    uint64_t allocs = alloc_count() - allocs_start;
+    
+    report_out->add_latency("SGX EREPORT Generation (QE target)", ereport_samples, iterations);
+    report_out->add_latency("SGX Quote Generation (QE)", quote_samples, iterations);
+    report_out->add_field("quote_size_bytes", quote_size);
+    report_out->add_field("allocations_per_quote",
+                          successful ? (double)allocs / successful : 0);
+    report_out->add_latency("SGX End-to-End Quote", end_to_end_samples, iterations);
+    
+    printf("\n  Results Summary:\n");
+    printf("  ---------------\n");
+    printf("  Successful: %d/%d\n", successful, iterations);
+    
+    if (successful > 0) {
+        printf("  Average EREPORT time:    %.3f ms\n", total_ereport_time / successful);
+        printf("  Average Quote time:      %.3f ms\n", total_quote_time / successful);
+        printf("  Average End-to-End:      %.3f ms\n", total_end_to_end / successful);
+        printf("  Quote size:              %u bytes\n", quote_size);
+        printf("  Allocations per quote:   %.2f (QE library + AESM client)\n",
+               (double)allocs / successful);
+        
+        printf("\n  Tail Latency (%s):\n", bench_clock_source());
+        print_latency_header();
+        print_latency_row("EREPORT", ereport_hist);
+        print_latency_row("Quote (QE)", quote_hist);
+        print_latency_row("End-to-End", end_to_end_hist);
+        
+        // Parse and print quote header (first quote only)
+        printf("\n  Quote Structure (first quote):\n");
+        // Use generic byte parsing instead of sgx_quote3_t structure
+        printf("    Version: %u\n", *(uint16_t*)first_header);
+        printf("    Quote size: %u bytes\n", quote_size);
+        print_hex("    Quote header", first_header, 48);
+    }
+    
+    return successful;
+}
+
+int measure_quote_sizes(AttestationContext* ctx, BenchReport* report_out) {
+    printf("\n[2/3] Measuring Quote Sizes...\n");
+    printf("---------------------------------------------------------------\n");
+    
+    uint32_t quote_size = ctx->quote_size();
+    
+    printf("  SGX Quote Size: %u bytes\n", quote_size);
+    
+    // Compare with TDX
+    printf("\n  Comparison with TDX:\n");
+    printf("    SGX Quote:     %u bytes\n", quote_size);
+    printf("    TDX Token:     %d bytes (from your baseline)\n", TDX_BASELINE_TOKEN_BYTES);
+    printf("    TDX Evidence:  %d bytes (raw output)\n", TDX_BASELINE_EVIDENCE_BYTES);
+    
+    if (quote_size < TDX_BASELINE_TOKEN_BYTES) {
+        printf("    SGX quote is %.1fx smaller than TDX token\n",
+               (double)TDX_BASELINE_TOKEN_BYTES / quote_size);
+    } else {
+        printf("    SGX quote is %.1fx larger than TDX token\n",
+               (double)quote_size / TDX_BASELINE_TOKEN_BYTES);
+    }
+    
+    report_out->add_operation("SGX Quote Sizes");
+    report_out->add_field("quote_bytes", quote_size);
+    
+    // Hierarchical estimate
+    uint32_t hierarchical_size = quote_size + TDX_BASELINE_TOKEN_BYTES + 200; // SGX + TDX + binding
+    printf("\n  Hierarchical Protocol Estimate:\n");
+    printf("    SGX quote:     %u bytes\n", quote_size);
+    printf("    TDX token:     %d bytes\n", TDX_BASELINE_TOKEN_BYTES);
+    printf("    Binding data:  ~200 bytes (estimate)\n");
+    printf("    Total:         ~%u bytes\n", hierarchical_size);
+    
+    return 0;
+}
+
+int test_single_quote_detailed(sgx_enclave_id_t eid, AttestationContext* ctx,
+                               QuoteBufferPool* pool) {
+    printf("\n[3/3] Detailed Single Quote Test...\n");
+    printf("---------------------------------------------------------------\n");
+    
+    sgx_target_info_t qe_target_info;
+    uint64_t generation = ctx->target_info(&qe_target_info);
+    uint32_t quote_size = ctx->quote_size();
+    
+    uint8_t* quote_buffer = pool->lease(quote_size);
+    if (!quote_buffer) {
+        printf("  ✗ No pooled buffer for a %u byte quote\n", quote_size);
+        return -1;
+    }
+    
+    uint8_t report[sizeof(sgx_report_t)];
+    uint8_t custom_data[64] = "Hierarchical-TEE-SGX-Quote-Test";
+    
+    // Generate EREPORT
+    printf("  Step 1: Generating EREPORT...\n");
+    double start = get_time_ms();
+    
+    int enclave_ret;
+    sgx_status_t ret = ecall_generate_report_for_quote(
+        eid, &enclave_ret,
+        report, sizeof(report),
+        (uint8_t*)&qe_target_info, sizeof(qe_target_info),
+        custom_data, 64
+    );
+    
+    double ereport_time = get_time_ms() - start;
+    
+    if (ret != SGX_SUCCESS || enclave_ret != 0) {
+        printf("  ✗ Failed to generate EREPORT: SGX=0x%x, Enclave=%d\n", ret, enclave_ret);
+        pool->release(quote_buffer);
+        return -1;
+    }
+    printf("    ✓ EREPORT generated in %.3f ms\n", ereport_time);
+    
+    // Generate Quote
+    printf("  Step 2: Converting to Quote (via Quoting Enclave)...\n");
+    start = get_time_ms();
+    
+    quote3_error_t qe3_ret = ctx->get_quote((sgx_report_t*)report, generation,
+                                            quote_size, quote_buffer);
+    
+    double quote_time = get_time_ms() - start;
+    
+    if (qe3_ret != SGX_QL_SUCCESS) {
+        printf("  ✗ Failed to generate quote: 0x%x\n", qe3_ret);
+        pool->release(quote_buffer);
+        return -1;
+    }
+    printf("    ✓ Quote generated in %.3f ms\n", quote_time);
+    
+    // Print quote information
+    printf("\n  Quote Details:\n");
+    printf("    Total Size: %u bytes\n", quote_size);
+    printf("    Version: %u\n", *(uint16_t*)quote_buffer);
+    
+    // Print some quote data
+    print_hex("    Quote header", quote_buffer, 48);
+    print_hex("    Report body (partial)", quote_buffer + 48, 64);
+    
+    printf("\n  Performance Summary:\n");
+    printf("    EREPORT generation:     %.3f ms\n", ereport_time);
+    printf("    Quote generation (QE):  %.3f ms\n", quote_time);
+    printf("    Total:                  %.3f ms\n", ereport_time + quote_time);
+    
+    printf("\n  For Hierarchical Protocol:\n");
+    printf("    SGX layer time:  %.3f ms (this measurement)\n", ereport_time + quote_time);
+    printf("    TDX layer time:  %.2f ms (from your baseline)\n", TDX_BASELINE_EVIDENCE_MS);
+    printf("    Estimated total: %.2f ms\n", ereport_time + quote_time + TDX_BASELINE_EVIDENCE_MS);
+    printf("    Overlapped:      %.2f ms (max of the two, --overlap)\n",
+           std::max(ereport_time + quote_time, TDX_BASELINE_EVIDENCE_MS));
+    printf("    Added overhead:  +%.1f%%\n", 
+           ((ereport_time + quote_time) / TDX_BASELINE_EVIDENCE_MS) * 100.0);
+    
+    pool->release(quote_buffer);
+    return 0;
+}
+
+// Cold fetch vs. what each call site used to pay vs. the cached lookup
+void report_attestation_context_cost(AttestationContext* ctx, BenchReport* report_out) {
+    const int uncached_rounds = 10;
+    const int cached_rounds = 10000;
+    sgx_target_info_t target_info;
+    uint32_t quote_size = 0;
+    
+    double start = get_time_ms();
+    for (int i = 0; i < uncached_rounds; i++) {
+        sgx_qe_get_target_info(&target_info);
+        sgx_qe_get_quote_size(&quote_size);
+    }
+    double uncached = (get_time_ms() - start) / uncached_rounds;
+    
+    start = get_time_ms();
+    for (int i = 0; i < cached_rounds; i++) {
+        ctx->target_info(&target_info);
+        quote_size = ctx->quote_size();
+    }
+    double cached = (get_time_ms() - start) / cached_rounds;
+    
+    printf("✓ Attestation context ready (quote size: %u bytes)\n", ctx->quote_size());
+    printf("    Cold start (first fetch):  %.3f ms\n", ctx->cold_start_ms());
+    printf("    Warm uncached re-fetch:    %.3f ms\n", uncached);
+    printf("    Cached lookup:             %.6f ms\n", cached);
+    
+    report_out->add_operation("SGX QE Target Info");
+    report_out->add_field("cold_start_ms", ctx->cold_start_ms());
+    report_out->add_field("uncached_refetch_ms", uncached);
+    report_out->add_field("cached_lookup_ms", cached);
+}
+
+// Time to attestation-ready: QE target info, then collateral for the first quote
+void report_attestation_startup(AttestationContext* ctx, BenchReport* report_out) {
+    bool warm = ctx->wait_warm(WARM_TIMEOUT_MS);
+    double startup = ctx->cold_start_ms() + ctx->collateral_warm_ms();
+    if (warm) {
+        printf("✓ Attestation startup: %.3f ms (target info %.3f + collateral prefetch %.3f)\n",
+               startup, ctx->cold_start_ms(), ctx->collateral_warm_ms());
+    } else {
+        printf("⚠ Collateral prefetch not done after %d ms (PCCS slow or unreachable?)\n",
+               WARM_TIMEOUT_MS);
+    }
+    
+    report_out->add_operation("SGX Attestation Startup");
+    report_out->add_field("target_info_ms", ctx->cold_start_ms());
+    report_out->add_field("collateral_prefetch_ms", ctx->collateral_warm_ms());
+    report_out->add_field("startup_ms", warm ? startup : 0.0);
+    report_out->add_field("collateral_warm", warm ? 1.0 : 0.0);
+}
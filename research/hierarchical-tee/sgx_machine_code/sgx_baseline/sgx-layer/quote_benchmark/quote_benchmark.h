@@ -0,0 +1,91 @@
+#ifndef QUOTE_BENCHMARK_H
+#define QUOTE_BENCHMARK_H
+
+#include <stddef.h>
+#include <sgx_urts.h>
+#include "attestation_context.h"
+#include "bench_clock.h"
+#include "bench_report.h"
+#include "quote_buffer_pool.h"
+
+/*
+ * Benchmarks run by quote_benchmark's main(), one translation unit per
+ * feature. Each prints its own section and adds its operations to the
+ * report; most return the number of successful iterations, or -1 if the
+ * benchmark could not run at all.
+ */
+
+#define ENCLAVE_TCS_NUM 10  /* TCSNum in Enclave.config.xml */
+/* TCSPolicy 0: the main thread keeps the TCS it bound on its first ecall */
+#define WORKER_TCS_NUM (ENCLAVE_TCS_NUM - 1)
+#define WARM_TIMEOUT_MS 30000
+/* TDX reference numbers for the printed comparison only; final_comparison.py
+ * reads the measured values from the TDX baseline JSON instead */
+#define TDX_BASELINE_TOKEN_BYTES 5934
+#define TDX_BASELINE_EVIDENCE_BYTES 11469
+#define TDX_BASELINE_EVIDENCE_MS 199.75
+#define TDX_TOKEN_BUDGET 8192  /* pool buffers hold a quote plus a token this size */
+#define SGX_QUOTE_REPORT_DATA_OFFSET 368  /* header (48) + report body up to report_data (320) */
+#define OVERLAP_MODEL "model"  /* --overlap without a TD: sleep the TDX baseline */
+
+static inline double get_time_ms() {
+    return bench_now_ms();
+}
+
+/* quote_bench.cpp: EREPORT + QE quote, sizes, QE context and startup cost */
+int benchmark_quote_generation(sgx_enclave_id_t eid, AttestationContext* ctx,
+                               QuoteBufferPool* pool, BenchReport* report_out,
+                               int iterations);
+int measure_quote_sizes(AttestationContext* ctx, BenchReport* report_out);
+int test_single_quote_detailed(sgx_enclave_id_t eid, AttestationContext* ctx,
+                               QuoteBufferPool* pool);
+void report_attestation_context_cost(AttestationContext* ctx, BenchReport* report_out);
+void report_attestation_startup(AttestationContext* ctx, BenchReport* report_out);
+
+/* binding_bench.cpp: composite frame and host vs in-enclave binding */
+int benchmark_composite_evidence(sgx_enclave_id_t eid, AttestationContext* ctx,
+                                 QuoteBufferPool* pool, BenchReport* report_out, int iterations);
+int benchmark_binding_reports(sgx_enclave_id_t eid, AttestationContext* ctx,
+                              QuoteBufferPool* pool, BenchReport* report_out, int iterations);
+
+/* session_bench.cpp: attested session and ticket resumption */
+int benchmark_attested_session(sgx_enclave_id_t eid, AttestationContext* ctx,
+                               QuoteBufferPool* pool, BenchReport* report_out, int iterations);
+int benchmark_session_resumption(sgx_enclave_id_t eid, AttestationContext* ctx,
+                                 QuoteBufferPool* pool, BenchReport* report_out, int iterations);
+
+/* verification_bench.cpp: --verify */
+int benchmark_quote_verification(sgx_enclave_id_t eid, AttestationContext* ctx,
+                                 BenchReport* report_out, int count);
+
+/* report_bench.cpp: --batch and --switchless */
+int benchmark_batched_reports(sgx_enclave_id_t eid, AttestationContext* ctx,
+                              QuoteBufferPool* pool, int iterations, int batch_size);
+int benchmark_switchless_reports(sgx_enclave_id_t eid, AttestationContext* ctx,
+                                 int iterations, int tworkers);
+
+/* thread_bench.cpp: --threads and --pipeline */
+int benchmark_threaded_quotes(sgx_enclave_id_t eid, AttestationContext* ctx,
+                              QuoteBufferPool* pool, BenchReport* report_out,
+                              int iterations, int max_threads);
+int benchmark_pipelined_quotes(sgx_enclave_id_t eid, AttestationContext* ctx,
+                               QuoteBufferPool* pool, BenchReport* report_out,
+                               int iterations, int stages);
+
+/* trace_bench.cpp: --trace */
+int benchmark_traced_evidence(sgx_enclave_id_t eid, AttestationContext* ctx,
+                              QuoteBufferPool* pool, BenchReport* report_out,
+                              int iterations, const char* trace_path,
+                              const char* quotes_path);
+
+/* overlap_bench.cpp: --overlap */
+int benchmark_overlapped_attestation(sgx_enclave_id_t eid, AttestationContext* ctx,
+                                     QuoteBufferPool* pool, BenchReport* report_out,
+                                     int iterations, const char* td_address);
+
+/* reservoir_bench.cpp: --reservoir */
+int benchmark_evidence_reservoir(sgx_enclave_id_t eid, AttestationContext* ctx,
+                                 QuoteBufferPool* pool, BenchReport* report_out,
+                                 int iterations, const char* td_address, int capacity);
+
+#endif /* QUOTE_BENCHMARK_H */
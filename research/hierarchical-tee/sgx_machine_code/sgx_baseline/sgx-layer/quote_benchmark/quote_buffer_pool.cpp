@@ -0,0 +1,77 @@
+#include "quote_buffer_pool.h"
+
+#include <stdlib.h>
+
+#define POOL_PAGE_SIZE 4096
+
+QuoteBufferPool::QuoteBufferPool()
+    : slab_(NULL), buffer_size_(0), buffer_count_(0),
+      high_water_(0), lease_failures_(0) {
+}
+
+QuoteBufferPool::~QuoteBufferPool() {
+    free(slab_);
+}
+
+bool QuoteBufferPool::init(size_t min_buffer_size, size_t buffer_count) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (slab_ || min_buffer_size == 0 || buffer_count == 0) {
+        return false;
+    }
+    
+    // A multiple of the page size is also a multiple of the cache line
+    size_t buffer_size = (min_buffer_size / POOL_PAGE_SIZE + 1) * POOL_PAGE_SIZE;
+    if (buffer_count > (size_t)-1 / buffer_size) {
+        return false;
+    }
+    
+    void* slab = NULL;
+    if (posix_memalign(&slab, CACHE_LINE_SIZE, buffer_size * buffer_count) != 0) {
+        return false;
+    }
+    
+    slab_ = (uint8_t*)slab;
+    buffer_size_ = buffer_size;
+    buffer_count_ = buffer_count;
+    free_.reserve(buffer_count);
+    for (size_t i = buffer_count; i > 0; i--) {
+        free_.push_back(slab_ + (i - 1) * buffer_size);
+    }
+    return true;
+}
+
+uint8_t* QuoteBufferPool::lease(size_t size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (size > buffer_size_ || free_.empty()) {
+        lease_failures_++;
+        return NULL;
+    }
+    
+    uint8_t* buffer = free_.back();
+    free_.pop_back();
+    size_t leased = buffer_count_ - free_.size();
+    if (leased > high_water_) {
+        high_water_ = leased;
+    }
+    return buffer;
+}
+
+void QuoteBufferPool::release(uint8_t* buffer) {
+    if (!buffer) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    // The stack was reserved for every buffer, so this never reallocates
+    free_.push_back(buffer);
+}
+
+size_t QuoteBufferPool::high_water() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return high_water_;
+}
+
+uint64_t QuoteBufferPool::lease_failures() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lease_failures_;
+}
@@ -0,0 +1,58 @@
+#ifndef QUOTE_BUFFER_POOL_H
+#define QUOTE_BUFFER_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <mutex>
+#include <vector>
+
+#ifndef CACHE_LINE_SIZE
+#define CACHE_LINE_SIZE 64
+#endif
+
+/*
+ * Fixed-capacity pool of quote/evidence buffers carved out of one
+ * cache-line-aligned slab.
+ *
+ * All memory is allocated by init(); lease() and release() only move
+ * pointers on a preallocated free stack, so the quote hot path does no
+ * allocator traffic. Each buffer starts on its own cache line, so workers
+ * writing quotes concurrently never share a line.
+ *
+ * Buffers are rounded up to a whole page over the requested size to leave
+ * headroom for a quote that grows after a TCB recovery (longer PCK chain).
+ * A lease larger than that, or one made while every buffer is out, fails
+ * with NULL rather than falling back to malloc.
+ */
+class QuoteBufferPool {
+public:
+    QuoteBufferPool();
+    ~QuoteBufferPool();
+
+    /* Allocate `buffer_count` buffers of at least `min_buffer_size` bytes. */
+    bool init(size_t min_buffer_size, size_t buffer_count);
+
+    /* Borrow a buffer holding at least `size` bytes, NULL if none fits. */
+    uint8_t* lease(size_t size);
+
+    void release(uint8_t* buffer);
+
+    size_t buffer_size() const { return buffer_size_; }
+    size_t capacity() const { return buffer_count_; }
+    size_t high_water() const;
+    uint64_t lease_failures() const;
+
+private:
+    QuoteBufferPool(const QuoteBufferPool&);
+    QuoteBufferPool& operator=(const QuoteBufferPool&);
+
+    mutable std::mutex mutex_;
+    uint8_t* slab_;
+    size_t buffer_size_;
+    size_t buffer_count_;
+    std::vector<uint8_t*> free_;
+    size_t high_water_;
+    uint64_t lease_failures_;
+};
+
+#endif /* QUOTE_BUFFER_POOL_H */
@@ -0,0 +1,301 @@
+#include "quote_benchmark.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+#include "Enclave_u.h"
+#include "report_ring.h"
+
+int benchmark_batched_reports(sgx_enclave_id_t eid, AttestationContext* ctx,
+                              QuoteBufferPool* pool, int iterations, int batch_size) {
+    printf("\n[+] Benchmarking Batched EREPORT (%d iterations x %d reports)...\n",
+           iterations, batch_size);
+    printf("---------------------------------------------------------------\n");
+    
+    sgx_target_info_t qe_target_info;
+    uint64_t generation = ctx->target_info(&qe_target_info);
+    uint32_t quote_size = ctx->quote_size();
+    
+    uint8_t* reports = (uint8_t*)malloc((size_t)batch_size * sizeof(sgx_report_t));
+    uint8_t* nonces = (uint8_t*)calloc((size_t)batch_size, sizeof(sgx_report_data_t));
+    uint8_t* quote_buffer = pool->lease(quote_size);
+    // Two bursts' worth of slots, so successive bursts also cover the wrap
+    size_t ring_slots = 2 * (size_t)batch_size;
+    void* ring_memory = NULL;
+    if (posix_memalign(&ring_memory, REPORT_RING_ALIGN, ring_slots * sizeof(report_ring_slot_t)) != 0) {
+        ring_memory = NULL;
+    }
+    report_ring_slot_t* ring = (report_ring_slot_t*)ring_memory;
+    if (!reports || !nonces || !quote_buffer || !ring) {
+        printf("  ✗ Failed to allocate batch buffers\n");
+        free(reports);
+        free(nonces);
+        free(ring);
+        pool->release(quote_buffer);
+        return -1;
+    }
+    memset(ring, 0, ring_slots * sizeof(report_ring_slot_t));
+    
+    int enclave_ret = 0;
+    sgx_status_t ret = ecall_register_report_ring(eid, &enclave_ret, (uint8_t*)ring, ring_slots,
+                                                  (uint8_t*)&qe_target_info, sizeof(qe_target_info));
+    bool have_ring = ret == SGX_SUCCESS && enclave_ret == 0;
+    if (!have_ring) {
+        printf("  ⚠ Shared report ring not registered: SGX=0x%x, Enclave=%d\n", ret, enclave_ret);
+    }
+    
+    double total_single_time = 0;
+    double total_batch_time = 0;
+    double total_ring_time = 0;
+    int successful = 0;
+    int ring_successful = 0;
+    bool ring_matches = true;
+    size_t ring_next = 0;
+    
+    for (int i = 0; i < iterations; i++) {
+        for (int j = 0; j < batch_size; j++) {
+            snprintf((char*)(nonces + (size_t)j * sizeof(sgx_report_data_t)),
+                     sizeof(sgx_report_data_t), "Batch-%d-%d", i, j);
+        }
+        
+        // Baseline: one ecall (EENTER/EEXIT) per report
+        ret = SGX_SUCCESS;
+        enclave_ret = 0;
+        double single_start = get_time_ms();
+        for (int j = 0; j < batch_size && ret == SGX_SUCCESS && enclave_ret == 0; j++) {
+            ret = ecall_generate_report_for_quote(
+                eid, &enclave_ret,
+                reports + (size_t)j * sizeof(sgx_report_t), sizeof(sgx_report_t),
+                (uint8_t*)&qe_target_info, sizeof(qe_target_info),
+                nonces + (size_t)j * sizeof(sgx_report_data_t), sizeof(sgx_report_data_t)
+            );
+        }
+        double single_end = get_time_ms();
+        
+        if (ret != SGX_SUCCESS || enclave_ret != 0) {
+            if (i == 0) {
+                printf("  [%d] ✗ Failed to generate EREPORT: SGX=0x%x, Enclave=%d\n",
+                       i+1, ret, enclave_ret);
+            }
+            continue;
+        }
+        
+        // Batched: every report of the burst in a single transition
+        double batch_start = get_time_ms();
+        ret = ecall_generate_report_batch(
+            eid, &enclave_ret,
+            reports, (size_t)batch_size * sizeof(sgx_report_t),
+            (uint8_t*)&qe_target_info, sizeof(qe_target_info),
+            nonces, (size_t)batch_size * sizeof(sgx_report_data_t),
+            (size_t)batch_size
+        );
+        double batch_end = get_time_ms();
+        
+        if (ret != SGX_SUCCESS || enclave_ret != 0) {
+            if (i == 0) {
+                printf("  [%d] ✗ Failed to generate EREPORT batch: SGX=0x%x, Enclave=%d\n",
+                       i+1, ret, enclave_ret);
+            }
+            continue;
+        }
+        
+        successful++;
+        total_single_time += single_end - single_start;
+        total_batch_time += batch_end - batch_start;
+        
+        if (!have_ring) {
+            continue;
+        }
+        
+        // Shared ring: the same burst written straight into registered
+        // slots, with nothing marshalled by the bridge
+        for (int j = 0; j < batch_size; j++) {
+            report_ring_slot_t* slot = &ring[(ring_next + (size_t)j) % ring_slots];
+            memcpy(&slot->report_data, nonces + (size_t)j * sizeof(sgx_report_data_t),
+                   sizeof(sgx_report_data_t));
+            slot->status = -1;
+        }
+        double ring_start = get_time_ms();
+        ret = ecall_generate_report_ring(eid, &enclave_ret, ring_next, (size_t)batch_size);
+        double ring_end = get_time_ms();
+        
+        if (ret != SGX_SUCCESS || enclave_ret != 0) {
+            if (ring_successful == 0) {
+                printf("  [%d] ✗ Failed to generate EREPORT ring: SGX=0x%x, Enclave=%d\n",
+                       i+1, ret, enclave_ret);
+            }
+        } else {
+            ring_successful++;
+            total_ring_time += ring_end - ring_start;
+            for (int j = 0; j < batch_size; j++) {
+                const report_ring_slot_t* slot = &ring[(ring_next + (size_t)j) % ring_slots];
+                const uint8_t* nonce = nonces + (size_t)j * sizeof(sgx_report_data_t);
+                if (slot->status != 0 ||
+                    memcmp(slot->report.body.report_data.d, nonce, sizeof(sgx_report_data_t)) != 0) {
+                    ring_matches = false;
+                }
+            }
+        }
+        ring_next = (ring_next + (size_t)batch_size) % ring_slots;
+    }
+    
+    printf("\n  Results Summary:\n");
+    printf("  ---------------\n");
+    printf("  Successful batches: %d/%d\n", successful, iterations);
+    
+    if (successful > 0) {
+        double reports_done = (double)successful * batch_size;
+        double single_per_report = total_single_time / reports_done;
+        double batch_per_report = total_batch_time / reports_done;
+        
+        printf("  Single-call EREPORT:     %.3f ms/report (%d transitions per batch)\n",
+               single_per_report, batch_size);
+        printf("  Batched EREPORT:         %.3f ms/report (1 transition per batch)\n",
+               batch_per_report);
+        printf("  Batched call latency:    %.3f ms/batch\n", total_batch_time / successful);
+        if (batch_per_report > 0) {
+            printf("  Amortization speedup:    %.2fx\n", single_per_report / batch_per_report);
+        }
+        if (ring_successful > 0) {
+            double ring_per_report = total_ring_time / ((double)ring_successful * batch_size);
+            printf("  Shared-ring EREPORT:     %.3f ms/report (no bridge copies)\n", ring_per_report);
+            if (ring_per_report > 0) {
+                printf("  Ring vs batched:         %.2fx\n", batch_per_report / ring_per_report);
+            }
+            if (ring_matches) {
+                printf("  ✓ Ring reports carry their slot's report_data\n");
+            } else {
+                printf("  ✗ Ring report does not match its slot\n");
+            }
+        }
+        
+        // The batched reports must still be accepted by the QE
+        quote3_error_t qe3_ret = ctx->get_quote((sgx_report_t*)reports, generation,
+                                                quote_size, quote_buffer);
+        if (qe3_ret == SGX_QL_SUCCESS) {
+            printf("  ✓ Batched report accepted by QE (%u byte quote)\n", quote_size);
+        } else {
+            printf("  ✗ Batched report rejected by QE: 0x%x\n", qe3_ret);
+        }
+    }
+    
+    if (have_ring) {
+        ecall_register_report_ring(eid, &enclave_ret, NULL, 0, NULL, 0);
+    }
+    free(reports);
+    free(nonces);
+    free(ring);
+    pool->release(quote_buffer);
+    return successful;
+}
+
+typedef struct {
+    int successful;
+    int attempted;
+    double total_latency_ms;
+    double wall_time_ms;
+} ereport_load_result_t;
+
+static void ereport_load_worker(sgx_enclave_id_t eid, bool switchless,
+                                const sgx_target_info_t* qe_target_info,
+                                int worker_id, int calls,
+                                int* successful, double* total_latency_ms) {
+    uint8_t report[sizeof(sgx_report_t)];
+    uint8_t custom_data[64] = {0};
+    snprintf((char*)custom_data, 64, "Switchless-%d", worker_id);
+    
+    for (int i = 0; i < calls; i++) {
+        int enclave_ret = 0;
+        double start = get_time_ms();
+        sgx_status_t ret = switchless
+            ? ecall_generate_report_switchless(
+                  eid, &enclave_ret, report, sizeof(report),
+                  (uint8_t*)qe_target_info, sizeof(sgx_target_info_t), custom_data, 64)
+            : ecall_generate_report_for_quote(
+                  eid, &enclave_ret, report, sizeof(report),
+                  (uint8_t*)qe_target_info, sizeof(sgx_target_info_t), custom_data, 64);
+        double end = get_time_ms();
+        
+        if (ret == SGX_SUCCESS && enclave_ret == 0) {
+            (*successful)++;
+            *total_latency_ms += end - start;
+        }
+    }
+}
+
+// Keep `in_flight` EREPORT ecalls outstanding at all times, one per caller thread
+static ereport_load_result_t run_ereport_load(sgx_enclave_id_t eid, bool switchless,
+                                              const sgx_target_info_t* qe_target_info,
+                                              int in_flight, int calls_per_thread) {
+    std::vector<std::thread> workers;
+    std::vector<int> successes(in_flight, 0);
+    std::vector<double> latencies(in_flight, 0.0);
+    
+    double start = get_time_ms();
+    for (int t = 0; t < in_flight; t++) {
+        workers.push_back(std::thread(ereport_load_worker, eid, switchless, qe_target_info,
+                                      t, calls_per_thread, &successes[t], &latencies[t]));
+    }
+    for (size_t t = 0; t < workers.size(); t++) {
+        workers[t].join();
+    }
+    double end = get_time_ms();
+    
+    ereport_load_result_t result = {0, in_flight * calls_per_thread, 0.0, end - start};
+    for (int t = 0; t < in_flight; t++) {
+        result.successful += successes[t];
+        result.total_latency_ms += latencies[t];
+    }
+    return result;
+}
+
+int benchmark_switchless_reports(sgx_enclave_id_t eid, AttestationContext* ctx,
+                                 int iterations, int tworkers) {
+    printf("\n[+] Benchmarking Switched vs Switchless EREPORT (%d calls per thread)...\n",
+           iterations);
+    printf("---------------------------------------------------------------\n");
+    
+    sgx_target_info_t qe_target_info;
+    ctx->target_info(&qe_target_info);
+    
+    // Warm up both paths so worker start-up is not charged to the first level
+    run_ereport_load(eid, false, &qe_target_info, 1, 10);
+    run_ereport_load(eid, true, &qe_target_info, 1, 10);
+    
+    static const int levels[] = {1, 2, 4, 8};
+    int rows = 0;
+    
+    printf("  %-9s | %-22s | %-22s | %s\n",
+           "In-flight", "Switched (ms, ops/s)", "Switchless (ms, ops/s)", "Speedup");
+    for (size_t l = 0; l < sizeof(levels) / sizeof(levels[0]); l++) {
+        int in_flight = levels[l];
+        // Trusted workers each pin a TCS; switched callers need one TCS apiece
+        if (in_flight + tworkers > WORKER_TCS_NUM) {
+            printf("  %-9d | skipped: %d callers + %d tworkers exceed %d free TCS\n",
+                   in_flight, in_flight, tworkers, WORKER_TCS_NUM);
+            continue;
+        }
+        
+        ereport_load_result_t sw = run_ereport_load(eid, false, &qe_target_info,
+                                                    in_flight, iterations);
+        ereport_load_result_t sl = run_ereport_load(eid, true, &qe_target_info,
+                                                    in_flight, iterations);
+        if (sw.successful == 0 || sl.successful == 0) {
+            printf("  %-9d | ✗ EREPORT failed (switched %d/%d, switchless %d/%d)\n",
+                   in_flight, sw.successful, sw.attempted, sl.successful, sl.attempted);
+            continue;
+        }
+        
+        double sw_lat = sw.total_latency_ms / sw.successful;
+        double sl_lat = sl.total_latency_ms / sl.successful;
+        double sw_tput = sw.successful * 1000.0 / sw.wall_time_ms;
+        double sl_tput = sl.successful * 1000.0 / sl.wall_time_ms;
+        printf("  %-9d | %8.4f  %10.1f  | %8.4f  %10.1f  | %.2fx\n",
+               in_flight, sw_lat, sw_tput, sl_lat, sl_tput, sl_tput / sw_tput);
+        rows++;
+    }
+    
+    return rows;
+}
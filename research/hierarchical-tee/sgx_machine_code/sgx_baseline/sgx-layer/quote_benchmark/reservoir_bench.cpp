@@ -0,0 +1,227 @@
+#include "quote_benchmark.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include "Enclave_u.h"
+#include "composite_evidence.h"
+#include "evidence_reservoir.h"
+#include "latency_histogram.h"
+#include "sgx_binding.h"
+#include "token_client.h"
+#include "token_service.h"
+#include "trace_span.h"
+
+#define RESERVOIR_FRESHNESS_MS 30000     /* a frame older than this is not handed out */
+#define RESERVOIR_NONCE_LIFETIME_MS 60000
+#define RESERVOIR_NONCE_BATCH 16
+#define RESERVOIR_SLOW_GAP_MS 500        /* mean session inter-arrival, first half */
+#define RESERVOIR_FAST_GAP_MS 100        /* second half */
+
+// SGX quote and TD token over `nonce`, framed into `buffer`; what session
+// setup pays inline without a reservoir
+static bool produce_composite_frame(sgx_enclave_id_t eid, AttestationContext* ctx, int td_fd,
+                                    const uint8_t* nonce, uint8_t* buffer, size_t capacity,
+                                    size_t* frame_len) {
+    sgx_target_info_t qe_target_info;
+    uint8_t report[sizeof(sgx_report_t)];
+    uint8_t binding[SGX_BINDING_SIZE];
+    uint32_t quote_size = ctx->quote_size();
+    int enclave_ret = 0;
+    uint64_t generation = ctx->target_info(&qe_target_info);
+    sgx_status_t ret = ecall_generate_binding_report(
+        eid, &enclave_ret, report, sizeof(report),
+        (uint8_t*)&qe_target_info, sizeof(qe_target_info),
+        (uint8_t*)nonce, SGX_BINDING_NONCE_SIZE, binding, sizeof(binding));
+    if (ret != SGX_SUCCESS || enclave_ret != 0 ||
+        capacity < composite_evidence_size(quote_size, 0) ||
+        ctx->get_quote((sgx_report_t*)report, generation, quote_size,
+                       buffer + COMPOSITE_QUOTE_OFFSET) != SGX_QL_SUCCESS) {
+        return false;
+    }
+    
+    std::string token;
+    uint8_t status = TOKEN_STATUS_OK;
+    if (!fetch_tdx_token(td_fd, binding, &token, &status) || status != TOKEN_STATUS_OK) {
+        return false;
+    }
+    return composite_evidence_write(buffer, capacity, buffer + COMPOSITE_QUOTE_OFFSET, quote_size,
+                                    (const uint8_t*)token.data(), token.size(), binding,
+                                    frame_len) == COMPOSITE_OK;
+}
+
+// Reservoir producer on the SGX host. The verifier daemon has no nonce
+// issuance endpoint, so a batch is random nonces with the lifetime a
+// verifier would give them; the reservoir spends each one once
+class HostReservoirSource : public ReservoirSource {
+public:
+    HostReservoirSource(sgx_enclave_id_t eid, AttestationContext* ctx, int td_fd)
+        : eid_(eid), ctx_(ctx), td_fd_(td_fd) {}
+    
+    size_t issue_nonces(issued_nonce_t* out, size_t max) {
+        double expires = get_time_ms() + RESERVOIR_NONCE_LIFETIME_MS;
+        for (size_t i = 0; i < max; i++) {
+            if (!trace_random(out[i].nonce, SGX_BINDING_NONCE_SIZE)) {
+                return i;
+            }
+            out[i].expires_ms = expires;
+        }
+        return max;
+    }
+    
+    bool produce(const uint8_t nonce[SGX_BINDING_NONCE_SIZE], uint8_t* buffer,
+                 size_t capacity, size_t* frame_len) {
+        return produce_composite_frame(eid_, ctx_, td_fd_, nonce, buffer, capacity, frame_len);
+    }
+    
+private:
+    sgx_enclave_id_t eid_;
+    AttestationContext* ctx_;
+    int td_fd_;
+};
+
+// Session setup with a reservoir of pre-made composite frames vs attesting
+// inline. Sessions arrive at a low and then a high rate, so the reservoir
+// has to re-tune its depth halfway through
+int benchmark_evidence_reservoir(sgx_enclave_id_t eid, AttestationContext* ctx,
+                                 QuoteBufferPool* pool, BenchReport* report_out,
+                                 int iterations, const char* td_address, int capacity) {
+    bool model = strcmp(td_address, OVERLAP_MODEL) == 0;
+    printf("\n[+] Benchmarking Evidence Reservoir (%d sessions, depth <= %d, TD: %s)...\n",
+           iterations, capacity, model ? "modelled" : td_address);
+    printf("---------------------------------------------------------------\n");
+    
+    // The producer and the inline fallback each need their own TD connection
+    int producer_fd = -1;
+    int inline_fd = -1;
+    if (!model) {
+        producer_fd = connect_token_service(td_address);
+        inline_fd = connect_token_service(td_address);
+        if (producer_fd < 0 || inline_fd < 0) {
+            printf("  ✗ Cannot connect to TD token service %s\n", td_address);
+            if (producer_fd >= 0) {
+                close(producer_fd);
+            }
+            if (inline_fd >= 0) {
+                close(inline_fd);
+            }
+            return -1;
+        }
+    }
+    
+    size_t frame_size = composite_evidence_size(ctx->quote_size(), TDX_TOKEN_BUDGET);
+    HostReservoirSource source(eid, ctx, producer_fd);
+    EvidenceReservoir reservoir;
+    int sessions = 0;
+    if (!reservoir.start(&source, capacity, frame_size, RESERVOIR_FRESHNESS_MS,
+                         RESERVOIR_NONCE_BATCH)) {
+        printf("  ✗ Failed to start the reservoir\n");
+    } else if (!reservoir.wait_depth(1, WARM_TIMEOUT_MS)) {
+        printf("  ✗ No frame produced within %d ms\n", WARM_TIMEOUT_MS);
+    } else {
+        sessions = iterations;
+    }
+    
+    LatencyHistogram setup_hist;
+    LatencyHistogram hit_hist;
+    LatencyHistogram miss_hist;
+    std::vector<double> setup_samples;
+    setup_samples.reserve(iterations);
+    double depth_sum = 0;
+    int failures = 0;
+    srand48(1);  // same arrival pattern every run
+    
+    for (int i = 0; i < sessions; i++) {
+        double gap_ms = i < sessions / 2 ? RESERVOIR_SLOW_GAP_MS : RESERVOIR_FAST_GAP_MS;
+        usleep((useconds_t)(-log(1.0 - drand48()) * gap_ms * 1000));
+        depth_sum += reservoir.stats().depth;
+        
+        evidence_bundle_t bundle;
+        double start = get_time_ms();
+        if (reservoir.take(&bundle)) {
+            // The frame goes to the verifier as is; here its header is checked and it is returned
+            size_t frame_len = 0;
+            bool ok = composite_evidence_frame_length(bundle.frame, bundle.frame_len,
+                                                      &frame_len) == COMPOSITE_OK &&
+                      frame_len == bundle.frame_len;
+            double setup_ms = get_time_ms() - start;
+            reservoir.release(bundle);
+            if (!ok) {
+                failures++;
+                continue;
+            }
+            hit_hist.record_ms(setup_ms);
+            setup_hist.record_ms(setup_ms);
+            setup_samples.push_back(setup_ms);
+            continue;
+        }
+        
+        // Miss: a fresh nonce and the whole attestation on the critical path
+        uint8_t nonce[SGX_BINDING_NONCE_SIZE];
+        uint8_t* frame = pool->lease(frame_size);
+        size_t frame_len = 0;
+        bool ok = frame && trace_random(nonce, sizeof(nonce)) &&
+                  produce_composite_frame(eid, ctx, inline_fd, nonce, frame, pool->buffer_size(),
+                                          &frame_len);
+        double setup_ms = get_time_ms() - start;
+        pool->release(frame);
+        if (!ok) {
+            if (failures++ == 0) {
+                printf("  [%d] ✗ Inline attestation failed\n", i+1);
+            }
+            continue;
+        }
+        miss_hist.record_ms(setup_ms);
+        setup_hist.record_ms(setup_ms);
+        setup_samples.push_back(setup_ms);
+    }
+    reservoir_stats_t stats = reservoir.stats();
+    reservoir.stop();
+    if (producer_fd >= 0) {
+        close(producer_fd);
+    }
+    if (inline_fd >= 0) {
+        close(inline_fd);
+    }
+    
+    printf("\n  Results Summary:\n");
+    printf("  ---------------\n");
+    if (setup_hist.count() == 0) {
+        printf("  ✗ No sessions set up (%d failed)\n", failures);
+        return -1;
+    }
+    uint64_t takes = stats.hits + stats.misses;
+    printf("  Sessions:                %zu/%d (%d failed)\n", setup_samples.size(), iterations,
+           failures);
+    printf("  Hits / misses:           %lu / %lu (%.1f%% hit rate)\n", (unsigned long)stats.hits,
+           (unsigned long)stats.misses, takes ? 100.0 * stats.hits / takes : 0.0);
+    printf("  Depth:                   %.1f mean at arrival, %zu peak, target %zu at exit\n",
+           sessions ? depth_sum / sessions : 0.0, stats.high_water, stats.target_depth);
+    printf("  Produced:                %lu frames (%.3f ms each, %lu failed)\n",
+           (unsigned long)stats.produced, stats.production_ms,
+           (unsigned long)stats.production_failures);
+    printf("  Expired unused:          %lu frames, %lu nonces (%lu nonce batches)\n",
+           (unsigned long)stats.expired, (unsigned long)stats.nonces_expired,
+           (unsigned long)stats.nonce_batches);
+    printf("  Demand at exit:          %.1f sessions/s\n", stats.demand_per_s);
+    printf("\n  Tail Latency (per session setup):\n");
+    print_latency_header();
+    print_latency_row("all sessions", setup_hist);
+    print_latency_row("reservoir hit", hit_hist);
+    print_latency_row("miss (inline)", miss_hist);
+    
+    report_out->add_latency("Session Setup (reservoir)", setup_samples, iterations);
+    report_out->add_field("hit_rate", takes ? (double)stats.hits / takes : 0.0);
+    report_out->add_field("misses", (double)stats.misses);
+    report_out->add_field("expired", (double)stats.expired);
+    report_out->add_field("nonces_expired", (double)stats.nonces_expired);
+    report_out->add_field("mean_depth", sessions ? depth_sum / sessions : 0.0);
+    report_out->add_field("peak_depth", (double)stats.high_water);
+    report_out->add_field("production_ms", stats.production_ms);
+    
+    return (int)setup_samples.size();
+}
@@ -0,0 +1,353 @@
+#include "quote_benchmark.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+#include <sgx_quote_3.h>
+#include "Enclave_u.h"
+#include "attestation_session.h"
+#include "latency_histogram.h"
+#include "quote_verifier.h"
+#include "resumption_ticket.h"
+#include "sgx_binding.h"
+#include "sgx_session.h"
+
+#define TICKET_LIFETIME_S 3600  /* stand-in for the TDX token's exp */
+
+typedef struct {
+    double report_ms;   /* ecall_generate_composite_report */
+    double quote_ms;
+    double setup_ms;    /* binding check, key exchange and ecall_open_session */
+} session_timing_t;
+
+// Steps 1-3 of an attested session. The quote is left in `quote` for the
+// caller to verify; prints the reason and returns false on failure.
+static bool attest_session(sgx_enclave_id_t eid, AttestationContext* ctx, uint8_t* quote,
+                           uint32_t quote_size, AttestedSession* session,
+                           std::vector<uint8_t>* sealed_session, session_timing_t* timing) {
+    sgx_target_info_t qe_target_info;
+    uint64_t generation = ctx->target_info(&qe_target_info);
+    uint8_t report[sizeof(sgx_report_t)];
+    uint8_t nonce[SGX_BINDING_NONCE_SIZE] = {0};
+    uint8_t binding[SGX_BINDING_SIZE];
+    uint8_t public_key[SGX_SESSION_PUBLIC_KEY_SIZE];
+    std::vector<uint8_t> sealed_key(SGX_SESSION_SEALED_SIZE);
+    sealed_session->resize(SGX_SESSION_SEALED_SIZE);
+    snprintf((char*)nonce, sizeof(nonce), "Session-%ld", (long)time(NULL));
+    
+    // Step 1: key pair, binding report and sealed private key in one ecall
+    int enclave_ret = 0;
+    double report_start = get_time_ms();
+    sgx_status_t ret = ecall_generate_composite_report(
+        eid, &enclave_ret, report, sizeof(report),
+        (uint8_t*)&qe_target_info, sizeof(qe_target_info),
+        nonce, sizeof(nonce), binding, sizeof(binding),
+        public_key, sizeof(public_key), &sealed_key[0], sealed_key.size());
+    double report_end = get_time_ms();
+    quote3_error_t qe3_ret = SGX_QL_ERROR_UNEXPECTED;
+    if (ret == SGX_SUCCESS && enclave_ret == 0) {
+        qe3_ret = ctx->get_quote((sgx_report_t*)report, generation, quote_size, quote);
+    }
+    double quote_end = get_time_ms();
+    if (qe3_ret != SGX_QL_SUCCESS) {
+        printf("  ✗ Composite attestation failed: SGX=0x%x, Enclave=%d, QE=0x%x\n",
+               ret, enclave_ret, qe3_ret);
+        return false;
+    }
+    
+    // Step 2 (verifier): the quote must bind this public key and nonce
+    const sgx_quote3_t* quote3 = (const sgx_quote3_t*)quote;
+    uint8_t key_nonce[SGX_BINDING_NONCE_SIZE];
+    uint8_t peer_public_key[SGX_SESSION_PUBLIC_KEY_SIZE];
+    double setup_start = get_time_ms();
+    bool bound = session_key_nonce(public_key, nonce, key_nonce) &&
+                 session_report_data_matches(quote3->report_body.report_data.d,
+                                             quote3->report_body.mr_enclave.m, key_nonce) &&
+                 memcmp(binding, quote3->report_body.report_data.d, SGX_BINDING_SIZE) == 0;
+    bool accepted = bound && session->accept(public_key, key_nonce, peer_public_key);
+    
+    // Step 3 (enclave): same session key from the sealed private key
+    if (accepted) {
+        ret = ecall_open_session(eid, &enclave_ret, &sealed_key[0], sealed_key.size(),
+                                 peer_public_key, sizeof(peer_public_key),
+                                 &(*sealed_session)[0], sealed_session->size());
+    }
+    double setup_end = get_time_ms();
+    if (!bound) {
+        printf("  ✗ Quote report_data does not bind the session key\n");
+        return false;
+    }
+    if (!accepted || ret != SGX_SUCCESS || enclave_ret != 0) {
+        printf("  ✗ Session setup failed: SGX=0x%x, Enclave=%d\n", ret, enclave_ret);
+        return false;
+    }
+    
+    timing->report_ms = report_end - report_start;
+    timing->quote_ms = quote_end - report_end;
+    timing->setup_ms = setup_end - setup_start;
+    return true;
+}
+
+// One request over the session: MAC in the enclave, checked by the verifier
+static bool session_request(sgx_enclave_id_t eid, const std::vector<uint8_t>& sealed_session,
+                            const AttestedSession& session, int request) {
+    uint8_t message[64] = {0};
+    uint8_t mac[SGX_SESSION_MAC_SIZE];
+    int len = snprintf((char*)message, sizeof(message), "Request-%d", request);
+    int enclave_ret = 0;
+    sgx_status_t ret = ecall_session_mac(eid, &enclave_ret,
+                                         (uint8_t*)&sealed_session[0], sealed_session.size(),
+                                         message, (size_t)len, mac, sizeof(mac));
+    return ret == SGX_SUCCESS && enclave_ret == 0 && session.verify(message, (size_t)len, mac);
+}
+
+// One composite attestation, then requests over the session it set up
+int benchmark_attested_session(sgx_enclave_id_t eid, AttestationContext* ctx,
+                               QuoteBufferPool* pool, BenchReport* report_out, int iterations) {
+    printf("\n[+] Benchmarking Attested Session (1 attestation + %d requests)...\n", iterations);
+    printf("---------------------------------------------------------------\n");
+    
+    uint32_t quote_size = ctx->quote_size();
+    uint8_t* quote = pool->lease(quote_size);
+    if (!quote) {
+        printf("  ✗ No pooled buffer for a %u byte quote\n", quote_size);
+        return -1;
+    }
+    
+    AttestedSession session;
+    std::vector<uint8_t> sealed_session;
+    session_timing_t timing;
+    bool attested = attest_session(eid, ctx, quote, quote_size, &session, &sealed_session, &timing);
+    pool->release(quote);
+    if (!attested) {
+        return -1;
+    }
+    printf("  ✓ Composite report: %.3f ms, quote: %.3f ms\n", timing.report_ms, timing.quote_ms);
+    printf("  ✓ Session key bound by the quote, setup: %.3f ms\n", timing.setup_ms);
+    
+    // Step 4: requests authenticated by the session instead of a new quote
+    int verified = 0;
+    double total_request_time = 0;
+    LatencyHistogram request_hist;
+    for (int i = 0; i < iterations; i++) {
+        double start = get_time_ms();
+        bool ok = session_request(eid, sealed_session, session, i);
+        double end = get_time_ms();
+        if (!ok) {
+            if (i == 0) {
+                printf("  [%d] ✗ Session request failed\n", i+1);
+            }
+            continue;
+        }
+        verified++;
+        total_request_time += end - start;
+        request_hist.record_ms(end - start);
+    }
+    
+    double attest_ms = timing.report_ms + timing.quote_ms;
+    printf("\n  Results Summary:\n");
+    printf("  ---------------\n");
+    printf("  Requests verified:       %d/%d\n", verified, iterations);
+    printf("  Attestation (once):      %.3f ms (composite report + quote)\n", attest_ms);
+    if (verified > 0) {
+        double request_ms = total_request_time / verified;
+        printf("  Session request:         %.3f ms (P99 %.3f ms, MAC in enclave + verify)\n",
+               request_ms, request_hist.percentile_ms(99));
+        if (request_ms > 0) {
+            printf("  vs re-attesting:         %.0fx cheaper per request (before quote verification)\n",
+                   attest_ms / request_ms);
+        }
+        
+        report_out->add_operation("SGX Attested Session");
+        report_out->add_field("composite_report_ms", timing.report_ms);
+        report_out->add_field("quote_ms", timing.quote_ms);
+        report_out->add_field("session_setup_ms", timing.setup_ms);
+        report_out->add_field("request_ms", request_ms);
+        report_out->add_field("requests_verified", (double)verified);
+    }
+    return verified;
+}
+
+// A reconnecting prover: fresh challenge, proof from the sealed ticket, redeem.
+// With a `replay_status` the same challenge and proof are redeemed a second time.
+static ticket_status_t resume_session(sgx_enclave_id_t eid, const TicketIssuer& issuer,
+                                      const std::vector<uint8_t>& sealed_ticket, time_t now,
+                                      uint32_t tcb_evaluation, bool corrupt_proof,
+                                      AttestedSession* session,
+                                      ticket_status_t* replay_status) {
+    uint8_t challenge[SGX_RESUME_CHALLENGE_SIZE];
+    uint8_t ticket[SGX_RESUMPTION_TICKET_MAX];
+    uint8_t proof[SGX_SESSION_MAC_SIZE];
+    size_t ticket_size = 0;
+    int enclave_ret = 0;
+    if (!TicketIssuer::challenge(challenge)) {
+        return TICKET_MALFORMED;
+    }
+    sgx_status_t ret = ecall_resume_proof(eid, &enclave_ret,
+                                          (uint8_t*)&sealed_ticket[0], sealed_ticket.size(),
+                                          challenge, sizeof(challenge),
+                                          ticket, sizeof(ticket), &ticket_size,
+                                          proof, sizeof(proof));
+    if (ret != SGX_SUCCESS || enclave_ret != 0) {
+        return TICKET_MALFORMED;
+    }
+    if (corrupt_proof) {
+        challenge[0] ^= 1;  // answered a different challenge
+    }
+    ticket_claims_t claims;
+    ticket_status_t status = issuer.resume(ticket, ticket_size, challenge, proof, now,
+                                           tcb_evaluation, session, &claims);
+    if (replay_status) {
+        AttestedSession replayed;
+        *replay_status = issuer.resume(ticket, ticket_size, challenge, proof, now,
+                                       tcb_evaluation, &replayed, &claims);
+    }
+    return status;
+}
+
+// Full composite attestation once, then reconnects that redeem a sealed ticket
+int benchmark_session_resumption(sgx_enclave_id_t eid, AttestationContext* ctx,
+                                 QuoteBufferPool* pool, BenchReport* report_out, int iterations) {
+    printf("\n[+] Benchmarking Session Resumption (1 full attestation + %d reconnects)...\n",
+           iterations);
+    printf("---------------------------------------------------------------\n");
+    
+    TicketIssuer issuer;
+    QuoteVerifier verifier;
+    bool have_qvl = verifier.init() == SGX_QL_SUCCESS;
+    if (!issuer.init()) {
+        printf("  ✗ Failed to create a ticket key\n");
+        return -1;
+    }
+    
+    uint32_t quote_size = ctx->quote_size();
+    uint8_t* quote = pool->lease(quote_size);
+    if (!quote) {
+        printf("  ✗ No pooled buffer for a %u byte quote\n", quote_size);
+        return -1;
+    }
+    
+    // Full path: composite report, quote, DCAP verification, key exchange
+    AttestedSession session;
+    std::vector<uint8_t> sealed_session;
+    session_timing_t timing;
+    bool attested = attest_session(eid, ctx, quote, quote_size, &session, &sealed_session, &timing);
+    double verify_ms = 0;
+    bool quote_ok = false;
+    uint8_t mrenclave[SGX_BINDING_MRENCLAVE_SIZE];
+    if (attested) {
+        memcpy(mrenclave, ((const sgx_quote3_t*)quote)->report_body.mr_enclave.m, sizeof(mrenclave));
+        if (have_qvl) {
+            quote_scratch_t scratch;
+            quote_verdict_t verdict;
+            byte_span_t span = {quote, quote_size};
+            double verify_start = get_time_ms();
+            verifier.verify_batch(&span, 1, time(NULL), &scratch, &verdict);
+            verify_ms = get_time_ms() - verify_start;
+            quote_ok = QuoteVerifier::accepted(verdict);
+        }
+    }
+    pool->release(quote);
+    if (!attested) {
+        return -1;
+    }
+    double full_ms = timing.report_ms + timing.quote_ms + verify_ms + timing.setup_ms;
+    if (!have_qvl) {
+        printf("  ⚠ No DCAP QVL: full attestation timed without quote verification\n");
+    } else if (!quote_ok) {
+        printf("  ⚠ Quote not accepted by DCAP verification (issuing the ticket anyway)\n");
+    }
+    printf("  ✓ Full attestation: %.3f ms (report %.3f, quote %.3f, verify %.3f, setup %.3f)\n",
+           full_ms, timing.report_ms, timing.quote_ms, verify_ms, timing.setup_ms);
+    
+    // Ticket until the token's exp; the TCB evaluation it was verified under
+    time_t now = time(NULL);
+    int64_t expires = (int64_t)now + TICKET_LIFETIME_S;
+    uint32_t tcb_evaluation = verifier.tcb_evaluation();
+    uint8_t ticket[RESUMPTION_TICKET_SIZE];
+    std::vector<uint8_t> sealed_ticket(SGX_SESSION_SEALED_SIZE);
+    int enclave_ret = 0;
+    sgx_status_t ret = SGX_ERROR_UNEXPECTED;
+    if (issuer.issue(session, mrenclave, expires, tcb_evaluation, ticket)) {
+        ret = ecall_seal_ticket(eid, &enclave_ret, &sealed_session[0], sealed_session.size(),
+                                ticket, sizeof(ticket), &sealed_ticket[0], sealed_ticket.size());
+    }
+    if (ret != SGX_SUCCESS || enclave_ret != 0) {
+        printf("  ✗ Failed to issue and seal a ticket: SGX=0x%x, Enclave=%d\n", ret, enclave_ret);
+        return -1;
+    }
+    printf("  ✓ Ticket issued (%d bytes, TCB evaluation %u) and sealed by the enclave\n",
+           RESUMPTION_TICKET_SIZE, tcb_evaluation);
+    
+    int resumed = 0;
+    int first_error = TICKET_OK;
+    double total_resume_time = 0;
+    LatencyHistogram resume_hist;
+    for (int i = 0; i < iterations; i++) {
+        AttestedSession reconnected;
+        double start = get_time_ms();
+        ticket_status_t status = resume_session(eid, issuer, sealed_ticket, time(NULL),
+                                                tcb_evaluation, false, &reconnected, NULL);
+        double end = get_time_ms();
+        // The resumed channel must carry requests like the original one
+        if (status != TICKET_OK || !session_request(eid, sealed_ticket, reconnected, i)) {
+            if (first_error == TICKET_OK) {
+                first_error = status != TICKET_OK ? status : TICKET_BAD_PROOF;
+            }
+            continue;
+        }
+        resumed++;
+        total_resume_time += end - start;
+        resume_hist.record_ms(end - start);
+    }
+    
+    // Tickets must not outlive the token or a TCB recovery, and a proof
+    // answers exactly one challenge, once
+    AttestedSession rejected;
+    bool expired = resume_session(eid, issuer, sealed_ticket, (time_t)(expires + 1),
+                                  tcb_evaluation, false, &rejected, NULL) == TICKET_EXPIRED;
+    bool tcb_changed = resume_session(eid, issuer, sealed_ticket, time(NULL),
+                                      tcb_evaluation + 1, false, &rejected,
+                                      NULL) == TICKET_TCB_CHANGED;
+    bool wrong_challenge = resume_session(eid, issuer, sealed_ticket, time(NULL),
+                                          tcb_evaluation, true, &rejected,
+                                          NULL) == TICKET_BAD_PROOF;
+    ticket_status_t replay_status = TICKET_OK;
+    bool replayed = resume_session(eid, issuer, sealed_ticket, time(NULL), tcb_evaluation,
+                                   false, &rejected, &replay_status) == TICKET_OK &&
+                    replay_status == TICKET_REPLAYED;
+    bool rejections_ok = expired && tcb_changed && wrong_challenge && replayed;
+    
+    printf("\n  Results Summary:\n");
+    printf("  ---------------\n");
+    printf("  Reconnects resumed:      %d/%d\n", resumed, iterations);
+    if (first_error != TICKET_OK) {
+        printf("  ✗ First failure: %s\n", ticket_status_str((ticket_status_t)first_error));
+    }
+    printf("  %s Rejected after exp: %s, after TCB change: %s, wrong challenge: %s, "
+           "reused challenge: %s\n",
+           rejections_ok ? "✓" : "✗", expired ? "yes" : "no", tcb_changed ? "yes" : "no",
+           wrong_challenge ? "yes" : "no", replayed ? "yes" : "no");
+    printf("  Full attestation:        %.3f ms (+ %.2f ms TDX token baseline)\n",
+           full_ms, TDX_BASELINE_EVIDENCE_MS);
+    if (resumed == 0) {
+        return 0;
+    }
+    double resume_ms = total_resume_time / resumed;
+    printf("  Resumption:              %.3f ms (P99 %.3f ms, challenge + proof + redeem)\n",
+           resume_ms, resume_hist.percentile_ms(99));
+    if (resume_ms > 0) {
+        printf("  Per-connection speedup:  %.0fx (with TDX baseline: %.0fx)\n",
+               full_ms / resume_ms, (full_ms + TDX_BASELINE_EVIDENCE_MS) / resume_ms);
+    }
+    
+    report_out->add_operation("SGX Session Resumption");
+    report_out->add_field("full_attestation_ms", full_ms);
+    report_out->add_field("quote_verify_ms", verify_ms);
+    report_out->add_field("resume_ms", resume_ms);
+    report_out->add_field("resume_p99_ms", resume_hist.percentile_ms(99));
+    report_out->add_field("resumed", (double)resumed);
+    report_out->add_field("rejections_ok", rejections_ok ? 1.0 : 0.0);
+    return resumed;
+}
@@ -0,0 +1,75 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stddef.h>
+#include <atomic>
+
+#define CACHE_LINE_SIZE 64
+
+/*
+ * Bounded single-producer/single-consumer ring.
+ *
+ * try_push() may only be called from one thread and try_pop() from one
+ * other thread. Neither takes a lock: each side owns one index, publishes
+ * it with a release store and reads the other side's index with an
+ * acquire load only when its cached copy says the ring is full/empty.
+ * The indices and caches are padded onto separate cache lines so the
+ * producer and consumer do not false-share.
+ */
+template <typename T, size_t Capacity>
+class SpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscRing capacity must be a power of two");
+
+public:
+    SpscRing() : head_(0), tail_cache_(0), tail_(0), head_cache_(0) {}
+
+    /* Producer side. Returns false if the ring is full. */
+    bool try_push(const T& item) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ == Capacity) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ == Capacity) {
+                return false;
+            }
+        }
+        slots_[tail & (Capacity - 1)] = item;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /* Consumer side. Returns false if the ring is empty. */
+    bool try_pop(T* item) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cache_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_) {
+                return false;
+            }
+        }
+        *item = slots_[head & (Capacity - 1)];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /* Approximate occupancy; exact only when both sides are quiescent. */
+    size_t size() const {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+    static size_t capacity() { return Capacity; }
+
+private:
+    char pad0_[CACHE_LINE_SIZE];
+    /* Consumer-owned */
+    std::atomic<size_t> head_;
+    size_t tail_cache_;
+    char pad1_[CACHE_LINE_SIZE];
+    /* Producer-owned */
+    std::atomic<size_t> tail_;
+    size_t head_cache_;
+    char pad2_[CACHE_LINE_SIZE];
+    T slots_[Capacity];
+};
+
+#endif /* SPSC_RING_H */
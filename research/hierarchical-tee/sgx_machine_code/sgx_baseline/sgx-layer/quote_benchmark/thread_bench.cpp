@@ -0,0 +1,380 @@
+#include "quote_benchmark.h"
+
+#include <stdio.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "Enclave_u.h"
+#include "alloc_counter.h"
+#include "latency_histogram.h"
+#include "spsc_ring.h"
+
+#define PIPELINE_RING_SIZE 64
+
+typedef struct {
+    int successful;
+    int attempted;
+    double total_ereport_ms;
+    double total_quote_ms;
+    // Each worker's histograms have their own heap storage
+    LatencyHistogram ereport_hist;
+    LatencyHistogram quote_hist;
+    LatencyHistogram end_to_end_hist;
+} quote_worker_stats_t;
+
+static void quote_load_worker(sgx_enclave_id_t eid, AttestationContext* ctx,
+                              QuoteBufferPool* pool, int worker_id, int quotes,
+                              quote_worker_stats_t* stats) {
+    // Accumulate locally and publish once so workers do not share cache lines
+    int successful = 0;
+    double total_ereport_ms = 0;
+    double total_quote_ms = 0;
+    
+    for (int i = 0; i < quotes; i++) {
+        sgx_target_info_t qe_target_info;
+        uint64_t generation = ctx->target_info(&qe_target_info);
+        uint32_t quote_size = ctx->quote_size();
+        uint8_t* quote_buffer = pool->lease(quote_size);
+        if (!quote_buffer) {
+            continue;
+        }
+        
+        uint8_t report[sizeof(sgx_report_t)];
+        uint8_t custom_data[64] = {0};
+        snprintf((char*)custom_data, 64, "Thread-%d-Iteration-%d", worker_id, i);
+        
+        int enclave_ret = 0;
+        double ereport_start = get_time_ms();
+        sgx_status_t ret = ecall_generate_report_for_quote(
+            eid, &enclave_ret, report, sizeof(report),
+            (uint8_t*)&qe_target_info, sizeof(qe_target_info), custom_data, 64);
+        double ereport_end = get_time_ms();
+        if (ret != SGX_SUCCESS || enclave_ret != 0) {
+            pool->release(quote_buffer);
+            continue;
+        }
+        
+        quote3_error_t qe3_ret = ctx->get_quote((sgx_report_t*)report, generation,
+                                                quote_size, quote_buffer);
+        double quote_end = get_time_ms();
+        pool->release(quote_buffer);
+        if (qe3_ret != SGX_QL_SUCCESS) {
+            continue;
+        }
+        
+        successful++;
+        total_ereport_ms += ereport_end - ereport_start;
+        total_quote_ms += quote_end - ereport_end;
+        stats->ereport_hist.record_ms(ereport_end - ereport_start);
+        stats->quote_hist.record_ms(quote_end - ereport_end);
+        stats->end_to_end_hist.record_ms(quote_end - ereport_start);
+    }
+    
+    stats->successful = successful;
+    stats->attempted = quotes;
+    stats->total_ereport_ms = total_ereport_ms;
+    stats->total_quote_ms = total_quote_ms;
+}
+
+int benchmark_threaded_quotes(sgx_enclave_id_t eid, AttestationContext* ctx,
+                              QuoteBufferPool* pool, BenchReport* report_out,
+                              int iterations, int max_threads) {
+    printf("\n[+] Benchmarking Multi-threaded Quote Generation (1-%d threads, %d quotes each)...\n",
+           max_threads, iterations);
+    printf("---------------------------------------------------------------\n");
+    
+    // Scaling curve: powers of two up to the requested count, plus the count itself
+    std::vector<int> levels;
+    for (int n = 1; n < max_threads; n *= 2) {
+        levels.push_back(n);
+    }
+    levels.push_back(max_threads);
+    
+    double single_thread_tput = 0;
+    int rows = 0;
+    
+    printf("  %-7s | %-10s | %-11s | %-11s | %-11s | %-11s | %-7s | %s\n",
+           "Threads", "Quotes/sec", "EREPORT ms", "Quote ms", "Quote p99", "Successful",
+           "Scaling", "Allocs/quote");
+    // Tail table for the highest thread count that produced quotes
+    quote_worker_stats_t busiest = quote_worker_stats_t();
+    int busiest_threads = 0;
+    for (size_t l = 0; l < levels.size(); l++) {
+        int threads = levels[l];
+        std::vector<std::thread> workers;
+        std::vector<quote_worker_stats_t> stats(threads);
+        
+        uint64_t allocs_start = alloc_count();
+        double start = get_time_ms();
+        for (int t = 0; t < threads; t++) {
+            workers.push_back(std::thread(quote_load_worker, eid, ctx, pool,
+                                          t, iterations, &stats[t]));
+        }
+        for (size_t t = 0; t < workers.size(); t++) {
+            workers[t].join();
+        }
+        double wall_time = get_time_ms() - start;
+        // Includes the handful made by std::thread itself
+        uint64_t allocs = alloc_count() - allocs_start;
+        
+        quote_worker_stats_t total = quote_worker_stats_t();
+        for (int t = 0; t < threads; t++) {
+            total.successful += stats[t].successful;
+            total.attempted += stats[t].attempted;
+            total.total_ereport_ms += stats[t].total_ereport_ms;
+            total.total_quote_ms += stats[t].total_quote_ms;
+            total.ereport_hist.merge(stats[t].ereport_hist);
+            total.quote_hist.merge(stats[t].quote_hist);
+            total.end_to_end_hist.merge(stats[t].end_to_end_hist);
+        }
+        
+        if (total.successful == 0) {
+            printf("  %-7d | ✗ no quotes generated (0/%d)\n", threads, total.attempted);
+            continue;
+        }
+        
+        double tput = total.successful * 1000.0 / wall_time;
+        if (threads == 1) {
+            single_thread_tput = tput;
+        }
+        // Parallel efficiency relative to linear scaling from one thread;
+        // a flat quotes/sec column with rising Quote ms is where the QE/AESM serializes
+        double scaling = single_thread_tput > 0 ? tput / (single_thread_tput * threads) : 0;
+        printf("  %-7d | %10.1f | %11.3f | %11.3f | %11.3f | %5d/%-5d | %6.0f%% | %.2f\n",
+               threads, tput,
+               total.total_ereport_ms / total.successful,
+               total.total_quote_ms / total.successful,
+               total.quote_hist.percentile_ms(99.0),
+               total.successful, total.attempted, scaling * 100.0,
+               (double)allocs / total.successful);
+        rows++;
+        
+        char operation[64];
+        snprintf(operation, sizeof(operation), "SGX Multi-threaded Quote Generation (%d threads)",
+                 threads);
+        report_out->add_operation(operation);
+        report_out->add_field("threads", threads);
+        report_out->add_field("successes", total.successful);
+        report_out->add_field("failures", total.attempted - total.successful);
+        report_out->add_field("quotes_per_sec", tput);
+        report_out->add_field("scaling_efficiency", scaling);
+        report_out->add_field("quote_p50_ms", total.quote_hist.percentile_ms(50.0));
+        report_out->add_field("quote_p99_ms", total.quote_hist.percentile_ms(99.0));
+        report_out->add_field("end_to_end_p99_ms", total.end_to_end_hist.percentile_ms(99.0));
+        
+        busiest_threads = threads;
+        busiest = total;
+    }
+    
+    if (busiest_threads > 0) {
+        printf("\n  Tail Latency at %d threads:\n", busiest_threads);
+        print_latency_header();
+        print_latency_row("EREPORT", busiest.ereport_hist);
+        print_latency_row("Quote (QE)", busiest.quote_hist);
+        print_latency_row("End-to-End", busiest.end_to_end_hist);
+    }
+    
+    return rows;
+}
+
+typedef struct {
+    uint8_t report[sizeof(sgx_report_t)];
+    uint64_t generation;
+    double issued_ms;
+} pipeline_item_t;
+
+typedef SpscRing<pipeline_item_t, PIPELINE_RING_SIZE> report_ring_t;
+
+typedef struct {
+    int produced;
+    int consumed;
+    long producer_stalls;
+    long consumer_stalls;
+    double total_latency_ms;
+    LatencyHistogram latency_hist;
+} pipeline_stats_t;
+
+// Stage 1: EREPORT inside the enclave, handed to the paired QE stage
+static void pipeline_producer(sgx_enclave_id_t eid, AttestationContext* ctx,
+                              int stage_id, int quotes, report_ring_t* ring,
+                              std::atomic<bool>* done, pipeline_stats_t* stats) {
+    int produced = 0;
+    long stalls = 0;
+    
+    for (int i = 0; i < quotes; i++) {
+        pipeline_item_t item;
+        uint8_t custom_data[64] = {0};
+        snprintf((char*)custom_data, 64, "Pipeline-%d-Iteration-%d", stage_id, i);
+        
+        sgx_target_info_t qe_target_info;
+        int enclave_ret = 0;
+        item.issued_ms = get_time_ms();
+        item.generation = ctx->target_info(&qe_target_info);
+        sgx_status_t ret = ecall_generate_report_for_quote(
+            eid, &enclave_ret, item.report, sizeof(item.report),
+            (uint8_t*)&qe_target_info, sizeof(qe_target_info), custom_data, 64);
+        if (ret != SGX_SUCCESS || enclave_ret != 0) {
+            continue;
+        }
+        
+        while (!ring->try_push(item)) {
+            stalls++;
+            std::this_thread::yield();
+        }
+        produced++;
+    }
+    
+    done->store(true, std::memory_order_release);
+    stats->produced = produced;
+    stats->producer_stalls = stalls;
+}
+
+// Stage 2: drain reports into the Quoting Enclave
+static void pipeline_consumer(AttestationContext* ctx, QuoteBufferPool* pool,
+                              report_ring_t* ring, std::atomic<bool>* done,
+                              pipeline_stats_t* stats) {
+    int consumed = 0;
+    long stalls = 0;
+    double total_latency = 0;
+    
+    for (;;) {
+        pipeline_item_t item;
+        // Sample done before popping: an empty ring after the producer
+        // finished can never be refilled
+        bool finished = done->load(std::memory_order_acquire);
+        if (!ring->try_pop(&item)) {
+            if (finished) {
+                break;
+            }
+            stalls++;
+            std::this_thread::yield();
+            continue;
+        }
+        
+        uint32_t quote_size = ctx->quote_size();
+        uint8_t* quote_buffer = pool->lease(quote_size);
+        if (quote_buffer &&
+            ctx->get_quote((sgx_report_t*)item.report, item.generation,
+                           quote_size, quote_buffer) == SGX_QL_SUCCESS) {
+            double latency = get_time_ms() - item.issued_ms;
+            consumed++;
+            total_latency += latency;
+            stats->latency_hist.record_ms(latency);
+        }
+        pool->release(quote_buffer);
+    }
+    
+    stats->consumed = consumed;
+    stats->consumer_stalls = stalls;
+    stats->total_latency_ms = total_latency;
+}
+
+int benchmark_pipelined_quotes(sgx_enclave_id_t eid, AttestationContext* ctx,
+                               QuoteBufferPool* pool, BenchReport* report_out,
+                               int iterations, int stages) {
+    printf("\n[+] Benchmarking Pipelined EREPORT/QE (%d stage pairs, %d quotes each)...\n",
+           stages, iterations);
+    printf("---------------------------------------------------------------\n");
+    
+    // Baseline: the same number of enclave threads doing EREPORT then QE in lockstep
+    std::vector<std::thread> workers;
+    std::vector<quote_worker_stats_t> seq_stats(stages);
+    uint64_t allocs_start = alloc_count();
+    double start = get_time_ms();
+    for (int t = 0; t < stages; t++) {
+        workers.push_back(std::thread(quote_load_worker, eid, ctx, pool,
+                                      t, iterations, &seq_stats[t]));
+    }
+    for (size_t t = 0; t < workers.size(); t++) {
+        workers[t].join();
+    }
+    double seq_wall = get_time_ms() - start;
+    uint64_t seq_allocs = alloc_count() - allocs_start;
+    workers.clear();
+    
+    int seq_successful = 0;
+    double seq_latency = 0;
+    LatencyHistogram seq_hist;
+    for (int t = 0; t < stages; t++) {
+        seq_successful += seq_stats[t].successful;
+        seq_latency += seq_stats[t].total_ereport_ms + seq_stats[t].total_quote_ms;
+        seq_hist.merge(seq_stats[t].end_to_end_hist);
+    }
+    
+    // Pipeline: one SPSC ring per producer/consumer pair
+    std::vector<report_ring_t*> rings(stages);
+    std::vector<pipeline_stats_t> pipe_stats(stages);
+    std::atomic<bool>* done = new std::atomic<bool>[stages];
+    for (int t = 0; t < stages; t++) {
+        rings[t] = new report_ring_t();
+        done[t].store(false);
+    }
+    
+    allocs_start = alloc_count();
+    start = get_time_ms();
+    for (int t = 0; t < stages; t++) {
+        workers.push_back(std::thread(pipeline_consumer, ctx, pool, rings[t],
+                                      &done[t], &pipe_stats[t]));
+        workers.push_back(std::thread(pipeline_producer, eid, ctx, t,
+                                      iterations, rings[t], &done[t], &pipe_stats[t]));
+    }
+    for (size_t t = 0; t < workers.size(); t++) {
+        workers[t].join();
+    }
+    double pipe_wall = get_time_ms() - start;
+    uint64_t pipe_allocs = alloc_count() - allocs_start;
+    
+    int pipe_produced = 0;
+    int pipe_consumed = 0;
+    long producer_stalls = 0;
+    long consumer_stalls = 0;
+    double pipe_latency = 0;
+    LatencyHistogram pipe_hist;
+    for (int t = 0; t < stages; t++) {
+        pipe_produced += pipe_stats[t].produced;
+        pipe_consumed += pipe_stats[t].consumed;
+        producer_stalls += pipe_stats[t].producer_stalls;
+        consumer_stalls += pipe_stats[t].consumer_stalls;
+        pipe_latency += pipe_stats[t].total_latency_ms;
+        pipe_hist.merge(pipe_stats[t].latency_hist);
+        delete rings[t];
+    }
+    delete[] done;
+    
+    printf("\n  Results Summary:\n");
+    printf("  ---------------\n");
+    printf("  Ring capacity:           %zu reports per stage pair\n", report_ring_t::capacity());
+    
+    if (seq_successful == 0 || pipe_consumed == 0) {
+        printf("  ✗ No quotes generated (sequential %d, pipelined %d)\n",
+               seq_successful, pipe_consumed);
+        return -1;
+    }
+    
+    double seq_tput = seq_successful * 1000.0 / seq_wall;
+    double pipe_tput = pipe_consumed * 1000.0 / pipe_wall;
+    printf("  Sequential:              %.1f quotes/sec, %.3f ms/quote (%d ok)\n",
+           seq_tput, seq_latency / seq_successful, seq_successful);
+    printf("  Pipelined:               %.1f quotes/sec, %.3f ms/quote (%d/%d ok)\n",
+           pipe_tput, pipe_latency / pipe_consumed, pipe_consumed, pipe_produced);
+    printf("  Allocations per quote:   %.2f sequential, %.2f pipelined\n",
+           (double)seq_allocs / seq_successful, (double)pipe_allocs / pipe_consumed);
+    printf("  Producer stalls (full):  %ld\n", producer_stalls);
+    printf("  Consumer stalls (empty): %ld\n", consumer_stalls);
+    printf("  Pipeline speedup:        %.2fx\n", pipe_tput / seq_tput);
+    
+    // Pipelined latency runs from EREPORT issue to quote done, ring wait included
+    printf("\n  Tail Latency (end-to-end per quote):\n");
+    print_latency_header();
+    print_latency_row("Sequential", seq_hist);
+    print_latency_row("Pipelined", pipe_hist);
+    
+    report_out->add_operation("SGX Pipelined Quote Generation");
+    report_out->add_field("stages", stages);
+    report_out->add_field("sequential_quotes_per_sec", seq_tput);
+    report_out->add_field("pipelined_quotes_per_sec", pipe_tput);
+    report_out->add_field("sequential_p99_ms", seq_hist.percentile_ms(99.0));
+    report_out->add_field("pipelined_p99_ms", pipe_hist.percentile_ms(99.0));
+    
+    return pipe_consumed;
+}
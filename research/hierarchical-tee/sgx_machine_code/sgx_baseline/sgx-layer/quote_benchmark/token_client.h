@@ -0,0 +1,21 @@
+#ifndef TOKEN_CLIENT_H
+#define TOKEN_CLIENT_H
+
+#include <stdint.h>
+#include <string>
+
+/*
+ * SGX host side of the TD token service (token_service.h), shared by the
+ * overlapped and reservoir benchmarks. One request is in flight per
+ * connection; a caller that wants requests in parallel opens another.
+ */
+
+/* Connect to tdx_bench --serve at HOST:PORT; -1 if unreachable. */
+int connect_token_service(const char* address);
+
+/* Trust Authority token over `binding` from the TD. fd < 0 models the TD:
+ * the baseline's evidence time and a JWT-shaped token of the baseline size.
+ * False if the connection failed; the TD's own verdict is in `status`. */
+bool fetch_tdx_token(int fd, const uint8_t* binding, std::string* token, uint8_t* status);
+
+#endif /* TOKEN_CLIENT_H */
@@ -0,0 +1,246 @@
+/*
+ * ConfigSweep.cpp - loads the sample enclave once per signed configuration
+ * (Enclave/config.01.xml .. config.05.xml, see `make sweep`) and compares
+ * load time, EPC footprint and concurrent ECALL throughput.
+ *
+ * Static layouts (01) EADD every heap/stack/TCS page at load; dynamic ones
+ * (02-05, HeapMinSize/TCSMinPool) commit only the minimum and grow with
+ * EDMM on SGX2 hosts, so they should load faster and pin fewer EPC pages.
+ * On SGX1 hosts the SDK commits the maximum layout and the gap disappears.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sgx_urts.h"
+#include "App.h"
+#include "Enclave_u.h"
+#include "bench_clock.h"
+#include "bench_report.h"
+#include "latency_histogram.h"
+
+#define SWEEP_CONFIGS 5
+#define MAX_SWEEP_THREADS 64
+#define EPC_PAGE_SIZE 4096
+
+/* Shared with the Edger8rSyntax/TrustedLibrary helpers linked into the sweep */
+sgx_enclave_id_t global_eid = 0;
+
+void ocall_print_string(const char *str)
+{
+    printf("%s", str);
+}
+
+typedef struct {
+    int calls;
+    int successful;
+    int out_of_tcs;
+    LatencyHistogram latency_hist;
+} sweep_worker_stats_t;
+
+/* Free EPC pages reported by the out-of-tree isgx driver, -1 if unavailable.
+ * The in-kernel driver exposes no free-page counter, see enclave_mapped_pages.
+ */
+static long epc_free_pages(void)
+{
+    FILE *f = fopen("/sys/module/isgx/parameters/sgx_nr_free_pages", "r");
+    if (f == NULL)
+        return -1;
+    long pages = -1;
+    if (fscanf(f, "%ld", &pages) != 1)
+        pages = -1;
+    fclose(f);
+    return pages;
+}
+
+/* Pages of this process' enclave mappings that are accessible. The urts
+ * reserves the whole ELRANGE PROT_NONE and only opens committed pages, so
+ * this tracks what the enclave has added, not what ELRANGE could hold.
+ */
+static long enclave_mapped_pages(void)
+{
+    FILE *f = fopen("/proc/self/maps", "r");
+    if (f == NULL)
+        return -1;
+
+    long pages = 0;
+    char line[512];
+    while (fgets(line, sizeof(line), f) != NULL) {
+        unsigned long start = 0, end = 0;
+        char perms[8] = {0};
+        if (sscanf(line, "%lx-%lx %7s", &start, &end, perms) != 3)
+            continue;
+        if (strstr(line, "/dev/sgx") == NULL && strstr(line, "/dev/isgx") == NULL)
+            continue;
+        if (strncmp(perms, "---", 3) == 0)
+            continue;
+        pages += (long)((end - start) / EPC_PAGE_SIZE);
+    }
+    fclose(f);
+    return pages;
+}
+
+/* Resident EPC pages attributable to the loaded enclave */
+static long epc_resident_pages(long free_before)
+{
+    long free_now = epc_free_pages();
+    if (free_before >= 0 && free_now >= 0)
+        return free_before - free_now;
+    return enclave_mapped_pages();
+}
+
+static void sweep_worker(sgx_enclave_id_t eid, int calls, sweep_worker_stats_t *stats)
+{
+    stats->calls = calls;
+    for (int i = 0; i < calls; i++) {
+        uint64_t start = bench_now_ticks();
+        sgx_status_t ret = ecall_malloc_free(eid);
+        uint64_t end = bench_now_ticks();
+
+        if (ret == SGX_SUCCESS) {
+            stats->successful++;
+            stats->latency_hist.record_ns((uint64_t)bench_ticks_to_ns(end - start));
+        } else if (ret == SGX_ERROR_OUT_OF_TCS) {
+            stats->out_of_tcs++;
+        }
+    }
+}
+
+/* One configuration: `loads` timed create/destroy cycles, then a loaded
+ * enclave is measured for EPC pages and hammered from `threads` threads.
+ */
+static void sweep_config(BenchReport *report_out, const char *config, const char *enclave_file,
+                         int loads, int threads, int calls)
+{
+    printf("\n[%s] %s\n", config, enclave_file);
+
+    LatencyHistogram create_hist;
+    std::vector<double> create_samples;
+    for (int i = 0; i < loads; i++) {
+        sgx_enclave_id_t eid = 0;
+        double start = bench_now_ms();
+        sgx_status_t ret = sgx_create_enclave(enclave_file, SGX_DEBUG_FLAG, NULL, NULL, &eid, NULL);
+        double latency = bench_now_ms() - start;
+        if (ret != SGX_SUCCESS) {
+            printf("  ✗ sgx_create_enclave failed: 0x%x\n", ret);
+            return;
+        }
+        create_hist.record_ms(latency);
+        create_samples.push_back(latency);
+        sgx_destroy_enclave(eid);
+    }
+
+    long free_before = epc_free_pages();
+    sgx_enclave_id_t eid = 0;
+    sgx_status_t ret = sgx_create_enclave(enclave_file, SGX_DEBUG_FLAG, NULL, NULL, &eid, NULL);
+    if (ret != SGX_SUCCESS) {
+        printf("  ✗ sgx_create_enclave failed: 0x%x\n", ret);
+        return;
+    }
+    global_eid = eid;
+    long pages_loaded = epc_resident_pages(free_before);
+
+    std::vector<std::thread> workers;
+    std::vector<sweep_worker_stats_t> stats(threads, sweep_worker_stats_t());
+    double start = bench_now_ms();
+    for (int t = 0; t < threads; t++) {
+        workers.push_back(std::thread(sweep_worker, eid, calls, &stats[t]));
+    }
+    for (size_t t = 0; t < workers.size(); t++) {
+        workers[t].join();
+    }
+    double wall_time = bench_now_ms() - start;
+
+    // Dynamic layouts have grown their heap/TCS pool by now
+    long pages_after_run = epc_resident_pages(free_before);
+    sgx_destroy_enclave(eid);
+    global_eid = 0;
+
+    int successful = 0;
+    int out_of_tcs = 0;
+    LatencyHistogram ecall_hist;
+    for (int t = 0; t < threads; t++) {
+        successful += stats[t].successful;
+        out_of_tcs += stats[t].out_of_tcs;
+        ecall_hist.merge(stats[t].latency_hist);
+    }
+    double throughput = successful * 1000.0 / wall_time;
+
+    printf("  EPC pages: %ld after load, %ld after %d-thread run (%s)\n",
+           pages_loaded, pages_after_run, threads,
+           free_before >= 0 ? "isgx free-page delta" : "committed enclave mappings");
+    printf("  ECALLs: %d/%d successful, %d SGX_ERROR_OUT_OF_TCS, %.0f calls/sec\n",
+           successful, threads * calls, out_of_tcs, throughput);
+    print_latency_header();
+    print_latency_row("sgx_create_enclave", create_hist);
+    print_latency_row("ecall_malloc_free", ecall_hist);
+
+    std::string operation = std::string("SGX Enclave Creation (") + config + ")";
+    report_out->add_latency(operation.c_str(), create_samples, loads);
+    report_out->add_field("epc_pages_loaded", (double)pages_loaded);
+    report_out->add_field("epc_pages_after_run", (double)pages_after_run);
+    report_out->add_field("ecall_threads", threads);
+    report_out->add_field("ecall_per_sec", throughput);
+    report_out->add_field("ecall_p50_ms", ecall_hist.percentile_ms(50.0));
+    report_out->add_field("ecall_p99_ms", ecall_hist.percentile_ms(99.0));
+    report_out->add_field("out_of_tcs", out_of_tcs);
+}
+
+static void print_usage(const char *prog)
+{
+    printf("Usage: %s [--loads N] [--threads N] [--calls N] [--json FILE]\n", prog);
+    printf("  Expects enclave.config01.signed.so .. enclave.config05.signed.so (make sweep)\n");
+}
+
+int SGX_CDECL main(int argc, char *argv[])
+{
+    int loads = 10;
+    int threads = 8;
+    int calls = 2000;
+    std::string json_path = bench_report_path("sgx_config_sweep", "json");
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--loads") == 0 && i + 1 < argc) {
+            loads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--calls") == 0 && i + 1 < argc) {
+            calls = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (loads < 1 || calls < 1 || threads < 1 || threads > MAX_SWEEP_THREADS) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    printf("======================================================\n");
+    printf("SGX Enclave Configuration Sweep\n");
+    printf("======================================================\n");
+    printf("  %d loads, %d threads x %d ECALLs per config, clock: %s\n",
+           loads, threads, calls, bench_clock_source());
+
+    BenchReport report("Intel SGX");
+    for (int c = 1; c <= SWEEP_CONFIGS; c++) {
+        char config[16];
+        char enclave_file[64];
+        snprintf(config, sizeof(config), "config.%02d", c);
+        snprintf(enclave_file, sizeof(enclave_file), "enclave.config%02d.signed.so", c);
+        sweep_config(&report, config, enclave_file, loads, threads, calls);
+    }
+
+    std::string csv_path = bench_report_csv_path(json_path);
+    if (report.write_json(json_path.c_str()) && report.write_csv(csv_path.c_str())) {
+        printf("\n✓ Results saved to: %s (samples: %s)\n", json_path.c_str(), csv_path.c_str());
+    } else {
+        printf("\n✗ Failed to write results to %s\n", json_path.c_str());
+    }
+    return 0;
+}
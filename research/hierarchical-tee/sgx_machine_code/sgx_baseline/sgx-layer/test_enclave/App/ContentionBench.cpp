@@ -0,0 +1,378 @@
+/*
+ * ContentionBench.cpp - trusted-side contention under concurrent ECALLs
+ * (`make contention`).
+ *
+ * Request scratch: ecall_request_scratch() allocates one verification
+ * request's buffers either from trusted malloc, where every TCS shares the
+ * heap lock, or from the per-TCS arena of Enclave/TrustedLibrary/Arena.h.
+ * Both run from 1 up to --threads threads; the gap that opens as threads
+ * are added is the heap lock.
+ *
+ * Counters: ecall_count_mutex() increments under an sgx_thread_mutex,
+ * ecall_count_sharded() on the per-TCS atomic counter of
+ * Enclave/TrustedLibrary/Counter.h. Besides throughput, each run reports
+ * the synchronization OCALLs (enclave exits) counted by OcallCounter.h and
+ * checks the aggregated total.
+ *
+ * Queue handoff: the ecall_producer/ecall_consumer sample (one producer,
+ * four consumers on sgx_thread_cond) against the same handoff on the
+ * spin-then-park SpinParkQueue of Enclave/TrustedLibrary/SpinPark.h, at
+ * several spin budgets. Reports round latency and enclave exits per
+ * million items.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sgx_urts.h"
+#include "App.h"
+#include "Enclave_u.h"
+#include "OcallCounter.h"
+#include "user_types.h"
+#include "bench_clock.h"
+#include "bench_report.h"
+#include "latency_histogram.h"
+
+#define ENCLAVE_TCS_NUM 10  /* TCSNum in Enclave/Enclave.config.xml */
+#define HANDOFF_CONSUMERS 4  /* as in ecall_thread_functions */
+#define HANDOFF_ITEMS (HANDOFF_CONSUMERS * LOOPS_PER_THREAD)
+
+/* 0 parks at once, like sgx_thread_cond_wait */
+static const unsigned int handoff_spins[] = {0, 100, 1000, 10000};
+
+/* Shared with the Edger8rSyntax/TrustedLibrary helpers linked into the bench */
+sgx_enclave_id_t global_eid = 0;
+
+void ocall_print_string(const char *str)
+{
+    printf("%s", str);
+}
+
+typedef struct {
+    int successful;
+    int failed;
+    LatencyHistogram latency_hist;
+} scratch_worker_stats_t;
+
+typedef struct {
+    double calls_per_sec;
+    double p50_ms;
+    double p99_ms;
+    int failed;
+} scratch_result_t;
+
+static void scratch_worker(int use_arena, int calls, scratch_worker_stats_t *stats)
+{
+    for (int i = 0; i < calls; i++) {
+        int ret = -1;
+        uint64_t start = bench_now_ticks();
+        sgx_status_t status = ecall_request_scratch(global_eid, &ret, use_arena);
+        uint64_t end = bench_now_ticks();
+
+        if (status == SGX_SUCCESS && ret == 0) {
+            stats->successful++;
+            stats->latency_hist.record_ns((uint64_t)bench_ticks_to_ns(end - start));
+        } else {
+            stats->failed++;
+        }
+    }
+}
+
+static scratch_result_t run_scratch(int use_arena, int threads, int calls)
+{
+    std::vector<std::thread> workers;
+    std::vector<scratch_worker_stats_t> stats((size_t)threads, scratch_worker_stats_t());
+    double start = bench_now_ms();
+    for (int t = 0; t < threads; t++) {
+        workers.push_back(std::thread(scratch_worker, use_arena, calls, &stats[(size_t)t]));
+    }
+    for (size_t t = 0; t < workers.size(); t++) {
+        workers[t].join();
+    }
+    double wall_time = bench_now_ms() - start;
+
+    int successful = 0;
+    scratch_result_t result;
+    result.failed = 0;
+    LatencyHistogram hist;
+    for (size_t t = 0; t < stats.size(); t++) {
+        successful += stats[t].successful;
+        result.failed += stats[t].failed;
+        hist.merge(stats[t].latency_hist);
+    }
+    result.calls_per_sec = wall_time > 0 ? successful * 1000.0 / wall_time : 0;
+    result.p50_ms = hist.percentile_ms(50.0);
+    result.p99_ms = hist.percentile_ms(99.0);
+    return result;
+}
+
+static void add_scratch_operation(BenchReport *report_out, const char *mode, int threads,
+                                  int calls, const scratch_result_t &result)
+{
+    char operation[96];
+    snprintf(operation, sizeof(operation), "SGX Request Scratch (%s, %d threads)", mode, threads);
+    report_out->add_operation(operation);
+    report_out->add_field("threads", threads);
+    report_out->add_field("calls", (double)threads * calls);
+    report_out->add_field("failures", result.failed);
+    report_out->add_field("calls_per_sec", result.calls_per_sec);
+    report_out->add_field("p50_ms", result.p50_ms);
+    report_out->add_field("p99_ms", result.p99_ms);
+}
+
+static void benchmark_request_scratch(BenchReport *report_out, int max_threads, int calls)
+{
+    printf("\n[+] Request scratch: trusted malloc vs per-TCS arena (%d calls per thread)\n", calls);
+    printf("---------------------------------------------------------------\n");
+
+    // Warm both paths so the heap and every TCS's TLS are committed
+    run_scratch(0, max_threads, 100);
+    run_scratch(1, max_threads, 100);
+
+    printf("  %-8s %14s %10s %14s %10s %9s\n",
+           "threads", "malloc/s", "p99 ms", "arena/s", "p99 ms", "speedup");
+    for (int threads = 1; threads <= max_threads; threads++) {
+        scratch_result_t heap = run_scratch(0, threads, calls);
+        scratch_result_t arena = run_scratch(1, threads, calls);
+        double speedup = heap.calls_per_sec > 0 ? arena.calls_per_sec / heap.calls_per_sec : 0;
+        printf("  %-8d %14.0f %10.4f %14.0f %10.4f %8.2fx\n", threads,
+               heap.calls_per_sec, heap.p99_ms, arena.calls_per_sec, arena.p99_ms, speedup);
+        if (heap.failed || arena.failed) {
+            printf("  ✗ %d malloc and %d arena calls failed\n", heap.failed, arena.failed);
+        }
+
+        add_scratch_operation(report_out, "malloc", threads, calls, heap);
+        add_scratch_operation(report_out, "arena", threads, calls, arena);
+        report_out->add_field("speedup", speedup);
+    }
+    // Peak over every worker's TCS, kept by the enclave across ECALLs
+    size_t arena_bytes = 0;
+    ecall_arena_high_water(global_eid, &arena_bytes);
+    printf("  Arena high-water mark: %zu bytes per request\n", arena_bytes);
+}
+
+typedef struct {
+    double increments_per_sec;
+    uint64_t exits;
+    double exits_per_million;
+    bool exact;
+} counter_result_t;
+
+static void counter_worker(int sharded, size_t increments, sgx_status_t *status)
+{
+    if (sharded)
+        *status = ecall_count_sharded(global_eid, increments);
+    else
+        *status = ecall_count_mutex(global_eid, increments);
+}
+
+static counter_result_t run_counter(int sharded, int threads, size_t increments)
+{
+    ecall_count_reset(global_eid);
+    std::vector<std::thread> workers;
+    std::vector<sgx_status_t> status((size_t)threads, SGX_SUCCESS);
+    uint64_t exits_before = ocall_sync_exits();
+    double start = bench_now_ms();
+    for (int t = 0; t < threads; t++) {
+        workers.push_back(std::thread(counter_worker, sharded, increments, &status[(size_t)t]));
+    }
+    for (size_t t = 0; t < workers.size(); t++) {
+        workers[t].join();
+    }
+    double wall_time = bench_now_ms() - start;
+
+    counter_result_t result;
+    result.exits = ocall_sync_exits() - exits_before;
+    double total = (double)threads * (double)increments;
+    result.increments_per_sec = wall_time > 0 ? total * 1000.0 / wall_time : 0;
+    result.exits_per_million = (double)result.exits * 1e6 / total;
+
+    size_t count = 0;
+    bool ok = ecall_count_read(global_eid, &count, sharded) == SGX_SUCCESS;
+    for (size_t t = 0; t < status.size(); t++) {
+        ok = ok && status[t] == SGX_SUCCESS;
+    }
+    result.exact = ok && count == (size_t)threads * increments;
+    return result;
+}
+
+static void add_counter_operation(BenchReport *report_out, const char *mode, int threads,
+                                  size_t increments, const counter_result_t &result)
+{
+    char operation[96];
+    snprintf(operation, sizeof(operation), "SGX Counter (%s, %d threads)", mode, threads);
+    report_out->add_operation(operation);
+    report_out->add_field("threads", threads);
+    report_out->add_field("increments", (double)threads * (double)increments);
+    report_out->add_field("increments_per_sec", result.increments_per_sec);
+    report_out->add_field("ocall_exits", (double)result.exits);
+    report_out->add_field("exits_per_million", result.exits_per_million);
+    report_out->add_field("exact", result.exact ? 1 : 0);
+}
+
+static void benchmark_counters(BenchReport *report_out, int max_threads, size_t increments)
+{
+    printf("\n[+] Counters: sgx_thread_mutex vs per-TCS atomic (%zu increments per thread)\n",
+           increments);
+    printf("---------------------------------------------------------------\n");
+    printf("  %-8s %14s %12s %14s %12s %9s\n",
+           "threads", "mutex inc/s", "exits/M", "sharded inc/s", "exits/M", "speedup");
+    for (int threads = 1; threads <= max_threads; threads++) {
+        counter_result_t mutex = run_counter(0, threads, increments);
+        counter_result_t sharded = run_counter(1, threads, increments);
+        double speedup = mutex.increments_per_sec > 0
+            ? sharded.increments_per_sec / mutex.increments_per_sec : 0;
+        printf("  %-8d %14.0f %12.1f %14.0f %12.1f %8.2fx\n", threads,
+               mutex.increments_per_sec, mutex.exits_per_million,
+               sharded.increments_per_sec, sharded.exits_per_million, speedup);
+        if (!mutex.exact || !sharded.exact) {
+            printf("  ✗ Lost increments (mutex %s, sharded %s)\n",
+                   mutex.exact ? "exact" : "short", sharded.exact ? "exact" : "short");
+        }
+
+        add_counter_operation(report_out, "mutex", threads, increments, mutex);
+        add_counter_operation(report_out, "sharded", threads, increments, sharded);
+        report_out->add_field("speedup", speedup);
+    }
+}
+
+typedef struct {
+    std::vector<double> round_ms;
+    LatencyHistogram round_hist;
+    double exits_per_million;
+} handoff_result_t;
+
+/* spin < 0: the sgx_thread_cond sample */
+static void handoff_producer(long spin)
+{
+    sgx_status_t ret = spin < 0 ? ecall_producer(global_eid)
+                                : ecall_spin_producer(global_eid, HANDOFF_ITEMS, (unsigned int)spin);
+    if (ret != SGX_SUCCESS)
+        abort();
+}
+
+static void handoff_consumer(long spin)
+{
+    sgx_status_t ret = spin < 0 ? ecall_consumer(global_eid)
+                                : ecall_spin_consumer(global_eid, LOOPS_PER_THREAD, (unsigned int)spin);
+    if (ret != SGX_SUCCESS)
+        abort();
+}
+
+static void run_handoff(long spin, int rounds, handoff_result_t *result)
+{
+    uint64_t exits_before = ocall_sync_exits();
+    for (int r = 0; r < rounds; r++) {
+        std::vector<std::thread> workers;
+        double start = bench_now_ms();
+        for (int c = 0; c < HANDOFF_CONSUMERS; c++) {
+            workers.push_back(std::thread(handoff_consumer, spin));
+        }
+        workers.push_back(std::thread(handoff_producer, spin));
+        for (size_t t = 0; t < workers.size(); t++) {
+            workers[t].join();
+        }
+        double latency = bench_now_ms() - start;
+        result->round_ms.push_back(latency);
+        result->round_hist.record_ms(latency);
+    }
+    double items = (double)rounds * HANDOFF_ITEMS;
+    result->exits_per_million = (double)(ocall_sync_exits() - exits_before) * 1e6 / items;
+}
+
+static void benchmark_handoff(BenchReport *report_out, int rounds)
+{
+    printf("\n[+] Queue handoff: sgx_thread_cond vs spin-then-park "
+           "(1 producer, %d consumers, %d items x %d rounds)\n",
+           HANDOFF_CONSUMERS, HANDOFF_ITEMS, rounds);
+    printf("---------------------------------------------------------------\n");
+    printf("  %-18s %12s %12s %12s %12s\n", "variant", "p50 ms", "p99 ms", "ns/item", "exits/M");
+
+    size_t variants = 1 + sizeof(handoff_spins) / sizeof(handoff_spins[0]);
+    for (size_t v = 0; v < variants; v++) {
+        long spin = v == 0 ? -1 : (long)handoff_spins[v - 1];
+        char label[32];
+        if (spin < 0)
+            snprintf(label, sizeof(label), "sgx_thread_cond");
+        else
+            snprintf(label, sizeof(label), "spin %ld", spin);
+
+        handoff_result_t result;
+        run_handoff(spin, rounds, &result);
+        double p50 = result.round_hist.percentile_ms(50.0);
+        double ns_per_item = p50 * 1e6 / HANDOFF_ITEMS;
+        printf("  %-18s %12.3f %12.3f %12.1f %12.1f\n", label, p50,
+               result.round_hist.percentile_ms(99.0), ns_per_item, result.exits_per_million);
+
+        std::string operation = std::string("SGX Queue Handoff (") + label + ")";
+        report_out->add_latency(operation.c_str(), result.round_ms, rounds);
+        report_out->add_field("items_per_round", HANDOFF_ITEMS);
+        report_out->add_field("ns_per_item_p50", ns_per_item);
+        report_out->add_field("exits_per_million", result.exits_per_million);
+    }
+}
+
+static void print_usage(const char *prog)
+{
+    printf("Usage: %s [--threads N] [--calls N] [--increments N] [--rounds N] [--json FILE]\n",
+           prog);
+    printf("  Runs 1..N threads (N <= %d, the enclave's TCSNum)\n", ENCLAVE_TCS_NUM);
+}
+
+int SGX_CDECL main(int argc, char *argv[])
+{
+    int threads = ENCLAVE_TCS_NUM;
+    int calls = 20000;
+    long increments = 1000000;
+    int rounds = 200;
+    std::string json_path = bench_report_path("sgx_contention", "json");
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--calls") == 0 && i + 1 < argc) {
+            calls = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--increments") == 0 && i + 1 < argc) {
+            increments = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--rounds") == 0 && i + 1 < argc) {
+            rounds = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (calls < 1 || increments < 1 || rounds < 1 || threads < 1 || threads > ENCLAVE_TCS_NUM) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    printf("======================================================\n");
+    printf("SGX Trusted-Side Contention\n");
+    printf("======================================================\n");
+    printf("  1..%d threads x %d ECALLs, clock: %s\n", threads, calls, bench_clock_source());
+
+    sgx_status_t ret = sgx_create_enclave(ENCLAVE_FILENAME, SGX_DEBUG_FLAG, NULL, NULL, &global_eid, NULL);
+    if (ret != SGX_SUCCESS) {
+        printf("✗ sgx_create_enclave failed: 0x%x\n", ret);
+        return 1;
+    }
+
+    BenchReport report("Intel SGX");
+    benchmark_request_scratch(&report, threads, calls);
+    benchmark_counters(&report, threads, (size_t)increments);
+    benchmark_handoff(&report, rounds);
+    sgx_destroy_enclave(global_eid);
+
+    std::string csv_path = bench_report_csv_path(json_path);
+    if (report.write_json(json_path.c_str()) && report.write_csv(csv_path.c_str())) {
+        printf("\n✓ Results saved to: %s (samples: %s)\n", json_path.c_str(), csv_path.c_str());
+    } else {
+        printf("\n✗ Failed to write results to %s\n", json_path.c_str());
+    }
+    return 0;
+}
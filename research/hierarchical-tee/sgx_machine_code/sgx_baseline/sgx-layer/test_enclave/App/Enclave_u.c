@@ -1,549 +0,0 @@
-#include "Enclave_u.h"
-#include <errno.h>
-
-typedef struct ms_ecall_type_char_t {
-	char ms_val;
-} ms_ecall_type_char_t;
-
-typedef struct ms_ecall_type_int_t {
-	int ms_val;
-} ms_ecall_type_int_t;
-
-typedef struct ms_ecall_type_float_t {
-	float ms_val;
-} ms_ecall_type_float_t;
-
-typedef struct ms_ecall_type_double_t {
-	double ms_val;
-} ms_ecall_type_double_t;
-
-typedef struct ms_ecall_type_size_t_t {
-	size_t ms_val;
-} ms_ecall_type_size_t_t;
-
-typedef struct ms_ecall_type_wchar_t_t {
-	wchar_t ms_val;
-} ms_ecall_type_wchar_t_t;
-
-typedef struct ms_ecall_type_struct_t {
-	struct struct_foo_t ms_val;
-} ms_ecall_type_struct_t;
-
-typedef struct ms_ecall_type_enum_union_t {
-	enum enum_foo_t ms_val1;
-	union union_foo_t* ms_val2;
-} ms_ecall_type_enum_union_t;
-
-typedef struct ms_ecall_pointer_user_check_t {
-	size_t ms_retval;
-	void* ms_val;
-	size_t ms_sz;
-} ms_ecall_pointer_user_check_t;
-
-typedef struct ms_ecall_pointer_in_t {
-	int* ms_val;
-} ms_ecall_pointer_in_t;
-
-typedef struct ms_ecall_pointer_out_t {
-	int* ms_val;
-} ms_ecall_pointer_out_t;
-
-typedef struct ms_ecall_pointer_in_out_t {
-	int* ms_val;
-} ms_ecall_pointer_in_out_t;
-
-typedef struct ms_ecall_pointer_string_t {
-	char* ms_str;
-	size_t ms_str_len;
-} ms_ecall_pointer_string_t;
-
-typedef struct ms_ecall_pointer_string_const_t {
-	const char* ms_str;
-	size_t ms_str_len;
-} ms_ecall_pointer_string_const_t;
-
-typedef struct ms_ecall_pointer_size_t {
-	void* ms_ptr;
-	size_t ms_len;
-} ms_ecall_pointer_size_t;
-
-typedef struct ms_ecall_pointer_count_t {
-	int* ms_arr;
-	size_t ms_cnt;
-} ms_ecall_pointer_count_t;
-
-typedef struct ms_ecall_pointer_isptr_readonly_t {
-	buffer_t ms_buf;
-	size_t ms_len;
-} ms_ecall_pointer_isptr_readonly_t;
-
-typedef struct ms_ecall_array_user_check_t {
-	int* ms_arr;
-} ms_ecall_array_user_check_t;
-
-typedef struct ms_ecall_array_in_t {
-	int* ms_arr;
-} ms_ecall_array_in_t;
-
-typedef struct ms_ecall_array_out_t {
-	int* ms_arr;
-} ms_ecall_array_out_t;
-
-typedef struct ms_ecall_array_in_out_t {
-	int* ms_arr;
-} ms_ecall_array_in_out_t;
-
-typedef struct ms_ecall_array_isary_t {
-	array_t*  ms_arr;
-} ms_ecall_array_isary_t;
-
-typedef struct ms_ecall_function_private_t {
-	int ms_retval;
-} ms_ecall_function_private_t;
-
-typedef struct ms_ecall_sgx_cpuid_t {
-	int* ms_cpuinfo;
-	int ms_leaf;
-} ms_ecall_sgx_cpuid_t;
-
-typedef struct ms_ecall_increase_counter_t {
-	size_t ms_retval;
-} ms_ecall_increase_counter_t;
-
-typedef struct ms_ocall_print_string_t {
-	const char* ms_str;
-} ms_ocall_print_string_t;
-
-typedef struct ms_ocall_pointer_user_check_t {
-	int* ms_val;
-} ms_ocall_pointer_user_check_t;
-
-typedef struct ms_ocall_pointer_in_t {
-	int* ms_val;
-} ms_ocall_pointer_in_t;
-
-typedef struct ms_ocall_pointer_out_t {
-	int* ms_val;
-} ms_ocall_pointer_out_t;
-
-typedef struct ms_ocall_pointer_in_out_t {
-	int* ms_val;
-} ms_ocall_pointer_in_out_t;
-
-typedef struct ms_sgx_oc_cpuidex_t {
-	int* ms_cpuinfo;
-	int ms_leaf;
-	int ms_subleaf;
-} ms_sgx_oc_cpuidex_t;
-
-typedef struct ms_sgx_thread_wait_untrusted_event_ocall_t {
-	int ms_retval;
-	const void* ms_self;
-} ms_sgx_thread_wait_untrusted_event_ocall_t;
-
-typedef struct ms_sgx_thread_set_untrusted_event_ocall_t {
-	int ms_retval;
-	const void* ms_waiter;
-} ms_sgx_thread_set_untrusted_event_ocall_t;
-
-typedef struct ms_sgx_thread_setwait_untrusted_events_ocall_t {
-	int ms_retval;
-	const void* ms_waiter;
-	const void* ms_self;
-} ms_sgx_thread_setwait_untrusted_events_ocall_t;
-
-typedef struct ms_sgx_thread_set_multiple_untrusted_events_ocall_t {
-	int ms_retval;
-	const void** ms_waiters;
-	size_t ms_total;
-} ms_sgx_thread_set_multiple_untrusted_events_ocall_t;
-
-static sgx_status_t SGX_CDECL Enclave_ocall_print_string(void* pms)
-{
-	ms_ocall_print_string_t* ms = SGX_CAST(ms_ocall_print_string_t*, pms);
-	ocall_print_string(ms->ms_str);
-
-	return SGX_SUCCESS;
-}
-
-static sgx_status_t SGX_CDECL Enclave_ocall_pointer_user_check(void* pms)
-{
-	ms_ocall_pointer_user_check_t* ms = SGX_CAST(ms_ocall_pointer_user_check_t*, pms);
-	ocall_pointer_user_check(ms->ms_val);
-
-	return SGX_SUCCESS;
-}
-
-static sgx_status_t SGX_CDECL Enclave_ocall_pointer_in(void* pms)
-{
-	ms_ocall_pointer_in_t* ms = SGX_CAST(ms_ocall_pointer_in_t*, pms);
-	ocall_pointer_in(ms->ms_val);
-
-	return SGX_SUCCESS;
-}
-
-static sgx_status_t SGX_CDECL Enclave_ocall_pointer_out(void* pms)
-{
-	ms_ocall_pointer_out_t* ms = SGX_CAST(ms_ocall_pointer_out_t*, pms);
-	ocall_pointer_out(ms->ms_val);
-
-	return SGX_SUCCESS;
-}
-
-static sgx_status_t SGX_CDECL Enclave_ocall_pointer_in_out(void* pms)
-{
-	ms_ocall_pointer_in_out_t* ms = SGX_CAST(ms_ocall_pointer_in_out_t*, pms);
-	ocall_pointer_in_out(ms->ms_val);
-
-	return SGX_SUCCESS;
-}
-
-static sgx_status_t SGX_CDECL Enclave_ocall_function_allow(void* pms)
-{
-	if (pms != NULL) return SGX_ERROR_INVALID_PARAMETER;
-	ocall_function_allow();
-	return SGX_SUCCESS;
-}
-
-static sgx_status_t SGX_CDECL Enclave_sgx_oc_cpuidex(void* pms)
-{
-	ms_sgx_oc_cpuidex_t* ms = SGX_CAST(ms_sgx_oc_cpuidex_t*, pms);
-	sgx_oc_cpuidex(ms->ms_cpuinfo, ms->ms_leaf, ms->ms_subleaf);
-
-	return SGX_SUCCESS;
-}
-
-static sgx_status_t SGX_CDECL Enclave_sgx_thread_wait_untrusted_event_ocall(void* pms)
-{
-	ms_sgx_thread_wait_untrusted_event_ocall_t* ms = SGX_CAST(ms_sgx_thread_wait_untrusted_event_ocall_t*, pms);
-	ms->ms_retval = sgx_thread_wait_untrusted_event_ocall(ms->ms_self);
-
-	return SGX_SUCCESS;
-}
-
-static sgx_status_t SGX_CDECL Enclave_sgx_thread_set_untrusted_event_ocall(void* pms)
-{
-	ms_sgx_thread_set_untrusted_event_ocall_t* ms = SGX_CAST(ms_sgx_thread_set_untrusted_event_ocall_t*, pms);
-	ms->ms_retval = sgx_thread_set_untrusted_event_ocall(ms->ms_waiter);
-
-	return SGX_SUCCESS;
-}
-
-static sgx_status_t SGX_CDECL Enclave_sgx_thread_setwait_untrusted_events_ocall(void* pms)
-{
-	ms_sgx_thread_setwait_untrusted_events_ocall_t* ms = SGX_CAST(ms_sgx_thread_setwait_untrusted_events_ocall_t*, pms);
-	ms->ms_retval = sgx_thread_setwait_untrusted_events_ocall(ms->ms_waiter, ms->ms_self);
-
-	return SGX_SUCCESS;
-}
-
-static sgx_status_t SGX_CDECL Enclave_sgx_thread_set_multiple_untrusted_events_ocall(void* pms)
-{
-	ms_sgx_thread_set_multiple_untrusted_events_ocall_t* ms = SGX_CAST(ms_sgx_thread_set_multiple_untrusted_events_ocall_t*, pms);
-	ms->ms_retval = sgx_thread_set_multiple_untrusted_events_ocall(ms->ms_waiters, ms->ms_total);
-
-	return SGX_SUCCESS;
-}
-
-static const struct {
-	size_t nr_ocall;
-	void * table[11];
-} ocall_table_Enclave = {
-	11,
-	{
-		(void*)Enclave_ocall_print_string,
-		(void*)Enclave_ocall_pointer_user_check,
-		(void*)Enclave_ocall_pointer_in,
-		(void*)Enclave_ocall_pointer_out,
-		(void*)Enclave_ocall_pointer_in_out,
-		(void*)Enclave_ocall_function_allow,
-		(void*)Enclave_sgx_oc_cpuidex,
-		(void*)Enclave_sgx_thread_wait_untrusted_event_ocall,
-		(void*)Enclave_sgx_thread_set_untrusted_event_ocall,
-		(void*)Enclave_sgx_thread_setwait_untrusted_events_ocall,
-		(void*)Enclave_sgx_thread_set_multiple_untrusted_events_ocall,
-	}
-};
-sgx_status_t ecall_type_char(sgx_enclave_id_t eid, char val)
-{
-	sgx_status_t status;
-	ms_ecall_type_char_t ms;
-	ms.ms_val = val;
-	status = sgx_ecall(eid, 0, &ocall_table_Enclave, &ms);
-	return status;
-}
-
-sgx_status_t ecall_type_int(sgx_enclave_id_t eid, int val)
-{
-	sgx_status_t status;
-	ms_ecall_type_int_t ms;
-	ms.ms_val = val;
-	status = sgx_ecall(eid, 1, &ocall_table_Enclave, &ms);
-	return status;
-}
-
-sgx_status_t ecall_type_float(sgx_enclave_id_t eid, float val)
-{
-	sgx_status_t status;
-	ms_ecall_type_float_t ms;
-	ms.ms_val = val;
-	status = sgx_ecall(eid, 2, &ocall_table_Enclave, &ms);
-	return status;
-}
-
-sgx_status_t ecall_type_double(sgx_enclave_id_t eid, double val)
-{
-	sgx_status_t status;
-	ms_ecall_type_double_t ms;
-	ms.ms_val = val;
-	status = sgx_ecall(eid, 3, &ocall_table_Enclave, &ms);
-	return status;
-}
-
-sgx_status_t ecall_type_size_t(sgx_enclave_id_t eid, size_t val)
-{
-	sgx_status_t status;
-	ms_ecall_type_size_t_t ms;
-	ms.ms_val = val;
-	status = sgx_ecall(eid, 4, &ocall_table_Enclave, &ms);
-	return status;
-}
-
-sgx_status_t ecall_type_wchar_t(sgx_enclave_id_t eid, wchar_t val)
-{
-	sgx_status_t status;
-	ms_ecall_type_wchar_t_t ms;
-	ms.ms_val = val;
-	status = sgx_ecall(eid, 5, &ocall_table_Enclave, &ms);
-	return status;
-}
-
-sgx_status_t ecall_type_struct(sgx_enclave_id_t eid, struct struct_foo_t val)
-{
-	sgx_status_t status;
-	ms_ecall_type_struct_t ms;
-	ms.ms_val = val;
-	status = sgx_ecall(eid, 6, &ocall_table_Enclave, &ms);
-	return status;
-}
-
-sgx_status_t ecall_type_enum_union(sgx_enclave_id_t eid, enum enum_foo_t val1, union union_foo_t* val2)
-{
-	sgx_status_t status;
-	ms_ecall_type_enum_union_t ms;
-	ms.ms_val1 = val1;
-	ms.ms_val2 = val2;
-	status = sgx_ecall(eid, 7, &ocall_table_Enclave, &ms);
-	return status;
-}
-
-sgx_status_t ecall_pointer_user_check(sgx_enclave_id_t eid, size_t* retval, void* val, size_t sz)
-{
-	sgx_status_t status;
-	ms_ecall_pointer_user_check_t ms;
-	ms.ms_val = val;
-	ms.ms_sz = sz;
-	status = sgx_ecall(eid, 8, &ocall_table_Enclave, &ms);
-	if (status == SGX_SUCCESS && retval) *retval = ms.ms_retval;
-	return status;
-}
-
-sgx_status_t ecall_pointer_in(sgx_enclave_id_t eid, int* val)
-{
-	sgx_status_t status;
-	ms_ecall_pointer_in_t ms;
-	ms.ms_val = val;
-	status = sgx_ecall(eid, 9, &ocall_table_Enclave, &ms);
-	return status;
-}
-
-sgx_status_t ecall_pointer_out(sgx_enclave_id_t eid, int* val)
-{
-	sgx_status_t status;
-	ms_ecall_pointer_out_t ms;
-	ms.ms_val = val;
-	status = sgx_ecall(eid, 10, &ocall_table_Enclave, &ms);
-	return status;
-}
-
-sgx_status_t ecall_pointer_in_out(sgx_enclave_id_t eid, int* val)
-{
-	sgx_status_t status;
-	ms_ecall_pointer_in_out_t ms;
-	ms.ms_val = val;
-	status = sgx_ecall(eid, 11, &ocall_table_Enclave, &ms);
-	return status;
-}
-
-sgx_status_t ecall_pointer_string(sgx_enclave_id_t eid, char* str)
-{
-	sgx_status_t status;
-	ms_ecall_pointer_string_t ms;
-	ms.ms_str = str;
-	ms.ms_str_len = str ? strlen(str) + 1 : 0;
-	status = sgx_ecall(eid, 12, &ocall_table_Enclave, &ms);
-	return status;
-}
-
-sgx_status_t ecall_pointer_string_const(sgx_enclave_id_t eid, const char* str)
-{
-	sgx_status_t status;
-	ms_ecall_pointer_string_const_t ms;
-	ms.ms_str = str;
-	ms.ms_str_len = str ? strlen(str) + 1 : 0;
-	status = sgx_ecall(eid, 13, &ocall_table_Enclave, &ms);
-	return status;
-}
-
-sgx_status_t ecall_pointer_size(sgx_enclave_id_t eid, void* ptr, size_t len)
-{
-	sgx_status_t status;
-	ms_ecall_pointer_size_t ms;
-	ms.ms_ptr = ptr;
-	ms.ms_len = len;
-	status = sgx_ecall(eid, 14, &ocall_table_Enclave, &ms);
-	return status;
-}
-
-sgx_status_t ecall_pointer_count(sgx_enclave_id_t eid, int* arr, size_t cnt)
-{
-	sgx_status_t status;
-	ms_ecall_pointer_count_t ms;
-	ms.ms_arr = arr;
-	ms.ms_cnt = cnt;
-	status = sgx_ecall(eid, 15, &ocall_table_Enclave, &ms);
-	return status;
-}
-
-sgx_status_t ecall_pointer_isptr_readonly(sgx_enclave_id_t eid, buffer_t buf, size_t len)
-{
-	sgx_status_t status;
-	ms_ecall_pointer_isptr_readonly_t ms;
-	ms.ms_buf = buf;
-	ms.ms_len = len;
-	status = sgx_ecall(eid, 16, &ocall_table_Enclave, &ms);
-	return status;
-}
-
-sgx_status_t ocall_pointer_attr(sgx_enclave_id_t eid)
-{
-	sgx_status_t status;
-	status = sgx_ecall(eid, 17, &ocall_table_Enclave, NULL);
-	return status;
-}
-
-sgx_status_t ecall_array_user_check(sgx_enclave_id_t eid, int arr[4])
-{
-	sgx_status_t status;
-	ms_ecall_array_user_check_t ms;
-	ms.ms_arr = (int*)arr;
-	status = sgx_ecall(eid, 18, &ocall_table_Enclave, &ms);
-	return status;
-}
-
-sgx_status_t ecall_array_in(sgx_enclave_id_t eid, int arr[4])
-{
-	sgx_status_t status;
-	ms_ecall_array_in_t ms;
-	ms.ms_arr = (int*)arr;
-	status = sgx_ecall(eid, 19, &ocall_table_Enclave, &ms);
-	return status;
-}
-
-sgx_status_t ecall_array_out(sgx_enclave_id_t eid, int arr[4])
-{
-	sgx_status_t status;
-	ms_ecall_array_out_t ms;
-	ms.ms_arr = (int*)arr;
-	status = sgx_ecall(eid, 20, &ocall_table_Enclave, &ms);
-	return status;
-}
-
-sgx_status_t ecall_array_in_out(sgx_enclave_id_t eid, int arr[4])
-{
-	sgx_status_t status;
-	ms_ecall_array_in_out_t ms;
-	ms.ms_arr = (int*)arr;
-	status = sgx_ecall(eid, 21, &ocall_table_Enclave, &ms);
-	return status;
-}
-
-sgx_status_t ecall_array_isary(sgx_enclave_id_t eid, array_t arr)
-{
-	sgx_status_t status;
-	ms_ecall_array_isary_t ms;
-	ms.ms_arr = (array_t *)&arr[0];
-	status = sgx_ecall(eid, 22, &ocall_table_Enclave, &ms);
-	return status;
-}
-
-sgx_status_t ecall_function_public(sgx_enclave_id_t eid)
-{
-	sgx_status_t status;
-	status = sgx_ecall(eid, 23, &ocall_table_Enclave, NULL);
-	return status;
-}
-
-sgx_status_t ecall_function_private(sgx_enclave_id_t eid, int* retval)
-{
-	sgx_status_t status;
-	ms_ecall_function_private_t ms;
-	status = sgx_ecall(eid, 24, &ocall_table_Enclave, &ms);
-	if (status == SGX_SUCCESS && retval) *retval = ms.ms_retval;
-	return status;
-}
-
-sgx_status_t ecall_malloc_free(sgx_enclave_id_t eid)
-{
-	sgx_status_t status;
-	status = sgx_ecall(eid, 25, &ocall_table_Enclave, NULL);
-	return status;
-}
-
-sgx_status_t ecall_sgx_cpuid(sgx_enclave_id_t eid, int cpuinfo[4], int leaf)
-{
-	sgx_status_t status;
-	ms_ecall_sgx_cpuid_t ms;
-	ms.ms_cpuinfo = (int*)cpuinfo;
-	ms.ms_leaf = leaf;
-	status = sgx_ecall(eid, 26, &ocall_table_Enclave, &ms);
-	return status;
-}
-
-sgx_status_t ecall_exception(sgx_enclave_id_t eid)
-{
-	sgx_status_t status;
-	status = sgx_ecall(eid, 27, &ocall_table_Enclave, NULL);
-	return status;
-}
-
-sgx_status_t ecall_map(sgx_enclave_id_t eid)
-{
-	sgx_status_t status;
-	status = sgx_ecall(eid, 28, &ocall_table_Enclave, NULL);
-	return status;
-}
-
-sgx_status_t ecall_increase_counter(sgx_enclave_id_t eid, size_t* retval)
-{
-	sgx_status_t status;
-	ms_ecall_increase_counter_t ms;
-	status = sgx_ecall(eid, 29, &ocall_table_Enclave, &ms);
-	if (status == SGX_SUCCESS && retval) *retval = ms.ms_retval;
-	return status;
-}
-
-sgx_status_t ecall_producer(sgx_enclave_id_t eid)
-{
-	sgx_status_t status;
-	status = sgx_ecall(eid, 30, &ocall_table_Enclave, NULL);
-	return status;
-}
-
-sgx_status_t ecall_consumer(sgx_enclave_id_t eid)
-{
-	sgx_status_t status;
-	status = sgx_ecall(eid, 31, &ocall_table_Enclave, NULL);
-	return status;
-}
-
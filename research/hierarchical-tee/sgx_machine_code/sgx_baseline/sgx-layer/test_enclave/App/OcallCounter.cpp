@@ -0,0 +1,76 @@
+/*
+ * OcallCounter.cpp - see OcallCounter.h.
+ */
+
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+
+#include "Enclave_u.h"
+#include "OcallCounter.h"
+
+typedef int (*event_fn)(const void *);
+typedef int (*event_pair_fn)(const void *, const void *);
+typedef int (*event_multiple_fn)(const void **, size_t);
+
+static std::atomic<uint64_t> g_wait(0);
+static std::atomic<uint64_t> g_set(0);
+static std::atomic<uint64_t> g_setwait(0);
+static std::atomic<uint64_t> g_set_multiple(0);
+
+/* The urts definition this executable shadows */
+static void *next_symbol(const char *name)
+{
+    void *sym = dlsym(RTLD_NEXT, name);
+    if (sym == NULL) {
+        fprintf(stderr, "OcallCounter: %s not found in libsgx_urts\n", name);
+        abort();
+    }
+    return sym;
+}
+
+void ocall_counts(ocall_counts_t *out)
+{
+    out->wait = g_wait.load(std::memory_order_relaxed);
+    out->set = g_set.load(std::memory_order_relaxed);
+    out->setwait = g_setwait.load(std::memory_order_relaxed);
+    out->set_multiple = g_set_multiple.load(std::memory_order_relaxed);
+}
+
+uint64_t ocall_sync_exits(void)
+{
+    ocall_counts_t counts;
+    ocall_counts(&counts);
+    return counts.wait + counts.set + counts.setwait + counts.set_multiple;
+}
+
+extern "C" int sgx_thread_wait_untrusted_event_ocall(const void *self)
+{
+    static event_fn next = (event_fn)next_symbol("sgx_thread_wait_untrusted_event_ocall");
+    g_wait.fetch_add(1, std::memory_order_relaxed);
+    return next(self);
+}
+
+extern "C" int sgx_thread_set_untrusted_event_ocall(const void *waiter)
+{
+    static event_fn next = (event_fn)next_symbol("sgx_thread_set_untrusted_event_ocall");
+    g_set.fetch_add(1, std::memory_order_relaxed);
+    return next(waiter);
+}
+
+extern "C" int sgx_thread_setwait_untrusted_events_ocall(const void *waiter, const void *self)
+{
+    static event_pair_fn next =
+        (event_pair_fn)next_symbol("sgx_thread_setwait_untrusted_events_ocall");
+    g_setwait.fetch_add(1, std::memory_order_relaxed);
+    return next(waiter, self);
+}
+
+extern "C" int sgx_thread_set_multiple_untrusted_events_ocall(const void **waiters, size_t total)
+{
+    static event_multiple_fn next =
+        (event_multiple_fn)next_symbol("sgx_thread_set_multiple_untrusted_events_ocall");
+    g_set_multiple.fetch_add(1, std::memory_order_relaxed);
+    return next(waiters, total);
+}
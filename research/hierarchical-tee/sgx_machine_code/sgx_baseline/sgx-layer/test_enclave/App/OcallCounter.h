@@ -0,0 +1,29 @@
+/*
+ * OcallCounter.h - counts the synchronization OCALLs of sgx_tstdc.edl.
+ *
+ * The trusted sgx_thread_mutex/cond implementation parks and wakes threads
+ * through four untrusted-event OCALLs, each an enclave exit. OcallCounter.cpp
+ * defines those four symbols in the executable, so the edger8r OCALL table
+ * resolves to them rather than to libsgx_urts. Each one counts the call and
+ * forwards to the urts implementation via dlsym(RTLD_NEXT). Link it only
+ * into the benchmarks.
+ */
+
+#ifndef _OCALL_COUNTER_H_
+#define _OCALL_COUNTER_H_
+
+#include <stdint.h>
+
+typedef struct {
+    uint64_t wait;           /* sgx_thread_wait_untrusted_event_ocall */
+    uint64_t set;            /* sgx_thread_set_untrusted_event_ocall */
+    uint64_t setwait;        /* sgx_thread_setwait_untrusted_events_ocall */
+    uint64_t set_multiple;   /* sgx_thread_set_multiple_untrusted_events_ocall */
+} ocall_counts_t;
+
+void ocall_counts(ocall_counts_t *out);
+
+/* Enclave exits made by the four OCALLs so far */
+uint64_t ocall_sync_exits(void);
+
+#endif /* !_OCALL_COUNTER_H_ */
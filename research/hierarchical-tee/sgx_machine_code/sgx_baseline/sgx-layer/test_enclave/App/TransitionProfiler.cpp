@@ -0,0 +1,279 @@
+/*
+ * TransitionProfiler.cpp - see TransitionProfiler.h.
+ */
+
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+
+#include "sgx_edger8r.h"
+#include "TransitionProfiler.h"
+#include "bench_clock.h"
+
+/* App/Enclave_names.c */
+extern "C" {
+extern const char *const transition_ecall_names[];
+extern const size_t transition_ecall_name_count;
+extern const char *const transition_ocall_names[];
+extern const size_t transition_ocall_name_count;
+}
+
+#define TRANSITION_MAX_TABLES 8
+
+typedef sgx_status_t (SGX_CDECL *ecall_fn)(const sgx_enclave_id_t, const int, const void *, void *);
+typedef sgx_status_t (SGX_CDECL *ocall_bridge_fn)(void *);
+
+/* Layout of the generated ocall_table_Enclave, with room for any table */
+typedef struct {
+    size_t nr_ocall;
+    void *table[TRANSITION_MAX_OCALLS];
+} ocall_table_t;
+
+typedef struct {
+    std::atomic<uint64_t> calls;
+    std::atomic<uint64_t> ticks;
+} call_stats_t;
+
+typedef struct {
+    call_stats_t total;
+    std::atomic<uint64_t> enclave_ticks;
+    call_stats_t ocalls[TRANSITION_MAX_OCALLS];   /* made directly under this ECALL */
+} ecall_stats_t;
+
+/* One per ECALL in progress on this thread; OCALLs charge the innermost */
+typedef struct frame_t {
+    int ecall;
+    const ocall_table_t *table;
+    uint64_t ocall_ticks;
+    struct frame_t *parent;
+} frame_t;
+
+static ecall_stats_t g_ecalls[TRANSITION_MAX_ECALLS];
+static std::atomic<bool> g_enabled(false);
+static __thread frame_t *tls_frame = NULL;
+
+static std::atomic<const void *> g_table_orig[TRANSITION_MAX_TABLES];
+static ocall_table_t g_table_shadow[TRANSITION_MAX_TABLES];
+static std::mutex g_table_mutex;
+
+static std::string g_dump_path;
+
+static void *next_symbol(const char *name)
+{
+    void *sym = dlsym(RTLD_NEXT, name);
+    if (sym == NULL) {
+        fprintf(stderr, "TransitionProfiler: %s not found in libsgx_urts\n", name);
+        abort();
+    }
+    return sym;
+}
+
+static void add_call(call_stats_t *stats, uint64_t ticks)
+{
+    stats->calls.fetch_add(1, std::memory_order_relaxed);
+    stats->ticks.fetch_add(ticks, std::memory_order_relaxed);
+}
+
+static sgx_status_t profiled_ocall(int index, void *ms)
+{
+    frame_t *frame = tls_frame;
+    ocall_bridge_fn bridge = (ocall_bridge_fn)frame->table->table[index];
+    uint64_t start = bench_now_ticks();
+    sgx_status_t ret = bridge(ms);
+    uint64_t ticks = bench_now_ticks() - start;
+    frame->ocall_ticks += ticks;
+    add_call(&g_ecalls[frame->ecall].ocalls[index], ticks);
+    return ret;
+}
+
+template <int I>
+static sgx_status_t SGX_CDECL ocall_trampoline(void *ms)
+{
+    return profiled_ocall(I, ms);
+}
+
+template <int N>
+struct trampolines {
+    static void fill(void **table)
+    {
+        trampolines<N - 1>::fill(table);
+        table[N - 1] = (void *)&ocall_trampoline<N - 1>;
+    }
+};
+
+template <>
+struct trampolines<0> {
+    static void fill(void **) {}
+};
+
+/* Trampoline table standing in for `orig`; NULL if it cannot be shadowed */
+static const ocall_table_t *shadow_table(const void *orig)
+{
+    for (int i = 0; i < TRANSITION_MAX_TABLES; i++) {
+        const void *known = g_table_orig[i].load(std::memory_order_acquire);
+        if (known == orig)
+            return &g_table_shadow[i];
+        if (known == NULL)
+            break;
+    }
+
+    std::lock_guard<std::mutex> lock(g_table_mutex);
+    const ocall_table_t *table = (const ocall_table_t *)orig;
+    if (table->nr_ocall > TRANSITION_MAX_OCALLS)
+        return NULL;
+    for (int i = 0; i < TRANSITION_MAX_TABLES; i++) {
+        const void *known = g_table_orig[i].load(std::memory_order_relaxed);
+        if (known == orig)
+            return &g_table_shadow[i];
+        if (known == NULL) {
+            g_table_shadow[i].nr_ocall = table->nr_ocall;
+            trampolines<TRANSITION_MAX_OCALLS>::fill(g_table_shadow[i].table);
+            g_table_orig[i].store(orig, std::memory_order_release);
+            return &g_table_shadow[i];
+        }
+    }
+    return NULL;
+}
+
+extern "C" sgx_status_t SGX_CDECL sgx_ecall(const sgx_enclave_id_t eid, const int index,
+                                             const void *ocall_table, void *ms)
+{
+    static ecall_fn next = (ecall_fn)next_symbol("sgx_ecall");
+    if (!g_enabled.load(std::memory_order_relaxed) || index < 0 || index >= TRANSITION_MAX_ECALLS)
+        return next(eid, index, ocall_table, ms);
+
+    const ocall_table_t *shadow = ocall_table ? shadow_table(ocall_table) : NULL;
+    frame_t frame;
+    frame.ecall = index;
+    frame.table = (const ocall_table_t *)ocall_table;
+    frame.ocall_ticks = 0;
+    frame.parent = tls_frame;
+    tls_frame = &frame;
+
+    uint64_t start = bench_now_ticks();
+    sgx_status_t ret = next(eid, index, shadow ? (const void *)shadow : ocall_table, ms);
+    uint64_t ticks = bench_now_ticks() - start;
+    tls_frame = frame.parent;
+
+    ecall_stats_t *stats = &g_ecalls[index];
+    add_call(&stats->total, ticks);
+    uint64_t inside = ticks > frame.ocall_ticks ? ticks - frame.ocall_ticks : 0;
+    stats->enclave_ticks.fetch_add(inside, std::memory_order_relaxed);
+    return ret;
+}
+
+static std::string ecall_name(int index)
+{
+    if ((size_t)index < transition_ecall_name_count && transition_ecall_names[index] != NULL)
+        return transition_ecall_names[index];
+    return "ecall_" + std::to_string(index);
+}
+
+static std::string ocall_name(int index)
+{
+    if ((size_t)index < transition_ocall_name_count && transition_ocall_names[index] != NULL)
+        return transition_ocall_names[index];
+    return "ocall_" + std::to_string(index);
+}
+
+static uint64_t ticks_ns(const std::atomic<uint64_t> &ticks)
+{
+    return (uint64_t)bench_ticks_to_ns(ticks.load(std::memory_order_relaxed));
+}
+
+static void write_json(FILE *f)
+{
+    fprintf(f, "{\n  \"clock\": \"%s\",\n  \"ecalls\": [", bench_clock_source());
+    bool first = true;
+    for (int e = 0; e < TRANSITION_MAX_ECALLS; e++) {
+        const ecall_stats_t &stats = g_ecalls[e];
+        uint64_t calls = stats.total.calls.load(std::memory_order_relaxed);
+        if (calls == 0)
+            continue;
+        fprintf(f, "%s\n    {\"name\": \"%s\", \"index\": %d, \"calls\": %llu, "
+                "\"wall_ns\": %llu, \"enclave_ns\": %llu, \"ocalls\": [",
+                first ? "" : ",", ecall_name(e).c_str(), e, (unsigned long long)calls,
+                (unsigned long long)ticks_ns(stats.total.ticks),
+                (unsigned long long)ticks_ns(stats.enclave_ticks));
+        first = false;
+
+        bool first_ocall = true;
+        for (int o = 0; o < TRANSITION_MAX_OCALLS; o++) {
+            uint64_t ocalls = stats.ocalls[o].calls.load(std::memory_order_relaxed);
+            if (ocalls == 0)
+                continue;
+            fprintf(f, "%s\n      {\"name\": \"%s\", \"index\": %d, \"calls\": %llu, \"ns\": %llu}",
+                    first_ocall ? "" : ",", ocall_name(o).c_str(), o, (unsigned long long)ocalls,
+                    (unsigned long long)ticks_ns(stats.ocalls[o].ticks));
+            first_ocall = false;
+        }
+        fprintf(f, "%s]}", first_ocall ? "" : "\n    ");
+    }
+    fprintf(f, "\n  ]\n}\n");
+}
+
+/* "ecall value" for time inside the enclave, "ecall;ocall value" under it */
+static void write_folded(FILE *f)
+{
+    for (int e = 0; e < TRANSITION_MAX_ECALLS; e++) {
+        const ecall_stats_t &stats = g_ecalls[e];
+        if (stats.total.calls.load(std::memory_order_relaxed) == 0)
+            continue;
+        std::string name = ecall_name(e);
+        fprintf(f, "%s %llu\n", name.c_str(), (unsigned long long)ticks_ns(stats.enclave_ticks));
+        for (int o = 0; o < TRANSITION_MAX_OCALLS; o++) {
+            if (stats.ocalls[o].calls.load(std::memory_order_relaxed) == 0)
+                continue;
+            fprintf(f, "%s;%s %llu\n", name.c_str(), ocall_name(o).c_str(),
+                    (unsigned long long)ticks_ns(stats.ocalls[o].ticks));
+        }
+    }
+}
+
+void transition_profiler_enable(void)
+{
+    g_enabled.store(true, std::memory_order_relaxed);
+}
+
+bool transition_profiler_enabled(void)
+{
+    return g_enabled.load(std::memory_order_relaxed);
+}
+
+bool transition_profiler_dump(const char *path)
+{
+    FILE *f = fopen(path, "w");
+    if (f == NULL)
+        return false;
+    size_t len = strlen(path);
+    const char *suffix = ".folded";
+    size_t suffix_len = strlen(suffix);
+    if (len >= suffix_len && strcmp(path + len - suffix_len, suffix) == 0)
+        write_folded(f);
+    else
+        write_json(f);
+    return fclose(f) == 0;
+}
+
+static void dump_at_exit(void)
+{
+    if (!transition_profiler_dump(g_dump_path.c_str()))
+        fprintf(stderr, "TransitionProfiler: cannot write %s\n", g_dump_path.c_str());
+}
+
+/* SGX_TRANSITION_PROFILE turns profiling on before main() */
+static struct profiler_env_t {
+    profiler_env_t()
+    {
+        const char *path = getenv(TRANSITION_PROFILE_ENV);
+        if (path == NULL || *path == '\0')
+            return;
+        g_dump_path = path;
+        transition_profiler_enable();
+        atexit(dump_at_exit);
+    }
+} profiler_env;
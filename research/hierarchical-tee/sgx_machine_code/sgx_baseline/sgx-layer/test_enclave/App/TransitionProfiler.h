@@ -0,0 +1,42 @@
+/*
+ * TransitionProfiler.h - opt-in ECALL/OCALL profiler for the untrusted side.
+ *
+ * TransitionProfiler.cpp defines sgx_ecall() in the executable, so every
+ * generated ecall_* stub in Enclave_u.c goes through it before the urts
+ * (dlsym(RTLD_NEXT), as in OcallCounter.h). While profiling is on, it hands
+ * the urts a shadow copy of the stub's OCALL table whose entries record
+ * and forward to the real bridges. That yields, per ECALL:
+ *
+ *   - calls and wall time, and the part spent inside the enclave (wall
+ *     time minus the OCALLs it made)
+ *   - each OCALL made directly under it, with call count and time
+ *
+ * Profiling is off unless SGX_TRANSITION_PROFILE names an output file, or
+ * transition_profiler_enable() is called. When it is off, the interposed
+ * sgx_ecall() only checks a flag. The profile is written at exit:
+ *
+ *   SGX_TRANSITION_PROFILE=profile.json ./app      JSON
+ *   SGX_TRANSITION_PROFILE=profile.folded ./app    folded stacks, nanoseconds
+ *
+ * The folded form has one "ecall;ocall value" line per stack, for
+ * flamegraph.pl, speedscope, or `perf script | stackcollapse-perf.pl`
+ * comparisons. Names come from App/Enclave_names.c, generated from
+ * Enclave_u.c by App/transition_names.awk. Switchless ECALLs are not seen.
+ */
+
+#ifndef _TRANSITION_PROFILER_H_
+#define _TRANSITION_PROFILER_H_
+
+#include <stdint.h>
+
+#define TRANSITION_PROFILE_ENV "SGX_TRANSITION_PROFILE"
+#define TRANSITION_MAX_ECALLS 128
+#define TRANSITION_MAX_OCALLS 64
+
+void transition_profiler_enable(void);
+bool transition_profiler_enabled(void);
+
+/* Writes JSON, or folded stacks if `path` ends in ".folded"; false on I/O error. */
+bool transition_profiler_dump(const char *path);
+
+#endif /* !_TRANSITION_PROFILER_H_ */
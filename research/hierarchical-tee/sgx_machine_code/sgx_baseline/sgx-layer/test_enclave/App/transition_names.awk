@@ -0,0 +1,49 @@
+# transition_names.awk - ECALL/OCALL index -> name tables for
+# TransitionProfiler.cpp, read from the edger8r-generated Enclave_u.c:
+#   sgx_status_t ecall_foo(sgx_enclave_id_t eid, ...)  ...  sgx_ecall(eid, N, ...)
+#   (void*)Enclave_ocall_bar,                            (Nth entry of ocall_table_Enclave)
+
+BEGIN {
+    print "/* Generated from Enclave_u.c by App/transition_names.awk, do not edit */"
+    print "#include <stddef.h>"
+    ecalls = 0
+    ocalls = 0
+}
+
+/^sgx_status_t [A-Za-z_0-9]+\(sgx_enclave_id_t eid/ {
+    name = $2
+    sub(/\(.*/, "", name)
+}
+
+/sgx_ecall\(eid, [0-9]+,/ {
+    index_field = $0
+    sub(/.*sgx_ecall\(eid, /, "", index_field)
+    sub(/,.*/, "", index_field)
+    ecall_name[ecalls] = "[" index_field "] = \"" name "\""
+    ecalls++
+}
+
+/^\t\t\(void\*\)Enclave_[A-Za-z_0-9]+,?$/ {
+    bridge = $0
+    sub(/.*\(void\*\)Enclave_/, "", bridge)
+    sub(/,$/, "", bridge)
+    ocall_name[ocalls] = "\"" bridge "\""
+    ocalls++
+}
+
+END {
+    print "const char *const transition_ecall_names[] = {"
+    for (i = 0; i < ecalls; i++)
+        print "    " ecall_name[i] ","
+    if (ecalls == 0)
+        print "    NULL,"
+    print "};"
+    print "const size_t transition_ecall_name_count = sizeof(transition_ecall_names) / sizeof(transition_ecall_names[0]);"
+    print "const char *const transition_ocall_names[] = {"
+    for (i = 0; i < ocalls; i++)
+        print "    " ocall_name[i] ","
+    if (ocalls == 0)
+        print "    NULL,"
+    print "};"
+    print "const size_t transition_ocall_name_count = sizeof(transition_ocall_names) / sizeof(transition_ocall_names[0]);"
+}
@@ -0,0 +1,129 @@
+/*
+ * Arena.cpp - per-TCS bump arena (Arena.h) and the request-scratch ECALL
+ * that compares it with the trusted heap.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "../Enclave.h"
+#include "Arena.h"
+#include "Enclave_t.h"
+
+/* The shapes of a composite verification request (sgx_binding.h) */
+#define REQUEST_REPORT_DATA_SIZE 64
+#define REQUEST_BINDING_SIZE 32
+#define REQUEST_TOKEN_SIZE 6144      /* a Trust Authority JWT is ~5.9 KB */
+#define REQUEST_CLAIMS 16
+#define REQUEST_CLAIM_SIZE 64
+
+typedef struct {
+    size_t used;
+    uint8_t base[ARENA_SIZE] __attribute__((aligned(ARENA_ALIGN)));
+} arena_t;
+
+/* One per TCS: the trusted runtime gives every TCS its own TLS block */
+static __thread arena_t tcs_arena;
+
+/*
+ * Peak over every TCS. Under TCSPolicy 1 a TCS's TLS is re-initialized on
+ * each root ECALL, so a per-TCS mark would not survive to be read back.
+ */
+static size_t arena_peak;
+
+static void arena_note_peak(size_t used)
+{
+    size_t peak = __atomic_load_n(&arena_peak, __ATOMIC_RELAXED);
+    while (used > peak &&
+           !__atomic_compare_exchange_n(&arena_peak, &peak, used, true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+}
+
+void *arena_alloc(size_t size)
+{
+    arena_t *a = &tcs_arena;
+    size_t rounded = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+    if (size == 0 || rounded < size || rounded > ARENA_SIZE - a->used)
+        return NULL;
+
+    void *ptr = a->base + a->used;
+    a->used += rounded;
+    arena_note_peak(a->used);
+    return ptr;
+}
+
+size_t arena_mark(void)
+{
+    return tcs_arena.used;
+}
+
+void arena_release(size_t mark)
+{
+    if (mark <= tcs_arena.used)
+        tcs_arena.used = mark;
+}
+
+size_t arena_high_water(void)
+{
+    return __atomic_load_n(&arena_peak, __ATOMIC_RELAXED);
+}
+
+static void *scratch_alloc(int use_arena, size_t size)
+{
+    return use_arena ? arena_alloc(size) : malloc(size);
+}
+
+static void scratch_free(int use_arena, void *ptr)
+{
+    if (!use_arena)
+        free(ptr);
+}
+
+/* ecall_request_scratch:
+ *   Allocates, fills and drops the scratch of one verification request:
+ *   report data, a binding hash, a token copy and its split-out claims.
+ *   Returns 0, or -1 if an allocation failed.
+ */
+int ecall_request_scratch(int use_arena)
+{
+    ArenaScope scope;
+
+    uint8_t *report_data = (uint8_t *)scratch_alloc(use_arena, REQUEST_REPORT_DATA_SIZE);
+    uint8_t *binding = (uint8_t *)scratch_alloc(use_arena, REQUEST_BINDING_SIZE);
+    char *token = (char *)scratch_alloc(use_arena, REQUEST_TOKEN_SIZE);
+    char *claims[REQUEST_CLAIMS] = {NULL};
+    int ret = (report_data && binding && token) ? 0 : -1;
+    for (int i = 0; i < REQUEST_CLAIMS && ret == 0; i++) {
+        claims[i] = (char *)scratch_alloc(use_arena, REQUEST_CLAIM_SIZE);
+        if (claims[i] == NULL)
+            ret = -1;
+    }
+
+    if (ret == 0) {
+        memset(report_data, 0x5a, REQUEST_REPORT_DATA_SIZE);
+        memset(token, 'e', REQUEST_TOKEN_SIZE);
+        uint8_t acc = 0;
+        for (int i = 0; i < REQUEST_CLAIMS; i++) {
+            memcpy(claims[i], token + (size_t)i * REQUEST_CLAIM_SIZE, REQUEST_CLAIM_SIZE);
+            acc = (uint8_t)(acc ^ (uint8_t)claims[i][0]);
+        }
+        for (int i = 0; i < REQUEST_BINDING_SIZE; i++)
+            binding[i] = (uint8_t)(report_data[i] ^ acc);
+    }
+
+    for (int i = REQUEST_CLAIMS - 1; i >= 0; i--)
+        scratch_free(use_arena, claims[i]);
+    scratch_free(use_arena, token);
+    scratch_free(use_arena, binding);
+    scratch_free(use_arena, report_data);
+    return ret;
+}
+
+/* ecall_arena_high_water:
+ *   Peak arena use of any TCS since the enclave was loaded, in bytes.
+ */
+size_t ecall_arena_high_water(void)
+{
+    return arena_high_water();
+}
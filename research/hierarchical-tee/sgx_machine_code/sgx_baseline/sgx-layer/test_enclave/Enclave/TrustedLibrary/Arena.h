@@ -0,0 +1,45 @@
+/*
+ * Arena.h - per-TCS bump allocator for request-scoped enclave scratch.
+ *
+ * The trusted heap (HeapMaxSize in Enclave.config.xml) is one dlmalloc
+ * behind one lock, so every malloc/free from concurrent ECALLs serializes
+ * on it. Scratch that only lives for one ECALL (report data, binding
+ * hashes, a parsed token) can instead come from this arena: each TCS has
+ * its own in thread-local storage, so allocating is a pointer bump with no
+ * lock, and nothing is freed individually.
+ *
+ * Open an ArenaScope at the top of the ECALL; everything allocated after
+ * it is released when it goes out of scope at ECALL exit. Scopes nest, so
+ * an ECALL re-entered from an OCALL keeps its caller's allocations.
+ * arena_alloc() returns NULL once the TCS's ARENA_SIZE bytes are in use;
+ * callers fall back to malloc or fail the request. arena_high_water() is
+ * the peak over every TCS, kept in one shared counter.
+ */
+
+#ifndef _ARENA_H_
+#define _ARENA_H_
+
+#include <stddef.h>
+
+#define ARENA_SIZE (16 * 1024)   /* per TCS, in .tbss */
+#define ARENA_ALIGN 16
+
+void *arena_alloc(size_t size);
+size_t arena_mark(void);
+void arena_release(size_t mark);
+size_t arena_high_water(void);
+
+class ArenaScope
+{
+public:
+    ArenaScope() : mark_(arena_mark()) {}
+    ~ArenaScope() { arena_release(mark_); }
+
+private:
+    ArenaScope(const ArenaScope&);
+    ArenaScope& operator=(const ArenaScope&);
+
+    size_t mark_;
+};
+
+#endif /* !_ARENA_H_ */
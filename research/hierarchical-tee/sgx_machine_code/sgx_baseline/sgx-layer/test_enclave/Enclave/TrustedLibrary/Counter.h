@@ -0,0 +1,70 @@
+/*
+ * Counter.h - per-TCS counter with an aggregated read, for request counts
+ * and nonce sequence numbers inside the enclave.
+ *
+ * sgx_thread_mutex_lock() spins briefly and then parks the thread with
+ * sgx_thread_wait_untrusted_event_ocall(), which leaves the enclave, so a
+ * contended mutex-protected counter costs OCALLs. Here each TCS adds to
+ * its own cache-line-sized slot with a relaxed atomic instead. No lock is
+ * taken and no cache line bounces between writers. read() sums the slots,
+ * so it is exact only when no add() is in flight.
+ *
+ * A TCS claims a slot on first use and keeps it: slots are keyed by the
+ * TCS's thread data (sgx_thread_self()), not by TLS, which TCSPolicy 1
+ * resets on every root ECALL. Past COUNTER_SLOTS TCSs, slots are shared;
+ * the atomics keep that correct, only slower.
+ */
+
+#ifndef _COUNTER_H_
+#define _COUNTER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define COUNTER_SLOTS 64
+#define COUNTER_CACHE_LINE 64
+
+/* Slot of the calling TCS, claimed on its first call */
+size_t counter_slot(void);
+
+class PerThreadCounter
+{
+public:
+    void add(uint64_t n)
+    {
+        __atomic_fetch_add(&slots_[counter_slot()].value, n, __ATOMIC_RELAXED);
+    }
+
+    /* A value no other next() on this counter returns: the slot's count
+     * interleaved with the slot index. Increasing per TCS, not globally. */
+    uint64_t next()
+    {
+        size_t slot = counter_slot();
+        uint64_t count = __atomic_fetch_add(&slots_[slot].value, 1, __ATOMIC_RELAXED);
+        return count * COUNTER_SLOTS + slot;
+    }
+
+    uint64_t read() const
+    {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < COUNTER_SLOTS; i++)
+            sum += __atomic_load_n(&slots_[i].value, __ATOMIC_RELAXED);
+        return sum;
+    }
+
+    void reset()
+    {
+        for (size_t i = 0; i < COUNTER_SLOTS; i++)
+            __atomic_store_n(&slots_[i].value, 0, __ATOMIC_RELAXED);
+    }
+
+private:
+    struct slot_t {
+        uint64_t value;
+        uint8_t pad[COUNTER_CACHE_LINE - sizeof(uint64_t)];
+    } __attribute__((aligned(COUNTER_CACHE_LINE)));
+
+    slot_t slots_[COUNTER_SLOTS];
+};
+
+#endif /* !_COUNTER_H_ */
@@ -0,0 +1,100 @@
+/*
+ * SpinPark.cpp - SpinParkCond/SpinParkQueue (SpinPark.h) and the
+ * producer/consumer ECALLs that mirror ecall_producer/ecall_consumer.
+ */
+
+#include "../Enclave.h"
+#include "Enclave_t.h"
+#include "SpinPark.h"
+
+SpinParkCond::SpinParkCond() : parked_(0)
+{
+    sgx_thread_mutex_init(&mutex_, NULL);
+    sgx_thread_cond_init(&cond_, NULL);
+}
+
+void SpinParkCond::notify_one()
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&parked_, __ATOMIC_RELAXED) == 0)
+        return;
+    sgx_thread_mutex_lock(&mutex_);
+    sgx_thread_cond_signal(&cond_);
+    sgx_thread_mutex_unlock(&mutex_);
+}
+
+void SpinParkCond::notify_all()
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&parked_, __ATOMIC_RELAXED) == 0)
+        return;
+    sgx_thread_mutex_lock(&mutex_);
+    sgx_thread_cond_broadcast(&cond_);
+    sgx_thread_mutex_unlock(&mutex_);
+}
+
+SpinParkQueue::SpinParkQueue() : lock_(SGX_SPINLOCK_INITIALIZER), occupied_(0), nextin_(0), nextout_(0)
+{
+}
+
+bool SpinParkQueue::try_push(int value)
+{
+    sgx_spin_lock(&lock_);
+    bool pushed = occupied_ < SPIN_PARK_QUEUE_SIZE;
+    if (pushed) {
+        buf_[nextin_] = value;
+        nextin_ = (nextin_ + 1) % SPIN_PARK_QUEUE_SIZE;
+        __atomic_store_n(&occupied_, occupied_ + 1, __ATOMIC_RELEASE);
+    }
+    sgx_spin_unlock(&lock_);
+    return pushed;
+}
+
+bool SpinParkQueue::try_pop(int *value)
+{
+    sgx_spin_lock(&lock_);
+    bool popped = occupied_ > 0;
+    if (popped) {
+        *value = buf_[nextout_];
+        nextout_ = (nextout_ + 1) % SPIN_PARK_QUEUE_SIZE;
+        __atomic_store_n(&occupied_, occupied_ - 1, __ATOMIC_RELEASE);
+    }
+    sgx_spin_unlock(&lock_);
+    return popped;
+}
+
+void SpinParkQueue::push(int value, unsigned int spins)
+{
+    // Another producer can take the slot between the wakeup and try_push
+    while (!try_push(value))
+        not_full_.wait([this] { return occupied() < SPIN_PARK_QUEUE_SIZE; }, spins);
+    not_empty_.notify_one();
+}
+
+int SpinParkQueue::pop(unsigned int spins)
+{
+    int value = 0;
+    while (!try_pop(&value))
+        not_empty_.wait([this] { return occupied() > 0; }, spins);
+    not_full_.notify_one();
+    return value;
+}
+
+static SpinParkQueue spin_queue;
+
+/*
+ * ecall_spin_producer / ecall_spin_consumer:
+ *   The ecall_producer/ecall_consumer handoff on SpinParkQueue, with a
+ *   spin budget per call.
+ */
+void ecall_spin_producer(size_t items, unsigned int spins)
+{
+    for (size_t i = 0; i < items; i++)
+        spin_queue.push((int)(i % SPIN_PARK_QUEUE_SIZE), spins);
+}
+
+void ecall_spin_consumer(size_t items, unsigned int spins)
+{
+    for (size_t i = 0; i < items; i++)
+        spin_queue.pop(spins);
+}
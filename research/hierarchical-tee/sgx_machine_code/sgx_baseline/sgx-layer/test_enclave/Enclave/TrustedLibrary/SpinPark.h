@@ -0,0 +1,97 @@
+/*
+ * SpinPark.h - enclave-side spin-then-park condition and bounded queue.
+ *
+ * sgx_thread_cond_wait() parks the thread outside the enclave
+ * (sgx_thread_wait_untrusted_event_ocall), and waking it costs the
+ * signaller another OCALL. Most handoffs in a busy producer/consumer are
+ * short, so SpinParkCond first re-checks the condition for up to `spins`
+ * PAUSE iterations inside the enclave before it falls back to the SGX
+ * mutex/cond pair. notify_*() only touches that pair, and so only exits
+ * the enclave, when a waiter is actually parked.
+ *
+ * The spin budget is per call: 0 parks at once, like sgx_thread_cond; a
+ * latency-critical consumer can spin longer than a background one.
+ * Spinning burns the core, so budgets should stay well under the cost of
+ * the two OCALLs they save (tens of microseconds).
+ */
+
+#ifndef _SPIN_PARK_H_
+#define _SPIN_PARK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sgx_spinlock.h"
+#include "sgx_thread.h"
+
+#define SPIN_PARK_DEFAULT_SPINS 1000
+#define SPIN_PARK_QUEUE_SIZE 50   /* BUFFER_SIZE of the cond_buffer_t sample in Thread.cpp */
+
+class SpinParkCond
+{
+public:
+    SpinParkCond();
+
+    /* Returns once ready() holds. ready() must read shared state with
+     * acquire loads, since it also runs without the mutex. */
+    template <typename Ready>
+    void wait(Ready ready, unsigned int spins)
+    {
+        for (unsigned int i = 0; i < spins; i++) {
+            if (ready())
+                return;
+            __builtin_ia32_pause();
+        }
+
+        sgx_thread_mutex_lock(&mutex_);
+        // Pairs with the fence in notify_*(): either the notifier sees us
+        // parked, or we see the state it published
+        __atomic_add_fetch(&parked_, 1, __ATOMIC_SEQ_CST);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        while (!ready())
+            sgx_thread_cond_wait(&cond_, &mutex_);
+        __atomic_sub_fetch(&parked_, 1, __ATOMIC_SEQ_CST);
+        sgx_thread_mutex_unlock(&mutex_);
+    }
+
+    /* Call after publishing the state waiters check. */
+    void notify_one();
+    void notify_all();
+
+private:
+    SpinParkCond(const SpinParkCond&);
+    SpinParkCond& operator=(const SpinParkCond&);
+
+    sgx_thread_mutex_t mutex_;
+    sgx_thread_cond_t cond_;
+    uint32_t parked_;
+};
+
+/* Bounded MPMC queue of ints: a trusted spinlock around the ring, and a
+ * SpinParkCond for each of "not empty" and "not full". */
+class SpinParkQueue
+{
+public:
+    SpinParkQueue();
+
+    void push(int value, unsigned int spins);
+    int pop(unsigned int spins);
+
+private:
+    SpinParkQueue(const SpinParkQueue&);
+    SpinParkQueue& operator=(const SpinParkQueue&);
+
+    bool try_push(int value);
+    bool try_pop(int *value);
+    int occupied() const { return __atomic_load_n(&occupied_, __ATOMIC_ACQUIRE); }
+
+    sgx_spinlock_t lock_;
+    int buf_[SPIN_PARK_QUEUE_SIZE];
+    int occupied_;
+    int nextin_;
+    int nextout_;
+    SpinParkCond not_empty_;
+    SpinParkCond not_full_;
+};
+
+#endif /* !_SPIN_PARK_H_ */
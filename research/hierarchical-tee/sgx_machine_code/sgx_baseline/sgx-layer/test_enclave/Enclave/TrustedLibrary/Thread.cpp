@@ -34,10 +34,24 @@
 #include "Enclave_t.h"
 
 #include "sgx_thread.h"
+#include "Counter.h"
 
 static size_t global_counter = 0;
 static sgx_thread_mutex_t global_mutex = SGX_THREAD_MUTEX_INITIALIZER;
 
+/* ecall_count_mutex / ecall_count_sharded */
+static size_t mutex_count = 0;
+static sgx_thread_mutex_t count_mutex = SGX_THREAD_MUTEX_INITIALIZER;
+static PerThreadCounter sharded_count;
+
+/*
+ * Slot owners, keyed by sgx_thread_self(): the TCS's thread data, fixed for
+ * the enclave's lifetime. TLS cannot carry the slot, because TCSPolicy 1
+ * re-initializes it on every root ECALL. It only caches the lookup here.
+ */
+static sgx_thread_t counter_slot_owner[COUNTER_SLOTS];
+static __thread size_t tcs_counter_slot = 0;   /* slot + 1, 0 until looked up */
+
 #define BUFFER_SIZE 50
 
 typedef struct {
@@ -102,3 +116,73 @@ void ecall_consumer(void)
         sgx_thread_mutex_unlock(&b->mutex);
     }
 }
+
+static size_t claim_counter_slot(sgx_thread_t self)
+{
+    /* Open addressing from a hash of the thread data address */
+    size_t start = (size_t)((self >> 12) % COUNTER_SLOTS);
+    for (size_t i = 0; i < COUNTER_SLOTS; i++) {
+        size_t slot = (start + i) % COUNTER_SLOTS;
+        sgx_thread_t owner = __atomic_load_n(&counter_slot_owner[slot], __ATOMIC_ACQUIRE);
+        if (owner == self)
+            return slot;
+        if (owner == 0 &&
+            __atomic_compare_exchange_n(&counter_slot_owner[slot], &owner, self, false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            return slot;
+    }
+    return start;   /* more TCSs than slots: share */
+}
+
+size_t counter_slot(void)
+{
+    if (tcs_counter_slot == 0)
+        tcs_counter_slot = claim_counter_slot(sgx_thread_self()) + 1;
+    return tcs_counter_slot - 1;
+}
+
+/*
+ * ecall_count_mutex:
+ *   Adds `increments` to a counter shared under an SGX mutex, one lock
+ *   per increment as in ecall_increase_counter.
+ */
+void ecall_count_mutex(size_t increments)
+{
+    for (size_t i = 0; i < increments; i++) {
+        sgx_thread_mutex_lock(&count_mutex);
+        mutex_count++;
+        sgx_thread_mutex_unlock(&count_mutex);
+    }
+}
+
+/*
+ * ecall_count_sharded:
+ *   The same increments on the per-TCS counter of Counter.h.
+ */
+void ecall_count_sharded(size_t increments)
+{
+    for (size_t i = 0; i < increments; i++)
+        sharded_count.add(1);
+}
+
+/*
+ * ecall_count_read:
+ *   Total of either counter; exact once every increment has returned.
+ */
+size_t ecall_count_read(int sharded)
+{
+    if (sharded)
+        return (size_t)sharded_count.read();
+    sgx_thread_mutex_lock(&count_mutex);
+    size_t count = mutex_count;
+    sgx_thread_mutex_unlock(&count_mutex);
+    return count;
+}
+
+void ecall_count_reset(void)
+{
+    sgx_thread_mutex_lock(&count_mutex);
+    mutex_count = 0;
+    sgx_thread_mutex_unlock(&count_mutex);
+    sharded_count.reset();
+}
@@ -0,0 +1,130 @@
+#include "attestation_session.h"
+
+#include <string.h>
+#include <openssl/crypto.h>
+#include <openssl/ec.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/x509.h>
+
+/* DER SubjectPublicKeyInfo of a P-256 key, up to the uncompressed point */
+static const uint8_t p256_spki_prefix[] = {
+    0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02, 0x01,
+    0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04
+};
+#define P256_SPKI_SIZE (sizeof(p256_spki_prefix) + SGX_SESSION_PUBLIC_KEY_SIZE)
+
+/* sgx_ec256_public_t stores x and y little-endian, DER big-endian */
+static void swap_coordinates(const uint8_t* in, uint8_t* out) {
+    for (size_t half = 0; half < SGX_SESSION_PUBLIC_KEY_SIZE; half += SGX_SESSION_COORD_SIZE) {
+        for (size_t i = 0; i < SGX_SESSION_COORD_SIZE; i++) {
+            out[half + i] = in[half + SGX_SESSION_COORD_SIZE - 1 - i];
+        }
+    }
+}
+
+static EVP_PKEY* decode_sgx_public_key(const uint8_t public_key[SGX_SESSION_PUBLIC_KEY_SIZE]) {
+    uint8_t spki[P256_SPKI_SIZE];
+    memcpy(spki, p256_spki_prefix, sizeof(p256_spki_prefix));
+    swap_coordinates(public_key, spki + sizeof(p256_spki_prefix));
+    const uint8_t* p = spki;
+    // Rejects points that are not on the curve
+    return d2i_PUBKEY(NULL, &p, sizeof(spki));
+}
+
+static bool encode_sgx_public_key(EVP_PKEY* key, uint8_t public_key[SGX_SESSION_PUBLIC_KEY_SIZE]) {
+    uint8_t spki[P256_SPKI_SIZE];
+    uint8_t* p = spki;
+    if (i2d_PUBKEY(key, NULL) != (int)sizeof(spki) || i2d_PUBKEY(key, &p) != (int)sizeof(spki) ||
+        memcmp(spki, p256_spki_prefix, sizeof(p256_spki_prefix)) != 0) {
+        return false;
+    }
+    swap_coordinates(spki + sizeof(p256_spki_prefix), public_key);
+    return true;
+}
+
+static bool sha256_parts(const uint8_t* a, size_t a_len, const uint8_t* b, size_t b_len,
+                         const uint8_t* c, size_t c_len, uint8_t out[32]) {
+    EVP_MD_CTX* ctx = EVP_MD_CTX_new();
+    unsigned int len = 0;
+    bool ok = ctx != NULL &&
+              EVP_DigestInit_ex(ctx, EVP_sha256(), NULL) == 1 &&
+              EVP_DigestUpdate(ctx, a, a_len) == 1 &&
+              EVP_DigestUpdate(ctx, b, b_len) == 1 &&
+              (c_len == 0 || EVP_DigestUpdate(ctx, c, c_len) == 1) &&
+              EVP_DigestFinal_ex(ctx, out, &len) == 1 && len == 32;
+    EVP_MD_CTX_free(ctx);
+    return ok;
+}
+
+bool session_key_nonce(const uint8_t public_key[SGX_SESSION_PUBLIC_KEY_SIZE],
+                       const uint8_t nonce[SGX_BINDING_NONCE_SIZE],
+                       uint8_t out[SGX_BINDING_NONCE_SIZE]) {
+    return sha256_parts(public_key, SGX_SESSION_PUBLIC_KEY_SIZE, nonce, SGX_BINDING_NONCE_SIZE,
+                        NULL, 0, out);
+}
+
+bool session_report_data_matches(const uint8_t report_data[64], const uint8_t* mrenclave,
+                                 const uint8_t key_nonce[SGX_BINDING_NONCE_SIZE]) {
+    uint8_t binding[SGX_BINDING_SIZE];
+    return memcmp(report_data + SGX_BINDING_NONCE_OFFSET, key_nonce, SGX_BINDING_NONCE_SIZE) == 0 &&
+           sha256_parts(mrenclave, SGX_BINDING_MRENCLAVE_SIZE,
+                        (const uint8_t*)SGX_BINDING_PURPOSE, SGX_BINDING_PURPOSE_LEN,
+                        key_nonce, SGX_BINDING_NONCE_SIZE, binding) &&
+           CRYPTO_memcmp(report_data, binding, SGX_BINDING_SIZE) == 0;
+}
+
+AttestedSession::AttestedSession() : established_(false) {
+    memset(key_, 0, sizeof(key_));
+    memset(key_nonce_, 0, sizeof(key_nonce_));
+}
+
+AttestedSession::~AttestedSession() {
+    OPENSSL_cleanse(key_, sizeof(key_));
+}
+
+bool AttestedSession::accept(const uint8_t enclave_public_key[SGX_SESSION_PUBLIC_KEY_SIZE],
+                             const uint8_t key_nonce[SGX_BINDING_NONCE_SIZE],
+                             uint8_t peer_public_key[SGX_SESSION_PUBLIC_KEY_SIZE]) {
+    established_ = false;
+    EVP_PKEY* enclave_key = decode_sgx_public_key(enclave_public_key);
+    EVP_PKEY* own_key = NULL;
+    EVP_PKEY_CTX* keygen = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, NULL);
+    bool ok = enclave_key != NULL && keygen != NULL &&
+              EVP_PKEY_keygen_init(keygen) == 1 &&
+              EVP_PKEY_CTX_set_ec_paramgen_curve_nid(keygen, NID_X9_62_prime256v1) == 1 &&
+              EVP_PKEY_keygen(keygen, &own_key) == 1 &&
+              encode_sgx_public_key(own_key, peer_public_key);
+    EVP_PKEY_CTX_free(keygen);
+    
+    // ECDH x coordinate, big-endian
+    uint8_t shared[SGX_SESSION_COORD_SIZE];
+    size_t shared_len = sizeof(shared);
+    EVP_PKEY_CTX* derive = ok ? EVP_PKEY_CTX_new(own_key, NULL) : NULL;
+    ok = derive != NULL &&
+         EVP_PKEY_derive_init(derive) == 1 &&
+         EVP_PKEY_derive_set_peer(derive, enclave_key) == 1 &&
+         EVP_PKEY_derive(derive, shared, &shared_len) == 1 && shared_len == sizeof(shared) &&
+         sha256_parts(shared, sizeof(shared), (const uint8_t*)SGX_SESSION_LABEL,
+                      SGX_SESSION_LABEL_LEN, key_nonce, SGX_BINDING_NONCE_SIZE, key_);
+    EVP_PKEY_CTX_free(derive);
+    EVP_PKEY_free(own_key);
+    EVP_PKEY_free(enclave_key);
+    OPENSSL_cleanse(shared, sizeof(shared));
+    
+    if (ok) {
+        memcpy(key_nonce_, key_nonce, SGX_BINDING_NONCE_SIZE);
+        established_ = true;
+    }
+    return ok;
+}
+
+bool AttestedSession::verify(const uint8_t* message, size_t len,
+                             const uint8_t mac[SGX_SESSION_MAC_SIZE]) const {
+    uint8_t expected[SGX_SESSION_MAC_SIZE];
+    unsigned int expected_len = 0;
+    return established_ &&
+           HMAC(EVP_sha256(), key_, sizeof(key_), message, len, expected, &expected_len) != NULL &&
+           expected_len == SGX_SESSION_MAC_SIZE &&
+           CRYPTO_memcmp(expected, mac, SGX_SESSION_MAC_SIZE) == 0;
+}
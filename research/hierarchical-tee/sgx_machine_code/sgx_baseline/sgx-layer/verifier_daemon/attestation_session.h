@@ -0,0 +1,53 @@
+#ifndef ATTESTATION_SESSION_H
+#define ATTESTATION_SESSION_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "sgx_binding.h"
+#include "sgx_session.h"
+
+/* key_nonce = SHA256(public_key || nonce), as the enclave computes it. */
+bool session_key_nonce(const uint8_t public_key[SGX_SESSION_PUBLIC_KEY_SIZE],
+                       const uint8_t nonce[SGX_BINDING_NONCE_SIZE],
+                       uint8_t out[SGX_BINDING_NONCE_SIZE]);
+
+/* Does an SGX report_data carry key_nonce and the binding of `mrenclave`
+ * over it, i.e. came from ecall_generate_composite_report()? */
+bool session_report_data_matches(const uint8_t report_data[64], const uint8_t* mrenclave,
+                                 const uint8_t key_nonce[SGX_BINDING_NONCE_SIZE]);
+
+/*
+ * Verifier end of the attested session of sgx_session.h.
+ *
+ * accept() takes the enclave's public key once the quote that binds it has
+ * been verified, creates the verifier's ephemeral key and derives the
+ * session key; its public key goes back to the enclave's
+ * ecall_open_session(). From then on each request of the prover costs one
+ * HMAC on either side instead of a quote and its DCAP verification.
+ */
+class AttestedSession {
+public:
+    AttestedSession();
+    ~AttestedSession();
+
+    bool accept(const uint8_t enclave_public_key[SGX_SESSION_PUBLIC_KEY_SIZE],
+                const uint8_t key_nonce[SGX_BINDING_NONCE_SIZE],
+                uint8_t peer_public_key[SGX_SESSION_PUBLIC_KEY_SIZE]);
+    /* HMAC-SHA256 of message under the session key, constant-time compare. */
+    bool verify(const uint8_t* message, size_t len, const uint8_t mac[SGX_SESSION_MAC_SIZE]) const;
+
+    bool established() const { return established_; }
+    const uint8_t* key_nonce() const { return key_nonce_; }
+
+private:
+    friend class TicketIssuer;  /* seals the key into, and restores it from, tickets */
+
+    AttestedSession(const AttestedSession&);
+    AttestedSession& operator=(const AttestedSession&);
+
+    uint8_t key_[SGX_SESSION_KEY_SIZE];
+    uint8_t key_nonce_[SGX_BINDING_NONCE_SIZE];
+    bool established_;
+};
+
+#endif /* ATTESTATION_SESSION_H */
@@ -0,0 +1,138 @@
+#include "binding_merkle.h"
+
+#include <string.h>
+#include <openssl/evp.h>
+
+MerkleHasher::MerkleHasher() : ctx_(EVP_MD_CTX_new()) {
+}
+
+MerkleHasher::~MerkleHasher() {
+    EVP_MD_CTX_free(ctx_);
+}
+
+bool MerkleHasher::leaf(const uint8_t binding[BINDING_MERKLE_HASH_SIZE],
+                        uint8_t out[BINDING_MERKLE_HASH_SIZE]) {
+    static const uint8_t prefix = BINDING_MERKLE_LEAF_PREFIX;
+    unsigned int len = 0;
+    return ctx_ != NULL &&
+           EVP_DigestInit_ex(ctx_, EVP_sha256(), NULL) == 1 &&
+           EVP_DigestUpdate(ctx_, &prefix, 1) == 1 &&
+           EVP_DigestUpdate(ctx_, binding, BINDING_MERKLE_HASH_SIZE) == 1 &&
+           EVP_DigestFinal_ex(ctx_, out, &len) == 1 && len == BINDING_MERKLE_HASH_SIZE;
+}
+
+bool MerkleHasher::node(const uint8_t left[BINDING_MERKLE_HASH_SIZE],
+                        const uint8_t right[BINDING_MERKLE_HASH_SIZE],
+                        uint8_t out[BINDING_MERKLE_HASH_SIZE]) {
+    static const uint8_t prefix = BINDING_MERKLE_NODE_PREFIX;
+    unsigned int len = 0;
+    return ctx_ != NULL &&
+           EVP_DigestInit_ex(ctx_, EVP_sha256(), NULL) == 1 &&
+           EVP_DigestUpdate(ctx_, &prefix, 1) == 1 &&
+           EVP_DigestUpdate(ctx_, left, BINDING_MERKLE_HASH_SIZE) == 1 &&
+           EVP_DigestUpdate(ctx_, right, BINDING_MERKLE_HASH_SIZE) == 1 &&
+           EVP_DigestFinal_ex(ctx_, out, &len) == 1 && len == BINDING_MERKLE_HASH_SIZE;
+}
+
+bool MerkleHasher::root_from_proof(const uint8_t binding[BINDING_MERKLE_HASH_SIZE],
+                                   byte_span_t proof, uint8_t root[BINDING_MERKLE_HASH_SIZE]) {
+    if (proof.size < BINDING_MERKLE_PROOF_HEADER_SIZE) {
+        return false;
+    }
+    size_t index = composite_get_u32(proof.data);
+    size_t count = composite_get_u32(proof.data + 4);
+    if (count == 0 || count > BINDING_MERKLE_MAX_LEAVES || index >= count ||
+        proof.size != BINDING_MERKLE_PROOF_HEADER_SIZE +
+                      binding_merkle_siblings(index, count) * BINDING_MERKLE_HASH_SIZE) {
+        return false;
+    }
+    
+    uint8_t hash[BINDING_MERKLE_HASH_SIZE];
+    if (!leaf(binding, hash)) {
+        return false;
+    }
+    const uint8_t* sibling = proof.data + BINDING_MERKLE_PROOF_HEADER_SIZE;
+    while (count > 1) {
+        if (!(index == count - 1 && count % 2 == 1)) {
+            bool ok = index % 2 == 0 ? node(hash, sibling, hash) : node(sibling, hash, hash);
+            if (!ok) {
+                return false;
+            }
+            sibling += BINDING_MERKLE_HASH_SIZE;
+        }
+        index /= 2;
+        count = (count + 1) / 2;
+    }
+    memcpy(root, hash, BINDING_MERKLE_HASH_SIZE);
+    return true;
+}
+
+bool BindingMerkleTree::build(const uint8_t* bindings, size_t count) {
+    if (count == 0 || count > BINDING_MERKLE_MAX_LEAVES) {
+        return false;
+    }
+    // Every level rounds up; the storage is reused across batches
+    size_t total = count;
+    for (size_t width = count; width > 1; width = (width + 1) / 2) {
+        total += (width + 1) / 2;
+    }
+    nodes_.resize(total * BINDING_MERKLE_HASH_SIZE);
+    level_offset_.clear();
+    level_offset_.push_back(0);
+    leaf_count_ = count;
+    for (size_t i = 0; i < count; i++) {
+        if (!hasher_.leaf(bindings + i * BINDING_MERKLE_HASH_SIZE,
+                          &nodes_[i * BINDING_MERKLE_HASH_SIZE])) {
+            return false;
+        }
+    }
+    
+    size_t level = 0;
+    size_t width = count;
+    while (width > 1) {
+        const uint8_t* below = &nodes_[level * BINDING_MERKLE_HASH_SIZE];
+        size_t next = level + width;
+        uint8_t* above = &nodes_[next * BINDING_MERKLE_HASH_SIZE];
+        for (size_t i = 0; i + 1 < width; i += 2) {
+            if (!hasher_.node(below + i * BINDING_MERKLE_HASH_SIZE,
+                              below + (i + 1) * BINDING_MERKLE_HASH_SIZE,
+                              above + i / 2 * BINDING_MERKLE_HASH_SIZE)) {
+                return false;
+            }
+        }
+        if (width % 2 == 1) {
+            memcpy(above + width / 2 * BINDING_MERKLE_HASH_SIZE,
+                   below + (width - 1) * BINDING_MERKLE_HASH_SIZE, BINDING_MERKLE_HASH_SIZE);
+        }
+        level_offset_.push_back(next);
+        level = next;
+        width = (width + 1) / 2;
+    }
+    return true;
+}
+
+void BindingMerkleTree::report_data(uint8_t out[64]) const {
+    memcpy(out, root(), BINDING_MERKLE_HASH_SIZE);
+    memset(out + BINDING_MERKLE_HASH_SIZE, 0, 64 - BINDING_MERKLE_HASH_SIZE);
+}
+
+bool BindingMerkleTree::proof(size_t index, uint8_t* out, size_t capacity) const {
+    if (index >= leaf_count_ || capacity < proof_size(index)) {
+        return false;
+    }
+    composite_put_u32(out, (uint32_t)index);
+    composite_put_u32(out + 4, (uint32_t)leaf_count_);
+    uint8_t* sibling = out + BINDING_MERKLE_PROOF_HEADER_SIZE;
+    size_t width = leaf_count_;
+    for (size_t level = 0; width > 1; level++) {
+        if (!(index == width - 1 && width % 2 == 1)) {
+            size_t pair = index ^ 1;
+            memcpy(sibling, &nodes_[(level_offset_[level] + pair) * BINDING_MERKLE_HASH_SIZE],
+                   BINDING_MERKLE_HASH_SIZE);
+            sibling += BINDING_MERKLE_HASH_SIZE;
+        }
+        index /= 2;
+        width = (width + 1) / 2;
+    }
+    return true;
+}
@@ -0,0 +1,104 @@
+#ifndef BINDING_MERKLE_H
+#define BINDING_MERKLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "composite_evidence.h"
+
+/*
+ * One TDX attestation for many co-resident SGX enclaves. An aggregator
+ * inside the TD collects the enclaves' 32-byte binding hashes over a batch
+ * window and builds a Merkle tree:
+ *
+ *   leaf = SHA256(0x00 || binding)
+ *   node = SHA256(0x01 || left || right)
+ *
+ * An odd node at the end of a level moves up unchanged instead of being
+ * paired with itself, so no two leaf sets share a root. The TDX
+ * report_data is root (32) | zero (32). Each enclave gets an inclusion
+ * proof for the composite frame's optional proof section:
+ *
+ *   u32 leaf_index | u32 leaf_count | sibling hashes, leaf level first
+ *
+ * The index and count fix which levels have a sibling, so a proof has
+ * exactly binding_merkle_siblings() hashes. The verifier recomputes the
+ * root from the frame's binding hash and compares it with the token's
+ * report_data, where a single-enclave frame compares the binding itself.
+ *
+ * Shared by the verifier and the TD's aggregator (tdx-layer/native_client);
+ * OpenSSL only, no SGX SDK.
+ */
+
+#define BINDING_MERKLE_HASH_SIZE 32
+#define BINDING_MERKLE_MAX_LEAVES (1u << 16)
+#define BINDING_MERKLE_MAX_DEPTH 16
+#define BINDING_MERKLE_PROOF_HEADER_SIZE 8
+#define BINDING_MERKLE_PROOF_MAX \
+    (BINDING_MERKLE_PROOF_HEADER_SIZE + BINDING_MERKLE_MAX_DEPTH * BINDING_MERKLE_HASH_SIZE)
+#define BINDING_MERKLE_LEAF_PREFIX 0x00
+#define BINDING_MERKLE_NODE_PREFIX 0x01
+
+/* Sibling hashes on the path from leaf `index` of `count`. */
+static inline size_t binding_merkle_siblings(size_t index, size_t count) {
+    size_t siblings = 0;
+    while (count > 1) {
+        // The last node of an odd level has no sibling and moves up as is
+        if (!(index == count - 1 && count % 2 == 1)) {
+            siblings++;
+        }
+        index /= 2;
+        count = (count + 1) / 2;
+    }
+    return siblings;
+}
+
+/* Per-thread: owns a digest context, like EvidenceHasher. */
+class MerkleHasher {
+public:
+    MerkleHasher();
+    ~MerkleHasher();
+    
+    bool leaf(const uint8_t binding[BINDING_MERKLE_HASH_SIZE], uint8_t out[BINDING_MERKLE_HASH_SIZE]);
+    bool node(const uint8_t left[BINDING_MERKLE_HASH_SIZE],
+              const uint8_t right[BINDING_MERKLE_HASH_SIZE], uint8_t out[BINDING_MERKLE_HASH_SIZE]);
+    
+    /* Root implied by `binding` and its proof; false if the proof is malformed. */
+    bool root_from_proof(const uint8_t binding[BINDING_MERKLE_HASH_SIZE], byte_span_t proof,
+                         uint8_t root[BINDING_MERKLE_HASH_SIZE]);
+    
+private:
+    MerkleHasher(const MerkleHasher&);
+    MerkleHasher& operator=(const MerkleHasher&);
+    
+    struct evp_md_ctx_st* ctx_;
+};
+
+/* Built once per batch by the aggregator; not thread-safe. */
+class BindingMerkleTree {
+public:
+    BindingMerkleTree() : leaf_count_(0) {}
+    
+    /* `bindings`: `count` consecutive 32-byte hashes. */
+    bool build(const uint8_t* bindings, size_t count);
+    
+    size_t leaf_count() const { return leaf_count_; }
+    const uint8_t* root() const { return &nodes_[level_offset_.back() * BINDING_MERKLE_HASH_SIZE]; }
+    /* The TDX report_data for this batch. */
+    void report_data(uint8_t out[64]) const;
+    
+    size_t proof_size(size_t index) const {
+        return BINDING_MERKLE_PROOF_HEADER_SIZE +
+               binding_merkle_siblings(index, leaf_count_) * BINDING_MERKLE_HASH_SIZE;
+    }
+    /* Writes proof_size(index) bytes. */
+    bool proof(size_t index, uint8_t* out, size_t capacity) const;
+    
+private:
+    MerkleHasher hasher_;
+    std::vector<uint8_t> nodes_;        /* every level, leaves first */
+    std::vector<size_t> level_offset_;  /* first node of each level, in hashes */
+    size_t leaf_count_;
+};
+
+#endif /* BINDING_MERKLE_H */
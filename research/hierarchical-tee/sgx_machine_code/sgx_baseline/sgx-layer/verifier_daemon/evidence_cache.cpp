@@ -0,0 +1,451 @@
+#include "evidence_cache.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <mutex>
+#include <openssl/evp.h>
+
+#ifndef CACHE_LINE_SIZE
+#define CACHE_LINE_SIZE 64
+#endif
+#define COLLATERAL_PARTS 7
+#define NEXT_UPDATE_KEY "\"nextUpdate\":\""
+#define TCB_EVALUATION_KEY "\"tcbEvaluationDataNumber\":"
+
+/*
+ * Seqlock: a writer makes the sequence odd, updates, then makes it even
+ * again. A reader that saw the same even value before and after its copy
+ * read a consistent entry.
+ */
+static uint32_t read_begin(const std::atomic<uint32_t>& sequence) {
+    uint32_t begin;
+    while ((begin = sequence.load(std::memory_order_acquire)) & 1) {
+        __builtin_ia32_pause();
+    }
+    return begin;
+}
+
+static bool read_retry(const std::atomic<uint32_t>& sequence, uint32_t begin) {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return sequence.load(std::memory_order_relaxed) != begin;
+}
+
+static void write_begin(std::atomic<uint32_t>* sequence) {
+    sequence->store(sequence->load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+static void write_end(std::atomic<uint32_t>* sequence) {
+    sequence->store(sequence->load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+/* Way to replace: `matches` if set, else an empty or expired way, else the
+ * one expiring soonest. */
+static size_t victim_way(const int64_t* expires, size_t ways, int matches, time_t now) {
+    if (matches >= 0) {
+        return (size_t)matches;
+    }
+    size_t victim = 0;
+    for (size_t w = 0; w < ways; w++) {
+        if (expires[w] < (int64_t)now) {
+            return w;
+        }
+        if (expires[w] < expires[victim]) {
+            victim = w;
+        }
+    }
+    return victim;
+}
+
+EvidenceHasher::EvidenceHasher() : ctx_(EVP_MD_CTX_new()) {
+}
+
+EvidenceHasher::~EvidenceHasher() {
+    EVP_MD_CTX_free(ctx_);
+}
+
+bool EvidenceHasher::digest(const composite_evidence_t& evidence, uint32_t policy_generation,
+                            uint8_t out[EVIDENCE_DIGEST_SIZE]) {
+    uint8_t generation[4];
+    composite_put_u32(generation, policy_generation);
+    // Length-prefix the variable sections so their boundaries are hashed too
+    uint8_t quote_len[4];
+    uint8_t token_len[4];
+    composite_put_u32(quote_len, (uint32_t)evidence.sgx_quote.size);
+    composite_put_u32(token_len, (uint32_t)evidence.tdx_token.size);
+    unsigned int len = 0;
+    return ctx_ != NULL &&
+           EVP_DigestInit_ex(ctx_, EVP_sha256(), NULL) == 1 &&
+           EVP_DigestUpdate(ctx_, generation, sizeof(generation)) == 1 &&
+           EVP_DigestUpdate(ctx_, quote_len, sizeof(quote_len)) == 1 &&
+           EVP_DigestUpdate(ctx_, evidence.sgx_quote.data, evidence.sgx_quote.size) == 1 &&
+           EVP_DigestUpdate(ctx_, token_len, sizeof(token_len)) == 1 &&
+           EVP_DigestUpdate(ctx_, evidence.tdx_token.data, evidence.tdx_token.size) == 1 &&
+           EVP_DigestUpdate(ctx_, evidence.binding_hash.data, evidence.binding_hash.size) == 1 &&
+           // A verdict for one proof must not be served for another
+           (!evidence.binding_proof.data ||
+            EVP_DigestUpdate(ctx_, evidence.binding_proof.data, evidence.binding_proof.size) == 1) &&
+           EVP_DigestFinal_ex(ctx_, out, &len) == 1 && len == EVIDENCE_DIGEST_SIZE;
+}
+
+bool EvidenceHasher::binding(const uint8_t mrenclave[SGX_BINDING_MRENCLAVE_SIZE],
+                             const uint8_t nonce[SGX_BINDING_NONCE_SIZE],
+                             uint8_t out[SGX_BINDING_SIZE]) {
+    unsigned int len = 0;
+    return ctx_ != NULL &&
+           EVP_DigestInit_ex(ctx_, EVP_sha256(), NULL) == 1 &&
+           EVP_DigestUpdate(ctx_, mrenclave, SGX_BINDING_MRENCLAVE_SIZE) == 1 &&
+           EVP_DigestUpdate(ctx_, SGX_BINDING_PURPOSE, SGX_BINDING_PURPOSE_LEN) == 1 &&
+           EVP_DigestUpdate(ctx_, nonce, SGX_BINDING_NONCE_SIZE) == 1 &&
+           EVP_DigestFinal_ex(ctx_, out, &len) == 1 && len == SGX_BINDING_SIZE;
+}
+
+/* ---- Verdict cache ---- */
+
+typedef struct {
+    uint8_t digest[EVIDENCE_DIGEST_SIZE];
+    int64_t expires;          /* 0: empty */
+    verdict_record_t record;
+} verdict_slot_t;
+
+struct VerdictCache::shard_t {
+    shard_t() : sequence(0), hits(0), misses(0), insertions(0) {
+        memset(slots, 0, sizeof(slots));
+    }
+    
+    /* Read by lookups */
+    std::atomic<uint32_t> sequence;
+    verdict_slot_t slots[VERDICT_CACHE_WAYS];
+    char pad0_[CACHE_LINE_SIZE];
+    /* Written by lookups and inserts */
+    std::mutex write_lock;
+    std::atomic<uint64_t> hits;
+    std::atomic<uint64_t> misses;
+    std::atomic<uint64_t> insertions;
+    char pad1_[CACHE_LINE_SIZE];
+};
+
+// Digests are uniformly distributed, so their leading bytes pick the shard
+static size_t verdict_shard(const uint8_t* digest) {
+    return (size_t)composite_get_u32(digest) % VERDICT_CACHE_SHARDS;
+}
+
+VerdictCache::VerdictCache() : shards_(new shard_t[VERDICT_CACHE_SHARDS]) {
+}
+
+VerdictCache::~VerdictCache() {
+    delete[] shards_;
+}
+
+bool VerdictCache::lookup(const uint8_t digest[EVIDENCE_DIGEST_SIZE], time_t now,
+                          verdict_record_t* out) const {
+    shard_t& shard = shards_[verdict_shard(digest)];
+    verdict_slot_t found;
+    memset(&found, 0, sizeof(found));
+    bool hit;
+    uint32_t begin;
+    do {
+        begin = read_begin(shard.sequence);
+        hit = false;
+        for (size_t w = 0; w < VERDICT_CACHE_WAYS; w++) {
+            const verdict_slot_t& slot = shard.slots[w];
+            if (slot.expires != 0 && memcmp(slot.digest, digest, EVIDENCE_DIGEST_SIZE) == 0) {
+                found = slot;
+                hit = true;
+                break;
+            }
+        }
+    } while (read_retry(shard.sequence, begin));
+    
+    // Same bound as the token's own expiry check
+    hit = hit && (int64_t)now <= found.expires;
+    if (hit) {
+        *out = found.record;
+        shard.hits.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        shard.misses.fetch_add(1, std::memory_order_relaxed);
+    }
+    return hit;
+}
+
+void VerdictCache::insert(const uint8_t digest[EVIDENCE_DIGEST_SIZE], int64_t expires,
+                          const verdict_record_t& record) {
+    shard_t& shard = shards_[verdict_shard(digest)];
+    std::lock_guard<std::mutex> lock(shard.write_lock);
+    
+    int64_t way_expires[VERDICT_CACHE_WAYS];
+    int matches = -1;
+    for (size_t w = 0; w < VERDICT_CACHE_WAYS; w++) {
+        way_expires[w] = shard.slots[w].expires;
+        if (way_expires[w] != 0 &&
+            memcmp(shard.slots[w].digest, digest, EVIDENCE_DIGEST_SIZE) == 0) {
+            matches = (int)w;
+        }
+    }
+    verdict_slot_t& slot = shard.slots[victim_way(way_expires, VERDICT_CACHE_WAYS, matches,
+                                                  time(NULL))];
+    
+    write_begin(&shard.sequence);
+    memcpy(slot.digest, digest, EVIDENCE_DIGEST_SIZE);
+    slot.expires = expires;
+    slot.record = record;
+    write_end(&shard.sequence);
+    shard.insertions.fetch_add(1, std::memory_order_relaxed);
+}
+
+cache_stats_t VerdictCache::stats() const {
+    cache_stats_t stats = {0, 0, 0};
+    for (size_t s = 0; s < VERDICT_CACHE_SHARDS; s++) {
+        stats.hits += shards_[s].hits.load(std::memory_order_relaxed);
+        stats.misses += shards_[s].misses.load(std::memory_order_relaxed);
+        stats.insertions += shards_[s].insertions.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+/* ---- Collateral cache ---- */
+
+// The pointer/size pairs of sgx_ql_qve_collateral_t, flattened into a slot
+static char* sgx_ql_qve_collateral_t::* const collateral_part[COLLATERAL_PARTS] = {
+    &sgx_ql_qve_collateral_t::pck_crl_issuer_chain,
+    &sgx_ql_qve_collateral_t::root_ca_crl,
+    &sgx_ql_qve_collateral_t::pck_crl,
+    &sgx_ql_qve_collateral_t::tcb_info_issuer_chain,
+    &sgx_ql_qve_collateral_t::tcb_info,
+    &sgx_ql_qve_collateral_t::qe_identity_issuer_chain,
+    &sgx_ql_qve_collateral_t::qe_identity
+};
+static uint32_t sgx_ql_qve_collateral_t::* const collateral_part_size[COLLATERAL_PARTS] = {
+    &sgx_ql_qve_collateral_t::pck_crl_issuer_chain_size,
+    &sgx_ql_qve_collateral_t::root_ca_crl_size,
+    &sgx_ql_qve_collateral_t::pck_crl_size,
+    &sgx_ql_qve_collateral_t::tcb_info_issuer_chain_size,
+    &sgx_ql_qve_collateral_t::tcb_info_size,
+    &sgx_ql_qve_collateral_t::qe_identity_issuer_chain_size,
+    &sgx_ql_qve_collateral_t::qe_identity_size
+};
+
+typedef struct {
+    collateral_key_t key;
+    int64_t expires;          /* 0: empty */
+    uint32_t version;
+    uint32_t tee_type;
+    uint32_t offset[COLLATERAL_PARTS];
+    uint32_t size[COLLATERAL_PARTS];
+    uint32_t total;
+} collateral_header_t;
+
+typedef struct {
+    collateral_header_t header;
+    uint8_t* data;            /* COLLATERAL_SLOT_BYTES, lives as long as the cache */
+} collateral_slot_t;
+
+struct CollateralCache::shard_t {
+    shard_t() : sequence(0), hits(0), misses(0), insertions(0) {
+        for (size_t w = 0; w < COLLATERAL_CACHE_WAYS; w++) {
+            memset(&slots[w].header, 0, sizeof(slots[w].header));
+            slots[w].data = new uint8_t[COLLATERAL_SLOT_BYTES];
+        }
+    }
+    ~shard_t() {
+        for (size_t w = 0; w < COLLATERAL_CACHE_WAYS; w++) {
+            delete[] slots[w].data;
+        }
+    }
+    
+    std::atomic<uint32_t> sequence;
+    collateral_slot_t slots[COLLATERAL_CACHE_WAYS];
+    char pad0_[CACHE_LINE_SIZE];
+    std::mutex write_lock;
+    std::atomic<uint64_t> hits;
+    std::atomic<uint64_t> misses;
+    std::atomic<uint64_t> insertions;
+    char pad1_[CACHE_LINE_SIZE];
+};
+
+static bool key_equals(const collateral_key_t& a, const collateral_key_t& b) {
+    return memcmp(&a, &b, sizeof(collateral_key_t)) == 0;
+}
+
+static size_t collateral_shard(const collateral_key_t& key) {
+    size_t hash = key.ca;
+    for (size_t i = 0; i < FMSPC_SIZE; i++) {
+        hash = hash * 31 + key.fmspc[i];
+    }
+    return hash % COLLATERAL_CACHE_SHARDS;
+}
+
+/* Way holding `key`, or -1. Caller holds the shard's write lock or retries. */
+static int find_way(const collateral_slot_t* slots, const collateral_key_t& key) {
+    for (size_t w = 0; w < COLLATERAL_CACHE_WAYS; w++) {
+        if (slots[w].header.expires != 0 && key_equals(slots[w].header.key, key)) {
+            return (int)w;
+        }
+    }
+    return -1;
+}
+
+CollateralCache::CollateralCache() : shards_(new shard_t[COLLATERAL_CACHE_SHARDS]) {
+}
+
+CollateralCache::~CollateralCache() {
+    delete[] shards_;
+}
+
+bool CollateralCache::lookup(const collateral_key_t& key, time_t now,
+                             std::vector<uint8_t>* buffer, sgx_ql_qve_collateral_t* out) const {
+    if (buffer->size() < COLLATERAL_SLOT_BYTES) {
+        buffer->resize(COLLATERAL_SLOT_BYTES);
+    }
+    shard_t& shard = shards_[collateral_shard(key)];
+    collateral_header_t header;
+    memset(&header, 0, sizeof(header));
+    bool hit;
+    uint32_t begin;
+    do {
+        begin = read_begin(shard.sequence);
+        int way = find_way(shard.slots, key);
+        hit = way >= 0;
+        if (hit) {
+            header = shard.slots[way].header;
+            // A torn header is caught by the retry, but must not overrun the copy
+            size_t total = header.total < COLLATERAL_SLOT_BYTES ? header.total : COLLATERAL_SLOT_BYTES;
+            memcpy(buffer->data(), shard.slots[way].data, total);
+        }
+    } while (read_retry(shard.sequence, begin));
+    
+    hit = hit && (int64_t)now < header.expires;
+    if (!hit) {
+        shard.misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    shard.hits.fetch_add(1, std::memory_order_relaxed);
+    
+    memset(out, 0, sizeof(*out));
+    out->version = header.version;
+    out->tee_type = header.tee_type;
+    for (size_t i = 0; i < COLLATERAL_PARTS; i++) {
+        out->*collateral_part[i] = (char*)buffer->data() + header.offset[i];
+        out->*collateral_part_size[i] = header.size[i];
+    }
+    return true;
+}
+
+bool CollateralCache::insert(const collateral_key_t& key, int64_t expires,
+                             const sgx_ql_qve_collateral_t* collateral) {
+    collateral_header_t header;
+    memset(&header, 0, sizeof(header));
+    header.key = key;
+    header.expires = expires;
+    header.version = collateral->version;
+    header.tee_type = collateral->tee_type;
+    size_t total = 0;
+    for (size_t i = 0; i < COLLATERAL_PARTS; i++) {
+        header.offset[i] = (uint32_t)total;
+        header.size[i] = collateral->*collateral_part_size[i];
+        total += header.size[i];
+        if (total > COLLATERAL_SLOT_BYTES) {
+            return false;
+        }
+    }
+    header.total = (uint32_t)total;
+    
+    shard_t& shard = shards_[collateral_shard(key)];
+    std::lock_guard<std::mutex> lock(shard.write_lock);
+    int64_t way_expires[COLLATERAL_CACHE_WAYS];
+    for (size_t w = 0; w < COLLATERAL_CACHE_WAYS; w++) {
+        way_expires[w] = shard.slots[w].header.expires;
+    }
+    collateral_slot_t& slot = shard.slots[victim_way(way_expires, COLLATERAL_CACHE_WAYS,
+                                                     find_way(shard.slots, key), time(NULL))];
+    
+    write_begin(&shard.sequence);
+    slot.header = header;
+    for (size_t i = 0; i < COLLATERAL_PARTS; i++) {
+        memcpy(slot.data + header.offset[i], collateral->*collateral_part[i], header.size[i]);
+    }
+    write_end(&shard.sequence);
+    shard.insertions.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void CollateralCache::invalidate(const collateral_key_t& key) {
+    shard_t& shard = shards_[collateral_shard(key)];
+    std::lock_guard<std::mutex> lock(shard.write_lock);
+    int way = find_way(shard.slots, key);
+    if (way < 0) {
+        return;
+    }
+    write_begin(&shard.sequence);
+    shard.slots[way].header.expires = 0;
+    write_end(&shard.sequence);
+}
+
+cache_stats_t CollateralCache::stats() const {
+    cache_stats_t stats = {0, 0, 0};
+    for (size_t s = 0; s < COLLATERAL_CACHE_SHARDS; s++) {
+        stats.hits += shards_[s].hits.load(std::memory_order_relaxed);
+        stats.misses += shards_[s].misses.load(std::memory_order_relaxed);
+        stats.insertions += shards_[s].insertions.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+/* "nextUpdate":"YYYY-MM-DDTHH:MM:SSZ" in a PCS JSON body, 0 if absent. */
+static int64_t json_next_update(const char* json, uint32_t size) {
+    if (!json) {
+        return 0;
+    }
+    const char* key = (const char*)memmem(json, size, NEXT_UPDATE_KEY, strlen(NEXT_UPDATE_KEY));
+    if (!key) {
+        return 0;
+    }
+    const char* value = key + strlen(NEXT_UPDATE_KEY);
+    if ((size_t)(json + size - value) < 20) {
+        return 0;
+    }
+    char stamp[21];
+    memcpy(stamp, value, 20);
+    stamp[20] = '\0';
+    
+    struct tm tm;
+    memset(&tm, 0, sizeof(tm));
+    if (sscanf(stamp, "%4d-%2d-%2dT%2d:%2d:%2dZ", &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
+               &tm.tm_hour, &tm.tm_min, &tm.tm_sec) != 6) {
+        return 0;
+    }
+    tm.tm_year -= 1900;
+    tm.tm_mon -= 1;
+    return (int64_t)timegm(&tm);
+}
+
+int64_t collateral_next_update(const sgx_ql_qve_collateral_t* collateral) {
+    int64_t tcb_info = json_next_update(collateral->tcb_info, collateral->tcb_info_size);
+    int64_t qe_identity = json_next_update(collateral->qe_identity, collateral->qe_identity_size);
+    if (tcb_info == 0 || qe_identity == 0) {
+        return tcb_info ? tcb_info : qe_identity;
+    }
+    return tcb_info < qe_identity ? tcb_info : qe_identity;
+}
+
+uint32_t collateral_tcb_evaluation(const sgx_ql_qve_collateral_t* collateral) {
+    const char* json = collateral->tcb_info;
+    uint32_t size = collateral->tcb_info_size;
+    if (!json) {
+        return 0;
+    }
+    const char* key = (const char*)memmem(json, size, TCB_EVALUATION_KEY,
+                                          strlen(TCB_EVALUATION_KEY));
+    if (!key) {
+        return 0;
+    }
+    uint32_t number = 0;
+    for (const char* p = key + strlen(TCB_EVALUATION_KEY); p < json + size; p++) {
+        if (*p < '0' || *p > '9' || number > UINT32_MAX / 10) {
+            break;
+        }
+        number = number * 10 + (uint32_t)(*p - '0');
+    }
+    return number;
+}
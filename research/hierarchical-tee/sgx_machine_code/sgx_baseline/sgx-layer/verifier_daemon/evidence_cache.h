@@ -0,0 +1,125 @@
+#ifndef EVIDENCE_CACHE_H
+#define EVIDENCE_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+#include <vector>
+#include <sgx_ql_lib_common.h>
+#include "composite_evidence.h"
+#include "sgx_binding.h"
+#include "verifier_protocol.h"
+
+#define EVIDENCE_DIGEST_SIZE 32
+#define VERDICT_CACHE_SHARDS 1024
+#define VERDICT_CACHE_WAYS 8
+#define COLLATERAL_CACHE_SHARDS 4
+#define COLLATERAL_CACHE_WAYS 2
+#define COLLATERAL_SLOT_BYTES (64 * 1024)  /* PCCS collateral is ~15-20 KB */
+#define FMSPC_SIZE 6
+
+/* What the collateral of a quote depends on: TCB info is per FMSPC, the
+ * PCK CRL per issuing CA, and QE identity is the same for every quote. */
+typedef struct {
+    uint8_t fmspc[FMSPC_SIZE];
+    uint8_t ca;
+} collateral_key_t;
+
+typedef struct {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t insertions;
+} cache_stats_t;
+
+struct evp_md_ctx_st;
+
+/*
+ * SHA-256 over the quote, token and binding hash of one frame, and the
+ * generation of the policy it is checked against; the key of the verdict
+ * cache, so a policy reload never serves verdicts from the old policy.
+ * Holds its OpenSSL context for reuse, one per thread.
+ */
+class EvidenceHasher {
+public:
+    EvidenceHasher();
+    ~EvidenceHasher();
+
+    bool digest(const composite_evidence_t& evidence, uint32_t policy_generation,
+                uint8_t out[EVIDENCE_DIGEST_SIZE]);
+    /* The enclave-computed binding of sgx_binding.h, recomputed. */
+    bool binding(const uint8_t mrenclave[SGX_BINDING_MRENCLAVE_SIZE],
+                 const uint8_t nonce[SGX_BINDING_NONCE_SIZE], uint8_t out[SGX_BINDING_SIZE]);
+
+private:
+    EvidenceHasher(const EvidenceHasher&);
+    EvidenceHasher& operator=(const EvidenceHasher&);
+
+    struct evp_md_ctx_st* ctx_;
+};
+
+/*
+ * Both caches below are fixed-size and sharded. Each shard is guarded by a
+ * seqlock: lookups take no lock, they copy the entry and retry if a writer
+ * was active meanwhile, so re-attestation storms of identical evidence only
+ * read shared cache lines. Inserts serialise on a per-shard mutex and
+ * replace an empty or expired way first, else the one expiring soonest.
+ * Hit/miss counters are per shard, on their own cache line.
+ */
+
+/* Final verdicts, keyed by evidence digest, valid until the token's exp. */
+class VerdictCache {
+public:
+    VerdictCache();
+    ~VerdictCache();
+
+    bool lookup(const uint8_t digest[EVIDENCE_DIGEST_SIZE], time_t now,
+                verdict_record_t* out) const;
+    void insert(const uint8_t digest[EVIDENCE_DIGEST_SIZE], int64_t expires,
+                const verdict_record_t& record);
+    cache_stats_t stats() const;
+
+private:
+    VerdictCache(const VerdictCache&);
+    VerdictCache& operator=(const VerdictCache&);
+
+    struct shard_t;
+    shard_t* shards_;
+};
+
+/*
+ * DCAP collateral (tee_qv_get_collateral() output), keyed by FMSPC/CA and
+ * valid until the earliest nextUpdate of its TCB info and QE identity.
+ * Entries are flattened into slot storage that is never freed while the
+ * cache lives; lookup() copies one into `buffer` and points `out` into it.
+ */
+class CollateralCache {
+public:
+    CollateralCache();
+    ~CollateralCache();
+
+    bool lookup(const collateral_key_t& key, time_t now, std::vector<uint8_t>* buffer,
+                sgx_ql_qve_collateral_t* out) const;
+    /* False if the collateral does not fit a slot. */
+    bool insert(const collateral_key_t& key, int64_t expires,
+                const sgx_ql_qve_collateral_t* collateral);
+    void invalidate(const collateral_key_t& key);
+    cache_stats_t stats() const;
+
+private:
+    CollateralCache(const CollateralCache&);
+    CollateralCache& operator=(const CollateralCache&);
+
+    struct shard_t;
+    shard_t* shards_;
+};
+
+/* Earliest "nextUpdate" of the TCB info and QE identity JSON, 0 if neither
+ * has one. */
+int64_t collateral_next_update(const sgx_ql_qve_collateral_t* collateral);
+
+/* tcbEvaluationDataNumber of the TCB info, 0 if absent. Intel raises it
+ * with every TCB recovery, so a larger value means platforms were
+ * re-evaluated. */
+uint32_t collateral_tcb_evaluation(const sgx_ql_qve_collateral_t* collateral);
+
+#endif /* EVIDENCE_CACHE_H */
@@ -0,0 +1,215 @@
+#include "evidence_verifier.h"
+
+#include <string.h>
+#include <sgx_quote_3.h>
+
+#define TDX_TOKEN_ISSUER "trustauthority.intel.com"
+
+static int hex_value(uint8_t c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/* Does the hex string start with the hex encoding of `bytes`? */
+static bool hex_has_prefix(byte_span_t hex, const uint8_t* bytes, size_t len) {
+    if (hex.size < 2 * len) {
+        return false;
+    }
+    for (size_t i = 0; i < len; i++) {
+        int hi = hex_value(hex.data[2 * i]);
+        int lo = hex_value(hex.data[2 * i + 1]);
+        if (hi < 0 || lo < 0 || (uint8_t)(hi << 4 | lo) != bytes[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool span_contains(byte_span_t span, const char* needle) {
+    size_t len = strlen(needle);
+    return len <= span.size && memmem(span.data, span.size, needle, len) != NULL;
+}
+
+EvidenceVerifier::EvidenceVerifier() : cache_enabled_(true) {
+    policies_.publish(options_);
+}
+
+quote3_error_t EvidenceVerifier::init() {
+    return quotes_.init();
+}
+
+void EvidenceVerifier::set_cache(bool enabled) {
+    cache_enabled_ = enabled;
+    quotes_.set_collateral_cache(enabled);
+}
+
+bool EvidenceVerifier::add_trusted_mrtd(const char* mrtd_hex) {
+    return policy_add_measurement(&options_.tdx_mrtd, mrtd_hex, POLICY_TDX_MEASUREMENT_SIZE);
+}
+
+bool EvidenceVerifier::load_policy(const char* path, std::string* error) {
+    policy_path_ = path;
+    return reload_policy(error);
+}
+
+bool EvidenceVerifier::reload_policy(std::string* error) {
+    if (policy_path_.empty()) {
+        policies_.publish(options_);
+        return true;
+    }
+    composite_policy_t policy;
+    if (!parse_policy_file(policy_path_.c_str(), &policy, error)) {
+        return false;
+    }
+    policies_.publish(policy);
+    return true;
+}
+
+bool EvidenceVerifier::check_claims(const composite_evidence_t& evidence,
+                                    const CompiledPolicy& policy, time_t now,
+                                    verify_scratch_t* scratch, verdict_record_t* out,
+                                    int64_t* expires) const {
+    verdict_record_t& record = *out;
+    memset(&record, 0, sizeof(record));
+    record.verdict = VERDICT_UNTRUSTED;
+    record.checks = VERIFY_CHECK_FRAME;
+    
+    // Quote layout: header, report body, signature length, signature
+    if (evidence.sgx_quote.size < sizeof(sgx_quote3_t)) {
+        record.error = VERIFY_ERROR_SGX_QUOTE_FORMAT;
+        return false;
+    }
+    const sgx_quote3_t* quote = (const sgx_quote3_t*)evidence.sgx_quote.data;
+    if (quote->header.version != 3 ||
+        quote->signature_data_len > evidence.sgx_quote.size - sizeof(sgx_quote3_t)) {
+        record.error = VERIFY_ERROR_SGX_QUOTE_FORMAT;
+        return false;
+    }
+    
+    tdx_token_claims_t claims;
+    if (parse_tdx_token(evidence.tdx_token, &scratch->token, &claims) != TDX_TOKEN_OK) {
+        record.error = VERIFY_ERROR_TOKEN_FORMAT;
+        return false;
+    }
+    if (!span_contains(claims.issuer, TDX_TOKEN_ISSUER)) {
+        record.error = VERIFY_ERROR_TOKEN_ISSUER;
+        return false;
+    }
+    if (claims.exp < (int64_t)now) {
+        record.error = VERIFY_ERROR_TOKEN_EXPIRED;
+        return false;
+    }
+    // After the cheap claim checks: this is the one RSA operation per token
+    if (jwks_.size() > 0 && !scratch->token_signature.verify(jwks_, claims)) {
+        record.error = VERIFY_ERROR_TOKEN_SIGNATURE;
+        return false;
+    }
+    if (!claims.has_tdx) {
+        record.error = VERIFY_ERROR_TOKEN_NO_TDX;
+        return false;
+    }
+    record.checks |= VERIFY_CHECK_TDX_TOKEN;
+    
+    // One token for a batch of enclaves carries the root over their bindings
+    const uint8_t* tdx_binding = evidence.binding_hash.data;
+    uint8_t root[BINDING_MERKLE_HASH_SIZE];
+    if (evidence.binding_proof.data) {
+        if (!scratch->merkle.root_from_proof(evidence.binding_hash.data, evidence.binding_proof,
+                                             root)) {
+            record.error = VERIFY_ERROR_BINDING;
+            return false;
+        }
+        tdx_binding = root;
+    }
+    if (memcmp(quote->report_body.report_data.d, evidence.binding_hash.data,
+               COMPOSITE_BINDING_HASH_SIZE) != 0 ||
+        !hex_has_prefix(claims.report_data, tdx_binding, COMPOSITE_BINDING_HASH_SIZE)) {
+        record.error = VERIFY_ERROR_BINDING;
+        return false;
+    }
+    if (policy.require_enclave_binding()) {
+        // Recompute from the quote's own MRENCLAVE and the nonce after the binding
+        const sgx_report_body_t& body = quote->report_body;
+        uint8_t expected[SGX_BINDING_SIZE];
+        if (!scratch->hasher.binding(body.mr_enclave.m,
+                                     body.report_data.d + SGX_BINDING_NONCE_OFFSET, expected) ||
+            memcmp(expected, evidence.binding_hash.data, SGX_BINDING_SIZE) != 0) {
+            record.error = VERIFY_ERROR_BINDING;
+            return false;
+        }
+    }
+    record.checks |= VERIFY_CHECK_BINDING;
+    
+    record.error = policy.check_tdx(claims);
+    if (record.error == VERIFY_ERROR_NONE) {
+        const sgx_report_body_t& body = quote->report_body;
+        record.error = policy.check_sgx(body.mr_enclave.m, body.mr_signer.m, body.isv_svn);
+    }
+    if (record.error != VERIFY_ERROR_NONE) {
+        return false;
+    }
+    record.checks |= VERIFY_CHECK_POLICY;
+    *expires = claims.exp;
+    return true;
+}
+
+verdict_record_t EvidenceVerifier::verify(const composite_evidence_t& evidence, time_t now,
+                                          verify_scratch_t* scratch) const {
+    verdict_record_t record;
+    verify_batch(&evidence, 1, now, scratch, &record);
+    return record;
+}
+
+void EvidenceVerifier::verify_batch(const composite_evidence_t* evidence, size_t count, time_t now,
+                                    verify_scratch_t* scratch, verdict_record_t* out) const {
+    // One policy for the whole batch, even if a reload lands meanwhile
+    const CompiledPolicy& policy = *policies_.current();
+    scratch->digests.resize(count * EVIDENCE_DIGEST_SIZE);
+    scratch->hashed.assign(count, 0);
+    scratch->quotes.clear();
+    scratch->quote_owner.clear();
+    scratch->quote_expires.clear();
+    for (size_t i = 0; i < count; i++) {
+        uint8_t* digest = &scratch->digests[i * EVIDENCE_DIGEST_SIZE];
+        if (cache_enabled_ && scratch->hasher.digest(evidence[i], policy.generation(), digest)) {
+            scratch->hashed[i] = 1;
+            if (verdicts_.lookup(digest, now, &out[i])) {
+                continue;
+            }
+        }
+        int64_t expires = 0;
+        if (check_claims(evidence[i], policy, now, scratch, &out[i], &expires)) {
+            scratch->quotes.push_back(evidence[i].sgx_quote);
+            scratch->quote_owner.push_back(i);
+            scratch->quote_expires.push_back(expires);
+        }
+    }
+    if (scratch->quotes.empty()) {
+        return;
+    }
+    
+    scratch->quote_verdicts.resize(scratch->quotes.size());
+    quotes_.verify_batch(scratch->quotes.data(), scratch->quotes.size(), now,
+                         &scratch->quote, scratch->quote_verdicts.data());
+    for (size_t k = 0; k < scratch->quotes.size(); k++) {
+        size_t owner = scratch->quote_owner[k];
+        verdict_record_t& record = out[owner];
+        const quote_verdict_t& verdict = scratch->quote_verdicts[k];
+        if (verdict.status == SGX_QL_SUCCESS && verdict.collateral_expiration == 0 &&
+            policy.sgx_tcb_accepted(verdict.result)) {
+            record.checks |= VERIFY_CHECK_SGX_QUOTE;
+            record.verdict = VERDICT_TRUSTED;
+            record.error = VERIFY_ERROR_NONE;
+        } else {
+            record.error = verdict.status != SGX_QL_SUCCESS ? VERIFY_ERROR_SGX_QUOTE_VERIFY
+                                                            : VERIFY_ERROR_SGX_QUOTE_RESULT;
+        }
+        if (scratch->hashed[owner] && verdict.status == SGX_QL_SUCCESS &&
+            verdict.collateral_expiration == 0) {
+            verdicts_.insert(&scratch->digests[owner * EVIDENCE_DIGEST_SIZE],
+                             scratch->quote_expires[k], record);
+        }
+    }
+}
@@ -0,0 +1,115 @@
+#ifndef EVIDENCE_VERIFIER_H
+#define EVIDENCE_VERIFIER_H
+
+#include <stdint.h>
+#include <time.h>
+#include <string>
+#include <vector>
+#include <sgx_ql_lib_common.h>
+#include "binding_merkle.h"
+#include "composite_evidence.h"
+#include "evidence_cache.h"
+#include "jwks_cache.h"
+#include "policy_engine.h"
+#include "quote_verifier.h"
+#include "tdx_token.h"
+#include "verifier_protocol.h"
+
+/* Per-thread buffers reused across requests, so verification does not
+ * allocate once they have grown to the largest token/batch size. */
+typedef struct {
+    tdx_token_scratch_t token;
+    TokenSignatureVerifier token_signature;
+    EvidenceHasher hasher;
+    MerkleHasher merkle;
+    std::vector<uint8_t> digests;             /* EVIDENCE_DIGEST_SIZE per frame */
+    std::vector<uint8_t> hashed;
+    std::vector<byte_span_t> quotes;          /* quotes that passed the cheap checks */
+    std::vector<size_t> quote_owner;          /* their index in the batch */
+    std::vector<int64_t> quote_expires;       /* their token's exp */
+    std::vector<quote_verdict_t> quote_verdicts;
+    quote_scratch_t quote;
+} verify_scratch_t;
+
+/*
+ * Verifies one composite SGX+TDX evidence frame:
+ *
+ *   1. TDX token: issuer, expiry and TDX claims, as TDXTokenVerifier does;
+ *      with load_jwks(), also the RSxxx/PSxxx signature (jwks_cache.h)
+ *   2. binding: the SGX quote's report_data and the TDX token's
+ *      tdx_report_data both start with the frame's binding hash, or for a
+ *      frame with a binding proof, the token's starts with the Merkle root
+ *      the proof leads to (binding_merkle.h); with
+ *      set_require_enclave_binding() the hash must also be the enclave's
+ *      SHA256(MRENCLAVE || purpose || nonce) of sgx_binding.h
+ *   3. policy (policy_engine.h): MRTD/RTMRs, debug TD, TDX TCB status,
+ *      MRENCLAVE/MRSIGNER/ISVSVN
+ *   4. SGX quote: sgx_qv_verify_quote() with the policy's SGX TCB statuses
+ *
+ * Cheap checks run first so bad evidence is rejected before the DCAP call.
+ * verify_batch() runs them over a whole batch, then hands the surviving
+ * quotes to QuoteVerifier::verify_batch() so collateral is fetched once
+ * per FMSPC rather than once per quote.
+ *
+ * Verdicts that went through DCAP verification are cached by a digest of
+ * the whole frame until the token's exp, so identical evidence resubmitted
+ * after a prover restart costs one hash and a lock-free lookup. Transient
+ * failures (QVL errors, expired collateral) are not cached.
+ *
+ * The policy comes from a policy file (load_policy()) or from
+ * add_trusted_mrtd()/set_allow_debug()/set_require_enclave_binding(),
+ * applied by reload_policy(). A batch is checked against the policy in
+ * force when it starts; reload_policy() may run while workers verify, and
+ * they pick the new policy up on their next batch. verify() is const and
+ * safe to call from every worker thread.
+ */
+class EvidenceVerifier {
+public:
+    EvidenceVerifier();
+
+    /* Size the QVL supplemental data; fails if the DCAP QVL is missing. */
+    quote3_error_t init();
+
+    /* Rules for reload_policy() when no policy file is set. */
+    bool add_trusted_mrtd(const char* mrtd_hex);
+    void set_allow_debug(bool allow) { options_.allow_debug = allow; }
+    void set_require_enclave_binding(bool require) { options_.require_enclave_binding = require; }
+    /* Parse and apply a policy file; reload_policy() re-reads it. */
+    bool load_policy(const char* path, std::string* error);
+    /* Recompile and publish the policy; on error the current one stays. */
+    bool reload_policy(std::string* error);
+    const CompiledPolicy& policy() const { return *policies_.current(); }
+    /* ITA signing keys; without any, token signatures are not checked. */
+    bool load_jwks(const char* path) { return jwks_.load(path); }
+    size_t jwks_key_count() const { return jwks_.size(); }
+    /* Verdict and collateral caches, on by default. */
+    void set_cache(bool enabled);
+
+    verdict_record_t verify(const composite_evidence_t& evidence, time_t now,
+                            verify_scratch_t* scratch) const;
+    void verify_batch(const composite_evidence_t* evidence, size_t count, time_t now,
+                      verify_scratch_t* scratch, verdict_record_t* out) const;
+
+    const QuoteVerifier& quote_verifier() const { return quotes_; }
+    cache_stats_t verdict_cache_stats() const { return verdicts_.stats(); }
+
+private:
+    EvidenceVerifier(const EvidenceVerifier&);
+    EvidenceVerifier& operator=(const EvidenceVerifier&);
+
+    /* Steps 1-3; true if only the DCAP quote verification is left, with
+     * the token's exp in `expires`. */
+    bool check_claims(const composite_evidence_t& evidence, const CompiledPolicy& policy,
+                      time_t now, verify_scratch_t* scratch, verdict_record_t* record,
+                      int64_t* expires) const;
+
+    QuoteVerifier quotes_;
+    JwksCache jwks_;
+    mutable VerdictCache verdicts_;
+    PolicyStore policies_;
+    composite_policy_t options_;
+    std::string policy_path_;
+    bool cache_enabled_;
+};
+
+#endif /* EVIDENCE_VERIFIER_H */
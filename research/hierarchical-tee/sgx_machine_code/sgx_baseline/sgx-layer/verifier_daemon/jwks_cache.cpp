@@ -0,0 +1,186 @@
+#include "jwks_cache.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <openssl/bn.h>
+#include <openssl/evp.h>
+#include <openssl/rsa.h>
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+#include <openssl/core_names.h>
+#include <openssl/param_build.h>
+#endif
+
+#define JWKS_MAX_SIZE (1 << 20)
+
+/* Public key from the big-endian modulus and exponent; NULL on failure. */
+static EVP_PKEY* rsa_public_key(const std::vector<uint8_t>& n, size_t n_len,
+                                const std::vector<uint8_t>& e, size_t e_len) {
+    BIGNUM* bn_n = BN_bin2bn(n.data(), (int)n_len, NULL);
+    BIGNUM* bn_e = BN_bin2bn(e.data(), (int)e_len, NULL);
+    EVP_PKEY* pkey = NULL;
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    OSSL_PARAM_BLD* build = OSSL_PARAM_BLD_new();
+    OSSL_PARAM* params = NULL;
+    EVP_PKEY_CTX* ctx = EVP_PKEY_CTX_new_from_name(NULL, "RSA", NULL);
+    if (bn_n && bn_e && build && ctx &&
+        OSSL_PARAM_BLD_push_BN(build, OSSL_PKEY_PARAM_RSA_N, bn_n) == 1 &&
+        OSSL_PARAM_BLD_push_BN(build, OSSL_PKEY_PARAM_RSA_E, bn_e) == 1 &&
+        (params = OSSL_PARAM_BLD_to_param(build)) != NULL &&
+        EVP_PKEY_fromdata_init(ctx) == 1) {
+        EVP_PKEY_fromdata(ctx, &pkey, EVP_PKEY_PUBLIC_KEY, params);
+    }
+    EVP_PKEY_CTX_free(ctx);
+    OSSL_PARAM_free(params);
+    OSSL_PARAM_BLD_free(build);
+    BN_free(bn_n);
+    BN_free(bn_e);
+#else
+    RSA* rsa = RSA_new();
+    if (bn_n && bn_e && rsa && RSA_set0_key(rsa, bn_n, bn_e, NULL) == 1) {
+        bn_n = bn_e = NULL;  // owned by rsa now
+        pkey = EVP_PKEY_new();
+        if (pkey && EVP_PKEY_assign_RSA(pkey, rsa) == 1) {
+            rsa = NULL;
+        } else {
+            EVP_PKEY_free(pkey);
+            pkey = NULL;
+        }
+    }
+    RSA_free(rsa);
+    BN_free(bn_n);
+    BN_free(bn_e);
+#endif
+    return pkey;
+}
+
+/* End of the object starting at `p` ('{'), skipping strings; NULL if unterminated. */
+static const uint8_t* object_end(const uint8_t* p, const uint8_t* end) {
+    int depth = 0;
+    for (; p < end; p++) {
+        if (*p == '"') {
+            for (p++; p < end && *p != '"'; p++) {
+                if (*p == '\\') {
+                    p++;
+                }
+            }
+        } else if (*p == '{') {
+            depth++;
+        } else if (*p == '}' && --depth == 0) {
+            return p + 1;
+        }
+    }
+    return NULL;
+}
+
+JwksCache::~JwksCache() {
+    for (size_t i = 0; i < keys_.size(); i++) {
+        EVP_PKEY_free(keys_[i].key);
+    }
+}
+
+bool JwksCache::load(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        return false;
+    }
+    std::vector<uint8_t> json(JWKS_MAX_SIZE);
+    size_t len = fread(json.data(), 1, json.size(), f);
+    fclose(f);
+    
+    // {"keys": [{"kty": "RSA", "kid": ..., "n": ..., "e": ...}, ...]}
+    const uint8_t* end = json.data() + len;
+    const uint8_t* keys = (const uint8_t*)memmem(json.data(), len, "\"keys\"", 6);
+    const uint8_t* p = keys ? (const uint8_t*)memchr(keys, '[', (size_t)(end - keys)) : NULL;
+    size_t loaded = 0;
+    std::vector<uint8_t> n;
+    std::vector<uint8_t> e;
+    while (p && (p = (const uint8_t*)memchr(p, '{', (size_t)(end - p))) != NULL) {
+        const uint8_t* close = object_end(p, end);
+        if (!close) {
+            break;
+        }
+        size_t object_len = (size_t)(close - p);
+        byte_span_t kty, kid, n_b64, e_b64;
+        size_t n_len = 0;
+        size_t e_len = 0;
+        if (json_find_string(p, object_len, "kty", &kty) && span_equals(kty, "RSA") &&
+            json_find_string(p, object_len, "kid", &kid) &&
+            json_find_string(p, object_len, "n", &n_b64) &&
+            json_find_string(p, object_len, "e", &e_b64) &&
+            base64url_decode(n_b64.data, n_b64.size, &n, &n_len) &&
+            base64url_decode(e_b64.data, e_b64.size, &e, &e_len)) {
+            EVP_PKEY* key = rsa_public_key(n, n_len, e, e_len);
+            if (key) {
+                jwks_key_t entry;
+                entry.kid.assign((const char*)kid.data, kid.size);
+                entry.key = key;
+                keys_.push_back(entry);
+                loaded++;
+            }
+        }
+        p = close;
+    }
+    return loaded > 0;
+}
+
+EVP_PKEY* JwksCache::find(byte_span_t kid) const {
+    for (size_t i = 0; i < keys_.size(); i++) {
+        if (keys_[i].kid.size() == kid.size && memcmp(keys_[i].kid.data(), kid.data, kid.size) == 0) {
+            return keys_[i].key;
+        }
+    }
+    return NULL;
+}
+
+TokenSignatureVerifier::TokenSignatureVerifier() : ctx_(EVP_MD_CTX_new()) {
+}
+
+TokenSignatureVerifier::~TokenSignatureVerifier() {
+    EVP_MD_CTX_free(ctx_);
+}
+
+/* Digest and padding for a JWS alg (RFC 7518 3.3, 3.5), NULL if unsupported.
+ * Trust Authority signs with PS384 by default. */
+static const EVP_MD* token_digest(byte_span_t alg, bool* pss) {
+    static const struct {
+        const char* alg;
+        bool pss;
+        const EVP_MD* (*md)();
+    } algs[] = {
+        {"PS256", true, EVP_sha256},  {"PS384", true, EVP_sha384},  {"PS512", true, EVP_sha512},
+        {"RS256", false, EVP_sha256}, {"RS384", false, EVP_sha384}, {"RS512", false, EVP_sha512},
+    };
+    for (size_t i = 0; i < sizeof(algs) / sizeof(algs[0]); i++) {
+        if (span_equals(alg, algs[i].alg)) {
+            *pss = algs[i].pss;
+            return algs[i].md();
+        }
+    }
+    return NULL;
+}
+
+bool TokenSignatureVerifier::verify(const JwksCache& keys, const tdx_token_claims_t& claims) {
+    bool pss = false;
+    const EVP_MD* md = token_digest(claims.alg, &pss);
+    if (!ctx_ || !md) {
+        return false;
+    }
+    EVP_PKEY* key = keys.find(claims.kid);
+    if (!key) {
+        return false;
+    }
+    
+    EVP_MD_CTX_reset(ctx_);
+    EVP_PKEY_CTX* pctx = NULL;
+    if (EVP_DigestVerifyInit(ctx_, &pctx, md, NULL, key) != 1) {
+        return false;
+    }
+    // PSxxx: MGF1 with the same digest, salt as long as the digest
+    if (pss && (EVP_PKEY_CTX_set_rsa_padding(pctx, RSA_PKCS1_PSS_PADDING) != 1 ||
+                EVP_PKEY_CTX_set_rsa_pss_saltlen(pctx, RSA_PSS_SALTLEN_DIGEST) != 1 ||
+                EVP_PKEY_CTX_set_rsa_mgf1_md(pctx, md) != 1)) {
+        return false;
+    }
+    return EVP_DigestVerify(ctx_, claims.signature.data, claims.signature.size,
+                            claims.signing_input.data, claims.signing_input.size) == 1;
+}
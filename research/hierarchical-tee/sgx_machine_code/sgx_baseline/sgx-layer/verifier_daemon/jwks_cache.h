@@ -0,0 +1,63 @@
+#ifndef JWKS_CACHE_H
+#define JWKS_CACHE_H
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include "composite_evidence.h"
+#include "tdx_token.h"
+
+/*
+ * Intel Trust Authority token signing keys.
+ *
+ * ITA publishes them as a JWKS document (https://portal.trustauthority.intel.com/certs).
+ * The daemon loads a saved copy once at startup (--jwks FILE) and keeps
+ * every RSA key as a ready EVP_PKEY, so checking a token is a kid lookup
+ * and one RSA public-key operation: no key parsing and no network on the
+ * request path. ITA rotates keys rarely; refetch the file and restart the
+ * daemon when it does. A token whose kid is not in the file fails.
+ *
+ * Loaded before the verifier is shared and read-only afterwards, so
+ * find() is safe from every worker thread.
+ */
+typedef struct {
+    std::string kid;
+    struct evp_pkey_st* key;
+} jwks_key_t;
+
+class JwksCache {
+public:
+    JwksCache() {}
+    ~JwksCache();
+    
+    /* Adds the RSA keys of a JWKS file; false if it holds none. */
+    bool load(const char* path);
+    size_t size() const { return keys_.size(); }
+    /* NULL if no key has this kid. */
+    struct evp_pkey_st* find(byte_span_t kid) const;
+    
+private:
+    JwksCache(const JwksCache&);
+    JwksCache& operator=(const JwksCache&);
+    
+    std::vector<jwks_key_t> keys_;
+};
+
+/* Per-thread: owns a digest context, like MerkleHasher. */
+class TokenSignatureVerifier {
+public:
+    TokenSignatureVerifier();
+    ~TokenSignatureVerifier();
+    
+    /* RS256/384/512 or PS256/384/512 signature over claims.signing_input,
+     * under the key named by claims.kid. Any other alg fails. */
+    bool verify(const JwksCache& keys, const tdx_token_claims_t& claims);
+    
+private:
+    TokenSignatureVerifier(const TokenSignatureVerifier&);
+    TokenSignatureVerifier& operator=(const TokenSignatureVerifier&);
+    
+    struct evp_md_ctx_st* ctx_;
+};
+
+#endif /* JWKS_CACHE_H */
@@ -0,0 +1,766 @@
+/*
+ * load_generator.cpp - open- and closed-loop load against verifier_daemon.
+ *
+ * Replays recorded composite evidence: an SGX quote (quote.bin) combined
+ * with one or more TDX tokens, each either a raw JWT or a decoded_token.json
+ * saved by a tdx_baseline_* run. Each token becomes one frame
+ * (composite_evidence.h), and requests cycle through the frames. The
+ * binding section is copied from the quote's report_data. Replayed tokens
+ * are usually expired or carry another binding, so a rejected verdict
+ * still counts as a completed request; only missing verdicts count as
+ * failures. Run the daemon with --no-cache to load the full verification
+ * path rather than the evidence cache.
+ *
+ *   closed loop  N clients, each with its own connection, sending one frame
+ *                and waiting for its verdict before sending the next. Swept
+ *                over --closed.
+ *   open loop    frames are sent on a fixed schedule (--open, requests/s)
+ *                spread over --connections pipelined connections, whether
+ *                or not earlier verdicts have arrived. Latency is measured
+ *                from the scheduled send time, so a verifier that falls
+ *                behind shows up as queueing delay instead of a lower
+ *                offered rate.
+ *
+ * Every step of the sweep is written as one operation in the BenchReport
+ * layout (the one analyze_and_plot.py reads), with offered load and achieved
+ * throughput next to the latency statistics, so the steps together form the
+ * throughput-vs-latency curve. A final "Saturation Point" operation holds
+ * the last step before the knee: open loop, the first rate whose throughput
+ * falls below 95% of the offered rate or whose p99 exceeds 10x the lightest
+ * step's; closed loop, the first client count that adds less than 5%
+ * throughput.
+ *
+ * Needs no SGX libraries and runs on any host.
+ */
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench_clock.h"
+#include "bench_report.h"
+#include "composite_evidence.h"
+#include "latency_histogram.h"
+#include "quote_parser.h"
+#include "verifier_protocol.h"
+
+#define DEFAULT_HOST "127.0.0.1"
+#define DEFAULT_PORT "9999"
+#define DEFAULT_QUOTE "../../../gramine_attestation/quote.bin"
+#define DEFAULT_DURATION_S 5
+#define DEFAULT_CONNECTIONS 8
+#define DRAIN_TIMEOUT_MS 5000.0
+#define MAX_CONCURRENCY 1024
+#define MAX_STEPS 64
+
+#define SATURATION_THROUGHPUT 0.95   /* open loop: achieved / offered */
+#define SATURATION_P99_FACTOR 10.0   /* open loop: p99 over the lightest step's */
+#define SATURATION_GAIN 1.05         /* closed loop: throughput per added clients */
+
+typedef struct {
+    const char* host;
+    const char* port;
+    double duration_ms;
+    int connections;
+} load_target_t;
+
+/* One point of the sweep. `level` is the offered rate or the client count. */
+typedef struct {
+    int level;
+    uint64_t attempts;
+    uint64_t answered;
+    uint64_t trusted;
+    uint32_t rejection;     /* error of the last rejected verdict */
+    double elapsed_ms;
+    std::vector<double> samples_ms;
+    LatencyHistogram hist;
+} load_step_t;
+
+/* Per-connection (open loop) or per-client (closed loop) results. */
+typedef struct {
+    uint64_t attempts;
+    uint64_t answered;
+    uint64_t trusted;
+    uint32_t rejection;
+    double last_verdict_ms;
+    std::vector<double> samples_ms;
+    LatencyHistogram hist;
+} load_worker_t;
+
+static void print_usage(const char* prog) {
+    printf("Usage: %s --token FILE... [--quote FILE] [--host H] [--port P]\n"
+           "       [--closed N,N,...] [--open RATE,RATE,...] [--connections N]\n"
+           "       [--duration S] [--json FILE]\n"
+           "  --token: raw JWT or decoded_token.json, repeatable\n"
+           "  --closed: closed-loop client counts (default 1,2,4,8,16,32,64)\n"
+           "  --open: open-loop arrival rates in requests/s over --connections\n", prog);
+}
+
+static bool read_file(const char* path, std::string* out) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        return false;
+    }
+    out->clear();
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+        out->append(buf, n);
+    }
+    bool ok = !ferror(f);
+    fclose(f);
+    return ok;
+}
+
+static void base64url_append(std::string* out, const std::string& in) {
+    static const char alphabet[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+    size_t i = 0;
+    for (; i + 3 <= in.size(); i += 3) {
+        uint32_t v = (uint8_t)in[i] << 16 | (uint8_t)in[i + 1] << 8 | (uint8_t)in[i + 2];
+        out->push_back(alphabet[v >> 18]);
+        out->push_back(alphabet[(v >> 12) & 63]);
+        out->push_back(alphabet[(v >> 6) & 63]);
+        out->push_back(alphabet[v & 63]);
+    }
+    if (i < in.size()) {
+        uint32_t v = (uint8_t)in[i] << 16;
+        if (i + 1 < in.size()) {
+            v |= (uint8_t)in[i + 1] << 8;
+        }
+        out->push_back(alphabet[v >> 18]);
+        out->push_back(alphabet[(v >> 12) & 63]);
+        if (i + 1 < in.size()) {
+            out->push_back(alphabet[(v >> 6) & 63]);
+        }
+    }
+}
+
+/* Position just past the JSON value starting at `pos`, npos if it is cut off. */
+static size_t json_value_end(const std::string& json, size_t pos) {
+    if (pos >= json.size()) {
+        return std::string::npos;
+    }
+    if (json[pos] != '"' && json[pos] != '{' && json[pos] != '[') {
+        return json.find_first_of(",}] \t\r\n", pos);   // number, true, false, null
+    }
+    int depth = 0;
+    bool in_string = false;
+    for (size_t i = pos; i < json.size(); i++) {
+        char c = json[i];
+        if (in_string) {
+            if (c == '\\') {
+                i++;
+            } else if (c == '"') {
+                in_string = false;
+                if (depth == 0) {
+                    return i + 1;
+                }
+            }
+        } else if (c == '"') {
+            in_string = true;
+        } else if (c == '{' || c == '[') {
+            depth++;
+        } else if (c == '}' || c == ']') {
+            if (--depth == 0) {
+                return i + 1;
+            }
+        }
+    }
+    return std::string::npos;
+}
+
+/*
+ * Raw text of member `key` of the top-level object. Nested members are
+ * skipped: an ITA payload has "signature" keys of its own.
+ */
+static bool json_member(const std::string& json, const char* key, std::string* value) {
+    static const char* ws = " \t\r\n";
+    size_t pos = json.find_first_not_of(ws);
+    if (pos == std::string::npos || json[pos] != '{') {
+        return false;
+    }
+    pos++;
+    while ((pos = json.find_first_not_of(ws, pos)) != std::string::npos && json[pos] == '"') {
+        size_t name_end = json_value_end(json, pos);
+        size_t colon = name_end == std::string::npos ? name_end : json.find_first_not_of(ws, name_end);
+        if (colon == std::string::npos || json[colon] != ':') {
+            return false;
+        }
+        size_t start = json.find_first_not_of(ws, colon + 1);
+        size_t end = start == std::string::npos ? start : json_value_end(json, start);
+        if (end == std::string::npos) {
+            return false;
+        }
+        if (json.compare(pos + 1, name_end - pos - 2, key) == 0) {
+            *value = json.substr(start, end - start);
+            return true;
+        }
+        pos = json.find_first_not_of(ws, end);
+        if (pos == std::string::npos || json[pos] != ',') {
+            return false;
+        }
+        pos++;
+    }
+    return false;
+}
+
+/*
+ * decode_token.py saves the header and payload re-indented and the
+ * signature shortened to "<prefix>...", so the JWT rebuilt from them goes
+ * out with an empty signature; replay such tokens against a daemon without
+ * --jwks.
+ */
+static bool load_token(const char* path, std::string* token) {
+    std::string text;
+    if (!read_file(path, &text)) {
+        return false;
+    }
+    size_t start = text.find_first_not_of(" \t\r\n");
+    if (start == std::string::npos) {
+        return false;
+    }
+    if (text[start] != '{') {
+        size_t end = text.find_last_not_of(" \t\r\n");
+        *token = text.substr(start, end + 1 - start);
+        return true;
+    }
+    
+    std::string header, payload, signature;
+    if (!json_member(text, "header", &header) || !json_member(text, "payload", &payload)) {
+        return false;
+    }
+    token->clear();
+    base64url_append(token, header);
+    token->push_back('.');
+    base64url_append(token, payload);
+    token->push_back('.');
+    if (json_member(text, "signature", &signature) && signature.size() >= 2 &&
+        signature[0] == '"' && signature.find('.') == std::string::npos) {
+        token->append(signature, 1, signature.size() - 2);
+    }
+    return true;
+}
+
+/* One frame per token; the binding is whatever the quote's report_data carries. */
+static bool build_frames(const char* quote_path, const std::string& quote,
+                         const std::vector<std::string>& tokens,
+                         std::vector<std::vector<uint8_t> >* frames) {
+    const uint8_t* quote_data = (const uint8_t*)quote.data();
+    uint8_t binding[COMPOSITE_BINDING_HASH_SIZE] = {0};
+    SgxQuote3View view;
+    if (view.parse(quote_data, quote.size()) == QUOTE_OK) {
+        memcpy(binding, view.body<sgx_report_body_layout::report_data>(), sizeof(binding));
+    } else {
+        printf("⚠ %s is not an SGX v3 quote, sending a zero binding hash\n", quote_path);
+    }
+    for (size_t i = 0; i < tokens.size(); i++) {
+        std::vector<uint8_t> frame(composite_evidence_size(quote.size(), tokens[i].size()));
+        size_t frame_len = 0;
+        composite_status_t status = composite_evidence_write(
+            &frame[0], frame.size(), quote_data, quote.size(),
+            (const uint8_t*)tokens[i].data(), tokens[i].size(), binding, &frame_len);
+        if (status != COMPOSITE_OK) {
+            printf("✗ Frame %zu: %s\n", i, composite_status_str(status));
+            return false;
+        }
+        frame.resize(frame_len);
+        frames->push_back(frame);
+    }
+    return true;
+}
+
+static int connect_target(const load_target_t* target) {
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo* addrs = NULL;
+    if (getaddrinfo(target->host, target->port, &hints, &addrs) != 0) {
+        return -1;
+    }
+    int fd = -1;
+    for (struct addrinfo* a = addrs; a; a = a->ai_next) {
+        fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+        if (connect(fd, a->ai_addr, a->ai_addrlen) == 0) {
+            break;
+        }
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(addrs);
+    if (fd >= 0) {
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    return fd;
+}
+
+static bool send_all(int fd, const uint8_t* buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = send(fd, buf, len, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        buf += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+/* One verdict; false on EOF, error or `timeout_ms` without data. */
+/* A verdict's bytes read so far; kept per connection across poll timeouts. */
+typedef struct {
+    uint8_t wire[VERDICT_SIZE];
+    size_t got;
+} verdict_reader_t;
+
+/*
+ * Continue reading one verdict. *ready is false when timeout_ms passes
+ * first; the partial bytes stay in `reader` for the next call. false on
+ * EOF, a socket error or a malformed verdict.
+ */
+static bool recv_verdict(int fd, verdict_reader_t* reader, verdict_record_t* record,
+                         int timeout_ms, bool* ready) {
+    *ready = false;
+    while (reader->got < sizeof(reader->wire)) {
+        struct pollfd pfd = {fd, POLLIN, 0};
+        int polled = poll(&pfd, 1, timeout_ms);
+        if (polled < 0 && errno == EINTR) {
+            continue;
+        }
+        if (polled == 0) {
+            return true;
+        }
+        if (polled < 0) {
+            return false;
+        }
+        ssize_t n = recv(fd, reader->wire + reader->got, sizeof(reader->wire) - reader->got, 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        reader->got += (size_t)n;
+    }
+    reader->got = 0;
+    *ready = true;
+    return verdict_decode(reader->wire, record);
+}
+
+static void record_verdict(load_worker_t* worker, const verdict_record_t& verdict,
+                           double latency_ms, double now_ms) {
+    worker->answered++;
+    if (verdict.verdict == VERDICT_TRUSTED) {
+        worker->trusted++;
+    } else {
+        worker->rejection = verdict.error;
+    }
+    worker->samples_ms.push_back(latency_ms);
+    worker->hist.record_ms(latency_ms);
+    worker->last_verdict_ms = now_ms;
+}
+
+static void closed_loop_client(const load_target_t* target,
+                               const std::vector<std::vector<uint8_t> >* frames, int client,
+                               double deadline_ms, load_worker_t* worker) {
+    int fd = connect_target(target);
+    if (fd < 0) {
+        return;
+    }
+    size_t next = (size_t)client % frames->size();
+    verdict_reader_t reader;
+    reader.got = 0;
+    while (bench_now_ms() < deadline_ms) {
+        const std::vector<uint8_t>& frame = (*frames)[next];
+        next = (next + 1) % frames->size();
+        worker->attempts++;
+        double start = bench_now_ms();
+        verdict_record_t verdict;
+        bool ready = false;
+        if (!send_all(fd, &frame[0], frame.size()) ||
+            !recv_verdict(fd, &reader, &verdict, (int)DRAIN_TIMEOUT_MS, &ready) || !ready) {
+            break;
+        }
+        double now = bench_now_ms();
+        record_verdict(worker, verdict, now - start, now);
+    }
+    close(fd);
+}
+
+/*
+ * Connection `index` of `count` sends request i at start + (i * count +
+ * index) * interval, so the connections interleave into one fixed rate.
+ */
+typedef struct {
+    double start_ms;
+    double interval_ms;
+    int index;
+    int count;
+    uint64_t requests;
+    std::atomic<uint64_t> sent;
+    std::atomic<bool> done;
+} open_loop_schedule_t;
+
+static double scheduled_ms(const open_loop_schedule_t* schedule, uint64_t i) {
+    return schedule->start_ms +
+           (double)(i * schedule->count + schedule->index) * schedule->interval_ms;
+}
+
+static void open_loop_sender(int fd, const std::vector<std::vector<uint8_t> >* frames,
+                             open_loop_schedule_t* schedule) {
+    size_t next = (size_t)schedule->index % frames->size();
+    for (uint64_t i = 0; i < schedule->requests; i++) {
+        double wait = scheduled_ms(schedule, i) - bench_now_ms();
+        if (wait > 0.2) {
+            usleep((useconds_t)((wait - 0.1) * 1000));
+        }
+        while (bench_now_ms() < scheduled_ms(schedule, i)) {
+        }
+        const std::vector<uint8_t>& frame = (*frames)[next];
+        next = (next + 1) % frames->size();
+        if (!send_all(fd, &frame[0], frame.size())) {
+            break;
+        }
+        schedule->sent.store(i + 1, std::memory_order_release);
+    }
+    schedule->done.store(true, std::memory_order_release);
+}
+
+/* Verdicts come back in order, so the sequence number names the request. */
+static void open_loop_receiver(int fd, open_loop_schedule_t* schedule, load_worker_t* worker) {
+    double idle_since = 0;
+    verdict_reader_t reader;
+    reader.got = 0;
+    while (worker->answered < schedule->requests) {
+        verdict_record_t verdict;
+        bool ready = false;
+        if (!recv_verdict(fd, &reader, &verdict, 100, &ready)) {
+            break;
+        }
+        if (ready) {
+            double now = bench_now_ms();
+            record_verdict(worker, verdict, now - scheduled_ms(schedule, verdict.sequence), now);
+            idle_since = 0;
+            continue;
+        }
+        // Nothing within the poll interval: give up once the sender is done and drained
+        if (!schedule->done.load(std::memory_order_acquire)) {
+            continue;
+        }
+        if (worker->answered >= schedule->sent.load(std::memory_order_acquire)) {
+            break;
+        }
+        double now = bench_now_ms();
+        if (idle_since == 0) {
+            idle_since = now;
+        } else if (now - idle_since > DRAIN_TIMEOUT_MS) {
+            break;
+        }
+    }
+    worker->attempts = schedule->sent.load(std::memory_order_acquire);
+}
+
+static void merge_workers(std::vector<load_worker_t>* workers, double start_ms,
+                          double duration_ms, load_step_t* step) {
+    double last = start_ms + duration_ms;
+    for (size_t i = 0; i < workers->size(); i++) {
+        load_worker_t& w = (*workers)[i];
+        step->attempts += w.attempts;
+        step->answered += w.answered;
+        step->trusted += w.trusted;
+        if (w.answered > w.trusted) {
+            step->rejection = w.rejection;
+        }
+        step->samples_ms.insert(step->samples_ms.end(), w.samples_ms.begin(), w.samples_ms.end());
+        step->hist.merge(w.hist);
+        if (w.last_verdict_ms > last) {
+            last = w.last_verdict_ms;
+        }
+    }
+    step->elapsed_ms = last - start_ms;
+}
+
+static void run_closed_loop(const load_target_t* target,
+                            const std::vector<std::vector<uint8_t> >& frames, int clients,
+                            load_step_t* step) {
+    std::vector<load_worker_t> workers(clients);
+    std::vector<std::thread> threads;
+    double start = bench_now_ms();
+    for (int i = 0; i < clients; i++) {
+        workers[i].attempts = workers[i].answered = workers[i].trusted = 0;
+        workers[i].rejection = VERIFY_ERROR_NONE;
+        workers[i].last_verdict_ms = 0;
+        threads.push_back(std::thread(closed_loop_client, target, &frames, i,
+                                      start + target->duration_ms, &workers[i]));
+    }
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+    step->level = clients;
+    merge_workers(&workers, start, target->duration_ms, step);
+}
+
+static bool run_open_loop(const load_target_t* target,
+                          const std::vector<std::vector<uint8_t> >& frames, int rate,
+                          load_step_t* step) {
+    int count = target->connections;
+    std::vector<int> fds(count, -1);
+    for (int i = 0; i < count; i++) {
+        fds[i] = connect_target(target);
+        if (fds[i] < 0) {
+            for (int j = 0; j < i; j++) {
+                close(fds[j]);
+            }
+            return false;
+        }
+    }
+    
+    uint64_t total = (uint64_t)(rate * target->duration_ms / 1000.0);
+    std::vector<load_worker_t> workers(count);
+    std::vector<open_loop_schedule_t> schedules(count);
+    std::vector<std::thread> threads;
+    // A short lead time so every sender is waiting before the first slot
+    double start = bench_now_ms() + 10;
+    for (int i = 0; i < count; i++) {
+        open_loop_schedule_t& s = schedules[i];
+        s.start_ms = start;
+        s.interval_ms = 1000.0 / rate;
+        s.index = i;
+        s.count = count;
+        s.requests = total / count + ((uint64_t)i < total % count);
+        s.sent.store(0);
+        s.done.store(false);
+        workers[i].attempts = workers[i].answered = workers[i].trusted = 0;
+        workers[i].rejection = VERIFY_ERROR_NONE;
+        workers[i].last_verdict_ms = 0;
+        workers[i].samples_ms.reserve(s.requests);
+        threads.push_back(std::thread(open_loop_sender, fds[i], &frames, &s));
+        threads.push_back(std::thread(open_loop_receiver, fds[i], &s, &workers[i]));
+    }
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+    for (int i = 0; i < count; i++) {
+        close(fds[i]);
+    }
+    step->level = rate;
+    merge_workers(&workers, start, target->duration_ms, step);
+    step->attempts = total;
+    return true;
+}
+
+static double step_throughput(const load_step_t& step) {
+    return step.elapsed_ms > 0 ? step.answered * 1000.0 / step.elapsed_ms : 0;
+}
+
+/* Index of the last step before the knee (see the file comment). */
+static size_t saturation_step(const std::vector<load_step_t>& steps, bool open_loop) {
+    for (size_t i = 1; i < steps.size(); i++) {
+        double throughput = step_throughput(steps[i]);
+        bool knee;
+        if (open_loop) {
+            knee = throughput < SATURATION_THROUGHPUT * steps[i].level ||
+                   steps[i].hist.percentile_ms(99) >
+                       SATURATION_P99_FACTOR * steps[0].hist.percentile_ms(99);
+        } else {
+            knee = throughput < SATURATION_GAIN * step_throughput(steps[i - 1]);
+        }
+        if (knee) {
+            return i - 1;
+        }
+    }
+    return steps.size() - 1;
+}
+
+/* "1,2,4" -> {1, 2, 4}; false on anything else. */
+static bool parse_levels(const char* list, int max, std::vector<int>* levels) {
+    levels->clear();
+    const char* p = list;
+    while (*p) {
+        char* end = NULL;
+        long value = strtol(p, &end, 10);
+        if (end == p || value <= 0 || value > max || (*end != ',' && *end != '\0')) {
+            return false;
+        }
+        levels->push_back((int)value);
+        p = *end ? end + 1 : end;
+    }
+    return !levels->empty() && levels->size() <= MAX_STEPS;
+}
+
+int main(int argc, char* argv[]) {
+    load_target_t target;
+    target.host = DEFAULT_HOST;
+    target.port = DEFAULT_PORT;
+    target.duration_ms = DEFAULT_DURATION_S * 1000.0;
+    target.connections = DEFAULT_CONNECTIONS;
+    const char* quote_path = DEFAULT_QUOTE;
+    std::vector<const char*> token_paths;
+    std::vector<int> levels;
+    parse_levels("1,2,4,8,16,32,64", MAX_CONCURRENCY, &levels);
+    bool open_loop = false;
+    std::string json_path = bench_report_path("load_generator", "json");
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--token") == 0 && i + 1 < argc) {
+            token_paths.push_back(argv[++i]);
+        } else if (strcmp(argv[i], "--quote") == 0 && i + 1 < argc) {
+            quote_path = argv[++i];
+        } else if (strcmp(argv[i], "--host") == 0 && i + 1 < argc) {
+            target.host = argv[++i];
+        } else if (strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+            target.port = argv[++i];
+        } else if (strcmp(argv[i], "--closed") == 0 && i + 1 < argc) {
+            open_loop = false;
+            if (!parse_levels(argv[++i], MAX_CONCURRENCY, &levels)) {
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--open") == 0 && i + 1 < argc) {
+            open_loop = true;
+            if (!parse_levels(argv[++i], 10000000, &levels)) {
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--connections") == 0 && i + 1 < argc) {
+            target.connections = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--duration") == 0 && i + 1 < argc) {
+            target.duration_ms = atof(argv[++i]) * 1000.0;
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (token_paths.empty() || target.duration_ms <= 0 || target.connections <= 0 ||
+        target.connections > MAX_CONCURRENCY) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    
+    std::string quote;
+    if (!read_file(quote_path, &quote) || quote.empty()) {
+        printf("✗ Cannot read quote %s\n", quote_path);
+        return 1;
+    }
+    std::vector<std::string> tokens;
+    for (size_t i = 0; i < token_paths.size(); i++) {
+        std::string token;
+        if (!load_token(token_paths[i], &token)) {
+            printf("✗ No token in %s\n", token_paths[i]);
+            return 1;
+        }
+        tokens.push_back(token);
+    }
+    std::vector<std::vector<uint8_t> > frames;
+    if (!build_frames(quote_path, quote, tokens, &frames)) {
+        return 1;
+    }
+    
+    bench_clock();
+    printf("Composite verifier load: %s:%s, %s loop, %zu frame(s) of %zu bytes, %.1f s per step\n",
+           target.host, target.port, open_loop ? "open" : "closed", frames.size(),
+           frames[0].size(), target.duration_ms / 1000.0);
+    if (open_loop) {
+        printf("  %d pipelined connections, latency from the scheduled send time\n",
+               target.connections);
+    }
+    printf("\n");
+    
+    std::vector<load_step_t> steps;
+    for (size_t i = 0; i < levels.size(); i++) {
+        load_step_t step;
+        step.attempts = step.answered = step.trusted = 0;
+        step.rejection = VERIFY_ERROR_NONE;
+        step.elapsed_ms = 0;
+        if (open_loop) {
+            if (!run_open_loop(&target, frames, levels[i], &step)) {
+                printf("✗ Cannot connect to %s:%s\n", target.host, target.port);
+                return 1;
+            }
+        } else {
+            run_closed_loop(&target, frames, levels[i], &step);
+        }
+        if (step.answered == 0) {
+            printf("✗ No verdicts at %d %s; is verifier_daemon running on %s:%s?\n", levels[i],
+                   open_loop ? "req/s" : "clients", target.host, target.port);
+            if (steps.empty()) {
+                return 1;
+            }
+            break;
+        }
+        printf("  %6d %-8s %10.1f verdicts/s, %lu trusted, %lu lost", levels[i],
+               open_loop ? "req/s" : "clients", step_throughput(step),
+               (unsigned long)step.trusted, (unsigned long)(step.attempts - step.answered));
+        if (step.answered > step.trusted) {
+            printf(" (rejected: %s)", verify_error_str(step.rejection));
+        }
+        printf("\n");
+        steps.push_back(step);
+    }
+    
+    printf("\n");
+    print_latency_header();
+    for (size_t i = 0; i < steps.size(); i++) {
+        char label[32];
+        snprintf(label, sizeof(label), open_loop ? "%d req/s" : "%d clients", steps[i].level);
+        print_latency_row(label, steps[i].hist);
+    }
+    
+    size_t knee = saturation_step(steps, open_loop);
+    const load_step_t& saturated = steps[knee];
+    printf("\nSaturation point: %.1f verdicts/s at %d %s (p99 %.3f ms)\n",
+           step_throughput(saturated), saturated.level, open_loop ? "req/s offered" : "clients",
+           saturated.hist.percentile_ms(99));
+    if (knee + 1 == steps.size()) {
+        printf("⚠ No knee within the sweep, extend %s\n", open_loop ? "--open" : "--closed");
+    }
+    
+    BenchReport report("Composite Verifier");
+    for (size_t i = 0; i < steps.size(); i++) {
+        char name[96];
+        snprintf(name, sizeof(name), open_loop ? "Composite Verification (open loop, %d req/s)"
+                                               : "Composite Verification (closed loop, %d clients)",
+                 steps[i].level);
+        report.add_latency(name, steps[i].samples_ms, (int)steps[i].attempts);
+        report.add_field(open_loop ? "offered_rate_per_sec" : "clients", steps[i].level);
+        report.add_field("throughput_per_sec", step_throughput(steps[i]));
+        report.add_field("trusted", (double)steps[i].trusted);
+        report.add_field("rejected", (double)(steps[i].answered - steps[i].trusted));
+        if (open_loop) {
+            report.add_field("connections", target.connections);
+        }
+    }
+    report.add_operation("Saturation Point");
+    report.add_field(open_loop ? "offered_rate_per_sec" : "clients", saturated.level);
+    report.add_field("throughput_per_sec", step_throughput(saturated));
+    report.add_field("p99_at_saturation_ms", saturated.hist.percentile_ms(99));
+    report.add_field("knee_found", knee + 1 < steps.size() ? 1 : 0);
+    report.add_field("frame_size", (double)frames[0].size());
+    if (report.write_json(json_path.c_str())) {
+        printf("\n✓ Results saved to: %s\n", json_path.c_str());
+    } else {
+        printf("\n✗ Failed to write results to %s\n", json_path.c_str());
+    }
+    return 0;
+}
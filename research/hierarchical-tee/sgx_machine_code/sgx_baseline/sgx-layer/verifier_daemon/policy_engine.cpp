@@ -0,0 +1,252 @@
+#include "policy_engine.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define POLICY_LINE_MAX 512
+
+static const struct {
+    const char* name;
+    unsigned bit;
+} tcb_status_names[] = {
+    {"UpToDate", POLICY_TCB_UP_TO_DATE},
+    {"SWHardeningNeeded", POLICY_TCB_SW_HARDENING_NEEDED},
+    {"ConfigurationNeeded", POLICY_TCB_CONFIGURATION_NEEDED},
+    {"ConfigurationAndSWHardeningNeeded", POLICY_TCB_CONFIGURATION_AND_SW_HARDENING_NEEDED},
+    {"OutOfDate", POLICY_TCB_OUT_OF_DATE},
+    {"OutOfDateConfigurationNeeded", POLICY_TCB_OUT_OF_DATE_CONFIGURATION_NEEDED}
+};
+
+#define TCB_STATUS_COUNT (sizeof(tcb_status_names) / sizeof(tcb_status_names[0]))
+
+static int hex_value(uint8_t c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/* Exactly 2 * size hex characters into `out`. */
+static bool hex_decode(const uint8_t* hex, size_t len, uint8_t* out, size_t size) {
+    if (len != 2 * size) {
+        return false;
+    }
+    for (size_t i = 0; i < size; i++) {
+        int hi = hex_value(hex[2 * i]);
+        int lo = hex_value(hex[2 * i + 1]);
+        if (hi < 0 || lo < 0) {
+            return false;
+        }
+        out[i] = (uint8_t)(hi << 4 | lo);
+    }
+    return true;
+}
+
+/* Set bit of an ITA/PCS status name, 0 if unknown. */
+static unsigned tcb_status_bit(const uint8_t* name, size_t len) {
+    for (size_t i = 0; i < TCB_STATUS_COUNT; i++) {
+        if (strlen(tcb_status_names[i].name) == len && memcmp(tcb_status_names[i].name, name, len) == 0) {
+            return tcb_status_names[i].bit;
+        }
+    }
+    return 0;
+}
+
+bool policy_add_measurement(std::vector<uint8_t>* list, const char* hex, size_t size) {
+    uint8_t value[POLICY_TDX_MEASUREMENT_SIZE];
+    if (size > sizeof(value) || !hex_decode((const uint8_t*)hex, strlen(hex), value, size)) {
+        return false;
+    }
+    list->insert(list->end(), value, value + size);
+    return true;
+}
+
+/* One "key value" rule; `error` set on failure. */
+static bool parse_rule(const char* key, const char* value, composite_policy_t* policy,
+                       std::string* error) {
+    if (strcmp(key, "sgx.mrenclave") == 0 || strcmp(key, "sgx.mrsigner") == 0) {
+        std::vector<uint8_t>* list = strcmp(key, "sgx.mrenclave") == 0 ? &policy->sgx_mrenclave
+                                                                       : &policy->sgx_mrsigner;
+        if (!policy_add_measurement(list, value, POLICY_SGX_MEASUREMENT_SIZE)) {
+            *error = "expected 64 hex characters";
+            return false;
+        }
+    } else if (strcmp(key, "tdx.mrtd") == 0 ||
+               (strncmp(key, "tdx.rtmr", 8) == 0 && key[8] >= '0' &&
+                key[8] < '0' + POLICY_RTMRS && key[9] == '\0')) {
+        std::vector<uint8_t>* list = strcmp(key, "tdx.mrtd") == 0 ? &policy->tdx_mrtd
+                                                                  : &policy->tdx_rtmr[key[8] - '0'];
+        if (!policy_add_measurement(list, value, POLICY_TDX_MEASUREMENT_SIZE)) {
+            *error = "expected 96 hex characters";
+            return false;
+        }
+    } else if (strcmp(key, "sgx.min_isvsvn") == 0) {
+        char* end = NULL;
+        long svn = strtol(value, &end, 10);
+        if (*value == '\0' || *end != '\0' || svn < 0 || svn > 0xffff) {
+            *error = "expected an ISVSVN between 0 and 65535";
+            return false;
+        }
+        policy->sgx_min_isvsvn = (uint16_t)svn;
+    } else if (strcmp(key, "sgx.tcb_status") == 0 || strcmp(key, "tdx.tcb_status") == 0) {
+        unsigned bit = tcb_status_bit((const uint8_t*)value, strlen(value));
+        if (bit == 0) {
+            *error = std::string("unknown TCB status ") + value;
+            return false;
+        }
+        *(strcmp(key, "sgx.tcb_status") == 0 ? &policy->sgx_tcb : &policy->tdx_tcb) |= bit;
+    } else if (strcmp(key, "tdx.allow_debug") == 0) {
+        if (strcmp(value, "true") != 0 && strcmp(value, "false") != 0) {
+            *error = "expected true or false";
+            return false;
+        }
+        policy->allow_debug = strcmp(value, "true") == 0;
+    } else if (strcmp(key, "binding") == 0) {
+        if (strcmp(value, "enclave") != 0 && strcmp(value, "report_data") != 0) {
+            *error = "expected report_data or enclave";
+            return false;
+        }
+        policy->require_enclave_binding = strcmp(value, "enclave") == 0;
+    } else {
+        *error = std::string("unknown rule ") + key;
+        return false;
+    }
+    return true;
+}
+
+bool parse_policy_file(const char* path, composite_policy_t* policy, std::string* error) {
+    *policy = composite_policy_t();
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        *error = std::string("cannot open ") + path;
+        return false;
+    }
+    char line[POLICY_LINE_MAX];
+    int number = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), f)) {
+        number++;
+        char* hash = strchr(line, '#');
+        if (hash) {
+            *hash = '\0';
+        }
+        char key[64];
+        char value[POLICY_LINE_MAX];
+        char extra[2];
+        int fields = sscanf(line, "%63s %511s %1s", key, value, extra);
+        if (fields <= 0) {
+            continue;
+        }
+        std::string why;
+        if (fields != 2) {
+            why = "expected \"rule value\"";
+        }
+        if (!why.empty() || !parse_rule(key, value, policy, &why)) {
+            char prefix[32];
+            snprintf(prefix, sizeof(prefix), "line %d: ", number);
+            *error = prefix + why;
+            ok = false;
+        }
+    }
+    fclose(f);
+    return ok;
+}
+
+CompiledPolicy::CompiledPolicy(const composite_policy_t& policy, uint32_t generation)
+    : min_isvsvn_(policy.sgx_min_isvsvn),
+      sgx_tcb_(policy.sgx_tcb ? policy.sgx_tcb : POLICY_TCB_DEFAULT),
+      tdx_tcb_(policy.tdx_tcb ? policy.tdx_tcb : POLICY_TCB_DEFAULT),
+      allow_debug_(policy.allow_debug),
+      require_enclave_binding_(policy.require_enclave_binding),
+      generation_(generation) {
+    mrenclave_.build(policy.sgx_mrenclave.data(),
+                     policy.sgx_mrenclave.size() / POLICY_SGX_MEASUREMENT_SIZE);
+    mrsigner_.build(policy.sgx_mrsigner.data(),
+                    policy.sgx_mrsigner.size() / POLICY_SGX_MEASUREMENT_SIZE);
+    mrtd_.build(policy.tdx_mrtd.data(), policy.tdx_mrtd.size() / POLICY_TDX_MEASUREMENT_SIZE);
+    for (int i = 0; i < POLICY_RTMRS; i++) {
+        rtmr_[i].build(policy.tdx_rtmr[i].data(),
+                       policy.tdx_rtmr[i].size() / POLICY_TDX_MEASUREMENT_SIZE);
+    }
+}
+
+size_t CompiledPolicy::measurement_count() const {
+    size_t count = mrenclave_.size() + mrsigner_.size() + mrtd_.size();
+    for (int i = 0; i < POLICY_RTMRS; i++) {
+        count += rtmr_[i].size();
+    }
+    return count;
+}
+
+/* Empty set: any measurement; the token's hex must still decode. */
+static bool tdx_measurement_allowed(const MeasurementSet<POLICY_TDX_MEASUREMENT_SIZE>& set,
+                                    byte_span_t hex) {
+    uint8_t value[POLICY_TDX_MEASUREMENT_SIZE];
+    return set.empty() ||
+           (hex_decode(hex.data, hex.size, value, sizeof(value)) && set.contains(value));
+}
+
+uint32_t CompiledPolicy::check_tdx(const tdx_token_claims_t& claims) const {
+    if (!tdx_measurement_allowed(mrtd_, claims.mrtd)) {
+        return VERIFY_ERROR_POLICY_MRTD;
+    }
+    for (int i = 0; i < POLICY_RTMRS; i++) {
+        if (!tdx_measurement_allowed(rtmr_[i], claims.rtmr[i])) {
+            return VERIFY_ERROR_POLICY_RTMR;
+        }
+    }
+    if (claims.is_debuggable && !allow_debug_) {
+        return VERIFY_ERROR_POLICY_DEBUG;
+    }
+    if (!(tcb_status_bit(claims.tcb_status.data, claims.tcb_status.size) & tdx_tcb_)) {
+        return VERIFY_ERROR_POLICY_TCB;
+    }
+    return VERIFY_ERROR_NONE;
+}
+
+uint32_t CompiledPolicy::check_sgx(const uint8_t mrenclave[POLICY_SGX_MEASUREMENT_SIZE],
+                                   const uint8_t mrsigner[POLICY_SGX_MEASUREMENT_SIZE],
+                                   uint16_t isvsvn) const {
+    if ((!mrenclave_.empty() && !mrenclave_.contains(mrenclave)) ||
+        (!mrsigner_.empty() && !mrsigner_.contains(mrsigner)) || isvsvn < min_isvsvn_) {
+        return VERIFY_ERROR_POLICY_SGX;
+    }
+    return VERIFY_ERROR_NONE;
+}
+
+bool CompiledPolicy::sgx_tcb_accepted(sgx_ql_qv_result_t result) const {
+    unsigned bit = 0;
+    switch (result) {
+    case SGX_QL_QV_RESULT_OK:                           bit = POLICY_TCB_UP_TO_DATE; break;
+    case SGX_QL_QV_RESULT_SW_HARDENING_NEEDED:          bit = POLICY_TCB_SW_HARDENING_NEEDED; break;
+    case SGX_QL_QV_RESULT_CONFIG_NEEDED:                bit = POLICY_TCB_CONFIGURATION_NEEDED; break;
+    case SGX_QL_QV_RESULT_CONFIG_AND_SW_HARDENING_NEEDED:
+        bit = POLICY_TCB_CONFIGURATION_AND_SW_HARDENING_NEEDED;
+        break;
+    case SGX_QL_QV_RESULT_OUT_OF_DATE:                  bit = POLICY_TCB_OUT_OF_DATE; break;
+    case SGX_QL_QV_RESULT_OUT_OF_DATE_CONFIG_NEEDED:
+        bit = POLICY_TCB_OUT_OF_DATE_CONFIGURATION_NEEDED;
+        break;
+    default:
+        break;   // revoked, invalid signature, unspecified
+    }
+    return (bit & sgx_tcb_) != 0;
+}
+
+PolicyStore::~PolicyStore() {
+    delete current_.load();
+    for (size_t i = 0; i < retired_.size(); i++) {
+        delete retired_[i];
+    }
+}
+
+void PolicyStore::publish(const composite_policy_t& policy) {
+    std::lock_guard<std::mutex> lock(publish_lock_);
+    // Compiled before the swap, so workers only ever see a complete policy
+    const CompiledPolicy* next = new CompiledPolicy(policy, ++generation_);
+    const CompiledPolicy* previous = current_.exchange(next, std::memory_order_acq_rel);
+    if (previous) {
+        retired_.push_back(previous);
+    }
+}
@@ -0,0 +1,227 @@
+#ifndef POLICY_ENGINE_H
+#define POLICY_ENGINE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <sgx_ql_lib_common.h>
+#include "composite_evidence.h"
+#include "tdx_token.h"
+#include "verifier_protocol.h"
+
+/*
+ * Composite attestation policy: what the verifier accepts from the SGX
+ * quote, the TDX token and the binding between them.
+ *
+ * Source form, one rule per line, '#' starts a comment:
+ *
+ *   sgx.mrenclave   <64 hex>      repeatable; none listed: any
+ *   sgx.mrsigner    <64 hex>      repeatable; none listed: any
+ *   sgx.min_isvsvn  <n>
+ *   sgx.tcb_status  <status>      repeatable; default UpToDate SWHardeningNeeded OutOfDate
+ *   tdx.mrtd        <96 hex>      repeatable; none listed: any
+ *   tdx.rtmr0..3    <96 hex>      repeatable per register; none listed: any
+ *   tdx.tcb_status  <status>      repeatable; same default as sgx.tcb_status
+ *   tdx.allow_debug true|false    default false
+ *   binding         report_data|enclave   enclave: sgx_binding.h's
+ *                                 SHA256(MRENCLAVE || purpose || nonce)
+ *
+ * Statuses use the ITA/PCS names (UpToDate, SWHardeningNeeded,
+ * ConfigurationNeeded, ConfigurationAndSWHardeningNeeded, OutOfDate,
+ * OutOfDateConfigurationNeeded); for SGX they map onto the QVL's
+ * sgx_ql_qv_result_t.
+ *
+ * compile() turns the rules into a CompiledPolicy: each measurement list
+ * becomes a MeasurementSet and the status lists become bitmasks, so
+ * evaluating a frame is a handful of probes however many thousand
+ * measurements the policy holds. PolicyStore publishes compiled policies
+ * for hot reload.
+ */
+
+#define POLICY_SGX_MEASUREMENT_SIZE 32
+#define POLICY_TDX_MEASUREMENT_SIZE 48
+#define POLICY_RTMRS TDX_TOKEN_RTMRS
+
+/*
+ * Set of N-byte measurements in one flat array, ordered by hash.
+ *
+ * Slots hold the key's 64-bit hash next to the key (one cache line for a
+ * 48-byte MRTD). build() sorts the keys by hash and places each at the
+ * first free slot from its home slot (the hash's top bits), so the array
+ * stays sorted and a probe stops at the first slot with a larger hash:
+ * found or not, a lookup reads one or two lines. The table is at most
+ * half full and never wraps.
+ *
+ * Measurements are hashes already; the multiply only spreads test values
+ * that share leading bytes.
+ */
+template <size_t N>
+class MeasurementSet {
+public:
+    MeasurementSet() : shift_(63), count_(0) {}
+    
+    /* `keys`: `count` consecutive N-byte measurements; duplicates are merged. */
+    void build(const uint8_t* keys, size_t count) {
+        std::vector<slot_t> sorted(count);
+        for (size_t i = 0; i < count; i++) {
+            memcpy(sorted[i].key, keys + i * N, N);
+            sorted[i].hash = hash(sorted[i].key);
+        }
+        std::sort(sorted.begin(), sorted.end(), slot_less);
+        
+        size_t bits = 1;
+        while (((size_t)1 << bits) < 2 * count) {
+            bits++;
+        }
+        shift_ = 64 - (unsigned)bits;
+        count_ = 0;
+        slots_.assign(((size_t)1 << bits) + count, slot_t());
+        size_t next = 0;
+        for (size_t i = 0; i < count; i++) {
+            if (count_ > 0 && sorted[i].hash == slots_[next - 1].hash &&
+                memcmp(sorted[i].key, slots_[next - 1].key, N) == 0) {
+                continue;
+            }
+            size_t pos = std::max(home(sorted[i].hash), next);
+            slots_[pos] = sorted[i];
+            next = pos + 1;
+            count_++;
+        }
+        slots_.resize(next);
+    }
+    
+    bool contains(const uint8_t* key) const {
+        uint64_t h = hash(key);
+        for (size_t i = home(h); i < slots_.size(); i++) {
+            const slot_t& slot = slots_[i];
+            if (slot.hash > h || slot.hash == 0) {
+                return false;
+            }
+            if (slot.hash == h && memcmp(slot.key, key, N) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+    
+private:
+    typedef struct {
+        uint64_t hash;      /* 0: empty slot */
+        uint8_t key[N];
+    } slot_t;
+    
+    static uint64_t hash(const uint8_t* key) {
+        uint64_t h;
+        memcpy(&h, key, sizeof(h));
+        return (h * 0x9e3779b97f4a7c15ull) | 1;
+    }
+    size_t home(uint64_t h) const { return (size_t)(h >> shift_); }
+    static bool slot_less(const slot_t& a, const slot_t& b) {
+        return a.hash < b.hash || (a.hash == b.hash && memcmp(a.key, b.key, N) < 0);
+    }
+    
+    std::vector<slot_t> slots_;
+    unsigned shift_;
+    size_t count_;
+};
+
+enum policy_tcb_status_t {
+    POLICY_TCB_UP_TO_DATE = 1 << 0,
+    POLICY_TCB_SW_HARDENING_NEEDED = 1 << 1,
+    POLICY_TCB_CONFIGURATION_NEEDED = 1 << 2,
+    POLICY_TCB_CONFIGURATION_AND_SW_HARDENING_NEEDED = 1 << 3,
+    POLICY_TCB_OUT_OF_DATE = 1 << 4,
+    POLICY_TCB_OUT_OF_DATE_CONFIGURATION_NEEDED = 1 << 5
+};
+
+/* Same accepted set as TDXTokenVerifier.allowed_tcb_statuses */
+#define POLICY_TCB_DEFAULT \
+    (POLICY_TCB_UP_TO_DATE | POLICY_TCB_SW_HARDENING_NEEDED | POLICY_TCB_OUT_OF_DATE)
+
+/* Rules as written, before compile(). */
+typedef struct composite_policy_t {
+    composite_policy_t()
+        : sgx_min_isvsvn(0), sgx_tcb(0), tdx_tcb(0), allow_debug(false),
+          require_enclave_binding(false) {}
+    
+    std::vector<uint8_t> sgx_mrenclave;         /* POLICY_SGX_MEASUREMENT_SIZE each */
+    std::vector<uint8_t> sgx_mrsigner;
+    uint16_t sgx_min_isvsvn;
+    unsigned sgx_tcb;                           /* 0: POLICY_TCB_DEFAULT */
+    std::vector<uint8_t> tdx_mrtd;              /* POLICY_TDX_MEASUREMENT_SIZE each */
+    std::vector<uint8_t> tdx_rtmr[POLICY_RTMRS];
+    unsigned tdx_tcb;
+    bool allow_debug;
+    bool require_enclave_binding;
+} composite_policy_t;
+
+/* Parse the source form; `error` gets "line N: ..." on failure. */
+bool parse_policy_file(const char* path, composite_policy_t* policy, std::string* error);
+/* Hex measurement appended to `list`; false unless exactly `size` bytes. */
+bool policy_add_measurement(std::vector<uint8_t>* list, const char* hex, size_t size);
+
+class CompiledPolicy {
+public:
+    CompiledPolicy(const composite_policy_t& policy, uint32_t generation);
+    
+    /* First failing check as a VERIFY_ERROR_POLICY_* code, or VERIFY_ERROR_NONE. */
+    uint32_t check_tdx(const tdx_token_claims_t& claims) const;
+    uint32_t check_sgx(const uint8_t mrenclave[POLICY_SGX_MEASUREMENT_SIZE],
+                       const uint8_t mrsigner[POLICY_SGX_MEASUREMENT_SIZE], uint16_t isvsvn) const;
+    bool sgx_tcb_accepted(sgx_ql_qv_result_t result) const;
+    bool require_enclave_binding() const { return require_enclave_binding_; }
+    
+    size_t measurement_count() const;
+    /* Bumped by every publish(); part of the verdict cache key. */
+    uint32_t generation() const { return generation_; }
+    
+private:
+    MeasurementSet<POLICY_SGX_MEASUREMENT_SIZE> mrenclave_;
+    MeasurementSet<POLICY_SGX_MEASUREMENT_SIZE> mrsigner_;
+    MeasurementSet<POLICY_TDX_MEASUREMENT_SIZE> mrtd_;
+    MeasurementSet<POLICY_TDX_MEASUREMENT_SIZE> rtmr_[POLICY_RTMRS];
+    uint16_t min_isvsvn_;
+    unsigned sgx_tcb_;
+    unsigned tdx_tcb_;
+    bool allow_debug_;
+    bool require_enclave_binding_;
+    uint32_t generation_;
+};
+
+/*
+ * The policy in force. current() is one acquire load, so workers never
+ * wait for a reload; publish() compiles a new policy with the next
+ * generation and swaps it in.
+ *
+ * A worker may still be evaluating the policy a reload just replaced, and
+ * nothing tracks when it is done, so replaced policies are kept until the
+ * store goes away. Reloads are operator actions (SIGHUP), so that is a
+ * few copies at most.
+ */
+class PolicyStore {
+public:
+    PolicyStore() : current_(NULL), generation_(0) {}
+    ~PolicyStore();
+    
+    const CompiledPolicy* current() const { return current_.load(std::memory_order_acquire); }
+    void publish(const composite_policy_t& policy);
+    
+private:
+    PolicyStore(const PolicyStore&);
+    PolicyStore& operator=(const PolicyStore&);
+    
+    std::atomic<const CompiledPolicy*> current_;
+    std::mutex publish_lock_;
+    uint32_t generation_;
+    std::vector<const CompiledPolicy*> retired_;
+};
+
+#endif /* POLICY_ENGINE_H */
@@ -0,0 +1,270 @@
+#include "quote_verifier.h"
+
+#include <string.h>
+#include <sgx_quote_3.h>
+#include <sgx_dcap_quoteverify.h>
+#include "quote_parser.h"
+
+#define CERT_TYPE_PCK_CHAIN 5        /* PEM PCK leaf, intermediate and root */
+#define CERT_TYPE_QE_REPORT 6        /* QE report, signature, auth data, nested cert data */
+#define CERT_DATA_HEADER_SIZE 6      /* u16 type, u32 size */
+#define PEM_BEGIN "-----BEGIN CERTIFICATE-----"
+#define PEM_END "-----END CERTIFICATE-----"
+
+// SGX extension FMSPC, OID 1.2.840.113741.1.13.1.4, then OCTET STRING (6)
+static const uint8_t fmspc_oid_der[] = {
+    0x06, 0x0a, 0x2a, 0x86, 0x48, 0x86, 0xf8, 0x4d, 0x01, 0x0d, 0x01, 0x04, 0x04, 0x06
+};
+
+static_assert(sizeof(sgx_quote3_t) == sgx_quote3_layout::fixed_size &&
+              sizeof(sgx_report_body_t) == sgx_report_body_layout::size &&
+              sizeof(sgx_ql_ecdsa_sig_data_t) == quote_ecdsa_sig_layout::size + sizeof(sgx_report_body_t) + 64,
+              "quote_parser.h layouts must match the SDK quote structs");
+
+static uint16_t get_u16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static int base64_value(uint8_t c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '+') return 62;
+    if (c == '/') return 63;
+    return -1;
+}
+
+/* Decode the body of the first PEM certificate into `der` (at most cap bytes). */
+static size_t decode_first_pem(const uint8_t* pem, size_t len, uint8_t* der, size_t cap) {
+    const uint8_t* begin = (const uint8_t*)memmem(pem, len, PEM_BEGIN, strlen(PEM_BEGIN));
+    if (!begin) {
+        return 0;
+    }
+    begin += strlen(PEM_BEGIN);
+    const uint8_t* end = (const uint8_t*)memmem(begin, len - (size_t)(begin - pem),
+                                                PEM_END, strlen(PEM_END));
+    if (!end) {
+        return 0;
+    }
+    
+    size_t out = 0;
+    uint32_t acc = 0;
+    int bits = 0;
+    for (const uint8_t* p = begin; p < end && out < cap; p++) {
+        int v = base64_value(*p);
+        if (v < 0) {
+            continue;  // line breaks and '=' padding
+        }
+        acc = (acc << 6) | (uint32_t)v;
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            der[out++] = (uint8_t)(acc >> bits);
+        }
+    }
+    return out;
+}
+
+static bool pck_chain_key(const uint8_t* pem, size_t len, collateral_key_t* key) {
+    uint8_t der[4096];  // a PCK leaf is ~1.2 KB
+    size_t der_len = decode_first_pem(pem, len, der, sizeof(der));
+    const uint8_t* oid = (const uint8_t*)memmem(der, der_len, fmspc_oid_der, sizeof(fmspc_oid_der));
+    if (!oid || (size_t)(der + der_len - oid) < sizeof(fmspc_oid_der) + FMSPC_SIZE) {
+        return false;
+    }
+    memcpy(key->fmspc, oid + sizeof(fmspc_oid_der), FMSPC_SIZE);
+    
+    // Issuer CN: "Intel SGX PCK Processor CA" or "Intel SGX PCK Platform CA"
+    if (memmem(der, der_len, "Processor CA", 12)) {
+        key->ca = PCK_CA_PROCESSOR;
+    } else if (memmem(der, der_len, "Platform CA", 11)) {
+        key->ca = PCK_CA_PLATFORM;
+    } else {
+        key->ca = PCK_CA_UNKNOWN;
+    }
+    return true;
+}
+
+/* Certification data at `p` (type, size, payload), unwrapping type 6. */
+static bool cert_data_key(const uint8_t* p, size_t len, collateral_key_t* key) {
+    if (len < CERT_DATA_HEADER_SIZE) {
+        return false;
+    }
+    uint16_t type = get_u16(p);
+    uint32_t size = get_u32(p + 2);
+    if (size > len - CERT_DATA_HEADER_SIZE) {
+        return false;
+    }
+    p += CERT_DATA_HEADER_SIZE;
+    if (type == CERT_TYPE_PCK_CHAIN) {
+        return pck_chain_key(p, size, key);
+    }
+    if (type == CERT_TYPE_QE_REPORT) {
+        size_t skip = sizeof(sgx_report_body_t) + 64;  // QE report and its signature
+        if (size < skip + 2) {
+            return false;
+        }
+        size_t auth = get_u16(p + skip);
+        skip += 2 + auth;
+        return size > skip && cert_data_key(p + skip, size - skip, key);
+    }
+    return false;
+}
+
+bool quote_collateral_key(byte_span_t quote, collateral_key_t* key) {
+    memset(key, 0, sizeof(*key));
+    if (quote.size < sizeof(sgx_quote3_t)) {
+        return false;
+    }
+    const sgx_quote3_t* q = (const sgx_quote3_t*)quote.data;
+    size_t sig_len = q->signature_data_len;
+    if (sig_len > quote.size - sizeof(sgx_quote3_t) || sig_len < sizeof(sgx_ql_ecdsa_sig_data_t) + 2) {
+        return false;
+    }
+    
+    // ECDSA signature data, QE auth data, then certification data
+    const uint8_t* p = q->signature_data + sizeof(sgx_ql_ecdsa_sig_data_t);
+    size_t left = sig_len - sizeof(sgx_ql_ecdsa_sig_data_t);
+    size_t auth = get_u16(p);
+    if (left < 2 + auth) {
+        return false;
+    }
+    return cert_data_key(p + 2 + auth, left - 2 - auth, key);
+}
+
+QuoteVerifier::QuoteVerifier()
+    : supplemental_size_(0), cache_enabled_(true), collateral_fetches_(0),
+      collateral_fetch_failures_(0), tcb_evaluation_(0) {
+}
+
+quote3_error_t QuoteVerifier::init() {
+    return sgx_qv_get_quote_supplemental_data_size(&supplemental_size_);
+}
+
+bool QuoteVerifier::accepted(const quote_verdict_t& verdict) {
+    return verdict.status == SGX_QL_SUCCESS && verdict.collateral_expiration == 0 &&
+           (verdict.result == SGX_QL_QV_RESULT_OK ||
+            verdict.result == SGX_QL_QV_RESULT_SW_HARDENING_NEEDED ||
+            verdict.result == SGX_QL_QV_RESULT_OUT_OF_DATE);
+}
+
+void QuoteVerifier::verify_with(byte_span_t quote, const uint8_t* collateral, time_t now,
+                                std::vector<uint8_t>* supplemental, quote_verdict_t* out) const {
+    if (supplemental->size() < supplemental_size_) {
+        supplemental->resize(supplemental_size_);
+    }
+    out->collateral_expiration = 1;
+    out->result = SGX_QL_QV_RESULT_UNSPECIFIED;
+    out->status = sgx_qv_verify_quote(quote.data, (uint32_t)quote.size,
+                                      (const sgx_ql_qve_collateral_t*)collateral, now,
+                                      &out->collateral_expiration, &out->result, NULL,
+                                      supplemental_size_,
+                                      supplemental_size_ ? supplemental->data() : NULL);
+}
+
+void QuoteVerifier::verify_one(byte_span_t quote, time_t now, quote_scratch_t* scratch,
+                               quote_verdict_t* out) const {
+    // NULL collateral: the QVL fetches it through the quote provider library
+    collateral_fetches_.fetch_add(1, std::memory_order_relaxed);
+    verify_with(quote, NULL, now, &scratch->supplemental, out);
+}
+
+bool QuoteVerifier::verify_group(const byte_span_t* quotes, const uint8_t* collateral, time_t now,
+                                 quote_scratch_t* scratch, quote_verdict_t* out) const {
+    bool expired = false;
+    for (size_t k = 0; k < scratch->group.size(); k++) {
+        size_t j = scratch->group[k];
+        verify_with(quotes[j], collateral, now, &scratch->supplemental, &out[j]);
+        expired = expired || out[j].collateral_expiration != 0;
+    }
+    return expired;
+}
+
+uint8_t* QuoteVerifier::fetch_collateral(byte_span_t quote, const collateral_key_t& key) const {
+    uint8_t* collateral = NULL;
+    uint32_t collateral_size = 0;
+    collateral_fetches_.fetch_add(1, std::memory_order_relaxed);
+    quote3_error_t ret = tee_qv_get_collateral(quote.data, (uint32_t)quote.size,
+                                               &collateral, &collateral_size);
+    if (ret != SGX_QL_SUCCESS) {
+        collateral_fetch_failures_.fetch_add(1, std::memory_order_relaxed);
+        return NULL;  // let the QVL try for each quote itself
+    }
+    const sgx_ql_qve_collateral_t* parsed = (const sgx_ql_qve_collateral_t*)collateral;
+    uint32_t evaluation = collateral_tcb_evaluation(parsed);
+    uint32_t seen = tcb_evaluation_.load();
+    // Only ever raised: resumption tickets from before a TCB recovery stay void
+    while (evaluation > seen && !tcb_evaluation_.compare_exchange_weak(seen, evaluation)) {
+    }
+    if (cache_enabled_) {
+        int64_t next_update = collateral_next_update(parsed);
+        if (next_update > 0) {
+            cache_.insert(key, next_update, parsed);
+        }
+    }
+    return collateral;
+}
+
+int64_t QuoteVerifier::prefetch_collateral(byte_span_t quote, time_t now) const {
+    collateral_key_t key;
+    if (!quote_collateral_key(quote, &key)) {
+        return 0;
+    }
+    uint8_t* collateral = fetch_collateral(quote, key);
+    if (!collateral) {
+        return 0;
+    }
+    int64_t next_update = collateral_next_update((const sgx_ql_qve_collateral_t*)collateral);
+    tee_qv_free_collateral(collateral);
+    return next_update > (int64_t)now ? next_update : 0;
+}
+
+void QuoteVerifier::verify_batch(const byte_span_t* quotes, size_t count, time_t now,
+                                 quote_scratch_t* scratch, quote_verdict_t* out) const {
+    // A batch spans a handful of platforms at most, so a linear scan beats a map
+    scratch->keys.resize(count);
+    scratch->has_key.resize(count);
+    scratch->done.assign(count, 0);
+    for (size_t i = 0; i < count; i++) {
+        scratch->has_key[i] = quote_collateral_key(quotes[i], &scratch->keys[i]);
+    }
+    
+    for (size_t i = 0; i < count; i++) {
+        if (scratch->done[i]) {
+            continue;
+        }
+        if (!scratch->has_key[i]) {
+            verify_one(quotes[i], now, scratch, &out[i]);
+            scratch->done[i] = 1;
+            continue;
+        }
+        
+        // Quote i leads its group: every later quote sharing its key
+        const collateral_key_t& key = scratch->keys[i];
+        scratch->group.clear();
+        for (size_t j = i; j < count; j++) {
+            if (!scratch->done[j] && scratch->has_key[j] &&
+                memcmp(&scratch->keys[j], &key, sizeof(collateral_key_t)) == 0) {
+                scratch->group.push_back(j);
+                scratch->done[j] = 1;
+            }
+        }
+        
+        sgx_ql_qve_collateral_t cached;
+        if (cache_enabled_ && cache_.lookup(key, now, &scratch->collateral, &cached)) {
+            if (!verify_group(quotes, (const uint8_t*)&cached, now, scratch, out)) {
+                continue;
+            }
+            cache_.invalidate(key);
+        }
+        uint8_t* collateral = fetch_collateral(quotes[i], key);
+        verify_group(quotes, collateral, now, scratch, out);
+        if (collateral) {
+            tee_qv_free_collateral(collateral);
+        }
+    }
+}
@@ -0,0 +1,105 @@
+#ifndef QUOTE_VERIFIER_H
+#define QUOTE_VERIFIER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+#include <atomic>
+#include <vector>
+#include <sgx_ql_lib_common.h>
+#include "composite_evidence.h"
+#include "evidence_cache.h"
+
+enum pck_ca_t {
+    PCK_CA_UNKNOWN = 0,
+    PCK_CA_PROCESSOR,
+    PCK_CA_PLATFORM
+};
+
+typedef struct {
+    quote3_error_t status;            /* sgx_qv_verify_quote() return */
+    sgx_ql_qv_result_t result;
+    uint32_t collateral_expiration;   /* non-zero: collateral expired at `now` */
+} quote_verdict_t;
+
+/* Per-thread buffers, reused so verification does not allocate. */
+typedef struct {
+    std::vector<uint8_t> supplemental;
+    std::vector<uint8_t> collateral;          /* copy of a cached entry */
+    std::vector<collateral_key_t> keys;
+    std::vector<uint8_t> has_key;
+    std::vector<uint8_t> done;
+    std::vector<size_t> group;
+} quote_scratch_t;
+
+/* FMSPC and CA from the PCK leaf certificate embedded in the quote's
+ * certification data; false for quotes without a PEM PCK chain. */
+bool quote_collateral_key(byte_span_t quote, collateral_key_t* key);
+
+/*
+ * DCAP quote verification on top of sgx_qv_verify_quote().
+ *
+ * verify_one() passes no collateral, so the QVL fetches PCK CRL, TCB info
+ * and QE identity through the quote provider library for every quote.
+ * verify_batch() groups the batch by FMSPC/CA, fetches collateral once per
+ * group with tee_qv_get_collateral() and verifies the whole group against
+ * it. Quotes whose key cannot be read fall back to verify_one().
+ *
+ * Fetched collateral is kept in a CollateralCache until its nextUpdate, so
+ * later batches from the same platforms skip the fetch. If the QVL still
+ * reports a cached entry expired (a CRL can lapse before the TCB info), it
+ * is dropped and the group re-verified against fresh collateral.
+ *
+ * Both are thread-safe; scratch buffers are caller-owned.
+ */
+class QuoteVerifier {
+public:
+    QuoteVerifier();
+
+    quote3_error_t init();
+
+    void verify_one(byte_span_t quote, time_t now, quote_scratch_t* scratch,
+                    quote_verdict_t* out) const;
+    void verify_batch(const byte_span_t* quotes, size_t count, time_t now,
+                      quote_scratch_t* scratch, quote_verdict_t* out) const;
+
+    /* Fetch the collateral for `quote`'s platform now, filling the cache
+     * (and the quote provider's own) ahead of foreground verification.
+     * Returns the collateral's nextUpdate, 0 if the fetch failed. */
+    int64_t prefetch_collateral(byte_span_t quote, time_t now) const;
+
+    /* Off: every batch fetches its own collateral. */
+    void set_collateral_cache(bool enabled) { cache_enabled_ = enabled; }
+
+    /* Verified and the TCB result is one the default policy accepts
+     * (POLICY_TCB_DEFAULT); EvidenceVerifier applies its own policy. */
+    static bool accepted(const quote_verdict_t& verdict);
+
+    /* Collateral retrievals, explicit (batch) or inside the QVL (verify_one). */
+    uint64_t collateral_fetches() const { return collateral_fetches_.load(); }
+    uint64_t collateral_fetch_failures() const { return collateral_fetch_failures_.load(); }
+    cache_stats_t collateral_cache_stats() const { return cache_.stats(); }
+    /* Highest tcbEvaluationDataNumber in any collateral fetched so far. */
+    uint32_t tcb_evaluation() const { return tcb_evaluation_.load(); }
+
+private:
+    QuoteVerifier(const QuoteVerifier&);
+    QuoteVerifier& operator=(const QuoteVerifier&);
+
+    void verify_with(byte_span_t quote, const uint8_t* collateral, time_t now,
+                     std::vector<uint8_t>* supplemental, quote_verdict_t* out) const;
+    /* Verify scratch->group against `collateral`; true if any reported it expired. */
+    bool verify_group(const byte_span_t* quotes, const uint8_t* collateral, time_t now,
+                      quote_scratch_t* scratch, quote_verdict_t* out) const;
+    /* tee_qv_get_collateral() for the group led by `quote`, cached on success. */
+    uint8_t* fetch_collateral(byte_span_t quote, const collateral_key_t& key) const;
+
+    uint32_t supplemental_size_;
+    bool cache_enabled_;
+    mutable CollateralCache cache_;
+    mutable std::atomic<uint64_t> collateral_fetches_;
+    mutable std::atomic<uint64_t> collateral_fetch_failures_;
+    mutable std::atomic<uint32_t> tcb_evaluation_;
+};
+
+#endif /* QUOTE_VERIFIER_H */
@@ -0,0 +1,172 @@
+#include "resumption_ticket.h"
+
+#include <string.h>
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/rand.h>
+#include "composite_evidence.h"
+
+#define TICKET_AAD_SIZE (RESUMPTION_TICKET_HEADER_SIZE + RESUMPTION_TICKET_IV_SIZE)
+#define TICKET_KEY_NONCE_OFFSET SGX_SESSION_KEY_SIZE
+#define TICKET_MRENCLAVE_OFFSET (TICKET_KEY_NONCE_OFFSET + SGX_BINDING_NONCE_SIZE)
+#define TICKET_EXPIRES_OFFSET (TICKET_MRENCLAVE_OFFSET + SGX_BINDING_MRENCLAVE_SIZE)
+#define TICKET_TCB_OFFSET (TICKET_EXPIRES_OFFSET + 8)
+
+TicketIssuer::TicketIssuer() : ready_(false), issued_(0), resumed_(0), rejected_(0) {
+    memset(key_, 0, sizeof(key_));
+}
+
+TicketIssuer::~TicketIssuer() {
+    OPENSSL_cleanse(key_, sizeof(key_));
+}
+
+bool TicketIssuer::init() {
+    ready_ = RAND_bytes(key_, sizeof(key_)) == 1;
+    return ready_;
+}
+
+bool TicketIssuer::challenge(uint8_t out[SGX_RESUME_CHALLENGE_SIZE]) {
+    return RAND_bytes(out, SGX_RESUME_CHALLENGE_SIZE) == 1;
+}
+
+bool TicketIssuer::issue(const AttestedSession& session, const uint8_t* mrenclave,
+                         int64_t expires, uint32_t tcb_evaluation,
+                         uint8_t out[RESUMPTION_TICKET_SIZE]) const {
+    if (!ready_ || !session.established()) {
+        return false;
+    }
+    
+    uint8_t plaintext[RESUMPTION_TICKET_PLAINTEXT_SIZE];
+    memset(plaintext, 0, sizeof(plaintext));
+    memcpy(plaintext, session.key_, SGX_SESSION_KEY_SIZE);
+    memcpy(plaintext + TICKET_KEY_NONCE_OFFSET, session.key_nonce_, SGX_BINDING_NONCE_SIZE);
+    memcpy(plaintext + TICKET_MRENCLAVE_OFFSET, mrenclave, SGX_BINDING_MRENCLAVE_SIZE);
+    composite_put_u32(plaintext + TICKET_EXPIRES_OFFSET, (uint32_t)(uint64_t)expires);
+    composite_put_u32(plaintext + TICKET_EXPIRES_OFFSET + 4, (uint32_t)((uint64_t)expires >> 32));
+    composite_put_u32(plaintext + TICKET_TCB_OFFSET, tcb_evaluation);
+    
+    memcpy(out, RESUMPTION_TICKET_MAGIC, 4);
+    out[4] = RESUMPTION_TICKET_VERSION;
+    memset(out + 5, 0, 3);
+    uint8_t* iv = out + RESUMPTION_TICKET_HEADER_SIZE;
+    uint8_t* ciphertext = iv + RESUMPTION_TICKET_IV_SIZE;
+    uint8_t* tag = ciphertext + RESUMPTION_TICKET_PLAINTEXT_SIZE;
+    
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    int len = 0;
+    bool ok = ctx != NULL && RAND_bytes(iv, RESUMPTION_TICKET_IV_SIZE) == 1 &&
+              EVP_EncryptInit_ex(ctx, EVP_aes_256_gcm(), NULL, key_, iv) == 1 &&
+              EVP_EncryptUpdate(ctx, NULL, &len, out, TICKET_AAD_SIZE) == 1 &&
+              EVP_EncryptUpdate(ctx, ciphertext, &len, plaintext, sizeof(plaintext)) == 1 &&
+              len == (int)sizeof(plaintext) &&
+              EVP_EncryptFinal_ex(ctx, ciphertext + len, &len) == 1 &&
+              EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_GET_TAG, RESUMPTION_TICKET_TAG_SIZE, tag) == 1;
+    EVP_CIPHER_CTX_free(ctx);
+    OPENSSL_cleanse(plaintext, sizeof(plaintext));
+    if (ok) {
+        issued_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return ok;
+}
+
+ticket_status_t TicketIssuer::open(const uint8_t* ticket, size_t len,
+                                   uint8_t plaintext[RESUMPTION_TICKET_PLAINTEXT_SIZE]) const {
+    if (len != RESUMPTION_TICKET_SIZE || memcmp(ticket, RESUMPTION_TICKET_MAGIC, 4) != 0 ||
+        ticket[4] != RESUMPTION_TICKET_VERSION) {
+        return TICKET_MALFORMED;
+    }
+    const uint8_t* iv = ticket + RESUMPTION_TICKET_HEADER_SIZE;
+    const uint8_t* ciphertext = iv + RESUMPTION_TICKET_IV_SIZE;
+    const uint8_t* tag = ciphertext + RESUMPTION_TICKET_PLAINTEXT_SIZE;
+    
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    int out_len = 0;
+    bool ok = ctx != NULL && ready_ &&
+              EVP_DecryptInit_ex(ctx, EVP_aes_256_gcm(), NULL, key_, iv) == 1 &&
+              EVP_DecryptUpdate(ctx, NULL, &out_len, ticket, TICKET_AAD_SIZE) == 1 &&
+              EVP_DecryptUpdate(ctx, plaintext, &out_len, ciphertext,
+                                RESUMPTION_TICKET_PLAINTEXT_SIZE) == 1 &&
+              EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_TAG, RESUMPTION_TICKET_TAG_SIZE,
+                                  (void*)tag) == 1 &&
+              EVP_DecryptFinal_ex(ctx, plaintext + out_len, &out_len) == 1;
+    EVP_CIPHER_CTX_free(ctx);
+    return ok ? TICKET_OK : TICKET_FORGED;
+}
+
+ticket_status_t TicketIssuer::resume(const uint8_t* ticket, size_t len,
+                                     const uint8_t challenge[SGX_RESUME_CHALLENGE_SIZE],
+                                     const uint8_t proof[SGX_SESSION_MAC_SIZE], time_t now,
+                                     uint32_t tcb_evaluation, AttestedSession* session,
+                                     ticket_claims_t* claims) const {
+    uint8_t plaintext[RESUMPTION_TICKET_PLAINTEXT_SIZE];
+    ticket_status_t status = open(ticket, len, plaintext);
+    if (status == TICKET_OK) {
+        int64_t expires = (int64_t)((uint64_t)composite_get_u32(plaintext + TICKET_EXPIRES_OFFSET) |
+                                    (uint64_t)composite_get_u32(plaintext + TICKET_EXPIRES_OFFSET + 4) << 32);
+        uint32_t issued_evaluation = composite_get_u32(plaintext + TICKET_TCB_OFFSET);
+        if (expires < (int64_t)now) {
+            status = TICKET_EXPIRED;
+        } else if (issued_evaluation < tcb_evaluation) {
+            status = TICKET_TCB_CHANGED;
+        } else {
+            memcpy(claims->mrenclave, plaintext + TICKET_MRENCLAVE_OFFSET,
+                   SGX_BINDING_MRENCLAVE_SIZE);
+            claims->expires = expires;
+            claims->tcb_evaluation = issued_evaluation;
+        }
+    }
+    
+    // proof = HMAC(session key, label || challenge || ticket)
+    if (status == TICKET_OK) {
+        uint8_t message[SGX_RESUME_LABEL_LEN + SGX_RESUME_CHALLENGE_SIZE + RESUMPTION_TICKET_SIZE];
+        memcpy(message, SGX_RESUME_LABEL, SGX_RESUME_LABEL_LEN);
+        memcpy(message + SGX_RESUME_LABEL_LEN, challenge, SGX_RESUME_CHALLENGE_SIZE);
+        memcpy(message + SGX_RESUME_LABEL_LEN + SGX_RESUME_CHALLENGE_SIZE, ticket,
+               RESUMPTION_TICKET_SIZE);
+        uint8_t expected[SGX_SESSION_MAC_SIZE];
+        unsigned int expected_len = 0;
+        if (HMAC(EVP_sha256(), plaintext, SGX_SESSION_KEY_SIZE, message, sizeof(message),
+                 expected, &expected_len) == NULL || expected_len != SGX_SESSION_MAC_SIZE ||
+            CRYPTO_memcmp(expected, proof, SGX_SESSION_MAC_SIZE) != 0) {
+            status = TICKET_BAD_PROOF;
+        }
+    }
+    
+    // Only a valid proof consumes the challenge, so garbage cannot fill the set
+    if (status == TICKET_OK && !consume(challenge, claims->expires, now)) {
+        status = TICKET_REPLAYED;
+    }
+    
+    if (status == TICKET_OK) {
+        memcpy(session->key_, plaintext, SGX_SESSION_KEY_SIZE);
+        memcpy(session->key_nonce_, plaintext + TICKET_KEY_NONCE_OFFSET, SGX_BINDING_NONCE_SIZE);
+        session->established_ = true;
+        resumed_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+    }
+    OPENSSL_cleanse(plaintext, sizeof(plaintext));
+    return status;
+}
+
+bool TicketIssuer::consume(const uint8_t challenge[SGX_RESUME_CHALLENGE_SIZE], int64_t expires,
+                           time_t now) const {
+    std::lock_guard<std::mutex> lock(consumed_mutex_);
+    // Past its ticket's exp a replay is TICKET_EXPIRED, so the entry can go
+    while (!consumed_expiry_.empty() && consumed_expiry_.begin()->first < (int64_t)now) {
+        consumed_.erase(consumed_expiry_.begin()->second);
+        consumed_expiry_.erase(consumed_expiry_.begin());
+    }
+    std::string key((const char*)challenge, SGX_RESUME_CHALLENGE_SIZE);
+    if (!consumed_.insert(key).second) {
+        return false;
+    }
+    consumed_expiry_.insert(std::make_pair(expires, key));
+    return true;
+}
+
+size_t TicketIssuer::consumed_challenges() const {
+    std::lock_guard<std::mutex> lock(consumed_mutex_);
+    return consumed_.size();
+}
@@ -0,0 +1,132 @@
+#ifndef RESUMPTION_TICKET_H
+#define RESUMPTION_TICKET_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include "attestation_session.h"
+#include "sgx_session.h"
+
+/*
+ * Ticket layout, opaque to the prover:
+ *
+ *   magic "HTRT" | u8 version | 3 reserved | 12-byte IV |
+ *   AES-256-GCM(session key | key_nonce | MRENCLAVE | u64 expires |
+ *               u32 tcb_evaluation | u32 reserved) | 16-byte tag
+ *
+ * with the first 20 bytes as additional data.
+ */
+#define RESUMPTION_TICKET_MAGIC "HTRT"
+#define RESUMPTION_TICKET_VERSION 1
+#define RESUMPTION_TICKET_HEADER_SIZE 8
+#define RESUMPTION_TICKET_IV_SIZE 12
+#define RESUMPTION_TICKET_TAG_SIZE 16
+#define RESUMPTION_TICKET_PLAINTEXT_SIZE \
+    (SGX_SESSION_KEY_SIZE + SGX_BINDING_NONCE_SIZE + SGX_BINDING_MRENCLAVE_SIZE + 16)
+#define RESUMPTION_TICKET_SIZE \
+    (RESUMPTION_TICKET_HEADER_SIZE + RESUMPTION_TICKET_IV_SIZE + \
+     RESUMPTION_TICKET_PLAINTEXT_SIZE + RESUMPTION_TICKET_TAG_SIZE)
+
+enum ticket_status_t {
+    TICKET_OK = 0,
+    TICKET_MALFORMED,
+    TICKET_FORGED,        /* not issued by this verifier, or altered */
+    TICKET_EXPIRED,       /* past the TDX token's exp */
+    TICKET_TCB_CHANGED,   /* issued before the latest TCB recovery */
+    TICKET_BAD_PROOF,     /* prover does not hold the session key */
+    TICKET_REPLAYED       /* challenge already redeemed */
+};
+
+static inline const char* ticket_status_str(ticket_status_t status) {
+    switch (status) {
+    case TICKET_OK:          return "ok";
+    case TICKET_MALFORMED:   return "malformed ticket";
+    case TICKET_FORGED:      return "ticket authentication failed";
+    case TICKET_EXPIRED:     return "ticket expired";
+    case TICKET_TCB_CHANGED: return "TCB changed since issuance";
+    case TICKET_BAD_PROOF:   return "bad resumption proof";
+    case TICKET_REPLAYED:    return "resumption challenge already used";
+    }
+    return "unknown";
+}
+
+/* What the full attestation established, recovered from a ticket. */
+typedef struct {
+    uint8_t mrenclave[SGX_BINDING_MRENCLAVE_SIZE];
+    int64_t expires;
+    uint32_t tcb_evaluation;
+} ticket_claims_t;
+
+/*
+ * Issues and redeems session resumption tickets (sgx_session.h).
+ *
+ * After a composite attestation passed in full, issue() wraps the session
+ * key and what was verified into a ticket under a key only this verifier
+ * holds, so it keeps no per-prover session state. The prover's enclave
+ * seals the ticket with its session key. On reconnect the prover answers
+ * challenge() with an HMAC bound to the ticket, and resume() accepts it
+ * until the TDX token's exp or until the TCB evaluation moves past the one
+ * the ticket was issued under, whichever comes first: one AES-GCM open and
+ * one HMAC instead of quote and token verification.
+ *
+ * A challenge is good for one resume(): an accepted one is remembered
+ * until its ticket's exp, after which the ticket is void anyway, and a
+ * second redemption within that window is TICKET_REPLAYED.
+ *
+ * The ticket key is random per process, so a verifier restart voids all
+ * tickets and provers fall back to a full attestation. Thread-safe after
+ * init().
+ */
+class TicketIssuer {
+public:
+    TicketIssuer();
+    ~TicketIssuer();
+
+    bool init();
+
+    /* `expires`: the token's exp (capped by the caller as it sees fit). */
+    bool issue(const AttestedSession& session, const uint8_t* mrenclave, int64_t expires,
+               uint32_t tcb_evaluation, uint8_t out[RESUMPTION_TICKET_SIZE]) const;
+
+    static bool challenge(uint8_t out[SGX_RESUME_CHALLENGE_SIZE]);
+
+    /* On TICKET_OK `session` holds the resumed session key. */
+    ticket_status_t resume(const uint8_t* ticket, size_t len,
+                           const uint8_t challenge[SGX_RESUME_CHALLENGE_SIZE],
+                           const uint8_t proof[SGX_SESSION_MAC_SIZE], time_t now,
+                           uint32_t tcb_evaluation, AttestedSession* session,
+                           ticket_claims_t* claims) const;
+
+    uint64_t issued() const { return issued_.load(); }
+    uint64_t resumed() const { return resumed_.load(); }
+    uint64_t rejected() const { return rejected_.load(); }
+    /* Challenges remembered against replay. */
+    size_t consumed_challenges() const;
+
+private:
+    TicketIssuer(const TicketIssuer&);
+    TicketIssuer& operator=(const TicketIssuer&);
+
+    ticket_status_t open(const uint8_t* ticket, size_t len,
+                         uint8_t plaintext[RESUMPTION_TICKET_PLAINTEXT_SIZE]) const;
+    /* False if `challenge` was already consumed; drops entries past their exp. */
+    bool consume(const uint8_t challenge[SGX_RESUME_CHALLENGE_SIZE], int64_t expires,
+                 time_t now) const;
+
+    uint8_t key_[32];
+    bool ready_;
+    mutable std::atomic<uint64_t> issued_;
+    mutable std::atomic<uint64_t> resumed_;
+    mutable std::atomic<uint64_t> rejected_;
+
+    mutable std::mutex consumed_mutex_;
+    mutable std::unordered_set<std::string> consumed_;
+    mutable std::multimap<int64_t, std::string> consumed_expiry_;
+};
+
+#endif /* RESUMPTION_TICKET_H */
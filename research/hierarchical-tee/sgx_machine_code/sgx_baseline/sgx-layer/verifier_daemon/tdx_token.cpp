@@ -0,0 +1,337 @@
+#include "tdx_token.h"
+
+#include <string.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
+#define B64_INVALID 0xff
+
+// Built once on first use; function-local statics are initialised thread-safely
+struct base64url_table_t {
+    uint8_t value[256];
+    base64url_table_t() {
+        memset(value, B64_INVALID, sizeof(value));
+        const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+        for (int i = 0; i < 64; i++) {
+            value[(uint8_t)alphabet[i]] = (uint8_t)i;
+        }
+    }
+};
+
+static const uint8_t* base64url_table() {
+    static const base64url_table_t table;
+    return table.value;
+}
+
+#if defined(__SSE2__)
+static inline __m128i in_range(__m128i c, char lo, char hi) {
+    return _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8((char)(lo - 1))),
+                         _mm_cmplt_epi8(c, _mm_set1_epi8((char)(hi + 1))));
+}
+
+/* 16 characters to 12 bytes (writes 16); false if any is outside the alphabet. */
+static inline bool decode_block16(const uint8_t* in, uint8_t* out) {
+    __m128i c = _mm_loadu_si128((const __m128i*)in);
+    // Signed compares: bytes >= 0x80 are negative and fall in no range
+    __m128i upper = in_range(c, 'A', 'Z');
+    __m128i lower = in_range(c, 'a', 'z');
+    __m128i digit = in_range(c, '0', '9');
+    __m128i dash = _mm_cmpeq_epi8(c, _mm_set1_epi8('-'));
+    __m128i underscore = _mm_cmpeq_epi8(c, _mm_set1_epi8('_'));
+    __m128i valid = _mm_or_si128(_mm_or_si128(upper, lower),
+                                 _mm_or_si128(digit, _mm_or_si128(dash, underscore)));
+    if (_mm_movemask_epi8(valid) != 0xffff) {
+        return false;
+    }
+    
+    // Each class is a contiguous run of values, so the value is c plus the class offset
+    __m128i offset = _mm_or_si128(
+        _mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-'A')),
+                     _mm_and_si128(lower, _mm_set1_epi8(26 - 'a'))),
+        _mm_or_si128(_mm_and_si128(digit, _mm_set1_epi8(52 - '0')),
+                     _mm_or_si128(_mm_and_si128(dash, _mm_set1_epi8(62 - '-')),
+                                  _mm_and_si128(underscore, _mm_set1_epi8(63 - '_')))));
+    __m128i v = _mm_add_epi8(c, offset);
+    
+    // 6-bit pairs to 12 bits per u16, u16 pairs to 24 bits per u32 (big-endian bytes)
+    __m128i pairs = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(v, _mm_set1_epi16(0x00ff)), 6),
+                                 _mm_srli_epi16(v, 8));
+    __m128i lanes = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+#if defined(__SSSE3__)
+    __m128i order = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    _mm_storeu_si128((__m128i*)out, _mm_shuffle_epi8(lanes, order));
+#else
+    // Reverse the three bytes of each lane (b0 b1 b2 0 in memory), then four overlapping stores
+    __m128i b2 = _mm_and_si128(_mm_slli_epi32(lanes, 16), _mm_set1_epi32(0x00ff0000));
+    __m128i b1 = _mm_and_si128(lanes, _mm_set1_epi32(0x0000ff00));
+    __m128i b0 = _mm_srli_epi32(lanes, 16);
+    uint32_t word[4];
+    _mm_storeu_si128((__m128i*)word, _mm_or_si128(_mm_or_si128(b2, b1), b0));
+    memcpy(out, &word[0], 4);
+    memcpy(out + 3, &word[1], 4);
+    memcpy(out + 6, &word[2], 4);
+    memcpy(out + 9, &word[3], 4);
+#endif
+    return true;
+}
+#endif
+
+bool base64url_decode(const uint8_t* in, size_t len, std::vector<uint8_t>* out, size_t* out_len) {
+    const uint8_t* table = base64url_table();
+    // Tolerate the padding some encoders emit anyway
+    while (len > 0 && in[len - 1] == '=') {
+        len--;
+    }
+    if (len % 4 == 1) {
+        return false;
+    }
+    size_t need = len / 4 * 3 + (len % 4 ? len % 4 - 1 : 0);
+    // Slack for the 16-byte stores of the last block
+    if (out->size() < need + 4) {
+        out->resize(need + 4);
+    }
+    
+    uint8_t* dst = out->data();
+    size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 16 <= len; i += 16) {
+        if (!decode_block16(in + i, dst)) {
+            return false;
+        }
+        dst += 12;
+    }
+#endif
+    // Tail (or everything without SSE2); i is a multiple of 4 here
+    uint32_t acc = 0;
+    int bits = 0;
+    for (; i < len; i++) {
+        uint8_t v = table[in[i]];
+        if (v == B64_INVALID) {
+            return false;
+        }
+        acc = (acc << 6) | v;
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            *dst++ = (uint8_t)(acc >> bits);
+        }
+    }
+    *out_len = need;
+    return true;
+}
+
+bool span_equals(byte_span_t span, const char* str) {
+    size_t len = strlen(str);
+    return span.size == len && memcmp(span.data, str, len) == 0;
+}
+
+static const uint8_t* skip_ws(const uint8_t* p, const uint8_t* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) {
+        p++;
+    }
+    return p;
+}
+
+/* Closing quote of the string whose opening quote is at `q`, or NULL. */
+static const uint8_t* string_end(const uint8_t* q, const uint8_t* end) {
+    const uint8_t* p = q + 1;
+    while ((p = (const uint8_t*)memchr(p, '"', (size_t)(end - p))) != NULL) {
+        // Escaped if preceded by an odd run of backslashes
+        const uint8_t* b = p;
+        while (b > q + 1 && b[-1] == '\\') {
+            b--;
+        }
+        if ((p - b) % 2 == 0) {
+            return p;
+        }
+        p++;
+    }
+    return NULL;
+}
+
+bool json_find_string(const uint8_t* json, size_t len, const char* key, byte_span_t* out) {
+    const uint8_t* end = json + len;
+    size_t key_len = strlen(key);
+    const uint8_t* p = json;
+    while ((p = (const uint8_t*)memchr(p, '"', (size_t)(end - p))) != NULL) {
+        const uint8_t* close = string_end(p, end);
+        if (!close) {
+            return false;
+        }
+        const uint8_t* v = skip_ws(close + 1, end);
+        if ((size_t)(close - p - 1) == key_len && memcmp(p + 1, key, key_len) == 0 &&
+            v < end && *v == ':') {
+            v = skip_ws(v + 1, end);
+            const uint8_t* value_end = v < end && *v == '"' ? string_end(v, end) : NULL;
+            if (!value_end) {
+                return false;
+            }
+            out->data = v + 1;
+            out->size = (size_t)(value_end - v - 1);
+            return true;
+        }
+        p = close + 1;
+    }
+    return false;
+}
+
+enum claim_id_t {
+    CLAIM_ISS,
+    CLAIM_EXP,
+    CLAIM_TDX,
+    CLAIM_MRTD,
+    CLAIM_RTMR0,
+    CLAIM_RTMR1,
+    CLAIM_RTMR2,
+    CLAIM_RTMR3,
+    CLAIM_REPORT_DATA,
+    CLAIM_TCB_STATUS,
+    CLAIM_DEBUGGABLE,
+    CLAIM_COUNT
+};
+
+static const char* const claim_keys[CLAIM_COUNT] = {
+    "iss", "exp", "tdx", "tdx_mrtd", "tdx_rtmr0", "tdx_rtmr1", "tdx_rtmr2", "tdx_rtmr3",
+    "tdx_report_data", "attester_tcb_status", "tdx_is_debuggable"
+};
+
+static int claim_id(const uint8_t* key, size_t len) {
+    for (int i = 0; i < CLAIM_COUNT; i++) {
+        if (strlen(claim_keys[i]) == len && memcmp(claim_keys[i], key, len) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static bool parse_integer(const uint8_t* v, const uint8_t* end, int64_t* out) {
+    bool negative = v < end && *v == '-';
+    if (negative) {
+        v++;
+    }
+    if (v >= end || *v < '0' || *v > '9') {
+        return false;
+    }
+    int64_t value = 0;
+    while (v < end && *v >= '0' && *v <= '9' && value < (INT64_MAX - 9) / 10) {
+        value = value * 10 + (*v++ - '0');
+    }
+    *out = negative ? -value : value;
+    return true;
+}
+
+/*
+ * One pass over the payload: every string is skipped whole, and only a
+ * string followed by ':' is looked up as a key. Returns which of iss/exp
+ * were found as flags (1 << CLAIM_ISS | 1 << CLAIM_EXP).
+ */
+static unsigned scan_claims(const uint8_t* json, size_t len, tdx_token_claims_t* claims) {
+    const uint8_t* end = json + len;
+    const uint8_t* p = json;
+    unsigned found = 0;
+    while ((p = (const uint8_t*)memchr(p, '"', (size_t)(end - p))) != NULL) {
+        const uint8_t* close = string_end(p, end);
+        if (!close) {
+            break;
+        }
+        const uint8_t* v = skip_ws(close + 1, end);
+        int id = v < end && *v == ':' ? claim_id(p + 1, (size_t)(close - p - 1)) : -1;
+        p = close + 1;
+        if (id < 0) {
+            continue;
+        }
+        v = skip_ws(v + 1, end);
+        byte_span_t str = {NULL, 0};
+        if (v < end && *v == '"') {
+            const uint8_t* value_end = string_end(v, end);
+            if (!value_end) {
+                break;
+            }
+            str.data = v + 1;
+            str.size = (size_t)(value_end - v - 1);
+            p = value_end + 1;
+        }
+        
+        switch (id) {
+        case CLAIM_ISS:
+            if (str.data) {
+                claims->issuer = str;
+                found |= 1u << CLAIM_ISS;
+            }
+            break;
+        case CLAIM_EXP:
+            if (parse_integer(v, end, &claims->exp)) {
+                found |= 1u << CLAIM_EXP;
+            }
+            break;
+        case CLAIM_TDX:
+            claims->has_tdx = true;
+            break;
+        case CLAIM_MRTD:
+            claims->mrtd = str;
+            break;
+        case CLAIM_RTMR0:
+        case CLAIM_RTMR1:
+        case CLAIM_RTMR2:
+        case CLAIM_RTMR3:
+            claims->rtmr[id - CLAIM_RTMR0] = str;
+            break;
+        case CLAIM_REPORT_DATA:
+            claims->report_data = str;
+            break;
+        case CLAIM_TCB_STATUS:
+            claims->tcb_status = str;
+            break;
+        case CLAIM_DEBUGGABLE:
+            if (end - v >= 4 && memcmp(v, "true", 4) == 0) {
+                claims->is_debuggable = true;
+            }
+            break;
+        }
+    }
+    return found;
+}
+
+tdx_token_status_t parse_tdx_token(byte_span_t token, tdx_token_scratch_t* scratch,
+                                   tdx_token_claims_t* claims) {
+    memset(claims, 0, sizeof(*claims));
+    
+    // header.payload.signature
+    const uint8_t* end = token.data + token.size;
+    const uint8_t* dot1 = (const uint8_t*)memchr(token.data, '.', token.size);
+    if (!dot1) {
+        return TDX_TOKEN_BAD_FORMAT;
+    }
+    const uint8_t* payload = dot1 + 1;
+    const uint8_t* dot2 = (const uint8_t*)memchr(payload, '.', (size_t)(end - payload));
+    if (!dot2 || memchr(dot2 + 1, '.', (size_t)(end - dot2 - 1)) != NULL) {
+        return TDX_TOKEN_BAD_FORMAT;
+    }
+    claims->signing_input.data = token.data;
+    claims->signing_input.size = (size_t)(dot2 - token.data);
+    
+    size_t header_len = 0;
+    size_t signature_len = 0;
+    if (!base64url_decode(token.data, (size_t)(dot1 - token.data), &scratch->header, &header_len) ||
+        !base64url_decode(dot2 + 1, (size_t)(end - dot2 - 1), &scratch->signature, &signature_len)) {
+        return TDX_TOKEN_BAD_FORMAT;
+    }
+    json_find_string(scratch->header.data(), header_len, "alg", &claims->alg);
+    json_find_string(scratch->header.data(), header_len, "kid", &claims->kid);
+    claims->signature.data = scratch->signature.data();
+    claims->signature.size = signature_len;
+    
+    size_t json_len = 0;
+    if (!base64url_decode(payload, (size_t)(dot2 - payload), &scratch->payload, &json_len)) {
+        return TDX_TOKEN_BAD_PAYLOAD;
+    }
+    unsigned found = scan_claims(scratch->payload.data(), json_len, claims);
+    if (found != (1u << CLAIM_ISS | 1u << CLAIM_EXP)) {
+        return TDX_TOKEN_BAD_PAYLOAD;
+    }
+    return TDX_TOKEN_OK;
+}
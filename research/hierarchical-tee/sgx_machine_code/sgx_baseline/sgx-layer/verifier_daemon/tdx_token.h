@@ -0,0 +1,64 @@
+#ifndef TDX_TOKEN_H
+#define TDX_TOKEN_H
+
+#include <stdint.h>
+#include <vector>
+#include "composite_evidence.h"
+
+/*
+ * Claims the verifier needs from an Intel Trust Authority JWT: the set
+ * TDXTokenVerifier.verify() in tdx_verifier_service.py reads, plus what
+ * the signature check needs (jwks_cache.h).
+ *
+ * The three segments are base64url-decoded into caller-owned scratch
+ * buffers reused across requests (16 characters per SSE2 step); string
+ * claims are views into those buffers, signing_input is a view into the
+ * token itself.
+ *
+ * Claims come from one pass over the payload that only stops at keys, not
+ * from a full JSON parse. Every key looked up is unique in the ITA payload
+ * ("exp" only appears at the top level, the tdx_* claims only under
+ * "tdx"), so this is unambiguous for these tokens.
+ */
+typedef struct {
+    std::vector<uint8_t> header;
+    std::vector<uint8_t> payload;
+    std::vector<uint8_t> signature;
+} tdx_token_scratch_t;
+
+#define TDX_TOKEN_RTMRS 4
+
+typedef struct {
+    byte_span_t alg;            /* JOSE header */
+    byte_span_t kid;
+    byte_span_t signing_input;  /* "header.payload", as signed */
+    byte_span_t signature;      /* decoded */
+    byte_span_t issuer;
+    int64_t exp;
+    bool has_tdx;
+    byte_span_t mrtd;
+    byte_span_t rtmr[TDX_TOKEN_RTMRS];
+    byte_span_t report_data;   /* hex, 128 characters */
+    byte_span_t tcb_status;
+    bool is_debuggable;
+} tdx_token_claims_t;
+
+enum tdx_token_status_t {
+    TDX_TOKEN_OK = 0,
+    TDX_TOKEN_BAD_FORMAT,   /* not three base64url segments */
+    TDX_TOKEN_BAD_PAYLOAD   /* payload does not decode or lacks iss/exp */
+};
+
+tdx_token_status_t parse_tdx_token(byte_span_t token, tdx_token_scratch_t* scratch,
+                                   tdx_token_claims_t* claims);
+
+/* Decode unpadded base64url into `out` (grown, never shrunk); false on a
+ * character outside the alphabet. */
+bool base64url_decode(const uint8_t* in, size_t len, std::vector<uint8_t>* out, size_t* out_len);
+
+/* String value of the first `"key":` in `json`, as a view; no unescaping. */
+bool json_find_string(const uint8_t* json, size_t len, const char* key, byte_span_t* out);
+
+bool span_equals(byte_span_t span, const char* str);
+
+#endif /* TDX_TOKEN_H */
@@ -0,0 +1,192 @@
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <thread>
+#include "bench_clock.h"
+#include "evidence_verifier.h"
+#include "latency_histogram.h"
+#include "trace_span.h"
+#include "verifier_server.h"
+
+#define DEFAULT_PORT 9999
+#define DEFAULT_IDLE_TIMEOUT_S 30
+#define MAX_WORKERS 256
+
+static void print_usage(const char* prog) {
+    printf("Usage: %s [port] [--workers N] [--idle-timeout S] [--trusted-mrtd HEX]... [--allow-debug] [--no-cache]\n"
+           "       [--require-enclave-binding] [--policy FILE] [--jwks FILE] [--trace FILE]\n"
+           "  --policy replaces --trusted-mrtd/--allow-debug/--require-enclave-binding;\n"
+           "  SIGHUP reloads it (see policy_engine.h for the format)\n"
+           "  --trace writes spans of traced evidence at shutdown (*.otlp.json: OTLP, else Chrome)\n",
+           prog);
+}
+
+static void print_cache_stats(const char* label, cache_stats_t stats) {
+    uint64_t lookups = stats.hits + stats.misses;
+    printf("%-16s %lu hits, %lu misses (%.1f%% hit rate), %lu inserts\n", label,
+           (unsigned long)stats.hits, (unsigned long)stats.misses,
+           lookups ? 100.0 * stats.hits / lookups : 0.0, (unsigned long)stats.insertions);
+}
+
+int main(int argc, char* argv[]) {
+    int port = DEFAULT_PORT;
+    int workers = (int)std::thread::hardware_concurrency();
+    int idle_timeout = DEFAULT_IDLE_TIMEOUT_S;
+    bool cache = true;
+    const char* jwks_path = NULL;
+    const char* policy_path = NULL;
+    const char* trace_path = NULL;
+    bool policy_flags = false;
+    EvidenceVerifier verifier;
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            workers = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--idle-timeout") == 0 && i + 1 < argc) {
+            idle_timeout = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--trusted-mrtd") == 0 && i + 1 < argc) {
+            policy_flags = true;
+            if (!verifier.add_trusted_mrtd(argv[++i])) {
+                printf("✗ MRTD must be 96 hex characters: %s\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--policy") == 0 && i + 1 < argc) {
+            policy_path = argv[++i];
+        } else if (strcmp(argv[i], "--jwks") == 0 && i + 1 < argc) {
+            jwks_path = argv[++i];
+            if (!verifier.load_jwks(jwks_path)) {
+                printf("✗ No RSA signing keys in %s\n", jwks_path);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            trace_path = argv[++i];
+        } else if (strcmp(argv[i], "--allow-debug") == 0) {
+            policy_flags = true;
+            verifier.set_allow_debug(true);
+        } else if (strcmp(argv[i], "--require-enclave-binding") == 0) {
+            policy_flags = true;
+            verifier.set_require_enclave_binding(true);
+        } else if (strcmp(argv[i], "--no-cache") == 0) {
+            cache = false;
+            verifier.set_cache(false);
+        } else if (argv[i][0] == '-') {
+            print_usage(argv[0]);
+            return 1;
+        } else {
+            port = atoi(argv[i]);
+        }
+    }
+    if (port <= 0 || port > 65535 || idle_timeout < 0 || (policy_path && policy_flags)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (workers <= 0 || workers > MAX_WORKERS) {
+        workers = 4;
+    }
+    
+    std::string policy_error;
+    if (policy_path ? !verifier.load_policy(policy_path, &policy_error)
+                    : !verifier.reload_policy(&policy_error)) {
+        printf("✗ Policy %s: %s\n", policy_path ? policy_path : "command line", policy_error.c_str());
+        return 1;
+    }
+    
+    quote3_error_t qv_ret = verifier.init();
+    if (qv_ret != SGX_QL_SUCCESS) {
+        printf("✗ DCAP quote verification library unavailable: 0x%x\n", qv_ret);
+        printf("  Install libsgx-dcap-quote-verify and configure /etc/sgx_default_qcnl.conf\n");
+        return 1;
+    }
+    
+    // Workers inherit the blocked mask; only this thread takes SIGINT/SIGTERM/SIGHUP
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    sigaddset(&signals, SIGHUP);
+    pthread_sigmask(SIG_BLOCK, &signals, NULL);
+    
+    bench_clock();  // calibrate before the workers time anything
+    VerifierServer server(&verifier);
+    TraceRecorder trace("verifier");
+    if (trace_path) {
+        server.set_trace(&trace);
+    }
+    if (!server.start(port, workers, idle_timeout)) {
+        printf("✗ Failed to listen on port %d\n", port);
+        return 1;
+    }
+    
+    printf("======================================================================\n");
+    printf("Composite SGX+TDX Verifier Daemon\n");
+    printf("======================================================================\n");
+    printf("Port:          %d\n", port);
+    printf("Workers:       %d (epoll, SO_REUSEPORT)\n", workers);
+    printf("Idle timeout:  %d s\n", idle_timeout);
+    const CompiledPolicy& policy = verifier.policy();
+    printf("Policy:        %s, %zu measurements (SIGHUP reloads)\n",
+           policy_path ? policy_path : "command line", policy.measurement_count());
+    printf("Binding:       %s\n", policy.require_enclave_binding()
+                                       ? "SHA256(MRENCLAVE || purpose || nonce)"
+                                       : "report_data match");
+    if (jwks_path) {
+        printf("Token sig.:    RS/PS 256/384/512, %zu keys from %s\n", verifier.jwks_key_count(), jwks_path);
+    } else {
+        printf("Token sig.:    not checked (no --jwks)\n");
+    }
+    printf("Caches:        %s\n", cache ? "verdicts (token exp), collateral (nextUpdate)" : "off");
+    printf("Tracing:       %s\n", trace_path ? trace_path : "off");
+    printf("======================================================================\n");
+    printf("\nWaiting for composite attestations...\n");
+    
+    double start = bench_now_ms();
+    int sig = 0;
+    while (sigwait(&signals, &sig) == 0 && sig == SIGHUP) {
+        // Compiled off to the side; workers switch on their next batch
+        if (verifier.reload_policy(&policy_error)) {
+            printf("✓ Policy reloaded: generation %u, %zu measurements\n",
+                   verifier.policy().generation(), verifier.policy().measurement_count());
+        } else {
+            printf("✗ Policy reload failed, keeping generation %u: %s\n",
+                   verifier.policy().generation(), policy_error.c_str());
+        }
+        fflush(stdout);
+    }
+    printf("\n\nShutting down...\n");
+    server.stop();
+    server.join();
+    double uptime_s = (bench_now_ms() - start) / 1000.0;
+    
+    verifier_server_stats_t stats = server.stats();
+    LatencyHistogram verify_hist = server.verify_latency();
+    printf("\n======================================================================\n");
+    printf("Service Statistics\n");
+    printf("======================================================================\n");
+    printf("Connections:     %lu\n", (unsigned long)stats.connections);
+    printf("Total requests:  %lu (%.1f/s over %.1f s)\n", (unsigned long)stats.requests,
+           uptime_s > 0 ? stats.requests / uptime_s : 0.0, uptime_s);
+    printf("Verified:        %lu\n", (unsigned long)stats.trusted);
+    printf("Failed:          %lu (%lu malformed frames)\n", (unsigned long)stats.rejected,
+           (unsigned long)stats.bad_frames);
+    printf("Received:        %.1f MB\n", stats.bytes_in / 1e6);
+    printf("Collateral:      %lu fetches (%lu failed)\n",
+           (unsigned long)verifier.quote_verifier().collateral_fetches(),
+           (unsigned long)verifier.quote_verifier().collateral_fetch_failures());
+    print_cache_stats("Verdict cache:", verifier.verdict_cache_stats());
+    print_cache_stats("Collat. cache:", verifier.quote_verifier().collateral_cache_stats());
+    print_latency_header();
+    print_latency_row("verify (batch)", verify_hist);
+    if (trace_path) {
+        if (trace.write(trace_path)) {
+            printf("Trace:           %zu spans to %s (%lu dropped)\n", trace.size(), trace_path,
+                   (unsigned long)trace.dropped());
+        } else {
+            printf("✗ Failed to write spans to %s\n", trace_path);
+        }
+    }
+    printf("======================================================================\n");
+    return 0;
+}
@@ -0,0 +1,480 @@
+#include "verifier_server.h"
+
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unordered_set>
+#include "bench_clock.h"
+#include "composite_evidence.h"
+#include "quote_parser.h"
+#include "trace_span.h"
+#include "verifier_protocol.h"
+
+#define RECV_BUFFER_INITIAL (64 * 1024)
+#define SEND_HIGH_WATER (256 * 1024)  /* stop reading while this many verdict bytes are unsent */
+#define EPOLL_BATCH 64
+#define VERIFY_BATCH_MAX 64  /* pipelined frames verified together, sharing collateral */
+#define POLL_INTERVAL_MS 200
+
+struct verifier_connection_t {
+    int fd;
+    std::vector<uint8_t> in;
+    size_t in_len;
+    std::vector<uint8_t> out;
+    size_t out_off;
+    uint32_t sequence;
+    time_t last_active;
+    bool closing;   /* framing lost or peer closed: flush verdicts, then close */
+    int64_t head_arrival_ns;   /* tracing only: first byte of the frame at in[0] */
+    int64_t last_read_ns;
+};
+
+/* Tracing only: when a frame arrived and how long its parse took. */
+typedef struct {
+    int64_t arrival_ns;
+    int64_t decode_start_ns;
+    int64_t decode_end_ns;
+} frame_timing_t;
+
+struct VerifierServer::worker_t {
+    int listen_fd;
+    int epoll_fd;
+    std::thread thread;
+    std::unordered_set<verifier_connection_t*> connections;
+    verify_scratch_t scratch;
+    composite_evidence_t batch_evidence[VERIFY_BATCH_MAX];
+    verdict_record_t batch_verdicts[VERIFY_BATCH_MAX];
+    bool batch_parsed[VERIFY_BATCH_MAX];
+    frame_timing_t batch_timing[VERIFY_BATCH_MAX];
+    LatencyHistogram verify_hist;
+    verifier_server_stats_t stats;
+};
+
+static int open_listener(int port) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) != 0) {
+        close(fd);
+        return -1;
+    }
+    
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons((uint16_t)port);
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, SOMAXCONN) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+VerifierServer::VerifierServer(const EvidenceVerifier* verifier)
+    : verifier_(verifier), trace_(NULL), idle_timeout_s_(0), running_(false) {
+}
+
+void VerifierServer::set_trace(TraceRecorder* trace) {
+    trace_ = trace;
+}
+
+VerifierServer::~VerifierServer() {
+    stop();
+    join();
+    for (size_t i = 0; i < workers_.size(); i++) {
+        delete workers_[i];
+    }
+}
+
+bool VerifierServer::start(int port, int workers, int idle_timeout_s) {
+    if (!workers_.empty() || workers <= 0) {
+        return false;
+    }
+    idle_timeout_s_ = idle_timeout_s;
+    
+    for (int i = 0; i < workers; i++) {
+        worker_t* worker = new worker_t();
+        worker->listen_fd = open_listener(port);
+        worker->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        workers_.push_back(worker);
+        
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN | EPOLLET;
+        ev.data.ptr = NULL;  // NULL marks the listener
+        if (worker->listen_fd < 0 || worker->epoll_fd < 0 ||
+            epoll_ctl(worker->epoll_fd, EPOLL_CTL_ADD, worker->listen_fd, &ev) != 0) {
+            return false;
+        }
+    }
+    
+    running_.store(true);
+    for (size_t i = 0; i < workers_.size(); i++) {
+        workers_[i]->thread = std::thread(&VerifierServer::run_worker, this, workers_[i]);
+    }
+    return true;
+}
+
+void VerifierServer::stop() {
+    running_.store(false);
+}
+
+void VerifierServer::join() {
+    for (size_t i = 0; i < workers_.size(); i++) {
+        worker_t* worker = workers_[i];
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+        std::unordered_set<verifier_connection_t*> open(worker->connections);
+        for (std::unordered_set<verifier_connection_t*>::iterator it = open.begin();
+             it != open.end(); ++it) {
+            close_connection(worker, *it);
+        }
+        if (worker->listen_fd >= 0) {
+            close(worker->listen_fd);
+            worker->listen_fd = -1;
+        }
+        if (worker->epoll_fd >= 0) {
+            close(worker->epoll_fd);
+            worker->epoll_fd = -1;
+        }
+    }
+}
+
+verifier_server_stats_t VerifierServer::stats() const {
+    verifier_server_stats_t total;
+    memset(&total, 0, sizeof(total));
+    for (size_t i = 0; i < workers_.size(); i++) {
+        const verifier_server_stats_t& s = workers_[i]->stats;
+        total.connections += s.connections;
+        total.requests += s.requests;
+        total.trusted += s.trusted;
+        total.rejected += s.rejected;
+        total.bad_frames += s.bad_frames;
+        total.bytes_in += s.bytes_in;
+    }
+    return total;
+}
+
+LatencyHistogram VerifierServer::verify_latency() const {
+    LatencyHistogram merged;
+    for (size_t i = 0; i < workers_.size(); i++) {
+        merged.merge(workers_[i]->verify_hist);
+    }
+    return merged;
+}
+
+void VerifierServer::run_worker(worker_t* worker) {
+    struct epoll_event events[EPOLL_BATCH];
+    time_t last_sweep = time(NULL);
+    
+    while (running_.load(std::memory_order_relaxed)) {
+        int n = epoll_wait(worker->epoll_fd, events, EPOLL_BATCH, POLL_INTERVAL_MS);
+        if (n < 0 && errno != EINTR) {
+            break;
+        }
+        for (int i = 0; i < n; i++) {
+            if (events[i].data.ptr == NULL) {
+                accept_connections(worker);
+            } else {
+                handle_event(worker, (verifier_connection_t*)events[i].data.ptr, events[i].events);
+            }
+        }
+        
+        time_t now = time(NULL);
+        if (idle_timeout_s_ > 0 && now != last_sweep) {
+            close_idle(worker, now);
+            last_sweep = now;
+        }
+    }
+}
+
+void VerifierServer::accept_connections(worker_t* worker) {
+    for (;;) {
+        int fd = accept4(worker->listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            // EAGAIN: drained; anything else (EMFILE, ECONNABORTED) is retried on the next edge
+            return;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        
+        verifier_connection_t* conn = new verifier_connection_t();
+        conn->fd = fd;
+        conn->in.resize(RECV_BUFFER_INITIAL);
+        conn->in_len = 0;
+        conn->out_off = 0;
+        conn->sequence = 0;
+        conn->last_active = time(NULL);
+        conn->closing = false;
+        conn->head_arrival_ns = 0;
+        conn->last_read_ns = 0;
+        
+        // Edge-triggered for both directions, so EPOLLOUT never needs re-arming
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        ev.data.ptr = conn;
+        if (epoll_ctl(worker->epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            close(fd);
+            delete conn;
+            continue;
+        }
+        worker->connections.insert(conn);
+        worker->stats.connections++;
+    }
+}
+
+static size_t unsent(const verifier_connection_t* conn) {
+    return conn->out.size() - conn->out_off;
+}
+
+void VerifierServer::handle_event(worker_t* worker, verifier_connection_t* conn, uint32_t events) {
+    if (events & EPOLLERR) {
+        close_connection(worker, conn);
+        return;
+    }
+    conn->last_active = time(NULL);
+    
+    for (;;) {
+        // Verdicts first: draining them may lift read back-pressure
+        if (!flush_output(conn)) {
+            close_connection(worker, conn);
+            return;
+        }
+        if (unsent(conn) >= SEND_HIGH_WATER) {
+            return;  // send() hit EAGAIN, the next EPOLLOUT edge resumes here
+        }
+        bool filled = conn->closing ? false : read_input(worker, conn);
+        bool stalled = process_frames(worker, conn);
+        if (filled || stalled) {
+            continue;
+        }
+        if (!flush_output(conn)) {
+            close_connection(worker, conn);
+        } else if (conn->closing && unsent(conn) == 0) {
+            close_connection(worker, conn);
+        }
+        return;
+    }
+}
+
+/* Receive until EAGAIN or the buffer is full; true if it filled up. */
+bool VerifierServer::read_input(worker_t* worker, verifier_connection_t* conn) {
+    for (;;) {
+        if (conn->in_len == conn->in.size()) {
+            return true;
+        }
+        ssize_t n = recv(conn->fd, conn->in.data() + conn->in_len, conn->in.size() - conn->in_len, 0);
+        if (n > 0) {
+            if (trace_) {
+                conn->last_read_ns = trace_now_ns();
+                if (conn->in_len == 0) {
+                    conn->head_arrival_ns = conn->last_read_ns;
+                }
+            }
+            conn->in_len += (size_t)n;
+            worker->stats.bytes_in += (uint64_t)n;
+        } else if (n == 0) {
+            conn->closing = true;
+            return false;
+        } else if (errno == EINTR) {
+            continue;
+        } else {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                conn->closing = true;
+            }
+            return false;
+        }
+    }
+}
+
+static void queue_verdict(verifier_connection_t* conn, const verdict_record_t& record) {
+    uint8_t wire[VERDICT_SIZE];
+    verdict_encode(&record, wire);
+    conn->out.insert(conn->out.end(), wire, wire + VERDICT_SIZE);
+}
+
+/* Receive, decode and verify spans, if the frame's quote carries a trace ID. */
+static void trace_frame(TraceRecorder* trace, const composite_evidence_t& evidence,
+                        const frame_timing_t& timing, int64_t verify_start, int64_t verify_end) {
+    SgxQuote3View quote;
+    trace_id_t id;
+    if (quote.parse(evidence.sgx_quote.data, evidence.sgx_quote.size) != QUOTE_OK ||
+        !trace_id_from_report_data(quote.report_data(), &id)) {
+        return;
+    }
+    uint64_t parent = trace->record(id, trace_root_span_id(id), "verifier.request",
+                                    timing.arrival_ns, verify_end);
+    trace->record(id, parent, "verifier.receive", timing.arrival_ns, timing.decode_start_ns);
+    trace->record(id, parent, "verifier.decode", timing.decode_start_ns, timing.decode_end_ns);
+    trace->record(id, parent, "verifier.verify", verify_start, verify_end);
+}
+
+/* Verify a batch of `count` frames, `parsed` of which are well-formed, and
+ * queue their verdicts in arrival order. */
+void VerifierServer::verify_batch(worker_t* worker, verifier_connection_t* conn,
+                                  size_t count, size_t parsed) {
+    int64_t trace_start = trace_ ? trace_now_ns() : 0;
+    uint64_t start = bench_now_ticks();
+    verifier_->verify_batch(worker->batch_evidence, parsed, time(NULL), &worker->scratch,
+                            worker->batch_verdicts);
+    uint64_t batch_ns = (uint64_t)bench_ticks_to_ns(bench_now_ticks() - start);
+    int64_t trace_end = trace_ ? trace_now_ns() : 0;
+    
+    size_t next = 0;
+    for (size_t i = 0; i < count; i++) {
+        verdict_record_t record;
+        if (worker->batch_parsed[i]) {
+            if (trace_) {
+                trace_frame(trace_, worker->batch_evidence[next], worker->batch_timing[i],
+                            trace_start, trace_end);
+            }
+            record = worker->batch_verdicts[next++];
+            worker->verify_hist.record_ns(batch_ns);  // what this frame waited
+        } else {
+            memset(&record, 0, sizeof(record));
+            record.error = VERIFY_ERROR_FRAME;
+            worker->stats.bad_frames++;
+        }
+        record.sequence = conn->sequence++;
+        queue_verdict(conn, record);
+        worker->stats.requests++;
+        if (record.verdict == VERDICT_TRUSTED) {
+            worker->stats.trusted++;
+        } else {
+            worker->stats.rejected++;
+        }
+    }
+}
+
+/* Verify every complete frame; true if it stopped early on back-pressure. */
+bool VerifierServer::process_frames(worker_t* worker, verifier_connection_t* conn) {
+    size_t offset = 0;
+    size_t grow_to = 0;
+    bool stalled = false;
+    bool framing_lost = false;
+    bool batch_full = true;
+    
+    while (batch_full && !stalled && !framing_lost && grow_to == 0) {
+        size_t count = 0;
+        size_t parsed = 0;
+        while (count < VERIFY_BATCH_MAX) {
+            if (unsent(conn) + count * VERDICT_SIZE >= SEND_HIGH_WATER) {
+                stalled = conn->in_len > offset;
+                break;
+            }
+            const uint8_t* frame = conn->in.data() + offset;
+            size_t available = conn->in_len - offset;
+            size_t frame_len = 0;
+            composite_status_t status = composite_evidence_frame_length(frame, available, &frame_len);
+            if (status == COMPOSITE_TRUNCATED) {
+                break;
+            }
+            if (status != COMPOSITE_OK) {
+                framing_lost = true;
+                break;
+            }
+            if (available < frame_len) {
+                grow_to = frame_len;
+                break;
+            }
+            
+            // Spans stay valid until the buffer is compacted or grown below
+            int64_t decode_start = trace_ ? trace_now_ns() : 0;
+            worker->batch_parsed[count] = composite_evidence_parse(
+                frame, frame_len, &worker->batch_evidence[parsed]) == COMPOSITE_OK;
+            if (trace_) {
+                frame_timing_t* timing = &worker->batch_timing[count];
+                timing->arrival_ns = conn->head_arrival_ns;
+                timing->decode_start_ns = decode_start;
+                timing->decode_end_ns = trace_now_ns();
+                // The next frame is already buffered: it came with the latest read
+                conn->head_arrival_ns = conn->last_read_ns;
+            }
+            if (worker->batch_parsed[count]) {
+                parsed++;
+            }
+            count++;
+            offset += frame_len;
+        }
+        batch_full = count == VERIFY_BATCH_MAX;
+        if (count > 0) {
+            verify_batch(worker, conn, count, parsed);
+        }
+    }
+    
+    if (framing_lost) {
+        // Cannot find the next frame boundary: report and hang up
+        verdict_record_t record;
+        memset(&record, 0, sizeof(record));
+        record.sequence = conn->sequence++;
+        record.error = VERIFY_ERROR_FRAME;
+        queue_verdict(conn, record);
+        worker->stats.requests++;
+        worker->stats.bad_frames++;
+        worker->stats.rejected++;
+        conn->closing = true;
+        offset = conn->in_len;
+    }
+    
+    // Keep a partial frame at the front of the buffer for the next read
+    if (offset > 0) {
+        memmove(conn->in.data(), conn->in.data() + offset, conn->in_len - offset);
+        conn->in_len -= offset;
+    }
+    if (conn->in.size() < grow_to) {
+        conn->in.resize(grow_to);  // bounded by COMPOSITE_FRAME_MAX
+    }
+    return stalled;
+}
+
+/* Send queued verdicts until done or EAGAIN; false on a dead socket. */
+bool VerifierServer::flush_output(verifier_connection_t* conn) {
+    while (conn->out_off < conn->out.size()) {
+        ssize_t n = send(conn->fd, conn->out.data() + conn->out_off,
+                         conn->out.size() - conn->out_off, MSG_NOSIGNAL);
+        if (n > 0) {
+            conn->out_off += (size_t)n;
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return true;
+        } else {
+            return false;
+        }
+    }
+    // Everything sent: reuse the buffer from the start
+    conn->out.clear();
+    conn->out_off = 0;
+    return true;
+}
+
+void VerifierServer::close_connection(worker_t* worker, verifier_connection_t* conn) {
+    epoll_ctl(worker->epoll_fd, EPOLL_CTL_DEL, conn->fd, NULL);
+    close(conn->fd);
+    worker->connections.erase(conn);
+    delete conn;
+}
+
+void VerifierServer::close_idle(worker_t* worker, time_t now) {
+    std::vector<verifier_connection_t*> idle;
+    for (std::unordered_set<verifier_connection_t*>::iterator it = worker->connections.begin();
+         it != worker->connections.end(); ++it) {
+        if (now - (*it)->last_active > idle_timeout_s_) {
+            idle.push_back(*it);
+        }
+    }
+    for (size_t i = 0; i < idle.size(); i++) {
+        close_connection(worker, idle[i]);
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef VERIFIER_SERVER_H
+#define VERIFIER_SERVER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "evidence_verifier.h"
+#include "latency_histogram.h"
+
+struct verifier_connection_t;
+class TraceRecorder;
+
+/* Totals over all workers; read after join(). */
+typedef struct {
+    uint64_t connections;
+    uint64_t requests;
+    uint64_t trusted;
+    uint64_t rejected;
+    uint64_t bad_frames;
+    uint64_t bytes_in;
+} verifier_server_stats_t;
+
+/*
+ * Multi-threaded epoll server for composite evidence (verifier_protocol.h).
+ *
+ * Every worker owns a SO_REUSEPORT listening socket and an edge-triggered
+ * epoll set, so the kernel spreads new connections across workers and no
+ * connection state is shared between threads. Sockets are non-blocking:
+ * a slow prover only occupies its own buffers instead of stalling the
+ * accept loop the way the Python service's blocking recv() does.
+ *
+ * Connections are keep-alive and requests may be pipelined. Each
+ * connection receives into one contiguous buffer, frames are parsed in
+ * place, and the complete frames of each read are verified as one batch
+ * (EvidenceVerifier::verify_batch) with verdicts queued in order. Reading
+ * pauses while a client is not draining its verdicts, and connections
+ * idle for longer than the timeout are closed.
+ *
+ * With set_trace(), every frame whose quote carries a trace ID
+ * (trace_span.h) gets receive, decode and verify spans. Receive runs from
+ * the frame's first byte to decode start. For a frame that was already in
+ * the buffer behind another one, it starts at the read that delivered it.
+ */
+class VerifierServer {
+public:
+    explicit VerifierServer(const EvidenceVerifier* verifier);
+    ~VerifierServer();
+
+    /* Spans for traced evidence, NULL (the default) for none; call before start(). */
+    void set_trace(TraceRecorder* trace);
+
+    /* Bind every worker's listener, then start the workers. */
+    bool start(int port, int workers, int idle_timeout_s);
+
+    /* Ask the workers to exit; they notice within one poll interval. */
+    void stop();
+    void join();
+
+    verifier_server_stats_t stats() const;
+    LatencyHistogram verify_latency() const;
+
+private:
+    VerifierServer(const VerifierServer&);
+    VerifierServer& operator=(const VerifierServer&);
+
+    struct worker_t;
+
+    void run_worker(worker_t* worker);
+    void accept_connections(worker_t* worker);
+    void handle_event(worker_t* worker, verifier_connection_t* conn, uint32_t events);
+    bool read_input(worker_t* worker, verifier_connection_t* conn);
+    bool process_frames(worker_t* worker, verifier_connection_t* conn);
+    void verify_batch(worker_t* worker, verifier_connection_t* conn, size_t count, size_t parsed);
+    bool flush_output(verifier_connection_t* conn);
+    void close_connection(worker_t* worker, verifier_connection_t* conn);
+    void close_idle(worker_t* worker, time_t now);
+
+    const EvidenceVerifier* verifier_;
+    TraceRecorder* trace_;
+    int idle_timeout_s_;
+    std::atomic<bool> running_;
+    std::vector<worker_t*> workers_;
+};
+
+#endif /* VERIFIER_SERVER_H */
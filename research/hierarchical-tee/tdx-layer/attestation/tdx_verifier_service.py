@@ -17,6 +17,12 @@ Example:
     
     # On TDX machine (prover)
     python3 tdx_remote_attestation.py  # or use the client
+
+This service handles one client at a time. For composite SGX+TDX evidence
+at fleet request rates, use the native verifier daemon instead
+(sgx_machine_code/sgx_baseline/sgx-layer/verifier_daemon). It speaks the
+binary frame format of docs/05-sgx-integration.md over keep-alive,
+pipelined connections.
 """
 
 import socket
@@ -163,6 +169,10 @@ class TDXTokenVerifier:
         return None
 
 
+# Tokens larger than this are truncated (JWTs are typically < 10KB)
+MAX_TOKEN_SIZE = 50000
+
+
 class TDXVerifierService:
     """
     Network service for TDX attestation verification
@@ -174,6 +184,10 @@ class TDXVerifierService:
     def __init__(self, port: int = 9999):
         self.port = port
         self.verifier = TDXTokenVerifier()
+        # Clients are served one at a time, so a single receive buffer is
+        # reused for every request instead of growing bytes per chunk
+        self.recv_buffer = bytearray(MAX_TOKEN_SIZE)
+        self.recv_view = memoryview(self.recv_buffer)
         self.stats = {
             "total_requests": 0,
             "verified": 0,
@@ -229,34 +243,31 @@ class TDXVerifierService:
         """Handle incoming attestation request"""
         receive_start = time.time()
         
-        # Receive token data
-        data = b""
+        # Receive token data straight into the preallocated buffer
+        received = 0
         client.settimeout(10)
         try:
-            while True:
-                chunk = client.recv(4096)
-                if not chunk:
-                    break
-                data += chunk
-                # Check for reasonable token size (JWTs are typically < 10KB)
-                if len(data) > 50000:
+            while received < MAX_TOKEN_SIZE:
+                n = client.recv_into(self.recv_view[received:])
+                if n == 0:
                     break
+                received += n
         except socket.timeout:
             pass
         
         receive_time = (time.time() - receive_start) * 1000
         
-        if not data:
+        if received == 0:
             client.close()
             return
         
         self.stats["total_requests"] += 1
         
         # Decode and verify
-        token_str = data.decode('utf-8').strip()
+        token_str = str(self.recv_view[:received], 'utf-8').strip()
         
         print(f"[{self.stats['total_requests']}] Request from {addr[0]}:{addr[1]}")
-        print(f"    Received: {len(data)} bytes ({receive_time:.2f} ms)")
+        print(f"    Received: {received} bytes ({receive_time:.2f} ms)")
         
         # Verify token
         verify_start = time.time()
@@ -0,0 +1,101 @@
+#include "binding_aggregator.h"
+
+#include <errno.h>
+#include <string.h>
+#include <chrono>
+#include "bench_clock.h"
+
+struct BindingAggregator::pending_t {
+    pending_t() : count(0), done(false) {}
+    
+    std::vector<uint8_t> bindings;   /* 32 bytes per submitter, in index order */
+    size_t count;
+    std::chrono::steady_clock::time_point deadline;
+    BindingMerkleTree tree;
+    std::shared_ptr<binding_batch_t> result;
+    bool done;
+};
+
+BindingAggregator::BindingAggregator(TdxGuest* guest, ItaClient* ita, int window_ms,
+                                     size_t max_leaves)
+    : guest_(guest), ita_(ita), window_ms_(window_ms > 0 ? window_ms : 0),
+      max_leaves_(max_leaves > 0 && max_leaves <= BINDING_MERKLE_MAX_LEAVES
+                  ? max_leaves : BINDING_MERKLE_MAX_LEAVES),
+      batches_(0), bindings_(0) {
+}
+
+bool BindingAggregator::submit(const uint8_t binding[BINDING_MERKLE_HASH_SIZE],
+                               aggregated_binding_t* out) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    bool leader = !open_;
+    if (leader) {
+        open_ = std::make_shared<pending_t>();
+        open_->bindings.reserve(max_leaves_ < 64 ? max_leaves_ * BINDING_MERKLE_HASH_SIZE
+                                                 : 64 * BINDING_MERKLE_HASH_SIZE);
+        open_->deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(window_ms_);
+    }
+    std::shared_ptr<pending_t> batch = open_;
+    size_t index = batch->count++;
+    batch->bindings.insert(batch->bindings.end(), binding, binding + BINDING_MERKLE_HASH_SIZE);
+    if (batch->count >= max_leaves_) {
+        // Full: close it now so the next submitter leads a new window
+        open_.reset();
+        filled_.notify_all();
+    }
+    
+    if (leader) {
+        filled_.wait_until(lock, batch->deadline, [&] { return batch->count >= max_leaves_; });
+        if (open_ == batch) {
+            open_.reset();
+        }
+        lock.unlock();
+        attest(batch.get());
+        lock.lock();
+        batch->done = true;
+        done_.notify_all();
+    } else {
+        done_.wait(lock, [&] { return batch->done; });
+    }
+    lock.unlock();
+    
+    out->batch = batch->result;
+    const binding_batch_t& result = *batch->result;
+    if (result.error != 0 || result.ita_status != ITA_OK) {
+        out->proof.clear();
+        return false;
+    }
+    // Proofs only read the finished tree, so every submitter makes its own
+    out->proof.resize(batch->tree.proof_size(index));
+    return batch->tree.proof(index, out->proof.data(), out->proof.size());
+}
+
+void BindingAggregator::attest(pending_t* batch) {
+    std::shared_ptr<binding_batch_t> result = std::make_shared<binding_batch_t>();
+    result->leaves = batch->count;
+    result->error = 0;
+    result->ita_status = ITA_OK;
+    result->http_status = 0;
+    result->attest_ms = 0;
+    memset(result->root, 0, sizeof(result->root));
+    batch->result = result;
+    
+    if (!batch->tree.build(batch->bindings.data(), batch->count)) {
+        result->error = EINVAL;
+        return;
+    }
+    memcpy(result->root, batch->tree.root(), BINDING_MERKLE_HASH_SIZE);
+    uint8_t report_data[TDX_REPORT_DATA_SIZE];
+    batch->tree.report_data(report_data);
+    
+    std::lock_guard<std::mutex> guard(attest_mutex_);
+    double start = bench_now_ms();
+    result->error = guest_->get_quote(report_data, &result->quote);
+    if (result->error == 0 && ita_) {
+        // No verifier nonce: the token's tdx_report_data is the root itself
+        result->ita_status = ita_->attest(result->quote.data(), result->quote.size(), NULL, NULL, 0,
+                                          &result->token, &result->http_status);
+    }
+    result->attest_ms = bench_now_ms() - start;
+    batches_++;
+    bindings_ += batch->count;
+}
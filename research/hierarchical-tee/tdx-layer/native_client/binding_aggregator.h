@@ -0,0 +1,81 @@
+#ifndef BINDING_AGGREGATOR_H
+#define BINDING_AGGREGATOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "binding_merkle.h"
+#include "ita_client.h"
+#include "tdx_guest.h"
+
+/*
+ * Group commit of SGX bindings into one TDX attestation (binding_merkle.h).
+ *
+ * The first enclave to submit() opens a batch window and becomes its
+ * leader. Everyone who submits before the window closes, or before it
+ * holds `max_leaves` bindings, joins that batch. The leader then builds
+ * the Merkle tree, takes one TD quote over its root and, with an
+ * ItaClient, one Trust Authority token. Each submitter wakes up with the
+ * shared result and its own inclusion proof. Submissions that arrive
+ * while a batch is being attested open the next window. TDX attestation
+ * is paid once per window instead of once per enclave.
+ *
+ * Thread-safe. `guest` is only used by one leader at a time.
+ */
+
+#define AGGREGATOR_DEFAULT_WINDOW_MS 10
+
+/* Shared by every enclave in a batch. */
+typedef struct {
+    uint8_t root[BINDING_MERKLE_HASH_SIZE];
+    size_t leaves;
+    std::vector<uint8_t> quote;
+    std::string token;          /* empty without an ItaClient */
+    int error;                  /* errno from the driver, 0 if none */
+    ita_status_t ita_status;
+    long http_status;
+    double attest_ms;           /* quote + token for the whole batch */
+} binding_batch_t;
+
+typedef struct {
+    std::shared_ptr<const binding_batch_t> batch;
+    std::vector<uint8_t> proof;   /* the composite frame's binding proof section */
+} aggregated_binding_t;
+
+class BindingAggregator {
+public:
+    /* `ita` NULL: quote only. */
+    BindingAggregator(TdxGuest* guest, ItaClient* ita, int window_ms, size_t max_leaves);
+    
+    /* Blocks until the batch holding `binding` is attested; false if that failed. */
+    bool submit(const uint8_t binding[BINDING_MERKLE_HASH_SIZE], aggregated_binding_t* out);
+    
+    uint64_t batches() const { return batches_.load(); }
+    uint64_t bindings() const { return bindings_.load(); }
+    
+private:
+    struct pending_t;
+    
+    void attest(pending_t* batch);
+    
+    TdxGuest* guest_;
+    ItaClient* ita_;
+    int window_ms_;
+    size_t max_leaves_;
+    
+    std::mutex mutex_;
+    std::condition_variable filled_;   /* the open batch reached max_leaves */
+    std::condition_variable done_;     /* some batch finished attesting */
+    std::shared_ptr<pending_t> open_;
+    std::mutex attest_mutex_;          /* serialises leaders on `guest` */
+    
+    std::atomic<uint64_t> batches_;
+    std::atomic<uint64_t> bindings_;
+};
+
+#endif /* BINDING_AGGREGATOR_H */
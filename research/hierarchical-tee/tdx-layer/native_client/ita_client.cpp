@@ -0,0 +1,285 @@
+#include "ita_client.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <openssl/evp.h>
+
+static std::once_flag curl_initialised;
+
+// "key": "value" -> value; false if the key is absent or its value not a string
+static bool json_string_field(const std::string& json, const char* key, std::string* out) {
+    std::string quoted = std::string("\"") + key + "\"";
+    size_t pos = json.find(quoted);
+    if (pos == std::string::npos) {
+        return false;
+    }
+    pos += quoted.size();
+    while (pos < json.size() && (json[pos] == ' ' || json[pos] == '\t' || json[pos] == '\n' ||
+                                 json[pos] == '\r' || json[pos] == ':')) {
+        pos++;
+    }
+    if (pos >= json.size() || json[pos] != '"') {
+        return false;
+    }
+    size_t end = json.find('"', pos + 1);
+    if (end == std::string::npos) {
+        return false;
+    }
+    out->assign(json, pos + 1, end - pos - 1);
+    return true;
+}
+
+static void base64_encode(const uint8_t* data, size_t len, std::string* out) {
+    size_t size = (len + 2) / 3 * 4;
+    out->resize(size + 1);
+    EVP_EncodeBlock((unsigned char*)&(*out)[0], data, (int)len);
+    out->resize(size);
+}
+
+static bool base64_decode(const std::string& in, std::vector<uint8_t>* out) {
+    if (in.empty() || in.size() % 4 != 0) {
+        return false;
+    }
+    out->resize(in.size() / 4 * 3);
+    int len = EVP_DecodeBlock(out->data(), (const unsigned char*)in.data(), (int)in.size());
+    if (len < 0) {
+        return false;
+    }
+    // EVP_DecodeBlock counts the padding as zero bytes
+    size_t padding = in[in.size() - 1] == '=' ? (in[in.size() - 2] == '=' ? 2 : 1) : 0;
+    out->resize((size_t)len - padding);
+    return true;
+}
+
+static size_t append_body(char* data, size_t size, size_t count, void* userdata) {
+    ((std::string*)userdata)->append(data, size * count);
+    return size * count;
+}
+
+bool load_ita_config(const char* path, ita_config_t* out) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        return false;
+    }
+    std::string json;
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+        json.append(buf, n);
+    }
+    fclose(f);
+    
+    if (!json_string_field(json, "trustauthority_api_key", &out->api_key)) {
+        return false;
+    }
+    if (!json_string_field(json, "trustauthority_api_url", &out->api_url)) {
+        out->api_url = ITA_DEFAULT_URL;
+    }
+    while (!out->api_url.empty() && out->api_url[out->api_url.size() - 1] == '/') {
+        out->api_url.erase(out->api_url.size() - 1);
+    }
+    return true;
+}
+
+const char* ita_status_str(ita_status_t status) {
+    switch (status) {
+    case ITA_OK:
+        return "ok";
+    case ITA_TRANSPORT:
+        return "transport error";
+    case ITA_HTTP:
+        return "HTTP error";
+    case ITA_BAD_RESPONSE:
+        return "unexpected response";
+    }
+    return "unknown";
+}
+
+ItaClient::ItaClient()
+    : headers_(NULL), share_(NULL), max_connections_(1), connections_opened_(0), requests_(0),
+      http_version_(0) {
+}
+
+ItaClient::~ItaClient() {
+    for (size_t i = 0; i < all_.size(); i++) {
+        curl_easy_cleanup(all_[i]);
+    }
+    if (share_) {
+        curl_share_cleanup(share_);
+    }
+    curl_slist_free_all(headers_);
+}
+
+bool ItaClient::init(const ita_config_t& config, int max_connections) {
+    std::call_once(curl_initialised, [] { curl_global_init(CURL_GLOBAL_DEFAULT); });
+    url_ = config.api_url;
+    max_connections_ = max_connections > 0 ? max_connections : 1;
+    
+    std::string key_header = "x-api-key: " + config.api_key;
+    headers_ = curl_slist_append(headers_, key_header.c_str());
+    headers_ = curl_slist_append(headers_, "Accept: application/json");
+    headers_ = curl_slist_append(headers_, "Content-Type: application/json");
+    
+    // One DNS cache and TLS session cache for the whole pool. Connections stay
+    // with their handle: libcurl's shared connection cache is not safe across
+    // handles in use on several threads at once.
+    share_ = curl_share_init();
+    if (!share_ || !headers_) {
+        return false;
+    }
+    curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, lock_share);
+    curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, unlock_share);
+    curl_share_setopt(share_, CURLSHOPT_USERDATA, this);
+    return curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS) == CURLSHE_OK &&
+           curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION) == CURLSHE_OK;
+}
+
+void ItaClient::lock_share(CURL*, curl_lock_data data, curl_lock_access, void* ctx) {
+    ((ItaClient*)ctx)->share_locks_[data].lock();
+}
+
+void ItaClient::unlock_share(CURL*, curl_lock_data data, void* ctx) {
+    ((ItaClient*)ctx)->share_locks_[data].unlock();
+}
+
+CURL* ItaClient::lease() {
+    std::unique_lock<std::mutex> lock(pool_mutex_);
+    pool_available_.wait(lock, [this] {
+        return !idle_.empty() || (int)all_.size() < max_connections_;
+    });
+    if (!idle_.empty()) {
+        CURL* handle = idle_.back();
+        idle_.pop_back();
+        return handle;
+    }
+    
+    CURL* handle = curl_easy_init();
+    if (!handle) {
+        return NULL;
+    }
+    curl_easy_setopt(handle, CURLOPT_SHARE, share_);
+    curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, (long)CURL_HTTP_VERSION_2TLS);
+    curl_easy_setopt(handle, CURLOPT_HTTPHEADER, headers_);
+    curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(handle, CURLOPT_TIMEOUT, (long)ITA_TIMEOUT_S);
+    curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);   // no SIGALRM timeouts across threads
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, append_body);
+    all_.push_back(handle);
+    return handle;
+}
+
+void ItaClient::release(CURL* handle) {
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        idle_.push_back(handle);
+    }
+    pool_available_.notify_one();
+}
+
+ita_status_t ItaClient::request(const char* path, const std::string* body, std::string* response,
+                                long* http_status) {
+    if (http_status) {
+        *http_status = 0;
+    }
+    CURL* handle = lease();
+    if (!handle) {
+        return ITA_TRANSPORT;
+    }
+    std::string url = url_ + path;
+    response->clear();
+    curl_easy_setopt(handle, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, response);
+    if (body) {
+        curl_easy_setopt(handle, CURLOPT_POSTFIELDS, body->data());
+        curl_easy_setopt(handle, CURLOPT_POSTFIELDSIZE, (long)body->size());
+    } else {
+        curl_easy_setopt(handle, CURLOPT_HTTPGET, 1L);
+    }
+    
+    CURLcode ret = curl_easy_perform(handle);
+    long code = 0;
+    long connects = 0;
+    long version = 0;
+    curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &code);
+    curl_easy_getinfo(handle, CURLINFO_NUM_CONNECTS, &connects);
+    curl_easy_getinfo(handle, CURLINFO_HTTP_VERSION, &version);
+    release(handle);
+    
+    requests_++;
+    connections_opened_ += (uint64_t)connects;
+    if (version == CURL_HTTP_VERSION_2_0) {
+        http_version_.store(2);
+    } else if (version != 0) {
+        http_version_.store(1);
+    }
+    if (http_status) {
+        *http_status = code;
+    }
+    if (ret != CURLE_OK) {
+        return ITA_TRANSPORT;
+    }
+    return code >= 200 && code < 300 ? ITA_OK : ITA_HTTP;
+}
+
+ita_status_t ItaClient::get_nonce(ita_nonce_t* out, long* http_status) {
+    std::string response;
+    ita_status_t status = request(ITA_NONCE_PATH, NULL, &response, http_status);
+    if (status != ITA_OK) {
+        return status;
+    }
+    if (!json_string_field(response, "val", &out->val) ||
+        !json_string_field(response, "iat", &out->iat) ||
+        !json_string_field(response, "signature", &out->signature) ||
+        !base64_decode(out->val, &out->val_raw) || !base64_decode(out->iat, &out->iat_raw)) {
+        return ITA_BAD_RESPONSE;
+    }
+    return ITA_OK;
+}
+
+void ItaClient::report_data(const ita_nonce_t& nonce, const uint8_t* runtime_data,
+                            size_t runtime_len, uint8_t out[64]) {
+    EVP_MD_CTX* ctx = EVP_MD_CTX_new();
+    EVP_DigestInit_ex(ctx, EVP_sha512(), NULL);
+    EVP_DigestUpdate(ctx, nonce.val_raw.data(), nonce.val_raw.size());
+    EVP_DigestUpdate(ctx, nonce.iat_raw.data(), nonce.iat_raw.size());
+    EVP_DigestUpdate(ctx, runtime_data, runtime_len);
+    EVP_DigestFinal_ex(ctx, out, NULL);
+    EVP_MD_CTX_free(ctx);
+}
+
+ita_status_t ItaClient::attest(const uint8_t* quote, size_t quote_len, const ita_nonce_t* nonce,
+                               const uint8_t* runtime_data, size_t runtime_len, std::string* token,
+                               long* http_status) {
+    std::string quote_b64;
+    std::string runtime_b64;
+    base64_encode(quote, quote_len, &quote_b64);
+    base64_encode(runtime_data, runtime_len, &runtime_b64);
+    
+    std::string body;
+    body.reserve(quote_b64.size() + runtime_b64.size() + 512);
+    body += "{\"quote\":\"";
+    body += quote_b64;
+    body += "\"";
+    if (nonce) {
+        body += ",\"verifier_nonce\":{\"val\":\"";
+        body += nonce->val;
+        body += "\",\"iat\":\"";
+        body += nonce->iat;
+        body += "\",\"signature\":\"";
+        body += nonce->signature;
+        body += "\"}";
+    }
+    if (runtime_len > 0) {
+        body += ",\"runtime_data\":\"";
+        body += runtime_b64;
+        body += "\"";
+    }
+    body += "}";
+    
+    std::string response;
+    ita_status_t status = request(ITA_ATTEST_PATH, &body, &response, http_status);
+    if (status != ITA_OK) {
+        return status;
+    }
+    return json_string_field(response, "token", token) ? ITA_OK : ITA_BAD_RESPONSE;
+}
@@ -0,0 +1,117 @@
+#ifndef ITA_CLIENT_H
+#define ITA_CLIENT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <curl/curl.h>
+
+/*
+ * Intel Trust Authority REST client, in place of forking
+ * `trustauthority-cli token` per sample.
+ *
+ * Same two calls the CLI makes:
+ *
+ *   GET  /appraisal/v1/nonce   -> {"val", "iat", "signature"}
+ *   POST /appraisal/v1/attest  {"quote", "verifier_nonce", "runtime_data"}
+ *                              -> {"token"}
+ *
+ * with the quote's report_data = SHA512(val || iat || runtime_data), so
+ * the token is bound to the verifier nonce. Without a nonce the quote's own
+ * report_data (e.g. a Merkle root over enclave bindings) is what the token
+ * reports as tdx_report_data. Requests go out over a pool
+ * of libcurl handles that negotiate HTTP/2 and each keep their own
+ * connection between requests; a share handle lets them reuse each other's
+ * DNS entries and TLS sessions. After warm-up no request pays a TCP or TLS
+ * handshake. Safe to call from many threads at once; more concurrent
+ * callers than `max_connections` wait for a handle.
+ *
+ * Responses are read by key, not by a full JSON parse (the same approach
+ * as tdx_token.cpp). Every value read is base64, a URL or a JWT, so none
+ * contain escaped quotes.
+ */
+
+#define ITA_DEFAULT_URL "https://api.trustauthority.intel.com"
+#define ITA_NONCE_PATH "/appraisal/v1/nonce"
+#define ITA_ATTEST_PATH "/appraisal/v1/attest"
+#define ITA_TIMEOUT_S 30
+
+/* trustauthority-cli's config.json */
+typedef struct {
+    std::string api_url;   /* trustauthority_api_url */
+    std::string api_key;   /* trustauthority_api_key */
+} ita_config_t;
+
+bool load_ita_config(const char* path, ita_config_t* out);
+
+typedef struct {
+    std::string val;        /* base64, echoed back in the attest request */
+    std::string iat;
+    std::string signature;
+    std::vector<uint8_t> val_raw;
+    std::vector<uint8_t> iat_raw;
+} ita_nonce_t;
+
+enum ita_status_t {
+    ITA_OK = 0,
+    ITA_TRANSPORT,      /* connect, TLS or timeout: see the curl error */
+    ITA_HTTP,           /* non-2xx, e.g. 429 when throttled */
+    ITA_BAD_RESPONSE    /* 2xx without the expected fields */
+};
+
+const char* ita_status_str(ita_status_t status);
+
+class ItaClient {
+public:
+    ItaClient();
+    ~ItaClient();
+    
+    bool init(const ita_config_t& config, int max_connections);
+    
+    /* `http_status` (optional) gets the response code, 0 on a transport error. */
+    ita_status_t get_nonce(ita_nonce_t* out, long* http_status = NULL);
+    /* `nonce` NULL: no verifier nonce; `runtime_len` 0: no runtime_data. */
+    ita_status_t attest(const uint8_t* quote, size_t quote_len, const ita_nonce_t* nonce,
+                        const uint8_t* runtime_data, size_t runtime_len, std::string* token,
+                        long* http_status = NULL);
+    
+    /* SHA512(val || iat || runtime_data): the report_data to quote. */
+    static void report_data(const ita_nonce_t& nonce, const uint8_t* runtime_data,
+                            size_t runtime_len, uint8_t out[64]);
+    
+    /* New TCP connections over all requests; stays at the pool size when reuse works. */
+    uint64_t connections_opened() const { return connections_opened_.load(); }
+    uint64_t requests() const { return requests_.load(); }
+    /* Last negotiated version: 2 for HTTP/2, 1 for HTTP/1.1, 0 before any request. */
+    int http_version() const { return http_version_.load(); }
+    
+private:
+    CURL* lease();
+    void release(CURL* handle);
+    ita_status_t request(const char* path, const std::string* body, std::string* response,
+                         long* http_status);
+    
+    static void lock_share(CURL* handle, curl_lock_data data, curl_lock_access access, void* ctx);
+    static void unlock_share(CURL* handle, curl_lock_data data, void* ctx);
+    
+    std::string url_;
+    struct curl_slist* headers_;
+    CURLSH* share_;
+    std::mutex share_locks_[CURL_LOCK_DATA_LAST];
+    
+    std::mutex pool_mutex_;
+    std::condition_variable pool_available_;
+    std::vector<CURL*> idle_;
+    std::vector<CURL*> all_;
+    int max_connections_;
+    
+    std::atomic<uint64_t> connections_opened_;
+    std::atomic<uint64_t> requests_;
+    std::atomic<int> http_version_;
+};
+
+#endif /* ITA_CLIENT_H */
@@ -0,0 +1,857 @@
+#include <errno.h>
+#include <netdb.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench_clock.h"
+#include "bench_report.h"
+#include "binding_aggregator.h"
+#include "binding_merkle.h"
+#include "composite_evidence.h"
+#include "ita_client.h"
+#include "latency_histogram.h"
+#include "quote_parser.h"
+#include "sgx_binding.h"
+#include "tdx_guest.h"
+#include "token_service.h"
+#include "trace_span.h"
+#include "verifier_protocol.h"
+
+/*
+ * Native TDX baseline: the measurements of attestation_benchmark_fixed.py
+ * without a `sudo trustauthority-cli` fork per sample, so the numbers are
+ * the driver, the QGS and Trust Authority rather than process start-up,
+ * sudo and a fresh TLS handshake. Each phase runs at 1, 2, 4, ... threads
+ * to show where quote and token throughput stop scaling. --aggregate N
+ * has N simulated enclaves share one attestation per batch window instead.
+ * --compose QUOTES completes traced SGX quotes (quote_benchmark --trace)
+ * into composite evidence, optionally verified by the verifier daemon.
+ * --serve PORT answers token requests from quote_benchmark --overlap.
+ */
+
+#define DEFAULT_ITERATIONS 50
+#define DEFAULT_MAX_THREADS 8
+#define MAX_THREADS 256
+#define RUNTIME_DATA_SIZE 32
+#define MAX_ENCLAVES 1024
+
+enum bench_phase_t {
+    PHASE_REPORT = 1,   /* TDREPORT ioctl only */
+    PHASE_QUOTE = 2,    /* configfs-tsm quote: `trustauthority-cli evidence` */
+    PHASE_TOKEN = 4     /* nonce + quote + attest: `trustauthority-cli token` */
+};
+
+typedef struct {
+    int successful;
+    int attempted;
+    int first_error;        /* errno from the driver, 0 if none */
+    ita_status_t first_ita_error;
+    long first_http_status;
+    double total_bytes;     /* quotes or tokens */
+    std::vector<double> samples_ms;
+    LatencyHistogram nonce_hist;
+    LatencyHistogram quote_hist;
+    LatencyHistogram attest_hist;
+    LatencyHistogram end_to_end_hist;
+} tdx_worker_stats_t;
+
+static const char* phase_name(bench_phase_t phase) {
+    switch (phase) {
+    case PHASE_REPORT:
+        return "Native TDX Report (ioctl)";
+    case PHASE_QUOTE:
+        return "Native TDX Evidence Collection";
+    case PHASE_TOKEN:
+        return "Native TDX Attestation (with ITA)";
+    }
+    return "Native TDX";
+}
+
+static void record_driver_error(tdx_worker_stats_t* stats, int err) {
+    if (stats->first_error == 0) {
+        stats->first_error = err;
+    }
+}
+
+static void record_ita_error(tdx_worker_stats_t* stats, ita_status_t status, long http_status) {
+    if (stats->first_ita_error == ITA_OK) {
+        stats->first_ita_error = status;
+        stats->first_http_status = http_status;
+    }
+}
+
+static void tdx_load_worker(bench_phase_t phase, ItaClient* ita, int worker_id, int iterations,
+                            tdx_worker_stats_t* stats) {
+    stats->attempted = iterations;
+    TdxGuest guest;
+    if (!guest.open()) {
+        record_driver_error(stats, guest.last_error());
+        return;
+    }
+    
+    std::vector<uint8_t> quote;
+    quote.reserve(TDX_QUOTE_MAX);
+    std::string token;
+    uint8_t report[TDX_REPORT_SIZE];
+    for (int i = 0; i < iterations; i++) {
+        uint8_t report_data[TDX_REPORT_DATA_SIZE] = {0};
+        uint8_t runtime_data[RUNTIME_DATA_SIZE] = {0};
+        snprintf((char*)runtime_data, sizeof(runtime_data), "Thread-%d-Iteration-%d", worker_id, i);
+        
+        double start = bench_now_ms();
+        double nonce_end = start;
+        ita_nonce_t nonce;
+        long http_status = 0;
+        if (phase == PHASE_TOKEN) {
+            ita_status_t status = ita->get_nonce(&nonce, &http_status);
+            if (status != ITA_OK) {
+                record_ita_error(stats, status, http_status);
+                continue;
+            }
+            ItaClient::report_data(nonce, runtime_data, sizeof(runtime_data), report_data);
+            nonce_end = bench_now_ms();
+        } else {
+            memcpy(report_data, runtime_data, sizeof(runtime_data));
+        }
+        
+        int err = phase == PHASE_REPORT ? guest.get_report(report_data, report)
+                                        : guest.get_quote(report_data, &quote);
+        double quote_end = bench_now_ms();
+        if (err != 0) {
+            record_driver_error(stats, err);
+            continue;
+        }
+        
+        double attest_end = quote_end;
+        if (phase == PHASE_TOKEN) {
+            ita_status_t status = ita->attest(quote.data(), quote.size(), &nonce, runtime_data,
+                                              sizeof(runtime_data), &token, &http_status);
+            attest_end = bench_now_ms();
+            if (status != ITA_OK) {
+                record_ita_error(stats, status, http_status);
+                continue;
+            }
+        }
+        
+        stats->successful++;
+        stats->total_bytes += phase == PHASE_TOKEN ? token.size()
+                              : phase == PHASE_QUOTE ? quote.size() : TDX_REPORT_SIZE;
+        stats->samples_ms.push_back(attest_end - start);
+        if (phase == PHASE_TOKEN) {
+            stats->nonce_hist.record_ms(nonce_end - start);
+            stats->attest_hist.record_ms(attest_end - quote_end);
+        }
+        stats->quote_hist.record_ms(quote_end - nonce_end);
+        stats->end_to_end_hist.record_ms(attest_end - start);
+    }
+}
+
+static int benchmark_phase(bench_phase_t phase, ItaClient* ita, BenchReport* report_out,
+                           int iterations, int max_threads) {
+    printf("\n[+] Benchmarking %s (1-%d threads, %d each)...\n", phase_name(phase), max_threads,
+           iterations);
+    printf("---------------------------------------------------------------\n");
+    
+    std::vector<int> levels;
+    for (int n = 1; n < max_threads; n *= 2) {
+        levels.push_back(n);
+    }
+    levels.push_back(max_threads);
+    
+    double single_thread_tput = 0;
+    int rows = 0;
+    printf("  %-7s | %-10s | %-11s | %-11s | %-11s | %-7s\n",
+           "Threads", "Ops/sec", "Mean ms", "p99 ms", "Successful", "Scaling");
+    tdx_worker_stats_t busiest = tdx_worker_stats_t();
+    int busiest_threads = 0;
+    for (size_t l = 0; l < levels.size(); l++) {
+        int threads = levels[l];
+        std::vector<std::thread> workers;
+        std::vector<tdx_worker_stats_t> stats(threads);
+        uint64_t connections_start = ita ? ita->connections_opened() : 0;
+        
+        double start = bench_now_ms();
+        for (int t = 0; t < threads; t++) {
+            workers.push_back(std::thread(tdx_load_worker, phase, ita, t, iterations, &stats[t]));
+        }
+        for (size_t t = 0; t < workers.size(); t++) {
+            workers[t].join();
+        }
+        double wall_time = bench_now_ms() - start;
+        
+        tdx_worker_stats_t total = tdx_worker_stats_t();
+        for (int t = 0; t < threads; t++) {
+            total.successful += stats[t].successful;
+            total.attempted += stats[t].attempted;
+            total.total_bytes += stats[t].total_bytes;
+            if (total.first_error == 0) {
+                total.first_error = stats[t].first_error;
+            }
+            if (total.first_ita_error == ITA_OK) {
+                total.first_ita_error = stats[t].first_ita_error;
+                total.first_http_status = stats[t].first_http_status;
+            }
+            total.samples_ms.insert(total.samples_ms.end(), stats[t].samples_ms.begin(),
+                                    stats[t].samples_ms.end());
+            total.nonce_hist.merge(stats[t].nonce_hist);
+            total.quote_hist.merge(stats[t].quote_hist);
+            total.attest_hist.merge(stats[t].attest_hist);
+            total.end_to_end_hist.merge(stats[t].end_to_end_hist);
+        }
+        
+        if (total.first_error != 0) {
+            printf("  ⚠ Driver error: %s\n", strerror(total.first_error));
+        }
+        if (total.first_ita_error != ITA_OK) {
+            printf("  ⚠ Trust Authority: %s (HTTP %ld)\n", ita_status_str(total.first_ita_error),
+                   total.first_http_status);
+        }
+        if (total.successful == 0) {
+            printf("  %-7d | ✗ no successful operations (0/%d)\n", threads, total.attempted);
+            break;
+        }
+        
+        double tput = total.successful * 1000.0 / wall_time;
+        if (threads == 1) {
+            single_thread_tput = tput;
+        }
+        double scaling = single_thread_tput > 0 ? tput / (single_thread_tput * threads) : 0;
+        printf("  %-7d | %10.1f | %11.3f | %11.3f | %5d/%-5d | %6.0f%%\n",
+               threads, tput, total.end_to_end_hist.mean_ns() / 1e6,
+               total.end_to_end_hist.percentile_ms(99.0), total.successful, total.attempted,
+               scaling * 100.0);
+        rows++;
+        
+        // Single-threaded samples in the Python baseline's layout, then the scaling rows
+        if (threads == 1) {
+            report_out->add_latency(phase_name(phase), total.samples_ms, total.attempted);
+            report_out->add_field("mean_size_bytes", total.total_bytes / total.successful);
+        }
+        char operation[96];
+        snprintf(operation, sizeof(operation), "%s (%d threads)", phase_name(phase), threads);
+        report_out->add_operation(operation);
+        report_out->add_field("threads", threads);
+        report_out->add_field("successes", total.successful);
+        report_out->add_field("failures", total.attempted - total.successful);
+        report_out->add_field("ops_per_sec", tput);
+        report_out->add_field("scaling_efficiency", scaling);
+        report_out->add_field("p50_ms", total.end_to_end_hist.percentile_ms(50.0));
+        report_out->add_field("p99_ms", total.end_to_end_hist.percentile_ms(99.0));
+        if (phase == PHASE_TOKEN) {
+            report_out->add_field("nonce_p50_ms", total.nonce_hist.percentile_ms(50.0));
+            report_out->add_field("quote_p50_ms", total.quote_hist.percentile_ms(50.0));
+            report_out->add_field("attest_p50_ms", total.attest_hist.percentile_ms(50.0));
+            report_out->add_field("new_connections", (double)(ita->connections_opened() -
+                                                              connections_start));
+        }
+        
+        busiest_threads = threads;
+        busiest = total;
+    }
+    
+    if (busiest_threads > 0) {
+        printf("\n  Tail Latency at %d threads:\n", busiest_threads);
+        print_latency_header();
+        if (phase == PHASE_TOKEN) {
+            print_latency_row("Nonce (ITA)", busiest.nonce_hist);
+            print_latency_row("Quote (tsm)", busiest.quote_hist);
+            print_latency_row("Attest (ITA)", busiest.attest_hist);
+        }
+        print_latency_row("End-to-End", busiest.end_to_end_hist);
+    }
+    return rows;
+}
+
+typedef struct {
+    int successful;
+    int attempted;
+    int verified;               /* proof leads to the batch root */
+    double batch_leaves;        /* summed over bindings, for the mean batch size */
+    double amortized_ms;        /* each binding's share of its batch's attestation */
+    LatencyHistogram latency_hist;
+} enclave_stats_t;
+
+// One co-resident SGX enclave handing its bindings to the TD's aggregator
+static void enclave_worker(BindingAggregator* aggregator, int enclave_id, int iterations,
+                           enclave_stats_t* stats) {
+    MerkleHasher hasher;
+    aggregated_binding_t result;
+    stats->attempted = iterations;
+    for (int i = 0; i < iterations; i++) {
+        uint8_t binding[BINDING_MERKLE_HASH_SIZE] = {0};
+        snprintf((char*)binding, sizeof(binding), "Enclave-%d-Binding-%d", enclave_id, i);
+        
+        double start = bench_now_ms();
+        bool ok = aggregator->submit(binding, &result);
+        double end = bench_now_ms();
+        if (!ok) {
+            continue;
+        }
+        
+        stats->successful++;
+        stats->latency_hist.record_ms(end - start);
+        const binding_batch_t& batch = *result.batch;
+        stats->batch_leaves += (double)batch.leaves;
+        stats->amortized_ms += batch.attest_ms / (double)batch.leaves;
+        uint8_t root[BINDING_MERKLE_HASH_SIZE];
+        byte_span_t proof = {result.proof.data(), result.proof.size()};
+        if (hasher.root_from_proof(binding, proof, root) &&
+            memcmp(root, batch.root, BINDING_MERKLE_HASH_SIZE) == 0) {
+            stats->verified++;
+        }
+    }
+}
+
+static int benchmark_aggregation(ItaClient* ita, BenchReport* report_out, int iterations,
+                                 int enclaves, int window_ms) {
+    printf("\n[+] Benchmarking Aggregated SGX Bindings (%d enclaves x %d, %d ms window, %s)...\n",
+           enclaves, iterations, window_ms, ita ? "quote + token" : "quote only");
+    printf("---------------------------------------------------------------\n");
+    
+    TdxGuest guest;
+    if (!guest.open() || !guest.has_quote()) {
+        printf("  ✗ No TD quotes: %s\n", strerror(guest.last_error() ? guest.last_error() : ENOTSUP));
+        return 0;
+    }
+    BindingAggregator aggregator(&guest, ita, window_ms, BINDING_MERKLE_MAX_LEAVES);
+    std::vector<std::thread> workers;
+    std::vector<enclave_stats_t> stats(enclaves);
+    
+    double start = bench_now_ms();
+    for (int e = 0; e < enclaves; e++) {
+        workers.push_back(std::thread(enclave_worker, &aggregator, e, iterations, &stats[e]));
+    }
+    for (size_t e = 0; e < workers.size(); e++) {
+        workers[e].join();
+    }
+    double wall_time = bench_now_ms() - start;
+    
+    enclave_stats_t total = enclave_stats_t();
+    for (int e = 0; e < enclaves; e++) {
+        total.successful += stats[e].successful;
+        total.attempted += stats[e].attempted;
+        total.verified += stats[e].verified;
+        total.batch_leaves += stats[e].batch_leaves;
+        total.amortized_ms += stats[e].amortized_ms;
+        total.latency_hist.merge(stats[e].latency_hist);
+    }
+    if (total.successful == 0) {
+        printf("  ✗ No batch attested (0/%d)\n", total.attempted);
+        return 0;
+    }
+    
+    uint64_t batches = aggregator.batches();
+    printf("  Bindings attested:       %d/%d (%s %d proofs verified)\n", total.successful,
+           total.attempted, total.verified == total.successful ? "✓" : "✗", total.verified);
+    printf("  TDX attestations:        %lu (mean batch %.1f bindings)\n", (unsigned long)batches,
+           total.batch_leaves / total.successful);
+    printf("  Attestation per binding: %.3f ms amortized\n", total.amortized_ms / total.successful);
+    printf("  Throughput:              %.1f bindings/sec\n", total.successful * 1000.0 / wall_time);
+    printf("\n");
+    print_latency_header();
+    print_latency_row("Submit -> proof", total.latency_hist);
+    
+    char operation[96];
+    snprintf(operation, sizeof(operation), "Native TDX Aggregated Binding (%d enclaves)", enclaves);
+    report_out->add_operation(operation);
+    report_out->add_field("enclaves", enclaves);
+    report_out->add_field("window_ms", window_ms);
+    report_out->add_field("successes", total.successful);
+    report_out->add_field("failures", total.attempted - total.successful);
+    report_out->add_field("tdx_attestations", (double)batches);
+    report_out->add_field("mean_batch_size", total.batch_leaves / total.successful);
+    report_out->add_field("amortized_attestation_ms", total.amortized_ms / total.successful);
+    report_out->add_field("bindings_per_sec", total.successful * 1000.0 / wall_time);
+    report_out->add_field("p50_ms", total.latency_hist.percentile_ms(50.0));
+    report_out->add_field("p99_ms", total.latency_hist.percentile_ms(99.0));
+    report_out->add_field("proofs_verified", total.verified);
+    return 1;
+}
+
+/* "host:port" -> connected TCP socket, -1 on failure. */
+static int connect_verifier(const char* address) {
+    std::string host(address);
+    size_t colon = host.rfind(':');
+    if (colon == std::string::npos) {
+        return -1;
+    }
+    std::string port = host.substr(colon + 1);
+    host.resize(colon);
+    
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo* addrs = NULL;
+    if (getaddrinfo(host.c_str(), port.c_str(), &hints, &addrs) != 0) {
+        return -1;
+    }
+    int fd = -1;
+    for (struct addrinfo* a = addrs; a; a = a->ai_next) {
+        fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+        if (fd >= 0 && connect(fd, a->ai_addr, a->ai_addrlen) == 0) {
+            break;
+        }
+        if (fd >= 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(addrs);
+    if (fd >= 0) {
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    return fd;
+}
+
+static bool send_all(int fd, const uint8_t* buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = send(fd, buf, len, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        buf += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+/* Exactly `len` bytes; false on EOF or an error. */
+static bool recv_all(int fd, uint8_t* buf, size_t len) {
+    size_t got = 0;
+    while (got < len) {
+        ssize_t n = recv(fd, buf + got, len - got, 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        got += (size_t)n;
+    }
+    return true;
+}
+
+/* One frame out, its verdict back; false if the connection failed. */
+static bool submit_frame(int fd, const uint8_t* frame, size_t len, verdict_record_t* verdict) {
+    uint8_t wire[VERDICT_SIZE];
+    return send_all(fd, frame, len) && recv_all(fd, wire, sizeof(wire)) &&
+           verdict_decode(wire, verdict);
+}
+
+// The TD half of a composite attestation for every traced SGX quote
+// (quote_benchmark --trace): TD quote over the SGX binding, ITA token, and
+// optionally the verifier's verdict, as spans of the quote's own trace
+static int benchmark_composition(ItaClient* ita, BenchReport* report_out, const char* quotes_path,
+                                 const char* verifier, const char* trace_path) {
+    printf("\n[+] Composing Traced Evidence (%s%s%s)...\n", quotes_path,
+           verifier ? " -> " : "", verifier ? verifier : "");
+    printf("---------------------------------------------------------------\n");
+    
+    std::vector<uint8_t> log;
+    FILE* f = fopen(quotes_path, "rb");
+    if (f) {
+        uint8_t chunk[64 * 1024];
+        size_t n;
+        while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) {
+            log.insert(log.end(), chunk, chunk + n);
+        }
+        fclose(f);
+    }
+    if (log.empty()) {
+        printf("  ✗ No SGX quotes in %s\n", quotes_path);
+        return 0;
+    }
+    
+    TdxGuest guest;
+    if (!guest.open() || !guest.has_quote()) {
+        printf("  ✗ No TD quotes: %s\n", strerror(guest.last_error() ? guest.last_error() : ENOTSUP));
+        return 0;
+    }
+    int fd = -1;
+    if (verifier) {
+        fd = connect_verifier(verifier);
+        if (fd < 0) {
+            printf("  ✗ Cannot connect to verifier %s\n", verifier);
+            return 0;
+        }
+    }
+    
+    TraceRecorder recorder("tdx-prover");
+    QuoteStream stream(log.data(), log.size());
+    quote_record_t record;
+    std::vector<uint8_t> td_quote;
+    td_quote.reserve(TDX_QUOTE_MAX);
+    std::vector<uint8_t> frame;
+    std::string token;
+    std::vector<double> samples;
+    LatencyHistogram quote_hist;
+    LatencyHistogram token_hist;
+    LatencyHistogram submit_hist;
+    int attempted = 0;
+    int untraced = 0;
+    int trusted = 0;
+    int rejected = 0;
+    uint32_t first_error = VERIFY_ERROR_NONE;
+    ita_status_t first_ita_error = ITA_OK;
+    
+    while (stream.next(&record)) {
+        SgxQuote3View sgx_quote;
+        trace_id_t trace;
+        if (record.kind != QUOTE_KIND_SGX_V3 ||
+            sgx_quote.parse(record.data, record.size) != QUOTE_OK ||
+            !trace_id_from_report_data(sgx_quote.report_data(), &trace)) {
+            untraced++;
+            continue;
+        }
+        attempted++;
+        
+        // Same report_data the verifier compares against the token's tdx_report_data
+        uint8_t report_data[TDX_REPORT_DATA_SIZE] = {0};
+        memcpy(report_data, sgx_quote.report_data(), SGX_BINDING_SIZE);
+        int64_t start = trace_now_ns();
+        int err = guest.get_quote(report_data, &td_quote);
+        int64_t quote_end = trace_now_ns();
+        if (err != 0) {
+            continue;
+        }
+        long http_status = 0;
+        ita_status_t status = ita->attest(td_quote.data(), td_quote.size(), NULL, NULL, 0,
+                                          &token, &http_status);
+        int64_t token_end = trace_now_ns();
+        if (status != ITA_OK) {
+            if (first_ita_error == ITA_OK) {
+                first_ita_error = status;
+                printf("  ✗ Trust Authority: %s (HTTP %ld)\n", ita_status_str(status), http_status);
+            }
+            continue;
+        }
+        
+        frame.resize(composite_evidence_size(record.size, token.size()));
+        size_t frame_len = 0;
+        if (composite_evidence_write(&frame[0], frame.size(), record.data, record.size,
+                                     (const uint8_t*)token.data(), token.size(), report_data,
+                                     &frame_len) != COMPOSITE_OK) {
+            continue;
+        }
+        int64_t end = trace_now_ns();
+        if (fd >= 0) {
+            verdict_record_t verdict;
+            if (!submit_frame(fd, &frame[0], frame_len, &verdict)) {
+                printf("  ✗ Verifier connection lost after %d requests\n", trusted + rejected);
+                close(fd);
+                fd = -1;
+            } else if (verdict.verdict == VERDICT_TRUSTED) {
+                trusted++;
+            } else {
+                rejected++;
+                if (first_error == VERIFY_ERROR_NONE) {
+                    first_error = verdict.error;
+                }
+            }
+            end = trace_now_ns();
+            submit_hist.record_ms((end - token_end) / 1e6);
+        }
+        
+        uint64_t parent = recorder.record(trace, trace_root_span_id(trace), "tdx.evidence",
+                                          start, end);
+        recorder.record(trace, parent, "tdx.td_quote", start, quote_end);
+        recorder.record(trace, parent, "tdx.ita_token", quote_end, token_end);
+        if (verifier) {
+            recorder.record(trace, parent, "tdx.submit", token_end, end);
+        }
+        quote_hist.record_ms((quote_end - start) / 1e6);
+        token_hist.record_ms((token_end - quote_end) / 1e6);
+        samples.push_back((end - start) / 1e6);
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+    if (stream.status() != QUOTE_OK) {
+        printf("  ⚠ Stopped at offset %zu: malformed quote\n", stream.offset());
+    }
+    
+    printf("  Traced SGX quotes:       %d (%d untraced skipped)\n", attempted, untraced);
+    printf("  Composite evidence:      %zu/%d\n", samples.size(), attempted);
+    if (verifier) {
+        printf("  Verdicts:                %d trusted, %d rejected%s%s\n", trusted, rejected,
+               first_error ? ", first: " : "", first_error ? verify_error_str(first_error) : "");
+    }
+    if (samples.empty()) {
+        return 0;
+    }
+    printf("\n");
+    print_latency_header();
+    print_latency_row("TD quote", quote_hist);
+    print_latency_row("ITA token", token_hist);
+    if (verifier) {
+        print_latency_row("Verifier", submit_hist);
+    }
+    
+    if (trace_path) {
+        if (recorder.write(trace_path)) {
+            printf("\n  ✓ %zu spans written to %s\n", recorder.size(), trace_path);
+        } else {
+            printf("\n  ✗ Failed to write spans to %s\n", trace_path);
+        }
+    }
+    report_out->add_latency("Native TDX Composite Evidence (traced)", samples, attempted);
+    if (verifier) {
+        report_out->add_field("trusted", trusted);
+        report_out->add_field("rejected", rejected);
+    }
+    return 1;
+}
+
+// One SGX host's connection to the token service; a TdxGuest of its own,
+// since a configfs entry serves one quote at a time
+static void token_service_connection(ItaClient* ita, int fd) {
+    TdxGuest guest;
+    bool have_quote = guest.open() && guest.has_quote();
+    std::vector<uint8_t> quote;
+    quote.reserve(TDX_QUOTE_MAX);
+    std::string token;
+    LatencyHistogram token_hist;
+    uint64_t failures = 0;
+    
+    uint8_t request[TOKEN_REQUEST_SIZE];
+    while (recv_all(fd, request, sizeof(request))) {
+        uint8_t report_data[TDX_REPORT_DATA_SIZE] = {0};
+        uint8_t status = TOKEN_STATUS_OK;
+        token.clear();
+        double start = bench_now_ms();
+        if (!token_request_decode(request, report_data)) {
+            status = TOKEN_STATUS_BAD_REQUEST;
+        } else if (!have_quote || guest.get_quote(report_data, &quote) != 0) {
+            status = TOKEN_STATUS_QUOTE_FAILED;
+        } else if (ita->attest(quote.data(), quote.size(), NULL, NULL, 0, &token) != ITA_OK) {
+            status = TOKEN_STATUS_ITA_FAILED;
+            token.clear();
+        }
+        
+        uint8_t header[TOKEN_RESPONSE_HEADER_SIZE];
+        token_response_encode(status, (uint32_t)token.size(), header);
+        if (!send_all(fd, header, sizeof(header)) ||
+            !send_all(fd, (const uint8_t*)token.data(), token.size())) {
+            break;
+        }
+        if (status == TOKEN_STATUS_OK) {
+            token_hist.record_ms(bench_now_ms() - start);
+        } else {
+            failures++;
+        }
+        if (status == TOKEN_STATUS_BAD_REQUEST) {
+            break;  // out of step with the client
+        }
+    }
+    close(fd);
+    printf("  Connection closed: %lu tokens (p50 %.3f ms), %lu failed\n",
+           (unsigned long)token_hist.count(), token_hist.percentile_ms(50.0),
+           (unsigned long)failures);
+    fflush(stdout);
+}
+
+// TD half of the overlapped attestation: tokens over bindings the SGX host
+// sends, possibly before its enclave has reported (quote_benchmark --overlap)
+static int serve_tokens(ItaClient* ita, int port) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    int one = 1;
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons((uint16_t)port);
+    if (fd < 0 || setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) != 0 ||
+        bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, SOMAXCONN) != 0) {
+        printf("✗ Cannot listen on port %d: %s\n", port, strerror(errno));
+        if (fd >= 0) {
+            close(fd);
+        }
+        return -1;
+    }
+    printf("\n[+] Serving TDX tokens on port %d (Ctrl-C to stop)...\n", port);
+    fflush(stdout);
+    
+    for (;;) {
+        int conn = accept4(fd, NULL, NULL, SOCK_CLOEXEC);
+        if (conn < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            printf("✗ accept: %s\n", strerror(errno));
+            break;
+        }
+        setsockopt(conn, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        std::thread(token_service_connection, ita, conn).detach();
+    }
+    close(fd);
+    return -1;
+}
+
+static void print_usage(const char* prog) {
+    printf("Usage: %s [iterations] [--threads N] [--connections N] [--config FILE] [--json FILE]\n"
+           "       [--report] [--quote] [--token]    (default: all three)\n"
+           "       [--aggregate ENCLAVES [--window MS]]\n"
+           "       [--compose QUOTES [--verifier HOST:PORT] [--trace FILE]]\n"
+           "       [--serve PORT]    (token service for quote_benchmark --overlap)\n", prog);
+}
+
+int main(int argc, char* argv[]) {
+    int iterations = DEFAULT_ITERATIONS;
+    int max_threads = DEFAULT_MAX_THREADS;
+    int connections = 0;
+    int phases = 0;
+    int aggregate = 0;
+    int window_ms = AGGREGATOR_DEFAULT_WINDOW_MS;
+    const char* compose_path = NULL;
+    const char* verifier = NULL;
+    const char* trace_path = NULL;
+    int serve_port = 0;
+    const char* home = getenv("HOME");
+    std::string config_path = std::string(home ? home : ".") + "/config.json";
+    std::string json_path = bench_report_path("tdx_native", "json");
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            max_threads = atoi(argv[++i]);
+            if (max_threads <= 0 || max_threads > MAX_THREADS) {
+                printf("Invalid thread count. Using default: %d\n", DEFAULT_MAX_THREADS);
+                max_threads = DEFAULT_MAX_THREADS;
+            }
+        } else if (strcmp(argv[i], "--connections") == 0 && i + 1 < argc) {
+            connections = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--config") == 0 && i + 1 < argc) {
+            config_path = argv[++i];
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else if (strcmp(argv[i], "--aggregate") == 0 && i + 1 < argc) {
+            aggregate = atoi(argv[++i]);
+            if (aggregate < 0 || aggregate > MAX_ENCLAVES) {
+                aggregate = 0;
+            }
+        } else if (strcmp(argv[i], "--window") == 0 && i + 1 < argc) {
+            window_ms = atoi(argv[++i]);
+            if (window_ms < 0) {
+                window_ms = AGGREGATOR_DEFAULT_WINDOW_MS;
+            }
+        } else if (strcmp(argv[i], "--compose") == 0 && i + 1 < argc) {
+            compose_path = argv[++i];
+        } else if (strcmp(argv[i], "--verifier") == 0 && i + 1 < argc) {
+            verifier = argv[++i];
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            trace_path = argv[++i];
+        } else if (strcmp(argv[i], "--serve") == 0 && i + 1 < argc) {
+            serve_port = atoi(argv[++i]);
+            if (serve_port <= 0 || serve_port > 65535) {
+                print_usage(argv[0]);
+                return -1;
+            }
+        } else if (strcmp(argv[i], "--report") == 0) {
+            phases |= PHASE_REPORT;
+        } else if (strcmp(argv[i], "--quote") == 0) {
+            phases |= PHASE_QUOTE;
+        } else if (strcmp(argv[i], "--token") == 0) {
+            phases |= PHASE_TOKEN;
+        } else if (argv[i][0] == '-') {
+            print_usage(argv[0]);
+            return -1;
+        } else {
+            iterations = atoi(argv[i]);
+            if (iterations <= 0 || iterations > 10000) {
+                iterations = DEFAULT_ITERATIONS;
+            }
+        }
+    }
+    if (phases == 0) {
+        // --compose and --serve alone run only themselves; both need the token setup
+        phases = compose_path || serve_port ? 0 : PHASE_REPORT | PHASE_QUOTE | PHASE_TOKEN;
+    }
+    // One pooled connection per concurrent caller unless told otherwise
+    if (connections <= 0) {
+        connections = max_threads;
+    }
+    
+    printf("===============================================================\n");
+    printf("TDX Attestation Benchmark (native client)\n");
+    printf("===============================================================\n");
+    printf("✓ Benchmark clock: %s\n", bench_clock_source());
+    
+    TdxGuest probe;
+    if (!probe.open()) {
+        printf("✗ Cannot open %s: %s\n", TDX_GUEST_DEVICE, strerror(probe.last_error()));
+        printf("  Run as root on a TDX guest (the tdx_guest driver must be loaded)\n");
+        return -1;
+    }
+    printf("✓ %s opened, quotes via %s\n", TDX_GUEST_DEVICE,
+           probe.has_quote() ? TDX_TSM_REPORT_DIR : "(unavailable: no configfs-tsm)");
+    bool have_quote = probe.has_quote();
+    probe.close();
+    
+    ItaClient ita;
+    ita_config_t config;
+    bool have_ita = false;
+    if ((phases & PHASE_TOKEN) || compose_path || serve_port) {
+        if (!load_ita_config(config_path.c_str(), &config)) {
+            printf("⚠ No trustauthority_api_key in %s, skipping token phase\n", config_path.c_str());
+        } else if (!ita.init(config, connections)) {
+            printf("⚠ Failed to set up the Trust Authority client, skipping token phase\n");
+        } else {
+            have_ita = true;
+            printf("✓ Trust Authority: %s (%d pooled connections)\n", config.api_url.c_str(),
+                   connections);
+        }
+    }
+    
+    if (serve_port > 0) {
+        if (!have_quote || !have_ita) {
+            printf("✗ The token service needs TD quotes and a Trust Authority client\n");
+            return -1;
+        }
+        return serve_tokens(&ita, serve_port);
+    }
+    
+    BenchReport report("Google Cloud C3 with Intel TDX (native client)");
+    int rows = 0;
+    if (phases & PHASE_REPORT) {
+        rows += benchmark_phase(PHASE_REPORT, NULL, &report, iterations, max_threads);
+    }
+    if ((phases & PHASE_QUOTE) && have_quote) {
+        rows += benchmark_phase(PHASE_QUOTE, NULL, &report, iterations, max_threads);
+    }
+    if ((phases & PHASE_TOKEN) && have_quote && have_ita) {
+        rows += benchmark_phase(PHASE_TOKEN, &ita, &report, iterations, max_threads);
+        printf("\n  Connections: %lu opened for %lu requests (HTTP/%d)\n",
+               (unsigned long)ita.connections_opened(), (unsigned long)ita.requests(),
+               ita.http_version() == 2 ? 2 : 1);
+    }
+    if (aggregate > 0 && have_quote) {
+        rows += benchmark_aggregation(have_ita ? &ita : NULL, &report, iterations, aggregate,
+                                      window_ms);
+    }
+    if (compose_path && have_quote && have_ita) {
+        rows += benchmark_composition(&ita, &report, compose_path, verifier, trace_path);
+    }
+    
+    std::string csv_path = bench_report_csv_path(json_path);
+    if (report.write_json(json_path.c_str()) && report.write_csv(csv_path.c_str())) {
+        printf("\n✓ Results saved to: %s (samples: %s)\n", json_path.c_str(), csv_path.c_str());
+    } else {
+        printf("\n✗ Failed to write results to %s\n", json_path.c_str());
+    }
+    
+    printf("\n===============================================================\n");
+    printf(rows > 0 ? "✓ Benchmark Complete!\n" : "⚠ Benchmark completed with errors\n");
+    printf("===============================================================\n");
+    return rows > 0 ? 0 : -1;
+}
@@ -0,0 +1,158 @@
+#include "tdx_guest.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <atomic>
+
+#define TSM_GENERATION_RETRIES 3
+
+// linux/tdx-guest.h, declared here so older kernel headers still build
+typedef struct {
+    uint8_t reportdata[TDX_REPORT_DATA_SIZE];
+    uint8_t tdreport[TDX_REPORT_SIZE];
+} tdx_report_req_t;
+
+#ifndef TDX_CMD_GET_REPORT0
+#define TDX_CMD_GET_REPORT0 _IOWR('T', 1, tdx_report_req_t)  /* 0xC4005401 */
+#endif
+
+static std::atomic<unsigned> tsm_entry_counter(0);
+
+static int write_file(const std::string& path, const uint8_t* data, size_t len) {
+    int fd = ::open(path.c_str(), O_WRONLY);
+    if (fd < 0) {
+        return errno;
+    }
+    ssize_t written = write(fd, data, len);
+    int err = written < 0 ? errno : (size_t)written != len ? EIO : 0;
+    ::close(fd);
+    return err;
+}
+
+static int read_file(const std::string& path, std::vector<uint8_t>* out, size_t max) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return errno;
+    }
+    out->resize(max);
+    size_t len = 0;
+    int err = 0;
+    while (len < max) {
+        ssize_t n = read(fd, out->data() + len, max - len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            err = errno;
+            break;
+        }
+        if (n == 0) {
+            break;
+        }
+        len += (size_t)n;
+    }
+    ::close(fd);
+    out->resize(len);
+    return err;
+}
+
+TdxGuest::TdxGuest() : fd_(-1), last_error_(0) {
+}
+
+TdxGuest::~TdxGuest() {
+    close();
+}
+
+bool TdxGuest::open(const char* device) {
+    close();
+    fd_ = ::open(device, O_RDWR | O_CLOEXEC);
+    if (fd_ < 0) {
+        last_error_ = errno;
+        return false;
+    }
+    last_error_ = 0;
+    open_tsm_entry();
+    return true;
+}
+
+void TdxGuest::close() {
+    if (!tsm_entry_.empty()) {
+        rmdir(tsm_entry_.c_str());
+        tsm_entry_.clear();
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+bool TdxGuest::open_tsm_entry() {
+    char path[128];
+    snprintf(path, sizeof(path), "%s/htee-%d-%u", TDX_TSM_REPORT_DIR, (int)getpid(),
+             tsm_entry_counter.fetch_add(1));
+    if (mkdir(path, 0700) != 0 && errno != EEXIST) {
+        return false;
+    }
+    tsm_entry_ = path;
+    return true;
+}
+
+bool TdxGuest::read_generation(uint64_t* out) const {
+    std::vector<uint8_t> text;
+    if (read_file(tsm_entry_ + "/generation", &text, 32) != 0 || text.empty()) {
+        return false;
+    }
+    text.push_back('\0');
+    *out = strtoull((const char*)text.data(), NULL, 10);
+    return true;
+}
+
+int TdxGuest::get_report(const uint8_t report_data[TDX_REPORT_DATA_SIZE],
+                         uint8_t report[TDX_REPORT_SIZE]) {
+    if (fd_ < 0) {
+        return EBADF;
+    }
+    tdx_report_req_t req;
+    memcpy(req.reportdata, report_data, sizeof(req.reportdata));
+    if (ioctl(fd_, TDX_CMD_GET_REPORT0, &req) != 0) {
+        return errno;
+    }
+    memcpy(report, req.tdreport, sizeof(req.tdreport));
+    return 0;
+}
+
+int TdxGuest::get_quote(const uint8_t report_data[TDX_REPORT_DATA_SIZE], std::vector<uint8_t>* quote) {
+    if (tsm_entry_.empty()) {
+        return ENOTSUP;
+    }
+    // generation moves on every inblob write; a change across the read means
+    // the quote is for someone else's report_data
+    for (int attempt = 0; attempt < TSM_GENERATION_RETRIES; attempt++) {
+        int err = write_file(tsm_entry_ + "/inblob", report_data, TDX_REPORT_DATA_SIZE);
+        if (err != 0) {
+            return err;
+        }
+        uint64_t before = 0;
+        uint64_t after = 0;
+        if (!read_generation(&before)) {
+            return EIO;
+        }
+        err = read_file(tsm_entry_ + "/outblob", quote, TDX_QUOTE_MAX);
+        if (err != 0) {
+            return err;
+        }
+        if (!read_generation(&after)) {
+            return EIO;
+        }
+        if (before == after) {
+            return quote->empty() ? EIO : 0;
+        }
+    }
+    return EAGAIN;
+}
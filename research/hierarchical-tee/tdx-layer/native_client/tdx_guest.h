@@ -0,0 +1,55 @@
+#ifndef TDX_GUEST_H
+#define TDX_GUEST_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/*
+ * Direct access to the TDX guest driver, in place of forking
+ * `trustauthority-cli evidence` per sample.
+ *
+ * Reports come from the TDX_CMD_GET_REPORT0 ioctl on /dev/tdx_guest, the
+ * TdxReportReq request tdx_attestation.py declares. Quotes come from the
+ * kernel's configfs-tsm interface (Linux 6.7+), which is what the Trust
+ * Authority CLI uses: write report_data to <entry>/inblob, read the quote
+ * from <entry>/outblob. The QGS round trip happens inside that read.
+ *
+ * Each TdxGuest owns its own fd and its own configfs entry, so workers
+ * never contend on a shared entry. It is not thread-safe: give each
+ * worker its own, like the latency histograms.
+ */
+
+#define TDX_GUEST_DEVICE "/dev/tdx_guest"
+#define TDX_TSM_REPORT_DIR "/sys/kernel/config/tsm/report"
+#define TDX_REPORT_DATA_SIZE 64
+#define TDX_REPORT_SIZE 1024
+#define TDX_QUOTE_MAX (16 * 1024)  /* v4 quote with its PCK chain is ~5 KB */
+
+class TdxGuest {
+public:
+    TdxGuest();
+    ~TdxGuest();
+    
+    /* false with errno-style last_error() when the device cannot be opened;
+     * a missing configfs-tsm only leaves has_quote() false. */
+    bool open(const char* device = TDX_GUEST_DEVICE);
+    void close();
+    
+    bool has_quote() const { return !tsm_entry_.empty(); }
+    int last_error() const { return last_error_; }
+    
+    /* 0 or an errno value. */
+    int get_report(const uint8_t report_data[TDX_REPORT_DATA_SIZE], uint8_t report[TDX_REPORT_SIZE]);
+    int get_quote(const uint8_t report_data[TDX_REPORT_DATA_SIZE], std::vector<uint8_t>* quote);
+    
+private:
+    bool open_tsm_entry();
+    bool read_generation(uint64_t* out) const;
+    
+    int fd_;
+    int last_error_;
+    std::string tsm_entry_;
+};
+
+#endif /* TDX_GUEST_H */